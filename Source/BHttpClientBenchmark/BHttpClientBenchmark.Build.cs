@@ -0,0 +1,15 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+using UnrealBuildTool;
+
+public class BHttpClientBenchmark : ModuleRules
+{
+	public BHttpClientBenchmark(ReadOnlyTargetRules Target) : base(Target)
+    {
+        PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+        PublicDependencyModuleNames.AddRange(new string[] { "Core", "BHttpClientLib", "OpenSSL", "zlib" });
+
+        PrivateDependencyModuleNames.AddRange(new string[] { "Core", "Json", "Projects" });
+	}
+}
@@ -0,0 +1,382 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#include "BHttpAllocationBenchmark.h"
+#include "BHttpAllocationCounter.h"
+#include "BHttpLoopbackServer.h"
+#include "BHttpClient.h"
+#include "Dom/JsonObject.h"
+#include "HAL/PlatformProperties.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/App.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+// Response bodies go nowhere, a growing std::ostringstream would be counted as the client's
+class FNullStreamBuffer : public std::streambuf
+{
+protected:
+    int overflow(int Character) override { return Character; }
+    std::streamsize xsputn(const char*, std::streamsize Count) override { return Count; }
+};
+
+bool BHttpAllocationBenchmark::Run(const FBHttpAllocationBenchmarkOptions& Options, TArray<FBHttpAllocationResult>& OutResults)
+{
+    OutResults.Empty();
+
+    BHttpLoopbackServer Server;
+    if (!Server.Start(false))
+    {
+        UE_LOG(LogBHttpClientLib, Error, TEXT("BHttpAllocationBenchmark: Loopback server could not be started"));
+        return false;
+    }
+
+    BHttpAllocationCounter& Counter = BHttpAllocationCounter::Get();
+    Counter.Install();
+
+    const FString BaseUrl = Server.GetBaseUrl();
+    const FString GetUrl = BaseUrl + FString::Printf(TEXT("/bytes/%d"), Options.PayloadBytes);
+    const FString UploadUrl = BaseUrl + TEXT("/sink");
+    const FString ContentType = TEXT("application/octet-stream");
+
+    TMap<FString, FString> Headers;
+    Headers.Add(TEXT("Accept"), TEXT("*/*"));
+    Headers.Add(TEXT("X-Request-Source"), TEXT("BHttpAllocationBenchmark"));
+
+    FNullStreamBuffer NullBuffer;
+    std::ostream Output(&NullBuffer);
+    // Rewound before every upload, reading it back allocates nothing
+    std::istringstream Input(std::string(FMath::Max(Options.PayloadBytes, 0), 'x'));
+    auto RewoundInput = [&Input]() -> std::istream*
+    {
+        Input.clear();
+        Input.seekg(0);
+        return &Input;
+    };
+
+    // PostFile reads the payload from disk, GetToFile writes over the same download every call
+    const FString UploadFilePath = FPaths::ProjectSavedDir() / TEXT("BHttpAllocationUpload.bin");
+    const FString DownloadFilePath = FPaths::ProjectSavedDir() / TEXT("BHttpAllocationDownload.bin");
+    bool bFilesWritable = false;
+    {
+        std::ofstream UploadFile(TCHAR_TO_UTF8(*UploadFilePath), std::ios::binary | std::ios::trunc);
+        UploadFile << Input.str();
+        bFilesWritable = UploadFile.good();
+    }
+    if (!bFilesWritable)
+    {
+        UE_LOG(LogBHttpClientLib, Warning, TEXT("BHttpAllocationBenchmark: %s could not be written, GetToFile and PostFile are skipped"), *UploadFilePath);
+    }
+
+    // Keeps its capacity between calls, as a caller reusing it would
+    TArray<uint8> Body;
+
+    TArray<FBHttpMultipartPart> Parts;
+    Parts.AddDefaulted(2);
+    Parts[0].Name = TEXT("metadata");
+    Parts[0].Value = TEXT("{\"source\":\"BHttpAllocationBenchmark\"}");
+    Parts[1].Name = TEXT("payload");
+    Parts[1].FileName = TEXT("payload.bin");
+    Parts[1].ContentType = ContentType;
+    Parts[1].Stream = &Input;
+    Parts[1].StreamBytes = FMath::Max(Options.PayloadBytes, 0);
+
+    constexpr int32 BatchSize = 8;
+    TArray<FString> PipelinedUrls;
+    TArray<std::ostream*> PipelinedOutputs;
+    TArray<FBHttpBatchRequest> BatchRequests;
+    for (int32 i = 0; i < BatchSize; i++)
+    {
+        PipelinedUrls.Add(GetUrl);
+        PipelinedOutputs.Add(&Output);
+
+        FBHttpBatchRequest Request;
+        Request.FullPath = GetUrl;
+        Request.HeadersData = Headers;
+        Request.OutputStream = &Output;
+        BatchRequests.Add(Request);
+    }
+
+    struct FEntryPoint
+    {
+        const TCHAR* Name;
+        int32 RequestsPerCall;
+        TFunction<void()> Call;
+        bool bUsesFiles = false;
+    };
+    const FEntryPoint EntryPoints[] = {
+        { TEXT("SplitPath"), 1, [&]() { FString Host, Path; BHttpClient::SplitPath(GetUrl, Host, Path); } },
+        { TEXT("Get"), 1, [&]() { BHttpClient::Get(&Output, GetUrl, Headers); } },
+        { TEXT("GetInto"), 1, [&]() { BHttpClient::GetInto(Body, GetUrl, Headers); } },
+        { TEXT("GetToFile"), 1, [&]() { BHttpClient::GetToFile(DownloadFilePath, GetUrl, Headers); }, true },
+        { TEXT("Delete"), 1, [&]() { BHttpClient::Delete(&Output, UploadUrl, Headers); } },
+        { TEXT("Post"), 1, [&]() { BHttpClient::Post(RewoundInput(), &Output, UploadUrl, Headers, ContentType); } },
+        { TEXT("PostFile"), 1, [&]() { BHttpClient::PostFile(UploadFilePath, &Output, UploadUrl, Headers, ContentType); }, true },
+        { TEXT("PostMultipart"), 1, [&]() { RewoundInput(); BHttpClient::PostMultipart(Parts, &Output, UploadUrl, Headers); } },
+        { TEXT("Put"), 1, [&]() { BHttpClient::Put(RewoundInput(), &Output, UploadUrl, Headers, ContentType); } },
+        { TEXT("Patch"), 1, [&]() { BHttpClient::Patch(RewoundInput(), &Output, UploadUrl, Headers, ContentType); } },
+        { TEXT("GetPipelined"), BatchSize, [&]() { BHttpClient::GetPipelined(PipelinedOutputs, PipelinedUrls, Headers); } },
+        { TEXT("ExecuteBatch"), BatchSize, [&]() { BHttpClient::ExecuteBatch(BatchRequests); } },
+    };
+
+    for (const FEntryPoint& EntryPoint : EntryPoints)
+    {
+        if (EntryPoint.bUsesFiles && !bFilesWritable)
+        {
+            continue;
+        }
+
+        for (int32 i = 0; i < Options.WarmupCalls; i++)
+        {
+            EntryPoint.Call();
+        }
+
+        FBHttpAllocationResult Result;
+        Result.Name = EntryPoint.Name;
+        Result.Calls = Options.Calls;
+        Result.RequestsPerCall = EntryPoint.RequestsPerCall;
+
+        const double Requests = static_cast<double>(FMath::Max(Options.Calls, 1)) * EntryPoint.RequestsPerCall;
+        for (int32 Round = 0; Round < FMath::Max(Options.Rounds, 1); Round++)
+        {
+            const double RoundStart = FPlatformTime::Seconds();
+            Counter.Start();
+            for (int32 i = 0; i < Options.Calls; i++)
+            {
+                EntryPoint.Call();
+            }
+            Counter.Stop();
+            const double RoundSeconds = FPlatformTime::Seconds() - RoundStart;
+
+            const double Allocations = Counter.GetAllocations() / Requests;
+            if (Round == 0 || Allocations < Result.AllocationsPerRequest)
+            {
+                Result.AllocationsPerRequest = Allocations;
+                Result.BytesPerRequest = Counter.GetBytes() / Requests;
+                Result.NanosecondsPerRequest = RoundSeconds * 1e9 / Requests;
+            }
+        }
+
+        UE_LOG(LogBHttpClientLib, Display, TEXT("BHttpAllocationBenchmark: %s - %.1f allocations, %.0f bytes, %.0f ns per request"),
+            *Result.Name, Result.AllocationsPerRequest, Result.BytesPerRequest, Result.NanosecondsPerRequest);
+        OutResults.Add(Result);
+    }
+
+    Server.Stop();
+    std::remove(TCHAR_TO_UTF8(*UploadFilePath));
+    std::remove(TCHAR_TO_UTF8(*DownloadFilePath));
+    return true;
+}
+
+// The entry of Build in a baseline, every build records its own next to the others
+static TSharedPtr<FJsonObject> FindBaselineBuild(const TSharedPtr<FJsonObject>& Root, const FString& Build, TArray<FString>* OutOtherBuilds = nullptr)
+{
+    const TArray<TSharedPtr<FJsonValue>>* Builds = nullptr;
+    if (!Root.IsValid() || !Root->TryGetArrayField(TEXT("builds"), Builds))
+    {
+        return nullptr;
+    }
+
+    TSharedPtr<FJsonObject> Found;
+    for (const TSharedPtr<FJsonValue>& Entry : *Builds)
+    {
+        const TSharedPtr<FJsonObject>* Object = nullptr;
+        FString EntryBuild;
+        if (!Entry.IsValid() || !Entry->TryGetObject(Object) || !(*Object)->TryGetStringField(TEXT("build"), EntryBuild))
+        {
+            continue;
+        }
+
+        if (EntryBuild == Build)
+        {
+            Found = *Object;
+        }
+        else if (OutOtherBuilds)
+        {
+            OutOtherBuilds->Add(EntryBuild);
+        }
+    }
+    return Found;
+}
+
+// One line per result, with the comparison to the baseline if bWithBaseline
+static void AppendResults(std::string& Json, const TArray<FBHttpAllocationResult>& Results, bool bWithBaseline)
+{
+    char Line[1024];
+    for (int32 i = 0; i < Results.Num(); i++)
+    {
+        const FBHttpAllocationResult& Result = Results[i];
+        snprintf(Line, sizeof(Line),
+            "%s\n{\"name\":\"%s\",\"calls\":%d,\"requests_per_call\":%d,\"allocations_per_request\":%.2f,\"bytes_per_request\":%.1f,\"nanoseconds_per_request\":%.0f",
+            i == 0 ? "" : ",", TCHAR_TO_UTF8(*Result.Name), Result.Calls, Result.RequestsPerCall,
+            Result.AllocationsPerRequest, Result.BytesPerRequest, Result.NanosecondsPerRequest);
+        Json += Line;
+
+        if (bWithBaseline && Result.bHasBaseline)
+        {
+            snprintf(Line, sizeof(Line), ",\"baseline_allocations_per_request\":%.2f,\"baseline_bytes_per_request\":%.1f,\"regressed\":%s",
+                Result.BaselineAllocationsPerRequest, Result.BaselineBytesPerRequest, Result.bRegressed ? "true" : "false");
+            Json += Line;
+        }
+        Json += "}";
+    }
+}
+
+bool BHttpAllocationBenchmark::CompareToBaseline(const FString& BaselineJson, const FBHttpAllocationBenchmarkOptions& Options, TArray<FBHttpAllocationResult>& InOutResults)
+{
+    TSharedPtr<FJsonObject> Root;
+    const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(BaselineJson);
+    if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid())
+    {
+        UE_LOG(LogBHttpClientLib, Error, TEXT("BHttpAllocationBenchmark: Baseline could not be parsed"));
+        return false;
+    }
+
+    // Counts of another build say nothing about this one, neither way
+    TArray<FString> OtherBuilds;
+    const TSharedPtr<FJsonObject> Build = FindBaselineBuild(Root, GetBuildName(), &OtherBuilds);
+    const TArray<TSharedPtr<FJsonValue>>* Entries = nullptr;
+    if (!Build.IsValid() || !Build->TryGetArrayField(TEXT("results"), Entries))
+    {
+        UE_LOG(LogBHttpClientLib, Error, TEXT("BHttpAllocationBenchmark: Baseline has no counts of \"%s\" (recorded: %s), run with -update in this build and check the baseline in"),
+            *GetBuildName(), OtherBuilds.Num() > 0 ? *FString::Join(OtherBuilds, TEXT(", ")) : TEXT("none"));
+        return false;
+    }
+
+    bool bPassed = true;
+    for (FBHttpAllocationResult& Result : InOutResults)
+    {
+        for (const TSharedPtr<FJsonValue>& Entry : *Entries)
+        {
+            const TSharedPtr<FJsonObject>* Object = nullptr;
+            if (!Entry.IsValid() || !Entry->TryGetObject(Object) || (*Object)->GetStringField(TEXT("name")) != Result.Name)
+            {
+                continue;
+            }
+
+            Result.bHasBaseline = true;
+            Result.BaselineAllocationsPerRequest = (*Object)->GetNumberField(TEXT("allocations_per_request"));
+            Result.BaselineBytesPerRequest = (*Object)->GetNumberField(TEXT("bytes_per_request"));
+            Result.bRegressed = Result.AllocationsPerRequest > Result.BaselineAllocationsPerRequest * (1.0 + Options.AllocationTolerance) + 1.0
+                || Result.BytesPerRequest > Result.BaselineBytesPerRequest * (1.0 + Options.ByteTolerance);
+            break;
+        }
+
+        // An entry point added since the baseline was recorded would otherwise never be gated
+        if (!Result.bHasBaseline)
+        {
+            bPassed = false;
+            UE_LOG(LogBHttpClientLib, Error, TEXT("BHttpAllocationBenchmark: %s has no baseline in \"%s\", run with -update in this build and check the baseline in"),
+                *Result.Name, *GetBuildName());
+        }
+        else if (Result.bRegressed)
+        {
+            bPassed = false;
+            UE_LOG(LogBHttpClientLib, Error, TEXT("BHttpAllocationBenchmark: %s regressed - %.1f allocations and %.0f bytes per request, baseline %.1f and %.0f"),
+                *Result.Name, Result.AllocationsPerRequest, Result.BytesPerRequest, Result.BaselineAllocationsPerRequest, Result.BaselineBytesPerRequest);
+        }
+        else if (Result.AllocationsPerRequest < Result.BaselineAllocationsPerRequest * (1.0 - Options.AllocationTolerance) - 1.0)
+        {
+            UE_LOG(LogBHttpClientLib, Display, TEXT("BHttpAllocationBenchmark: %s is below its baseline (%.1f, baseline %.1f allocations per request), update the baseline to keep it there"),
+                *Result.Name, Result.AllocationsPerRequest, Result.BaselineAllocationsPerRequest);
+        }
+    }
+    return bPassed;
+}
+
+FString BHttpAllocationBenchmark::ToJson(const TArray<FBHttpAllocationResult>& Results)
+{
+    bool bPassed = true;
+    for (const FBHttpAllocationResult& Result : Results)
+    {
+        bPassed = bPassed && !Result.bRegressed;
+    }
+
+    std::string Json = "{\"benchmark\":\"BHttpClientLib.Allocations\",\"version\":2,\"build\":\"";
+    Json += TCHAR_TO_UTF8(*GetBuildName());
+    Json += "\",\"passed\":";
+    Json += bPassed ? "true" : "false";
+    Json += ",\"results\":[";
+    AppendResults(Json, Results, true);
+    Json += "\n]}\n";
+
+    return FString(UTF8_TO_TCHAR(Json.c_str()));
+}
+
+FString BHttpAllocationBenchmark::UpdateBaseline(const FString& BaselineJson, const TArray<FBHttpAllocationResult>& Results)
+{
+    TSharedPtr<FJsonObject> Root;
+    const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(BaselineJson);
+    if (!BaselineJson.IsEmpty() && !FJsonSerializer::Deserialize(Reader, Root))
+    {
+        UE_LOG(LogBHttpClientLib, Warning, TEXT("BHttpAllocationBenchmark: Baseline could not be parsed, only the counts of this build are kept"));
+    }
+
+    // Builds sorted by name, so a re-recorded build only changes its own lines
+    TArray<FString> Builds;
+    FindBaselineBuild(Root, GetBuildName(), &Builds);
+    Builds.Add(GetBuildName());
+    Builds.Sort();
+
+    std::string Json = "{\"benchmark\":\"BHttpClientLib.Allocations\",\"version\":3,\"builds\":[";
+    bool bFirst = true;
+    for (int32 i = 0; i < Builds.Num(); i++)
+    {
+        TArray<FBHttpAllocationResult> BuildResults;
+        if (Builds[i] == GetBuildName())
+        {
+            BuildResults = Results;
+        }
+        else
+        {
+            const TArray<TSharedPtr<FJsonValue>>* Entries = nullptr;
+            const TSharedPtr<FJsonObject> Build = FindBaselineBuild(Root, Builds[i]);
+            if (!Build.IsValid() || !Build->TryGetArrayField(TEXT("results"), Entries)) continue;
+
+            for (const TSharedPtr<FJsonValue>& Entry : *Entries)
+            {
+                const TSharedPtr<FJsonObject>* Object = nullptr;
+                if (!Entry.IsValid() || !Entry->TryGetObject(Object)) continue;
+
+                FBHttpAllocationResult Result;
+                Result.Name = (*Object)->GetStringField(TEXT("name"));
+                Result.Calls = static_cast<int32>((*Object)->GetNumberField(TEXT("calls")));
+                Result.RequestsPerCall = static_cast<int32>((*Object)->GetNumberField(TEXT("requests_per_call")));
+                Result.AllocationsPerRequest = (*Object)->GetNumberField(TEXT("allocations_per_request"));
+                Result.BytesPerRequest = (*Object)->GetNumberField(TEXT("bytes_per_request"));
+                Result.NanosecondsPerRequest = (*Object)->GetNumberField(TEXT("nanoseconds_per_request"));
+                BuildResults.Add(Result);
+            }
+        }
+
+        Json += bFirst ? "\n{\"build\":\"" : ",\n{\"build\":\"";
+        bFirst = false;
+        Json += TCHAR_TO_UTF8(*Builds[i]);
+        Json += "\",\"results\":[";
+        AppendResults(Json, BuildResults, false);
+        Json += "\n]}";
+    }
+    Json += "\n]}\n";
+
+    return FString(UTF8_TO_TCHAR(Json.c_str()));
+}
+
+FString BHttpAllocationBenchmark::GetBuildName()
+{
+    return FString::Printf(TEXT("%s %s %s"), ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()), LexToString(FApp::GetBuildConfiguration()),
+        *FEngineVersion::Current().ToString(EVersionComponent::Minor));
+}
+
+FString BHttpAllocationBenchmark::GetDefaultBaselinePath()
+{
+    const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("BHttpClientLib"));
+    if (!Plugin.IsValid()) return FString();
+
+    return Plugin->GetBaseDir() / TEXT("Source/BHttpClientBenchmark/AllocationBaseline.json");
+}
@@ -0,0 +1,131 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#include "BHttpAllocationCounter.h"
+
+static thread_local int32 IgnoreDepth = 0;
+
+BHttpAllocationCounter& BHttpAllocationCounter::Get()
+{
+    static BHttpAllocationCounter Instance;
+    return Instance;
+}
+
+void BHttpAllocationCounter::Install()
+{
+    static std::atomic<bool> bInstalled{ false };
+    if (bInstalled.exchange(true)) return;
+
+    InnerMalloc = GMalloc;
+    GMalloc = this;
+}
+
+void BHttpAllocationCounter::Start()
+{
+    Allocations.store(0, std::memory_order_relaxed);
+    Bytes.store(0, std::memory_order_relaxed);
+    bCounting.store(true, std::memory_order_release);
+}
+
+void BHttpAllocationCounter::Stop()
+{
+    bCounting.store(false, std::memory_order_release);
+}
+
+BHttpAllocationCounter::FIgnoreThreadScope::FIgnoreThreadScope()
+{
+    IgnoreDepth++;
+}
+
+BHttpAllocationCounter::FIgnoreThreadScope::~FIgnoreThreadScope()
+{
+    IgnoreDepth--;
+}
+
+void BHttpAllocationCounter::Count(SIZE_T Size)
+{
+    if (!bCounting.load(std::memory_order_relaxed) || IgnoreDepth > 0) return;
+
+    Allocations.fetch_add(1, std::memory_order_relaxed);
+    Bytes.fetch_add(static_cast<int64>(Size), std::memory_order_relaxed);
+}
+
+void* BHttpAllocationCounter::Malloc(SIZE_T Size, uint32 Alignment)
+{
+    Count(Size);
+    return InnerMalloc->Malloc(Size, Alignment);
+}
+
+void* BHttpAllocationCounter::Realloc(void* Original, SIZE_T Size, uint32 Alignment)
+{
+    // A realloc that lands in place is still an allocator call on the hot path
+    if (Size > 0)
+    {
+        Count(Size);
+    }
+    return InnerMalloc->Realloc(Original, Size, Alignment);
+}
+
+void BHttpAllocationCounter::Free(void* Original)
+{
+    InnerMalloc->Free(Original);
+}
+
+SIZE_T BHttpAllocationCounter::QuantizeSize(SIZE_T Size, uint32 Alignment)
+{
+    return InnerMalloc->QuantizeSize(Size, Alignment);
+}
+
+bool BHttpAllocationCounter::GetAllocationSize(void* Original, SIZE_T& SizeOut)
+{
+    return InnerMalloc->GetAllocationSize(Original, SizeOut);
+}
+
+void BHttpAllocationCounter::Trim(bool bTrimThreadCaches)
+{
+    InnerMalloc->Trim(bTrimThreadCaches);
+}
+
+void BHttpAllocationCounter::SetupTLSCachesOnCurrentThread()
+{
+    InnerMalloc->SetupTLSCachesOnCurrentThread();
+}
+
+void BHttpAllocationCounter::ClearAndDisableTLSCachesOnCurrentThread()
+{
+    InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+}
+
+void BHttpAllocationCounter::InitializeStatsMetadata()
+{
+    InnerMalloc->InitializeStatsMetadata();
+}
+
+void BHttpAllocationCounter::UpdateStats()
+{
+    InnerMalloc->UpdateStats();
+}
+
+void BHttpAllocationCounter::GetAllocatorStats(FGenericMemoryStats& OutStats)
+{
+    InnerMalloc->GetAllocatorStats(OutStats);
+}
+
+void BHttpAllocationCounter::DumpAllocatorStats(FOutputDevice& Ar)
+{
+    InnerMalloc->DumpAllocatorStats(Ar);
+}
+
+bool BHttpAllocationCounter::IsInternallyThreadSafe() const
+{
+    return InnerMalloc->IsInternallyThreadSafe();
+}
+
+bool BHttpAllocationCounter::ValidateHeap()
+{
+    return InnerMalloc->ValidateHeap();
+}
+
+const TCHAR* BHttpAllocationCounter::GetDescriptiveName()
+{
+    return TEXT("BHttpAllocationCounter");
+}
@@ -0,0 +1,68 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/MemoryBase.h"
+#include <atomic>
+
+/*
+ * FMalloc proxy in front of GMalloc that counts allocations while counting is on. Everything the
+ * module allocates, std:: containers included, ends up in GMalloc, so this sees FString and TArray
+ * growth as well as httplib's std::string, multimap nodes and shared_ptr control blocks. OpenSSL and
+ * zlib allocate with malloc and are not counted.
+ *
+ * Once installed it stays in front of GMalloc: blocks from either side are freed through the same
+ * allocator, so leaving it in is safe, taking it out while other threads allocate is not.
+ *
+ * */
+class BHttpAllocationCounter : public FMalloc
+{
+public:
+    static BHttpAllocationCounter& Get();
+
+    // Wraps GMalloc on the first call, later calls do nothing
+    void Install();
+
+    // Zeroes the counters and starts counting on every thread that is not ignored
+    void Start();
+
+    // Stops counting, the counters keep their values
+    void Stop();
+
+    int64 GetAllocations() const { return Allocations.load(std::memory_order_relaxed); }
+    int64 GetBytes() const { return Bytes.load(std::memory_order_relaxed); }
+
+    // Allocations on the current thread are not counted while this is alive, for threads that only
+    // serve the measurement such as the loopback server
+    struct FIgnoreThreadScope
+    {
+        FIgnoreThreadScope();
+        ~FIgnoreThreadScope();
+    };
+
+    virtual void* Malloc(SIZE_T Size, uint32 Alignment) override;
+    virtual void* Realloc(void* Original, SIZE_T Size, uint32 Alignment) override;
+    virtual void Free(void* Original) override;
+    virtual SIZE_T QuantizeSize(SIZE_T Size, uint32 Alignment) override;
+    virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override;
+    virtual void Trim(bool bTrimThreadCaches) override;
+    virtual void SetupTLSCachesOnCurrentThread() override;
+    virtual void ClearAndDisableTLSCachesOnCurrentThread() override;
+    virtual void InitializeStatsMetadata() override;
+    virtual void UpdateStats() override;
+    virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override;
+    virtual void DumpAllocatorStats(FOutputDevice& Ar) override;
+    virtual bool IsInternallyThreadSafe() const override;
+    virtual bool ValidateHeap() override;
+    virtual const TCHAR* GetDescriptiveName() override;
+
+private:
+    void Count(SIZE_T Size);
+
+    FMalloc* InnerMalloc = nullptr;
+
+    std::atomic<bool> bCounting{ false };
+    std::atomic<int64> Allocations{ 0 };
+    std::atomic<int64> Bytes{ 0 };
+};
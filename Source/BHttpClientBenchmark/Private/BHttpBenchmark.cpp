@@ -0,0 +1,457 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#include "BHttpBenchmark.h"
+#include "BHttpBenchmarkStats.h"
+#include "BHttpLoopbackServer.h"
+#include "BHttpClient.h"
+#include "Misc/Paths.h"
+#include <algorithm>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#if PLATFORM_WINDOWS
+#include <io.h>
+#include "Windows/WindowsHWrapper.h"
+#else
+#include <time.h>
+#endif
+
+// User and system time of the calling thread
+static double GetThreadCpuSeconds()
+{
+#if PLATFORM_WINDOWS
+    FILETIME Creation, Exit, Kernel, User;
+    if (!GetThreadTimes(GetCurrentThread(), &Creation, &Exit, &Kernel, &User)) return 0.0;
+    const uint64 Ticks = (static_cast<uint64>(Kernel.dwHighDateTime) << 32 | Kernel.dwLowDateTime) + (static_cast<uint64>(User.dwHighDateTime) << 32 | User.dwLowDateTime);
+    return static_cast<double>(Ticks) * 100e-9;
+#else
+    timespec Now;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &Now) != 0) return 0.0;
+    return static_cast<double>(Now.tv_sec) + static_cast<double>(Now.tv_nsec) * 1e-9;
+#endif
+}
+
+// The benchmark thread got a ring, io_uring series would otherwise repeat the poll() ones
+static bool IsIoUringAvailable()
+{
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+    return httplib::detail::IoUring::get() != nullptr;
+#else
+    return false;
+#endif
+}
+
+static int32 OpenReadOnly(const FString& FilePath)
+{
+#if PLATFORM_WINDOWS
+    return _wopen(*FilePath, _O_RDONLY | _O_BINARY);
+#else
+    return open(TCHAR_TO_UTF8(*FilePath), O_RDONLY | O_CLOEXEC);
+#endif
+}
+
+static void CloseFile(int32 FileDescriptor)
+{
+#if PLATFORM_WINDOWS
+    _close(FileDescriptor);
+#else
+    close(FileDescriptor);
+#endif
+}
+
+bool BHttpBenchmark::Run(const FBHttpBenchmarkOptions& Options, TArray<FBHttpBenchmarkResult>& OutResults)
+{
+    OutResults.Empty();
+
+    // One file serves every upload size, smaller uploads send its start
+    int64 UploadFileBytes = 0;
+    for (const int64 PayloadBytes : Options.FileUploadSizes)
+    {
+        if (PayloadBytes <= Options.MaxPayloadBytes) UploadFileBytes = FMath::Max(UploadFileBytes, PayloadBytes);
+    }
+    const FString UploadFilePath = (Options.FileUploadDirectory.IsEmpty() ? FPaths::ProjectSavedDir() : Options.FileUploadDirectory) / TEXT("BHttpBenchmarkUpload.bin");
+    if (UploadFileBytes > 0 && !WriteUploadFile(UploadFilePath, UploadFileBytes))
+    {
+        UE_LOG(LogBHttpClientLib, Warning, TEXT("BHttpBenchmark: %s could not be written, file uploads are skipped"), *UploadFilePath);
+        UploadFileBytes = 0;
+    }
+
+    for (const bool bTls : { false, true })
+    {
+        if (bTls && !Options.bIncludeTls) continue;
+
+        BHttpLoopbackServer Server;
+        if (!Server.Start(bTls))
+        {
+            UE_LOG(LogBHttpClientLib, Error, TEXT("BHttpBenchmark: Loopback server could not be started (TLS: %d)"), bTls);
+            return false;
+        }
+        const FString BaseUrl = Server.GetBaseUrl();
+
+        for (const bool bKeepAlive : { true, false })
+        {
+            for (const bool bCompression : { false, true })
+            {
+                for (const int32 Backend : { 0, 1, 2 })
+                {
+                    const bool bKernelTls = Backend == 1;
+                    const bool bIoUring = Backend == 2;
+                    // Kernel TLS only changes the record layer, gzip'ed runs would mostly measure zlib
+                    if (bKernelTls && (!bTls || bCompression || !Options.bIncludeKernelTls)) continue;
+                    // Same for io_uring, which only carries cleartext sockets
+                    if (bIoUring && (bTls || bCompression || !Options.bIncludeIoUring || !IsIoUringAvailable())) continue;
+
+                    FBHttpBenchmarkResult Mode;
+                    Mode.bKeepAlive = bKeepAlive;
+                    Mode.bTls = bTls;
+                    Mode.bCompression = bCompression;
+                    Mode.bKernelTls = bKernelTls;
+                    Mode.bIoUring = bIoUring;
+
+                    FBHttpBenchmarkResult Tiny = Mode;
+                    Tiny.Test = TEXT("tiny_get");
+                    Tiny.PayloadBytes = Options.TinyPayloadBytes;
+                    RunSeries(BaseUrl, Options.TinyRequests, Options.WarmupRequests, Tiny);
+                    OutResults.Add(Tiny);
+
+                    for (const int64 PayloadBytes : Options.PayloadSizes)
+                    {
+                        if (PayloadBytes > Options.MaxPayloadBytes) continue;
+                        if (bCompression && PayloadBytes > Options.MaxCompressedPayloadBytes) continue;
+
+                        const int32 Iterations = static_cast<int32>(FMath::Clamp<int64>(Options.TargetBytesPerSeries / FMath::Max<int64>(PayloadBytes, 1), Options.MinIterations, Options.MaxIterations));
+                        // Large payloads take long enough that a warm-up only doubles the run
+                        const int32 WarmupRequests = PayloadBytes >= Options.TargetBytesPerSeries ? 0 : Options.WarmupRequests;
+
+                        for (const TCHAR* Test : { TEXT("get_throughput"), TEXT("put_throughput") })
+                        {
+                            FBHttpBenchmarkResult Result = Mode;
+                            Result.Test = Test;
+                            Result.PayloadBytes = PayloadBytes;
+                            RunSeries(BaseUrl, Iterations, WarmupRequests, Result);
+                            OutResults.Add(Result);
+                        }
+                    }
+
+                    for (const int64 PayloadBytes : Options.FileUploadSizes)
+                    {
+                        if (bCompression || PayloadBytes > UploadFileBytes) continue;
+
+                        const int32 Iterations = static_cast<int32>(FMath::Clamp<int64>(Options.TargetBytesPerSeries / FMath::Max<int64>(PayloadBytes, 1), Options.MinIterations, Options.MaxIterations));
+                        const int32 WarmupRequests = PayloadBytes >= Options.TargetBytesPerSeries ? 0 : Options.WarmupRequests;
+
+                        for (const TCHAR* Test : { TEXT("put_file"), TEXT("put_istream") })
+                        {
+                            FBHttpBenchmarkResult Result = Mode;
+                            Result.Test = Test;
+                            Result.PayloadBytes = PayloadBytes;
+                            RunSeries(BaseUrl, Iterations, WarmupRequests, Result, UploadFilePath);
+                            OutResults.Add(Result);
+                        }
+                    }
+
+                    UE_LOG(LogBHttpClientLib, Display, TEXT("BHttpBenchmark: Finished keep-alive %d, TLS %d, compression %d, kernel TLS %d, io_uring %d"), bKeepAlive, bTls, bCompression, bKernelTls, bIoUring);
+                }
+            }
+        }
+
+        // Cold first, a warmed up host would otherwise leave connections behind for it
+        for (const TCHAR* Test : { TEXT("cold_start"), TEXT("warm_start") })
+        {
+            if (Options.StartupRequests <= 0) break;
+
+            FBHttpBenchmarkResult Result;
+            Result.Test = Test;
+            Result.bKeepAlive = true;
+            Result.bTls = bTls;
+            Result.PayloadBytes = Options.TinyPayloadBytes;
+            RunStartupSeries(BaseUrl, Options.StartupRequests, Result);
+            OutResults.Add(Result);
+        }
+
+        Server.Stop();
+    }
+
+    if (UploadFileBytes > 0)
+    {
+        std::remove(TCHAR_TO_UTF8(*UploadFilePath));
+    }
+    return true;
+}
+
+bool BHttpBenchmark::WriteUploadFile(const FString& FilePath, int64 Bytes)
+{
+    const std::string& Block = BHttpLoopbackServer::GetPayloadBlock();
+
+    std::ofstream File(TCHAR_TO_UTF8(*FilePath), std::ios::binary | std::ios::trunc);
+    for (int64 Written = 0; File.good() && Written < Bytes; Written += static_cast<int64>(Block.size()))
+    {
+        File.write(Block.data(), static_cast<std::streamsize>(FMath::Min<int64>(Bytes - Written, Block.size())));
+    }
+    return File.good();
+}
+
+void BHttpBenchmark::RunSeries(const FString& BaseUrl, int32 Iterations, int32 WarmupRequests, FBHttpBenchmarkResult& InOutResult, const FString& UploadFilePath)
+{
+    const std::string Url = TCHAR_TO_UTF8(*BaseUrl);
+    const bool bPut = InOutResult.Test == TEXT("put_throughput");
+    const bool bPutFile = InOutResult.Test == TEXT("put_file");
+    const bool bPutIstream = InOutResult.Test == TEXT("put_istream");
+    const uint64 PayloadBytes = static_cast<uint64>(InOutResult.PayloadBytes);
+    const std::string GetPath = "/bytes/" + std::to_string(PayloadBytes);
+    const std::string& Block = BHttpLoopbackServer::GetPayloadBlock();
+
+    httplib::Headers Headers;
+    if (InOutResult.bCompression && !bPut)
+    {
+        Headers.emplace("Accept-Encoding", "gzip");
+    }
+
+    // As the last response saw its connection, kernel TLS can fail per handshake
+    auto NoteKernelTls = [&InOutResult](const httplib::Result& Res)
+    {
+        if (!Res) return;
+        InOutResult.bKernelTlsSend = Res->timings.kernel_tls_send;
+        InOutResult.bKernelTlsReceive = Res->timings.kernel_tls_recv;
+    };
+
+    std::unique_ptr<httplib::Client> Client;
+    auto SendRequest = [&]()
+    {
+        if (!Client || !InOutResult.bKeepAlive)
+        {
+            Client = std::make_unique<httplib::Client>(Url.c_str());
+            Client->set_keep_alive(InOutResult.bKeepAlive);
+            Client->set_compress(InOutResult.bCompression);
+            Client->set_kernel_tls(InOutResult.bKernelTls);
+            Client->set_io_uring(InOutResult.bIoUring);
+            Client->set_read_timeout(60);
+            Client->set_write_timeout(60);
+        }
+
+        // Both open the file per request, as a caller of BHttpClient::PutFile or BHttpClient::Put would
+        if (bPutFile)
+        {
+            const int32 FileDescriptor = OpenReadOnly(UploadFilePath);
+            if (FileDescriptor < 0) return false;
+
+            httplib::FileContent File;
+            File.fd = FileDescriptor;
+            File.length = PayloadBytes;
+            auto Res = Client->Put("/sink", Headers, File, "application/octet-stream", nullptr, nullptr, nullptr);
+            CloseFile(FileDescriptor);
+            NoteKernelTls(Res);
+            return Res && Res->status == 200 && Res->body == std::to_string(PayloadBytes);
+        }
+
+        if (bPutIstream)
+        {
+            std::ifstream File(TCHAR_TO_UTF8(*UploadFilePath), std::ios::binary);
+            if (!File.is_open()) return false;
+
+            // What BHttpClient::Put does with its istream
+            auto Res = Client->Put("/sink", Headers, PayloadBytes,
+                [&File](size_t Offset, size_t Length, httplib::DataSink& Sink)
+                {
+                    httplib::detail::BufferPool::Lease Buffer;
+                    File.read(Buffer.data(), static_cast<std::streamsize>(FMath::Min(Length, Buffer.size())));
+                    const std::streamsize Read = File.gcount();
+                    if (Read <= 0) return false;
+                    Sink.write(Buffer.data(), static_cast<size_t>(Read));
+                    return true;
+                },
+                "application/octet-stream");
+            NoteKernelTls(Res);
+            return Res && Res->status == 200 && Res->body == std::to_string(PayloadBytes);
+        }
+
+        if (bPut)
+        {
+            auto Res = Client->Put("/sink", Headers, PayloadBytes,
+                [&Block](size_t Offset, size_t Length, httplib::DataSink& Sink)
+                {
+                    const size_t BlockOffset = Offset % Block.size();
+                    Sink.write(Block.data() + BlockOffset, FMath::Min(Length, Block.size() - BlockOffset));
+                    return true;
+                },
+                "application/octet-stream");
+            NoteKernelTls(Res);
+            // The server answers with the bytes it read, compressed ones when gzip'ed
+            return Res && Res->status == 200 && (InOutResult.bCompression || Res->body == std::to_string(PayloadBytes));
+        }
+
+        uint64 Received = 0;
+        auto Res = Client->Get(GetPath.c_str(), Headers,
+            [&Received](const char*, size_t Length)
+            {
+                Received += Length;
+                return true;
+            });
+        NoteKernelTls(Res);
+        return Res && Res->status == 200 && Received == PayloadBytes;
+    };
+
+    for (int32 i = 0; i < WarmupRequests; i++)
+    {
+        SendRequest();
+    }
+
+    std::vector<double> Latencies;
+    Latencies.reserve(Iterations);
+
+    const double SeriesStart = FPlatformTime::Seconds();
+    const double SeriesCpuStart = GetThreadCpuSeconds();
+    for (int32 i = 0; i < Iterations; i++)
+    {
+        const double RequestStart = FPlatformTime::Seconds();
+        const bool bSucceed = SendRequest();
+        const double RequestEnd = FPlatformTime::Seconds();
+
+        if (bSucceed)
+        {
+            Latencies.push_back(RequestEnd - RequestStart);
+        }
+        else
+        {
+            InOutResult.Failures++;
+            // Whatever broke, the next request starts on a new connection
+            Client.reset();
+        }
+    }
+    InOutResult.Seconds = FPlatformTime::Seconds() - SeriesStart;
+    InOutResult.CpuSeconds = GetThreadCpuSeconds() - SeriesCpuStart;
+    InOutResult.Requests = Iterations;
+
+    SetLatencyStats(Latencies, InOutResult);
+}
+
+void BHttpBenchmark::RunStartupSeries(const FString& BaseUrl, int32 Iterations, FBHttpBenchmarkResult& InOutResult)
+{
+    const bool bWarm = InOutResult.Test == TEXT("warm_start");
+    const FString Url = FString::Printf(TEXT("%s/bytes/%lld"), *BaseUrl, InOutResult.PayloadBytes);
+    const TArray<FString> Hosts = { BaseUrl };
+
+    FBHttpWarmUpOptions WarmUpOptions;
+    WarmUpOptions.ConnectionsPerHost = 1;
+    WarmUpOptions.WaitSeconds = 5.0f;
+
+    std::vector<double> Latencies;
+    Latencies.reserve(Iterations);
+
+    // Only the requests are timed, not emptying the pool or waiting for the warm up
+    double Seconds = 0.0;
+    double CpuSeconds = 0.0;
+    for (int32 i = 0; i < Iterations; i++)
+    {
+        BHttpClient::CloseIdleConnections();
+        if (bWarm && BHttpClient::WarmUpConnections(Hosts, WarmUpOptions) < 1)
+        {
+            InOutResult.Failures++;
+            continue;
+        }
+
+        std::stringstream Body;
+        const double RequestStart = FPlatformTime::Seconds();
+        const double RequestCpuStart = GetThreadCpuSeconds();
+        const int32 StatusCode = BHttpClient::Get(&Body, Url);
+        const double RequestEnd = FPlatformTime::Seconds();
+        CpuSeconds += GetThreadCpuSeconds() - RequestCpuStart;
+        Seconds += RequestEnd - RequestStart;
+
+        if (StatusCode == 200 && static_cast<int64>(Body.str().size()) == InOutResult.PayloadBytes)
+        {
+            Latencies.push_back(RequestEnd - RequestStart);
+        }
+        else
+        {
+            InOutResult.Failures++;
+        }
+    }
+    if (bWarm)
+    {
+        BHttpClient::StopWarmUp(Hosts);
+    }
+    BHttpClient::CloseIdleConnections();
+
+    InOutResult.Seconds = Seconds;
+    InOutResult.CpuSeconds = CpuSeconds;
+    InOutResult.Requests = Iterations;
+
+    SetLatencyStats(Latencies, InOutResult);
+}
+
+void BHttpBenchmark::SetLatencyStats(std::vector<double>& Latencies, FBHttpBenchmarkResult& InOutResult)
+{
+    if (InOutResult.Failures > 0)
+    {
+        UE_LOG(LogBHttpClientLib, Warning, TEXT("BHttpBenchmark: %d of %d requests failed in %s, %lld bytes"), InOutResult.Failures, InOutResult.Requests, *InOutResult.Test, InOutResult.PayloadBytes);
+    }
+
+    if (Latencies.empty() || InOutResult.Seconds <= 0.0) return;
+
+    const double Succeeded = static_cast<double>(Latencies.size());
+    const double PayloadBytes = static_cast<double>(InOutResult.PayloadBytes);
+    InOutResult.RequestsPerSecond = Succeeded / InOutResult.Seconds;
+    InOutResult.MegabytesPerSecond = Succeeded * PayloadBytes / InOutResult.Seconds / 1e6;
+    InOutResult.CpuSecondsPerGigabyte = InOutResult.CpuSeconds / (Succeeded * PayloadBytes / 1e9);
+
+    std::sort(Latencies.begin(), Latencies.end());
+    InOutResult.P50Seconds = GetPercentile(Latencies, 0.5);
+    InOutResult.P99Seconds = GetPercentile(Latencies, 0.99);
+    InOutResult.P999Seconds = GetPercentile(Latencies, 0.999);
+    InOutResult.MaxSeconds = Latencies.back();
+}
+
+FString BHttpBenchmark::ToJson(const FBHttpBenchmarkOptions& Options, const TArray<FBHttpBenchmarkResult>& Results)
+{
+    std::string Json;
+    char Line[1024];
+
+    snprintf(Line, sizeof(Line),
+        "{\"benchmark\":\"BHttpClientLib\",\"version\":1,\"options\":{\"max_payload_bytes\":%lld,\"max_compressed_payload_bytes\":%lld,"
+        "\"target_bytes_per_series\":%lld,\"min_iterations\":%d,\"max_iterations\":%d,\"tiny_requests\":%d,\"warmup_requests\":%d,\"startup_requests\":%d},\"results\":[",
+        static_cast<long long>(Options.MaxPayloadBytes), static_cast<long long>(Options.MaxCompressedPayloadBytes),
+        static_cast<long long>(Options.TargetBytesPerSeries), Options.MinIterations, Options.MaxIterations, Options.TinyRequests, Options.WarmupRequests, Options.StartupRequests);
+    Json += Line;
+
+    for (int32 i = 0; i < Results.Num(); i++)
+    {
+        const FBHttpBenchmarkResult& Result = Results[i];
+        snprintf(Line, sizeof(Line),
+            "%s\n{\"test\":\"%s\",\"keep_alive\":%s,\"tls\":%s,\"compression\":%s,"
+            "\"kernel_tls\":%s,\"kernel_tls_send\":%s,\"kernel_tls_receive\":%s,\"io_uring\":%s,\"payload_bytes\":%lld,\"requests\":%d,\"failures\":%d,"
+            "\"seconds\":%.6f,\"mb_per_second\":%.3f,\"requests_per_second\":%.3f,\"cpu_seconds\":%.6f,\"cpu_seconds_per_gb\":%.6f,"
+            "\"latency_seconds\":{\"p50\":%.9f,\"p99\":%.9f,\"p999\":%.9f,\"max\":%.9f}}",
+            i == 0 ? "" : ",", TCHAR_TO_UTF8(*Result.Test),
+            Result.bKeepAlive ? "true" : "false", Result.bTls ? "true" : "false", Result.bCompression ? "true" : "false",
+            Result.bKernelTls ? "true" : "false", Result.bKernelTlsSend ? "true" : "false", Result.bKernelTlsReceive ? "true" : "false",
+            Result.bIoUring ? "true" : "false",
+            static_cast<long long>(Result.PayloadBytes), Result.Requests, Result.Failures,
+            Result.Seconds, Result.MegabytesPerSecond, Result.RequestsPerSecond, Result.CpuSeconds, Result.CpuSecondsPerGigabyte,
+            Result.P50Seconds, Result.P99Seconds, Result.P999Seconds, Result.MaxSeconds);
+        Json += Line;
+    }
+    Json += "\n]}\n";
+
+    return FString(UTF8_TO_TCHAR(Json.c_str()));
+}
+
+bool BHttpBenchmark::RunToFile(const FBHttpBenchmarkOptions& Options, const FString& FilePath)
+{
+    TArray<FBHttpBenchmarkResult> Results;
+    if (!Run(Options, Results)) return false;
+
+    std::ofstream File(TCHAR_TO_UTF8(*FilePath), std::ios::binary | std::ios::trunc);
+    if (!File.is_open())
+    {
+        UE_LOG(LogBHttpClientLib, Error, TEXT("BHttpBenchmark: %s could not be opened for writing"), *FilePath);
+        return false;
+    }
+
+    File << TCHAR_TO_UTF8(*ToJson(Options, Results));
+    return File.good();
+}
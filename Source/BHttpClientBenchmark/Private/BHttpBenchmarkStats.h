@@ -0,0 +1,16 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <cmath>
+#include <vector>
+
+// Nearest rank, 0 if Sorted is empty; shared by the benchmark and the scenario runner
+inline double GetPercentile(const std::vector<double>& Sorted, double Fraction)
+{
+    if (Sorted.empty()) return 0.0;
+
+    const size_t Rank = static_cast<size_t>(std::ceil(Fraction * static_cast<double>(Sorted.size())));
+    return Sorted[FMath::Clamp<size_t>(Rank, 1, Sorted.size()) - 1];
+}
@@ -0,0 +1,157 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#include "BHttpClientBenchmark.h"
+#include "BHttpAllocationBenchmark.h"
+#include "BHttpBenchmark.h"
+#include "BHttpScenarioRunner.h"
+#include "BHttpClient.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+#include <fstream>
+#include <sstream>
+
+// BHttp.Benchmark [OutputJsonPath] [MaxPayloadBytes], for CI: -ExecCmds="BHttp.Benchmark Out.json 67108864, Quit"
+static void RunBenchmarkCommand(const TArray<FString>& Args)
+{
+    const FString FilePath = Args.Num() > 0 ? Args[0] : FPaths::ProjectSavedDir() / TEXT("BHttpBenchmark.json");
+
+    FBHttpBenchmarkOptions Options;
+    if (Args.Num() > 1)
+    {
+        Options.MaxPayloadBytes = FCString::Atoi64(*Args[1]);
+    }
+
+    UE_LOG(LogBHttpClientLib, Display, TEXT("BHttpBenchmark: Started, results go to %s"), *FilePath);
+
+    if (BHttpBenchmark::RunToFile(Options, FilePath))
+    {
+        UE_LOG(LogBHttpClientLib, Display, TEXT("BHttpBenchmark: Results written to %s"), *FilePath);
+    }
+    else
+    {
+        UE_LOG(LogBHttpClientLib, Error, TEXT("BHttpBenchmark: Failed"));
+    }
+}
+
+static FAutoConsoleCommand BenchmarkCommand(
+    TEXT("BHttp.Benchmark"),
+    TEXT("Runs the loopback benchmark of the HTTP client and writes the results as JSON. Usage: BHttp.Benchmark [OutputJsonPath] [MaxPayloadBytes]"),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&RunBenchmarkCommand));
+
+static bool WriteFile(const FString& FilePath, const FString& Contents)
+{
+    std::ofstream File(TCHAR_TO_UTF8(*FilePath), std::ios::binary | std::ios::trunc);
+    File << TCHAR_TO_UTF8(*Contents);
+    return File.good();
+}
+
+static bool ReadFile(const FString& FilePath, FString& OutContents)
+{
+    std::ifstream File(TCHAR_TO_UTF8(*FilePath), std::ios::binary);
+    std::stringstream Contents;
+    Contents << File.rdbuf();
+    OutContents = UTF8_TO_TCHAR(Contents.str().c_str());
+    return File.is_open();
+}
+
+// BHttp.AllocationBenchmark [OutputJsonPath] [-update] [-exit], -exit quits with exit code 1 on a regression
+static void RunAllocationBenchmarkCommand(const TArray<FString>& Args)
+{
+    FString FilePath = FPaths::ProjectSavedDir() / TEXT("BHttpAllocations.json");
+    bool bUpdateBaseline = false;
+    bool bExitWhenDone = false;
+    for (const FString& Arg : Args)
+    {
+        if (Arg == TEXT("-update"))
+        {
+            bUpdateBaseline = true;
+        }
+        else if (Arg == TEXT("-exit"))
+        {
+            bExitWhenDone = true;
+        }
+        else
+        {
+            FilePath = Arg;
+        }
+    }
+
+    const FBHttpAllocationBenchmarkOptions Options;
+    TArray<FBHttpAllocationResult> Results;
+    bool bPassed = BHttpAllocationBenchmark::Run(Options, Results);
+
+    const FString BaselinePath = BHttpAllocationBenchmark::GetDefaultBaselinePath();
+    FString BaselineJson;
+    const bool bHasBaseline = ReadFile(BaselinePath, BaselineJson);
+    if (bPassed && bUpdateBaseline)
+    {
+        // Other builds' counts stay, only this build's are recorded again
+        bPassed = WriteFile(BaselinePath, BHttpAllocationBenchmark::UpdateBaseline(bHasBaseline ? BaselineJson : FString(), Results));
+        UE_LOG(LogBHttpClientLib, Display, TEXT("BHttpAllocationBenchmark: Baseline of %s written to %s"), *BHttpAllocationBenchmark::GetBuildName(), *BaselinePath);
+    }
+    else if (bPassed)
+    {
+        if (!bHasBaseline)
+        {
+            UE_LOG(LogBHttpClientLib, Error, TEXT("BHttpAllocationBenchmark: No baseline at %s, run with -update to create it"), *BaselinePath);
+            bPassed = false;
+        }
+        else
+        {
+            bPassed = BHttpAllocationBenchmark::CompareToBaseline(BaselineJson, Options, Results);
+        }
+    }
+
+    if (!WriteFile(FilePath, BHttpAllocationBenchmark::ToJson(Results)))
+    {
+        UE_LOG(LogBHttpClientLib, Error, TEXT("BHttpAllocationBenchmark: %s could not be written"), *FilePath);
+        bPassed = false;
+    }
+
+    UE_LOG(LogBHttpClientLib, Display, TEXT("BHttpAllocationBenchmark: %s, results written to %s"), bPassed ? TEXT("Passed") : TEXT("Failed"), *FilePath);
+
+    if (bExitWhenDone)
+    {
+        FPlatformMisc::RequestExitWithStatus(false, bPassed ? 0 : 1);
+    }
+}
+
+static FAutoConsoleCommand AllocationBenchmarkCommand(
+    TEXT("BHttp.AllocationBenchmark"),
+    TEXT("Counts allocations per request of every BHttpClient entry point and compares them to the checked-in baseline. Usage: BHttp.AllocationBenchmark [OutputJsonPath] [-update] [-exit]"),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&RunAllocationBenchmarkCommand));
+
+// BHttp.Scenarios [OutputJsonPath] [ScenarioName...], every default scenario if no name is given
+static void RunScenariosCommand(const TArray<FString>& Args)
+{
+    const FString FilePath = Args.Num() > 0 ? Args[0] : FPaths::ProjectSavedDir() / TEXT("BHttpScenarios.json");
+
+    TArray<FBHttpScenarioResult> Results;
+    bool bSucceed = true;
+    for (const FBHttpScenario& Scenario : BHttpScenarioRunner::GetDefaultScenarios())
+    {
+        if (Args.Num() > 1 && !Args.Contains(Scenario.Name)) continue;
+
+        FBHttpScenarioResult Result;
+        bSucceed = BHttpScenarioRunner::Run(Scenario, Result) && bSucceed;
+        Results.Add(Result);
+    }
+
+    if (!WriteFile(FilePath, BHttpScenarioRunner::ToJson(Results)))
+    {
+        UE_LOG(LogBHttpClientLib, Error, TEXT("BHttpScenarioRunner: %s could not be written"), *FilePath);
+        return;
+    }
+    UE_LOG(LogBHttpClientLib, Display, TEXT("BHttpScenarioRunner: %s, results written to %s"), bSucceed ? TEXT("Done") : TEXT("Some scenarios could not run"), *FilePath);
+}
+
+static FAutoConsoleCommand ScenariosCommand(
+    TEXT("BHttp.Scenarios"),
+    TEXT("Replays traffic mixes against a fault-injecting loopback server and writes success rates and latencies as JSON. Usage: BHttp.Scenarios [OutputJsonPath] [ScenarioName...]"),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&RunScenariosCommand));
+
+void FBHttpClientBenchmarkModule::StartupModule()
+{
+}
+
+IMPLEMENT_MODULE(FBHttpClientBenchmarkModule, BHttpClientBenchmark)
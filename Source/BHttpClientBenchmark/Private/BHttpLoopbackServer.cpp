@@ -0,0 +1,1028 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#include "BHttpLoopbackServer.h"
+#include "BHttpAllocationCounter.h"
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static constexpr size_t PayloadBlockSize = 64 * 1024;
+
+// Request lines and headers are read a byte at a time by stream_line_reader, one recv each without this
+class FBufferedStream : public httplib::Stream
+{
+public:
+    explicit FBufferedStream(httplib::Stream& InStrm) : Strm(InStrm) {}
+
+    bool is_readable() const override { return Begin < End || Strm.is_readable(); }
+    bool is_writable() const override { return Strm.is_writable(); }
+
+    ssize_t read(char* Ptr, size_t Size) override
+    {
+        if (Begin == End)
+        {
+            if (Size >= sizeof(Buffer)) return Strm.read(Ptr, Size);
+
+            const ssize_t Read = Strm.read(Buffer, sizeof(Buffer));
+            if (Read <= 0) return Read;
+            Begin = 0;
+            End = static_cast<size_t>(Read);
+        }
+
+        const size_t Length = FMath::Min(Size, End - Begin);
+        FMemory::Memcpy(Ptr, Buffer + Begin, Length);
+        Begin += Length;
+        return static_cast<ssize_t>(Length);
+    }
+
+    ssize_t write(const char* Ptr, size_t Size) override { return Strm.write(Ptr, Size); }
+
+    void get_remote_ip_and_port(std::string& Ip, int& Port) const override { Strm.get_remote_ip_and_port(Ip, Port); }
+
+private:
+    httplib::Stream& Strm;
+    char Buffer[16 * 1024];
+    size_t Begin = 0;
+    size_t End = 0;
+};
+
+BHttpLoopbackServer::~BHttpLoopbackServer()
+{
+    Stop();
+
+    if (SslContext)
+    {
+        SSL_CTX_free(SslContext);
+        SslContext = nullptr;
+    }
+}
+
+bool BHttpLoopbackServer::Start(bool bInTls)
+{
+    if (AcceptThread.joinable()) return false;
+
+    bTls = bInTls;
+    if (bTls && !SslContext && !CreateTlsContext()) return false;
+
+#ifndef _WIN32
+    // SSL_write to a client that hung up, as dropped and stalled connections do, must fail instead of ending the process
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
+    ListenSocket = httplib::detail::create_socket("127.0.0.1", 0, AI_PASSIVE, true, nullptr,
+        [](socket_t Socket, struct addrinfo& Info)
+        {
+            int Yes = 1;
+            setsockopt(Socket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<char*>(&Yes), sizeof(Yes));
+            return ::bind(Socket, Info.ai_addr, static_cast<int>(Info.ai_addrlen)) == 0 && ::listen(Socket, 128) == 0;
+        });
+    if (ListenSocket == INVALID_SOCKET) return false;
+
+    struct sockaddr_storage Address;
+    socklen_t AddressLength = sizeof(Address);
+    if (getsockname(ListenSocket, reinterpret_cast<struct sockaddr*>(&Address), &AddressLength) != 0)
+    {
+        httplib::detail::close_socket(ListenSocket);
+        ListenSocket = INVALID_SOCKET;
+        return false;
+    }
+    Port = Address.ss_family == AF_INET6
+        ? ntohs(reinterpret_cast<struct sockaddr_in6*>(&Address)->sin6_port)
+        : ntohs(reinterpret_cast<struct sockaddr_in*>(&Address)->sin_port);
+
+    {
+        std::lock_guard<std::mutex> Lock(StoreMutex);
+        Objects.clear();
+        Uploads.clear();
+        Sessions.clear();
+    }
+
+    bStopping = false;
+    AcceptThread = std::thread([this]() { AcceptLoop(); });
+    return true;
+}
+
+void BHttpLoopbackServer::Stop()
+{
+    if (!AcceptThread.joinable()) return;
+
+    bStopping = true;
+    AcceptThread.join();
+
+    httplib::detail::close_socket(ListenSocket);
+    ListenSocket = INVALID_SOCKET;
+
+    std::list<std::unique_ptr<FConnection>> Remaining;
+    {
+        std::lock_guard<std::mutex> Lock(ConnectionsMutex);
+        // Wakes up reads waiting for the next request; the threads close the sockets themselves
+        for (socket_t Socket : OpenSockets)
+        {
+            httplib::detail::shutdown_socket(Socket);
+        }
+        Remaining.swap(Connections);
+    }
+
+    for (std::unique_ptr<FConnection>& Connection : Remaining)
+    {
+        Connection->Thread.join();
+    }
+    Port = 0;
+}
+
+FString BHttpLoopbackServer::GetBaseUrl() const
+{
+    return FString::Printf(TEXT("%s://127.0.0.1:%d"), bTls ? TEXT("https") : TEXT("http"), Port);
+}
+
+const std::string& BHttpLoopbackServer::GetPayloadBlock()
+{
+    static const std::string Block = []()
+    {
+        static const char* const Words[] = {
+            "id", "name", "value", "true", "false", "null", "created", "updated", "items", "count",
+            "bucket", "object", "content", "length", "type", "etag", "version", "status", "owner", "size" };
+        constexpr uint32 WordCount = sizeof(Words) / sizeof(Words[0]);
+
+        std::string Result;
+        Result.reserve(PayloadBlockSize + 16);
+        uint32 Seed = 0x2545F491u;
+        while (Result.size() < PayloadBlockSize)
+        {
+            // Fixed seed, every run serves the same bytes
+            Seed = Seed * 1664525u + 1013904223u;
+            Result += Words[(Seed >> 16) % WordCount];
+            Result += ((Seed >> 8) & 15) == 0 ? '\n' : ' ';
+            if (((Seed >> 4) & 7) == 0)
+            {
+                Result += std::to_string(Seed % 100000);
+                Result += ',';
+            }
+        }
+        Result.resize(PayloadBlockSize);
+        return Result;
+    }();
+    return Block;
+}
+
+void BHttpLoopbackServer::AcceptLoop()
+{
+    BHttpAllocationCounter::FIgnoreThreadScope IgnoreAllocations;
+
+    while (!bStopping)
+    {
+        // Short waits so Stop is noticed without closing the socket under accept()
+        if (httplib::detail::select_read(ListenSocket, 0, 100000) <= 0) continue;
+
+        socket_t Socket = ::accept(ListenSocket, nullptr, nullptr);
+        if (Socket == INVALID_SOCKET) continue;
+
+        int Yes = 1;
+        setsockopt(Socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<char*>(&Yes), sizeof(Yes));
+
+        std::lock_guard<std::mutex> Lock(ConnectionsMutex);
+        ReapConnections();
+
+        OpenSockets.insert(Socket);
+        Connections.push_back(std::make_unique<FConnection>());
+        FConnection* Connection = Connections.back().get();
+        Connection->Thread = std::thread([this, Socket, Connection]() { ServeConnection(Socket, Connection); });
+    }
+}
+
+void BHttpLoopbackServer::ReapConnections()
+{
+    for (auto It = Connections.begin(); It != Connections.end();)
+    {
+        if ((*It)->bDone)
+        {
+            (*It)->Thread.join();
+            It = Connections.erase(It);
+        }
+        else
+        {
+            ++It;
+        }
+    }
+}
+
+void BHttpLoopbackServer::ServeConnection(socket_t Socket, FConnection* Connection)
+{
+    BHttpAllocationCounter::FIgnoreThreadScope IgnoreAllocations;
+
+    Stats.Connections++;
+
+    if (bTls)
+    {
+        double StallSeconds = 0.0;
+        {
+            std::lock_guard<std::mutex> Lock(FaultsMutex);
+            uint64 State = Faults.Seed ^ 0x544C53ull ^ (ConnectionCount++ * 0x9E3779B97F4A7C15ull);
+            if (NextRoll(State) < Faults.TlsHandshakeStallProbability)
+            {
+                StallSeconds = Faults.TlsHandshakeStallSeconds;
+            }
+        }
+
+        // The client is left waiting after its ClientHello, before a byte of the handshake came back
+        bool bStalled = true;
+        if (StallSeconds > 0.0)
+        {
+            Stats.StalledHandshakes++;
+            bStalled = SleepUnlessStopping(StallSeconds);
+        }
+
+        SSL* Ssl = bStalled
+            ? httplib::detail::ssl_new(Socket, SslContext, SslContextMutex,
+                [](SSL* InSsl) { return SSL_accept(InSsl); },
+                [](SSL*) { return true; })
+            : nullptr;
+        if (Ssl)
+        {
+            httplib::detail::SSLSocketStream SocketStrm(Socket, Ssl, CPPHTTPLIB_KEEPALIVE_TIMEOUT_SECOND, 0, CPPHTTPLIB_WRITE_TIMEOUT_SECOND, 0);
+            FBufferedStream Strm(SocketStrm);
+            while (!bStopping && ServeRequest(Strm)) {}
+            httplib::detail::ssl_delete(SslContextMutex, Ssl, true);
+        }
+    }
+    else
+    {
+        httplib::detail::SocketStream SocketStrm(Socket, CPPHTTPLIB_KEEPALIVE_TIMEOUT_SECOND, 0, CPPHTTPLIB_WRITE_TIMEOUT_SECOND, 0);
+        FBufferedStream Strm(SocketStrm);
+        while (!bStopping && ServeRequest(Strm)) {}
+    }
+
+    {
+        std::lock_guard<std::mutex> Lock(ConnectionsMutex);
+        OpenSockets.erase(Socket);
+    }
+    httplib::detail::close_socket(Socket);
+    Connection->bDone = true;
+}
+
+bool BHttpLoopbackServer::ServeRequest(httplib::Stream& Strm)
+{
+    char LineBuffer[2048];
+    httplib::detail::stream_line_reader LineReader(Strm, LineBuffer, sizeof(LineBuffer));
+    if (!LineReader.getline() || !LineReader.end_with_crlf()) return false;
+
+    const std::string RequestLine(LineReader.ptr(), LineReader.size() - 2);
+    const size_t MethodEnd = RequestLine.find(' ');
+    const size_t TargetEnd = MethodEnd == std::string::npos ? std::string::npos : RequestLine.find(' ', MethodEnd + 1);
+    if (TargetEnd == std::string::npos) return false;
+
+    const std::string Method = RequestLine.substr(0, MethodEnd);
+    const std::string Target = RequestLine.substr(MethodEnd + 1, TargetEnd - MethodEnd - 1);
+    const std::string Path = Target.substr(0, Target.find('?'));
+    const std::string Version = RequestLine.substr(TargetEnd + 1);
+
+    httplib::Headers Headers;
+    if (!httplib::detail::read_headers(Strm, Headers)) return false;
+
+    Stats.Requests++;
+    const FFaultPlan Plan = PlanFaults(Target);
+
+    const std::string ConnectionHeader = httplib::detail::get_header_value(Headers, "Connection", 0, "");
+    const bool bClose = Version == "HTTP/1.0" || ConnectionHeader == "close" || ConnectionHeader == "Close";
+    const char* ConnectionLine = bClose ? "Connection: close\r\n" : "";
+
+    auto Delay = [this, &Plan]()
+    {
+        if (Plan.LatencySeconds <= 0.0) return true;
+
+        Stats.DelayedResponses++;
+        return SleepUnlessStopping(Plan.LatencySeconds);
+    };
+
+    if (!strcasecmp(httplib::detail::get_header_value(Headers, "Expect", 0, ""), "100-continue"))
+    {
+        const size_t ExpectParam = Target.find("expect=", Path.size());
+        const int32 RejectStatus = ExpectParam != std::string::npos ? std::atoi(Target.c_str() + ExpectParam + 7) : 0;
+        if (RejectStatus >= 200)
+        {
+            // The body is never read, so the connection can't carry another request
+            Stats.RejectedBeforeBody++;
+            const std::string Body = httplib::detail::status_message(RejectStatus);
+            std::string Response = "HTTP/1.1 " + std::to_string(RejectStatus) + " " + Body + "\r\nConnection: close\r\n";
+            Response += "Content-Length: " + std::to_string(Body.size()) + "\r\n\r\n" + Body;
+            if (Delay())
+            {
+                httplib::detail::write_data(Strm, Response.data(), Response.size());
+            }
+            return false;
+        }
+        if (ExpectParam == std::string::npos || Target.compare(ExpectParam, 13, "expect=ignore") != 0)
+        {
+            Stats.Continues++;
+            if (!httplib::detail::write_data(Strm, "HTTP/1.1 100 Continue\r\n\r\n", 25)) return false;
+        }
+    }
+
+    if (Plan.StatusCode != 0)
+    {
+        FFaultPlan BodyPlan = Plan;
+        BodyPlan.bDropMidBody = false;
+        uint64 Ignored = 0;
+        if (!ReadBody(Strm, Headers, BodyPlan, Ignored) || !Delay()) return false;
+
+        if (Plan.StatusCode == 429)
+        {
+            Stats.TooManyRequests++;
+        }
+        else
+        {
+            Stats.ServiceUnavailable++;
+        }
+
+        std::string Response = Plan.StatusCode == 429 ? "HTTP/1.1 429 Too Many Requests\r\n" : "HTTP/1.1 503 Service Unavailable\r\n";
+        Response += ConnectionLine;
+        Response += "Retry-After: " + std::to_string(Plan.RetryAfterSeconds) + "\r\nContent-Length: 0\r\n\r\n";
+        return httplib::detail::write_data(Strm, Response.data(), Response.size()) && !bClose;
+    }
+
+    if (Path.compare(0, 7, "/store/") == 0)
+    {
+        const std::string Query = Target.size() > Path.size() ? Target.substr(Path.size() + 1) : std::string();
+        std::string Status;
+        std::string ExtraHeaders;
+        std::string Body;
+        if (!ServeObjectStore(Strm, Method, httplib::detail::decode_url(Path.substr(7), false), Query, Headers, Plan, Status, ExtraHeaders, Body) || !Delay()) return false;
+
+        std::string Response = "HTTP/1.1 " + Status + "\r\n";
+        Response += ConnectionLine;
+        Response += ExtraHeaders;
+        Response += "Content-Length: " + std::to_string(Body.size()) + "\r\n\r\n" + Body;
+        return httplib::detail::write_data(Strm, Response.data(), Response.size()) && !bClose;
+    }
+
+    // "checksums" or "checksums=bad", after the path
+    const size_t ChecksumsParam = Target.find("checksums", Path.size());
+    const bool bChecksums = ChecksumsParam != std::string::npos;
+    const bool bWrongChecksums = bChecksums && Target.compare(ChecksumsParam, 13, "checksums=bad") == 0;
+
+    if (Method == "GET" && Path.compare(0, 7, "/bytes/") == 0)
+    {
+        const uint64 Size = std::strtoull(Path.c_str() + 7, nullptr, 10);
+        const bool bGzip = std::strstr(httplib::detail::get_header_value(Headers, "Accept-Encoding", 0, ""), "gzip") != nullptr;
+        const bool bChunked = bGzip || Plan.bMalformedChunk;
+
+        std::string Head = "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\n";
+        Head += ConnectionLine;
+        if (bChecksums)
+        {
+            // Of the body as served uncompressed, which is what an object store reports
+            const std::string& Block = GetPayloadBlock();
+            FBHttpChecksumHasher Checksums(EBHttpChecksum::Crc32c | EBHttpChecksum::Md5);
+            for (uint64 Offset = 0; Offset < Size; Offset += Block.size())
+            {
+                Checksums.Update(Block.data(), static_cast<int64>(FMath::Min<uint64>(Size - Offset, Block.size())));
+            }
+            Head += MakeGoogHashLine(Checksums, bWrongChecksums);
+        }
+        Head += bGzip ? "Content-Encoding: gzip\r\n" : "";
+        Head += bChunked
+            ? std::string("Transfer-Encoding: chunked\r\n\r\n")
+            : "Content-Length: " + std::to_string(Size) + "\r\n\r\n";
+        if (!Delay() || !httplib::detail::write_data(Strm, Head.data(), Head.size())) return false;
+
+        return WriteBytes(Strm, Size, bGzip, Plan) && !bClose;
+    }
+
+    if (Method == "PUT" || Method == "POST" || Method == "PATCH" || Method == "DELETE")
+    {
+        uint64 BodySize = 0;
+        std::unique_ptr<FBHttpChecksumHasher> Checksums = bChecksums ? std::make_unique<FBHttpChecksumHasher>(EBHttpChecksum::Crc32c | EBHttpChecksum::Md5) : nullptr;
+        if (!ReadBody(Strm, Headers, Plan, BodySize, nullptr, nullptr, Checksums.get()) || !Delay()) return false;
+
+        const std::string Body = std::to_string(BodySize);
+        std::string Response = "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\n";
+        Response += ConnectionLine;
+        Response += Checksums ? MakeGoogHashLine(*Checksums, bWrongChecksums) : std::string();
+        Response += "Content-Length: " + std::to_string(Body.size()) + "\r\n\r\n" + Body;
+        return httplib::detail::write_data(Strm, Response.data(), Response.size()) && !bClose;
+    }
+
+    // A body nobody asked for would be read as the next request
+    FFaultPlan BodyPlan = Plan;
+    BodyPlan.bDropMidBody = false;
+    uint64 Ignored = 0;
+    if (!ReadBody(Strm, Headers, BodyPlan, Ignored) || !Delay()) return false;
+
+    std::string Response = "HTTP/1.1 404 Not Found\r\n";
+    Response += ConnectionLine;
+    Response += "Content-Length: 0\r\n\r\n";
+    return httplib::detail::write_data(Strm, Response.data(), Response.size()) && !bClose;
+}
+
+bool BHttpLoopbackServer::WriteBytes(httplib::Stream& Strm, uint64 Size, bool bGzip, const FFaultPlan& Plan)
+{
+    const std::string& Block = GetPayloadBlock();
+
+    // Throttled transfers go out in pieces of a tenth of a second, so the rate holds within a response
+    const size_t PieceSize = Plan.BytesPerSecond > 0
+        ? static_cast<size_t>(FMath::Clamp<int64>(Plan.BytesPerSecond / 10, 1024, Block.size()))
+        : Block.size();
+    // Only what precedes a drop is sent
+    const uint64 SendSize = Plan.bDropMidBody ? Size / 2 : Size;
+    const double Start = FPlatformTime::Seconds();
+    uint64 Sent = 0;
+
+    auto WriteChunk = [this, &Strm, &Plan, &Sent, Start](const char* Data, size_t Length)
+    {
+        if (Length == 0) return true;
+
+        // The second chunk is announced with a size that is not hex, the client has to reject the response
+        if (Plan.bMalformedChunk && Sent > 0)
+        {
+            Stats.MalformedChunks++;
+            httplib::detail::write_data(Strm, "zz\r\n", 4);
+            return false;
+        }
+
+        char SizeLine[32];
+        const int SizeLineLength = snprintf(SizeLine, sizeof(SizeLine), "%zx\r\n", Length);
+        if (!httplib::detail::write_data(Strm, SizeLine, SizeLineLength)
+            || !httplib::detail::write_data(Strm, Data, Length)
+            || !httplib::detail::write_data(Strm, "\r\n", 2)) return false;
+
+        Sent += Length;
+        Pace(Start, Sent, Plan.BytesPerSecond);
+        return true;
+    };
+
+    uint64 Offset = 0;
+    if (!bGzip)
+    {
+        while (Offset < SendSize)
+        {
+            const size_t Length = static_cast<size_t>(FMath::Min<uint64>(SendSize - Offset, PieceSize));
+            if (Plan.bMalformedChunk)
+            {
+                if (!WriteChunk(Block.data(), Length)) return false;
+            }
+            else
+            {
+                if (!httplib::detail::write_data(Strm, Block.data(), Length)) return false;
+                Pace(Start, Offset + Length, Plan.BytesPerSecond);
+            }
+            Offset += Length;
+        }
+    }
+    else
+    {
+        httplib::detail::gzip_compressor Compressor;
+        do
+        {
+            const size_t Length = static_cast<size_t>(FMath::Min<uint64>(SendSize - Offset, PieceSize));
+            Offset += Length;
+            if (!Compressor.compress(Block.data(), Length, Offset == SendSize, WriteChunk)) return false;
+        } while (Offset < SendSize);
+    }
+
+    if (Plan.bDropMidBody)
+    {
+        Stats.DroppedMidBody++;
+        return false;
+    }
+
+    // A body that fit in one chunk gets the broken size line instead of the last chunk
+    if (Plan.bMalformedChunk)
+    {
+        Stats.MalformedChunks++;
+        httplib::detail::write_data(Strm, "zz\r\n", 4);
+        return false;
+    }
+
+    return !bGzip || httplib::detail::write_data(Strm, "0\r\n\r\n", 5);
+}
+
+bool BHttpLoopbackServer::ReadBody(httplib::Stream& Strm, const httplib::Headers& Headers, const FFaultPlan& Plan, uint64& OutSize, std::string* OutBody, uint64* OutHash, FBHttpChecksumHasher* Checksums)
+{
+    OutSize = 0;
+    const double Start = FPlatformTime::Seconds();
+
+    auto Consume = [OutBody, OutHash, Checksums](const char* Data, size_t Length)
+    {
+        if (OutBody) OutBody->append(Data, Length);
+        if (OutHash) *OutHash = ContentHash(Data, static_cast<int64>(Length), *OutHash);
+        if (Checksums) Checksums->Update(Data, static_cast<int64>(Length));
+    };
+
+    if (httplib::detail::is_chunked_transfer_encoding(Headers))
+    {
+        // The size is not known up front, a drop comes after the first chunk
+        const bool bRead = httplib::detail::read_content_chunked(Strm, [this, &OutSize, &Plan, Start, &Consume](const char* Data, size_t Length)
+            {
+                Consume(Data, Length);
+                OutSize += Length;
+                Pace(Start, OutSize, Plan.BytesPerSecond);
+                return !Plan.bDropMidBody;
+            });
+        if (Plan.bDropMidBody && OutSize > 0)
+        {
+            Stats.DroppedMidBody++;
+        }
+        return bRead;
+    }
+
+    const uint64 ContentLength = httplib::detail::get_header_value<uint64_t>(Headers, "Content-Length", 0, 0);
+    const uint64 ReadLength = Plan.bDropMidBody ? ContentLength / 2 : ContentLength;
+
+    // Larger reads than read_content_with_length, the server should not be what the benchmark measures
+    static thread_local char Buffer[256 * 1024];
+    const size_t PieceSize = Plan.BytesPerSecond > 0
+        ? static_cast<size_t>(FMath::Clamp<int64>(Plan.BytesPerSecond / 10, 1024, sizeof(Buffer)))
+        : sizeof(Buffer);
+    while (OutSize < ReadLength)
+    {
+        const ssize_t Read = Strm.read(Buffer, static_cast<size_t>(FMath::Min<uint64>(ReadLength - OutSize, PieceSize)));
+        if (Read <= 0) return false;
+        Consume(Buffer, static_cast<size_t>(Read));
+        OutSize += static_cast<uint64>(Read);
+        Pace(Start, OutSize, Plan.BytesPerSecond);
+    }
+
+    if (ReadLength < ContentLength)
+    {
+        Stats.DroppedMidBody++;
+        return false;
+    }
+    return true;
+}
+
+std::string BHttpLoopbackServer::MakeGoogHashLine(FBHttpChecksumHasher& Checksums, bool bWrong)
+{
+    FBHttpChecksums Digests = Checksums.Finish();
+    if (bWrong)
+    {
+        Digests.Crc32c ^= 1;
+        Digests.Md5[0] ^= 1;
+    }
+    return "x-goog-hash: crc32c=" + std::string(TCHAR_TO_UTF8(*Digests.GetCrc32cBase64())) + ",md5=" + std::string(TCHAR_TO_UTF8(*Digests.GetMd5Base64())) + "\r\n";
+}
+
+// Value of a query parameter, decoded; false if the query does not have it
+static bool GetQueryParam(const std::string& Query, const char* Name, std::string* OutValue = nullptr)
+{
+    const size_t NameLength = std::strlen(Name);
+    size_t Begin = 0;
+    while (Begin <= Query.size())
+    {
+        size_t End = Query.find('&', Begin);
+        if (End == std::string::npos) End = Query.size();
+        if (Query.compare(Begin, NameLength, Name) == 0 && (Begin + NameLength == End || Query[Begin + NameLength] == '='))
+        {
+            if (OutValue)
+            {
+                *OutValue = Begin + NameLength < End ? httplib::detail::decode_url(Query.substr(Begin + NameLength + 1, End - Begin - NameLength - 1), true) : std::string();
+            }
+            return true;
+        }
+        Begin = End + 1;
+    }
+    return false;
+}
+
+// Texts of every <Element> of Xml in order, with the entities a client escapes resolved
+static std::vector<std::string> GetXmlElements(const std::string& Xml, const std::string& Element)
+{
+    const std::string Open = "<" + Element + ">";
+    const std::string Close = "</" + Element + ">";
+    std::vector<std::string> Result;
+    for (size_t Begin = Xml.find(Open); Begin != std::string::npos; Begin = Xml.find(Open, Begin))
+    {
+        Begin += Open.size();
+        const size_t End = Xml.find(Close, Begin);
+        if (End == std::string::npos) break;
+
+        std::string Text = Xml.substr(Begin, End - Begin);
+        for (const auto& Entity : { std::make_pair("&quot;", "\""), std::make_pair("&lt;", "<"), std::make_pair("&gt;", ">"), std::make_pair("&amp;", "&") })
+        {
+            for (size_t At = Text.find(Entity.first); At != std::string::npos; At = Text.find(Entity.first, At + 1))
+            {
+                Text.replace(At, std::strlen(Entity.first), Entity.second);
+            }
+        }
+        Result.push_back(Text);
+        Begin = End + Close.size();
+    }
+    return Result;
+}
+
+static std::string ToHex(uint64 Value)
+{
+    char Text[17];
+    snprintf(Text, sizeof(Text), "%016llx", static_cast<unsigned long long>(Value));
+    return Text;
+}
+
+bool BHttpLoopbackServer::ServeObjectStore(httplib::Stream& Strm, const std::string& Method, const std::string& Key, const std::string& Query, const httplib::Headers& Headers,
+    const FFaultPlan& Plan, std::string& OutStatus, std::string& OutHeaders, std::string& OutBody)
+{
+    // S3's smallest part, the last one excepted
+    constexpr uint64 MinPartBytes = 5ull * 1024 * 1024;
+    // What a GCS resumable session commits in, only the last chunk ends elsewhere
+    constexpr uint64 SessionGranularity = 256ull * 1024;
+
+    std::string UploadId;
+    std::string PartNumber;
+    std::string SessionId;
+    std::string UploadType;
+    const bool bUpload = GetQueryParam(Query, "uploadId", &UploadId);
+    const bool bCompose = GetQueryParam(Query, "compose");
+    const bool bSession = GetQueryParam(Query, "upload_id", &SessionId);
+    // Part lists and compose requests are small and parsed, objects and parts are hashed; a session
+    // chunk is kept until it is known how much of it lines up with what the session has
+    const bool bKeepBody = Method == "POST" || bCompose || bSession;
+
+    uint64 BodySize = 0;
+    std::string Body;
+    uint64 Hash = 0;
+    const bool bRead = ReadBody(Strm, Headers, Plan, BodySize, bKeepBody ? &Body : nullptr, bKeepBody ? nullptr : &Hash);
+    // A session keeps what arrived of a dropped chunk, anything else is lost with the connection
+    if (!bRead && !bSession) return false;
+
+    auto Reply = [&OutStatus, &OutHeaders, &OutBody](const char* Status, const std::string& ExtraHeaders, const std::string& Body)
+    {
+        OutStatus = Status;
+        OutHeaders = ExtraHeaders;
+        OutBody = Body;
+        return true;
+    };
+    auto Error = [&Reply, &Key](const char* Status, const char* Code)
+    {
+        return Reply(Status, "Content-Type: application/xml\r\n", std::string("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Error><Code>") + Code + "</Code><Key>" + Key + "</Key></Error>");
+    };
+
+    std::lock_guard<std::mutex> Lock(StoreMutex);
+
+    const bool bStartSession = Method == "POST"
+        && ((GetQueryParam(Query, "uploadType", &UploadType) && UploadType == "resumable")
+            || httplib::detail::get_header_value(Headers, "x-goog-resumable", 0, "") == std::string("start"));
+    if (bStartSession)
+    {
+        const std::string Id = std::to_string(NextUploadId++);
+        FResumableSession& Session = Sessions[Id];
+        Session.Key = Key;
+        if (httplib::detail::has_header(Headers, "X-Upload-Content-Length"))
+        {
+            Session.TotalBytes = std::strtoll(httplib::detail::get_header_value(Headers, "X-Upload-Content-Length", 0, ""), nullptr, 10);
+        }
+        const std::string Location = std::string(bTls ? "https" : "http") + "://127.0.0.1:" + std::to_string(Port) + "/store/" + httplib::detail::encode_url(Key) + "?upload_id=" + Id;
+        return Reply("200 OK", "Location: " + Location + "\r\n", std::string());
+    }
+
+    if (bSession)
+    {
+        auto Found = Sessions.find(SessionId);
+        if (Found == Sessions.end() || Found->second.Key != Key) return bRead && Error("404 Not Found", "NoSuchUpload");
+
+        FResumableSession& Session = Found->second;
+        if (Method == "DELETE")
+        {
+            Sessions.erase(Found);
+            return bRead && Reply("499 Client Closed Request", std::string(), std::string());
+        }
+
+        // "bytes <first>-<last>/<total>" for a chunk, "bytes */<total>" to ask, the total may be * until the last chunk
+        const std::string Range = httplib::detail::get_header_value(Headers, "Content-Range", 0, "");
+        const size_t Slash = Range.rfind('/');
+        if (Method != "PUT" || Range.compare(0, 6, "bytes ") != 0 || Slash == std::string::npos) return bRead && Error("400 Bad Request", "InvalidArgument");
+
+        const std::string Total = Range.substr(Slash + 1);
+        if (Total != "*")
+        {
+            const int64 TotalBytes = std::strtoll(Total.c_str(), nullptr, 10);
+            if (Session.TotalBytes >= 0 && Session.TotalBytes != TotalBytes) return bRead && Error("400 Bad Request", "InvalidArgument");
+            Session.TotalBytes = TotalBytes;
+        }
+
+        if (!Session.bDone && Range.compare(6, 1, "*") != 0)
+        {
+            const uint64 First = std::strtoull(Range.c_str() + 6, nullptr, 10);
+            // Chunks overlapping what was committed are fine, gaps are not
+            if (First > Session.CommittedBytes) return bRead && Error("400 Bad Request", "InvalidRange");
+
+            uint64 End = First + Body.size();
+            if (!bRead || Session.TotalBytes < 0 || End != static_cast<uint64>(Session.TotalBytes))
+            {
+                End -= End % SessionGranularity;
+            }
+            if (End > Session.CommittedBytes)
+            {
+                Session.Hash = ContentHash(Body.data() + (Session.CommittedBytes - First), static_cast<int64>(End - Session.CommittedBytes), Session.Hash);
+                Session.CommittedBytes = End;
+            }
+            if (!bRead) return false;
+        }
+
+        if (!Session.bDone && Session.TotalBytes >= 0 && Session.CommittedBytes == static_cast<uint64>(Session.TotalBytes))
+        {
+            Objects[Key] = FStoredObject{ Session.CommittedBytes, Session.Hash };
+            Session.bDone = true;
+        }
+        if (Session.bDone)
+        {
+            return Reply("200 OK", "Content-Type: application/json\r\n",
+                "{\"name\":\"" + Key + "\",\"size\":\"" + std::to_string(Session.CommittedBytes) + "\",\"etag\":\"" + ToHex(Session.Hash) + "\"}");
+        }
+        return Reply("308 Resume Incomplete", Session.CommittedBytes > 0 ? "Range: bytes=0-" + std::to_string(Session.CommittedBytes - 1) + "\r\n" : std::string(), std::string());
+    }
+
+    if (Method == "POST" && GetQueryParam(Query, "uploads"))
+    {
+        const std::string Id = std::to_string(NextUploadId++);
+        Uploads[Id].Key = Key;
+        return Reply("200 OK", "Content-Type: application/xml\r\n",
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<InitiateMultipartUploadResult><Bucket>store</Bucket><Key>" + Key + "</Key><UploadId>" + Id + "</UploadId></InitiateMultipartUploadResult>");
+    }
+
+    if (bUpload)
+    {
+        auto Upload = Uploads.find(UploadId);
+        if (Upload == Uploads.end() || Upload->second.Key != Key) return Error("404 Not Found", "NoSuchUpload");
+
+        if (Method == "PUT" && GetQueryParam(Query, "partNumber", &PartNumber))
+        {
+            const int32 Number = std::atoi(PartNumber.c_str());
+            if (Number < 1 || Number > 10000) return Error("400 Bad Request", "InvalidArgument");
+
+            Upload->second.Parts[Number] = FStoredObject{ BodySize, Hash };
+            return Reply("200 OK", "ETag: \"" + ToHex(Hash) + "\"\r\n", std::string());
+        }
+
+        if (Method == "POST")
+        {
+            const std::vector<std::string> Numbers = GetXmlElements(Body, "PartNumber");
+            const std::vector<std::string> ETags = GetXmlElements(Body, "ETag");
+            if (Numbers.empty() || Numbers.size() != ETags.size()) return Error("400 Bad Request", "MalformedXML");
+
+            FStoredObject Object;
+            int32 Previous = 0;
+            for (size_t i = 0; i < Numbers.size(); i++)
+            {
+                const int32 Number = std::atoi(Numbers[i].c_str());
+                if (Number <= Previous) return Error("400 Bad Request", "InvalidPartOrder");
+
+                const auto Part = Upload->second.Parts.find(Number);
+                if (Part == Upload->second.Parts.end() || ETags[i] != "\"" + ToHex(Part->second.Hash) + "\"") return Error("400 Bad Request", "InvalidPart");
+                if (i + 1 < Numbers.size() && Part->second.Bytes < MinPartBytes) return Error("400 Bad Request", "EntityTooSmall");
+
+                Object.Hash = CombineContentHash(Object.Hash, Part->second.Hash, Part->second.Bytes);
+                Object.Bytes += Part->second.Bytes;
+                Previous = Number;
+            }
+            Objects[Key] = Object;
+            Uploads.erase(Upload);
+            return Reply("200 OK", "Content-Type: application/xml\r\n",
+                "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<CompleteMultipartUploadResult><Bucket>store</Bucket><Key>" + Key + "</Key><ETag>&quot;"
+                + ToHex(Object.Hash) + "-" + std::to_string(Numbers.size()) + "&quot;</ETag></CompleteMultipartUploadResult>");
+        }
+
+        if (Method == "DELETE")
+        {
+            Uploads.erase(Upload);
+            return Reply("204 No Content", std::string(), std::string());
+        }
+        return Error("400 Bad Request", "InvalidRequest");
+    }
+
+    if (Method == "PUT" && bCompose)
+    {
+        const std::vector<std::string> Names = GetXmlElements(Body, "Name");
+        if (Names.empty() || Names.size() > 32) return Error("400 Bad Request", "InvalidArgument");
+
+        FStoredObject Object;
+        for (const std::string& Name : Names)
+        {
+            const auto Source = Objects.find(Name);
+            if (Source == Objects.end()) return Error("404 Not Found", "NoSuchKey");
+
+            Object.Hash = CombineContentHash(Object.Hash, Source->second.Hash, Source->second.Bytes);
+            Object.Bytes += Source->second.Bytes;
+        }
+        Objects[Key] = Object;
+        return Reply("200 OK", "ETag: \"" + ToHex(Object.Hash) + "\"\r\n", std::string());
+    }
+
+    if (Method == "PUT")
+    {
+        Objects[Key] = FStoredObject{ BodySize, Hash };
+        return Reply("200 OK", "ETag: \"" + ToHex(Hash) + "\"\r\n", std::string());
+    }
+
+    if (Method == "DELETE")
+    {
+        return Objects.erase(Key) > 0 ? Reply("204 No Content", std::string(), std::string()) : Error("404 Not Found", "NoSuchKey");
+    }
+    return Error("405 Method Not Allowed", "MethodNotAllowed");
+}
+
+bool BHttpLoopbackServer::GetStoredObject(const FString& Key, int64& OutBytes, uint64& OutHash) const
+{
+    std::lock_guard<std::mutex> Lock(StoreMutex);
+    const auto Object = Objects.find(TCHAR_TO_UTF8(*Key));
+    if (Object == Objects.end()) return false;
+
+    OutBytes = static_cast<int64>(Object->second.Bytes);
+    OutHash = Object->second.Hash;
+    return true;
+}
+
+int32 BHttpLoopbackServer::GetPendingUploadCount() const
+{
+    std::lock_guard<std::mutex> Lock(StoreMutex);
+    return static_cast<int32>(Uploads.size());
+}
+
+void BHttpLoopbackServer::ExpireResumableSessions()
+{
+    std::lock_guard<std::mutex> Lock(StoreMutex);
+    Sessions.clear();
+}
+
+// Polynomial hash, Hash * Prime + byte for every byte, so the hash of two concatenated bodies follows from theirs
+static constexpr uint64 ContentHashPrime = 0x100000001B3ull;
+
+uint64 BHttpLoopbackServer::ContentHash(const void* Data, int64 Bytes, uint64 Hash)
+{
+    const uint8* Byte = static_cast<const uint8*>(Data);
+    for (int64 i = 0; i < Bytes; i++)
+    {
+        // +1 so leading zero bytes change it too
+        Hash = Hash * ContentHashPrime + Byte[i] + 1;
+    }
+    return Hash;
+}
+
+uint64 BHttpLoopbackServer::CombineContentHash(uint64 HashA, uint64 HashB, uint64 BytesB)
+{
+    uint64 Power = 1;
+    uint64 Base = ContentHashPrime;
+    for (uint64 Exponent = BytesB; Exponent > 0; Exponent >>= 1)
+    {
+        if (Exponent & 1) Power *= Base;
+        Base *= Base;
+    }
+    return HashA * Power + HashB;
+}
+
+void BHttpLoopbackServer::SetFaults(const FBHttpLoopbackFaults& InFaults)
+{
+    std::lock_guard<std::mutex> Lock(FaultsMutex);
+    Faults = InFaults;
+    Attempts.clear();
+    ConnectionCount = 0;
+}
+
+FBHttpLoopbackServerStats BHttpLoopbackServer::GetStats() const
+{
+    FBHttpLoopbackServerStats Result;
+    Result.Connections = Stats.Connections;
+    Result.Requests = Stats.Requests;
+    Result.DelayedResponses = Stats.DelayedResponses;
+    Result.DroppedMidBody = Stats.DroppedMidBody;
+    Result.MalformedChunks = Stats.MalformedChunks;
+    Result.TooManyRequests = Stats.TooManyRequests;
+    Result.ServiceUnavailable = Stats.ServiceUnavailable;
+    Result.StalledHandshakes = Stats.StalledHandshakes;
+    Result.Continues = Stats.Continues;
+    Result.RejectedBeforeBody = Stats.RejectedBeforeBody;
+    return Result;
+}
+
+void BHttpLoopbackServer::ResetStats()
+{
+    Stats.Connections = 0;
+    Stats.Requests = 0;
+    Stats.DelayedResponses = 0;
+    Stats.DroppedMidBody = 0;
+    Stats.MalformedChunks = 0;
+    Stats.TooManyRequests = 0;
+    Stats.ServiceUnavailable = 0;
+    Stats.StalledHandshakes = 0;
+    Stats.Continues = 0;
+    Stats.RejectedBeforeBody = 0;
+
+    std::lock_guard<std::mutex> Lock(FaultsMutex);
+    Attempts.clear();
+    ConnectionCount = 0;
+}
+
+BHttpLoopbackServer::FFaultPlan BHttpLoopbackServer::PlanFaults(const std::string& Target)
+{
+    std::lock_guard<std::mutex> Lock(FaultsMutex);
+
+    FFaultPlan Plan;
+    Plan.BytesPerSecond = Faults.BytesPerSecond;
+    Plan.RetryAfterSeconds = Faults.RetryAfterSeconds;
+
+    // FNV-1a of the target, so which request gets which fault does not depend on arrival order
+    uint64 TargetHash = 0xCBF29CE484222325ull;
+    for (const char Character : Target)
+    {
+        TargetHash = (TargetHash ^ static_cast<uint8>(Character)) * 0x100000001B3ull;
+    }
+    uint64 State = Faults.Seed ^ TargetHash ^ (Attempts[Target]++ * 0x9E3779B97F4A7C15ull);
+
+    // Always the same number of rolls in the same order, changing one probability leaves the others' dice alone
+    const double LatencyRoll = NextRoll(State);
+    const double StatusRoll = NextRoll(State);
+    const double DropRoll = NextRoll(State);
+    const double MalformedRoll = NextRoll(State);
+
+    Plan.LatencySeconds = Faults.LatencySeconds + Faults.LatencyJitterSeconds * LatencyRoll;
+    if (StatusRoll < Faults.TooManyRequestsProbability)
+    {
+        Plan.StatusCode = 429;
+    }
+    else if (StatusRoll < Faults.TooManyRequestsProbability + Faults.ServiceUnavailableProbability)
+    {
+        Plan.StatusCode = 503;
+    }
+    Plan.bDropMidBody = DropRoll < Faults.DropMidBodyProbability;
+    // A broken chunk and a drop both end the body, the drop wins
+    Plan.bMalformedChunk = !Plan.bDropMidBody && MalformedRoll < Faults.MalformedChunkProbability;
+    return Plan;
+}
+
+double BHttpLoopbackServer::NextRoll(uint64& State)
+{
+    // splitmix64
+    State += 0x9E3779B97F4A7C15ull;
+    uint64 Value = State;
+    Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+    Value ^= Value >> 31;
+    return static_cast<double>(Value >> 11) / 9007199254740992.0;
+}
+
+void BHttpLoopbackServer::Pace(double Start, uint64 Bytes, int64 BytesPerSecond)
+{
+    if (BytesPerSecond <= 0) return;
+
+    const double Ahead = Start + static_cast<double>(Bytes) / static_cast<double>(BytesPerSecond) - FPlatformTime::Seconds();
+    if (Ahead > 0.0)
+    {
+        SleepUnlessStopping(Ahead);
+    }
+}
+
+bool BHttpLoopbackServer::SleepUnlessStopping(double Seconds)
+{
+    const double End = FPlatformTime::Seconds() + Seconds;
+    for (double Remaining = Seconds; Remaining > 0.0; Remaining = End - FPlatformTime::Seconds())
+    {
+        if (bStopping) return false;
+        std::this_thread::sleep_for(std::chrono::duration<double>(FMath::Min(Remaining, 0.05)));
+    }
+    return !bStopping;
+}
+
+bool BHttpLoopbackServer::CreateTlsContext()
+{
+    SslContext = SSL_CTX_new(SSLv23_server_method());
+    if (!SslContext) return false;
+
+    SSL_CTX_set_options(SslContext, SSL_OP_ALL | SSL_OP_NO_SSLv2 | SSL_OP_NO_SSLv3 | SSL_OP_NO_COMPRESSION);
+
+    // P-256 keeps the handshake cost close to what real servers present
+    EVP_PKEY* Key = nullptr;
+    EVP_PKEY_CTX* KeyContext = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+    const bool bKeyCreated = KeyContext
+        && EVP_PKEY_keygen_init(KeyContext) == 1
+        && EVP_PKEY_CTX_set_ec_paramgen_curve_nid(KeyContext, NID_X9_62_prime256v1) == 1
+        && EVP_PKEY_keygen(KeyContext, &Key) == 1;
+    EVP_PKEY_CTX_free(KeyContext);
+
+    X509* Certificate = bKeyCreated ? X509_new() : nullptr;
+    bool bSucceed = false;
+    if (Certificate)
+    {
+        X509_set_version(Certificate, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(Certificate), 1);
+        X509_gmtime_adj(X509_getm_notBefore(Certificate), 0);
+        X509_gmtime_adj(X509_getm_notAfter(Certificate), 24 * 60 * 60);
+        X509_set_pubkey(Certificate, Key);
+
+        X509_NAME* Name = X509_get_subject_name(Certificate);
+        X509_NAME_add_entry_by_txt(Name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+        X509_set_issuer_name(Certificate, Name);
+
+        bSucceed = X509_sign(Certificate, Key, EVP_sha256()) > 0
+            && SSL_CTX_use_certificate(SslContext, Certificate) == 1
+            && SSL_CTX_use_PrivateKey(SslContext, Key) == 1;
+    }
+
+    X509_free(Certificate);
+    EVP_PKEY_free(Key);
+
+    if (!bSucceed)
+    {
+        SSL_CTX_free(SslContext);
+        SslContext = nullptr;
+    }
+    return bSucceed;
+}
@@ -0,0 +1,319 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#include "BHttpScenarioRunner.h"
+#include "BHttpBenchmarkStats.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Response bodies are not what a scenario looks at
+class FScenarioNullBuffer : public std::streambuf
+{
+protected:
+    int overflow(int Character) override { return Character; }
+    std::streamsize xsputn(const char*, std::streamsize Count) override { return Count; }
+};
+
+// Mix entry of request Index, the same for a seed whatever the concurrency
+static int32 PickMixEntry(const FBHttpScenario& Scenario, int32 TotalWeight, int32 Index)
+{
+    // splitmix64 of the seed and the index
+    uint64 Value = (static_cast<uint64>(Scenario.Seed) << 32 | static_cast<uint32>(Index)) + 0x9E3779B97F4A7C15ull;
+    Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+    Value ^= Value >> 31;
+
+    int32 Remaining = static_cast<int32>(Value % static_cast<uint64>(TotalWeight));
+    for (int32 i = 0; i < Scenario.Mix.Num(); i++)
+    {
+        Remaining -= FMath::Max(Scenario.Mix[i].Weight, 0);
+        if (Remaining < 0) return i;
+    }
+    return Scenario.Mix.Num() - 1;
+}
+
+TArray<FBHttpScenario> BHttpScenarioRunner::GetDefaultScenarios()
+{
+    FBHttpScenario Baseline;
+    Baseline.Name = TEXT("baseline");
+    Baseline.Mix = {
+        { EBHttpBatchVerb::Get, 16 * 1024, 7 },
+        { EBHttpBatchVerb::Put, 64 * 1024, 2 },
+        { EBHttpBatchVerb::Delete, 0, 1 } };
+
+    TArray<FBHttpScenario> Scenarios;
+    Scenarios.Add(Baseline);
+
+    FBHttpScenario Latency = Baseline;
+    Latency.Name = TEXT("latency_20ms_jitter_30ms");
+    Latency.Faults.LatencySeconds = 0.02;
+    Latency.Faults.LatencyJitterSeconds = 0.03;
+    Scenarios.Add(Latency);
+
+    FBHttpScenario Throttled = Baseline;
+    Throttled.Name = TEXT("throttled_1MBps");
+    Throttled.Faults.BytesPerSecond = 1000 * 1000;
+    Scenarios.Add(Throttled);
+
+    FBHttpScenario Drops = Baseline;
+    Drops.Name = TEXT("drop_mid_body_10pct");
+    Drops.Faults.DropMidBodyProbability = 0.1;
+    Scenarios.Add(Drops);
+
+    FBHttpScenario SingleCallDrops = Drops;
+    SingleCallDrops.Name = TEXT("drop_mid_body_10pct_single_calls");
+    SingleCallDrops.Api = EBHttpScenarioApi::SingleCalls;
+    Scenarios.Add(SingleCallDrops);
+
+    FBHttpScenario Malformed = Baseline;
+    Malformed.Name = TEXT("malformed_chunk_10pct");
+    Malformed.Faults.MalformedChunkProbability = 0.1;
+    Scenarios.Add(Malformed);
+
+    FBHttpScenario TooManyRequests = Baseline;
+    TooManyRequests.Name = TEXT("too_many_requests_20pct");
+    TooManyRequests.Faults.TooManyRequestsProbability = 0.2;
+    Scenarios.Add(TooManyRequests);
+
+    FBHttpScenario ServiceUnavailable = Baseline;
+    ServiceUnavailable.Name = TEXT("service_unavailable_20pct");
+    ServiceUnavailable.Faults.ServiceUnavailableProbability = 0.2;
+    Scenarios.Add(ServiceUnavailable);
+
+    FBHttpScenario TlsBaseline = Baseline;
+    TlsBaseline.Name = TEXT("tls_baseline");
+    TlsBaseline.bTls = true;
+    Scenarios.Add(TlsBaseline);
+
+    FBHttpScenario TlsStall = TlsBaseline;
+    TlsStall.Name = TEXT("tls_handshake_stall_2s_25pct");
+    TlsStall.Faults.TlsHandshakeStallProbability = 0.25;
+    TlsStall.Faults.TlsHandshakeStallSeconds = 2.0;
+    Scenarios.Add(TlsStall);
+
+    return Scenarios;
+}
+
+bool BHttpScenarioRunner::Run(const FBHttpScenario& Scenario, FBHttpScenarioResult& OutResult)
+{
+    OutResult = FBHttpScenarioResult();
+    OutResult.Name = Scenario.Name;
+    OutResult.Api = Scenario.Api == EBHttpScenarioApi::Batch ? TEXT("batch") : TEXT("single_calls");
+
+    int32 TotalWeight = 0;
+    for (const FBHttpTrafficMixEntry& Entry : Scenario.Mix)
+    {
+        TotalWeight += FMath::Max(Entry.Weight, 0);
+    }
+    if (TotalWeight <= 0 || Scenario.Requests <= 0)
+    {
+        UE_LOG(LogBHttpClientLib, Error, TEXT("BHttpScenarioRunner: %s has no requests to send"), *Scenario.Name);
+        return false;
+    }
+
+    BHttpLoopbackServer Server;
+    if (!Server.Start(Scenario.bTls))
+    {
+        UE_LOG(LogBHttpClientLib, Error, TEXT("BHttpScenarioRunner: Loopback server could not be started for %s"), *Scenario.Name);
+        return false;
+    }
+    Server.SetFaults(Scenario.Faults);
+    const FString BaseUrl = Server.GetBaseUrl();
+
+    // Upload bodies per mix entry, each request reads its own copy so retries can rewind it
+    std::vector<std::string> Payloads;
+    for (const FBHttpTrafficMixEntry& Entry : Scenario.Mix)
+    {
+        const bool bUpload = Entry.Verb == EBHttpBatchVerb::Post || Entry.Verb == EBHttpBatchVerb::Put || Entry.Verb == EBHttpBatchVerb::Patch;
+        Payloads.emplace_back(bUpload ? static_cast<size_t>(FMath::Max<int64>(Entry.PayloadBytes, 0)) : 0, 'x');
+    }
+
+    TArray<FString> Urls;
+    TArray<int32> EntryIndices;
+    for (int32 i = 0; i < Scenario.Requests; i++)
+    {
+        const int32 EntryIndex = PickMixEntry(Scenario, TotalWeight, i);
+        const FBHttpTrafficMixEntry& Entry = Scenario.Mix[EntryIndex];
+        EntryIndices.Add(EntryIndex);
+        Urls.Add(Entry.Verb == EBHttpBatchVerb::Get
+            ? BaseUrl + FString::Printf(TEXT("/bytes/%lld?id=%d"), Entry.PayloadBytes, i)
+            : BaseUrl + FString::Printf(TEXT("/sink?id=%d"), i));
+    }
+
+    FScenarioNullBuffer NullBuffer;
+    std::ostream Output(&NullBuffer);
+    const FString ContentType = TEXT("application/octet-stream");
+    TArray<int32> StatusCodes;
+    StatusCodes.Init(-1, Scenario.Requests);
+    std::vector<double> Latencies(Scenario.Requests, 0.0);
+
+    const int64 RetriesBefore = BHttpClient::GetMetricsSnapshot().Retries;
+    const double Start = FPlatformTime::Seconds();
+
+    if (Scenario.Api == EBHttpScenarioApi::Batch)
+    {
+        std::vector<std::unique_ptr<std::istringstream>> Inputs;
+        TArray<FBHttpBatchRequest> Requests;
+        for (int32 i = 0; i < Scenario.Requests; i++)
+        {
+            FBHttpBatchRequest Request;
+            Request.Verb = Scenario.Mix[EntryIndices[i]].Verb;
+            Request.FullPath = Urls[i];
+            Request.OutputStream = &Output;
+            if (!Payloads[EntryIndices[i]].empty())
+            {
+                Inputs.push_back(std::make_unique<std::istringstream>(Payloads[EntryIndices[i]]));
+                Request.InputStream = Inputs.back().get();
+                Request.ContentType = ContentType;
+            }
+            Requests.Add(Request);
+        }
+
+        FBHttpBatchOptions Options;
+        Options.MaxConcurrency = FMath::Max(Scenario.Concurrency, 1);
+        Options.MaxConcurrencyPerHost = Options.MaxConcurrency;
+        Options.MaxRetriesPerRequest = Scenario.MaxRetriesPerRequest;
+
+        const FBHttpBatchResult BatchResult = BHttpClient::ExecuteBatch(Requests, Options);
+        for (int32 i = 0; i < BatchResult.Items.Num() && i < Scenario.Requests; i++)
+        {
+            StatusCodes[i] = BatchResult.Items[i].StatusCode;
+            Latencies[i] = BatchResult.Items[i].DurationSeconds;
+        }
+    }
+    else
+    {
+        std::atomic<int32> NextIndex{ 0 };
+        auto Worker = [&]()
+        {
+            for (int32 i = NextIndex++; i < Scenario.Requests; i = NextIndex++)
+            {
+                const FBHttpTrafficMixEntry& Entry = Scenario.Mix[EntryIndices[i]];
+                std::istringstream Input(Payloads[EntryIndices[i]]);
+
+                const double RequestStart = FPlatformTime::Seconds();
+                switch (Entry.Verb)
+                {
+                case EBHttpBatchVerb::Get:
+                    StatusCodes[i] = BHttpClient::Get(&Output, Urls[i]);
+                    break;
+                case EBHttpBatchVerb::Delete:
+                    StatusCodes[i] = BHttpClient::Delete(&Output, Urls[i]);
+                    break;
+                case EBHttpBatchVerb::Post:
+                    StatusCodes[i] = BHttpClient::Post(&Input, &Output, Urls[i], ContentType);
+                    break;
+                case EBHttpBatchVerb::Put:
+                    StatusCodes[i] = BHttpClient::Put(&Input, &Output, Urls[i], ContentType);
+                    break;
+                case EBHttpBatchVerb::Patch:
+                    StatusCodes[i] = BHttpClient::Patch(&Input, &Output, Urls[i], ContentType);
+                    break;
+                }
+                Latencies[i] = FPlatformTime::Seconds() - RequestStart;
+            }
+        };
+
+        std::vector<std::thread> Threads;
+        for (int32 i = 1; i < FMath::Max(Scenario.Concurrency, 1); i++)
+        {
+            Threads.emplace_back(Worker);
+        }
+        Worker();
+        for (std::thread& Thread : Threads)
+        {
+            Thread.join();
+        }
+    }
+
+    OutResult.Seconds = FPlatformTime::Seconds() - Start;
+    OutResult.Retries = BHttpClient::GetMetricsSnapshot().Retries - RetriesBefore;
+    OutResult.Server = Server.GetStats();
+    Server.Stop();
+
+    std::vector<double> SucceededLatencies;
+    for (int32 i = 0; i < Scenario.Requests; i++)
+    {
+        const int32 StatusCode = StatusCodes[i];
+        OutResult.StatusCounts.FindOrAdd(StatusCode)++;
+        if (StatusCode >= 200 && StatusCode < 300)
+        {
+            OutResult.Succeeded++;
+            SucceededLatencies.push_back(Latencies[i]);
+        }
+        else if (StatusCode == -1)
+        {
+            OutResult.Failed++;
+        }
+        else
+        {
+            OutResult.Rejected++;
+        }
+    }
+
+    std::sort(Latencies.begin(), Latencies.end());
+    std::sort(SucceededLatencies.begin(), SucceededLatencies.end());
+
+    OutResult.Requests = Scenario.Requests;
+    OutResult.SuccessRate = static_cast<double>(OutResult.Succeeded) / Scenario.Requests;
+    OutResult.RequestsPerSecond = OutResult.Seconds > 0.0 ? Scenario.Requests / OutResult.Seconds : 0.0;
+    OutResult.P50Seconds = GetPercentile(Latencies, 0.5);
+    OutResult.P90Seconds = GetPercentile(Latencies, 0.9);
+    OutResult.P99Seconds = GetPercentile(Latencies, 0.99);
+    OutResult.P999Seconds = GetPercentile(Latencies, 0.999);
+    OutResult.MaxSeconds = Latencies.back();
+    OutResult.SucceededP50Seconds = GetPercentile(SucceededLatencies, 0.5);
+    OutResult.SucceededP99Seconds = GetPercentile(SucceededLatencies, 0.99);
+
+    UE_LOG(LogBHttpClientLib, Display, TEXT("BHttpScenarioRunner: %s (%s) - %.1f%% succeeded, %d failed, %d rejected, %lld retries, p50 %.1f ms, p99 %.1f ms"),
+        *OutResult.Name, *OutResult.Api, OutResult.SuccessRate * 100.0, OutResult.Failed, OutResult.Rejected, OutResult.Retries,
+        OutResult.P50Seconds * 1000.0, OutResult.P99Seconds * 1000.0);
+    return true;
+}
+
+FString BHttpScenarioRunner::ToJson(const TArray<FBHttpScenarioResult>& Results)
+{
+    std::string Json = "{\"benchmark\":\"BHttpClientLib.Scenarios\",\"version\":1,\"results\":[";
+
+    char Line[1024];
+    for (int32 i = 0; i < Results.Num(); i++)
+    {
+        const FBHttpScenarioResult& Result = Results[i];
+        snprintf(Line, sizeof(Line),
+            "%s\n{\"name\":\"%s\",\"api\":\"%s\",\"requests\":%d,\"succeeded\":%d,\"failed\":%d,\"rejected\":%d,\"success_rate\":%.4f,\"retries\":%lld,"
+            "\"seconds\":%.3f,\"requests_per_second\":%.1f,\"p50_ms\":%.3f,\"p90_ms\":%.3f,\"p99_ms\":%.3f,\"p999_ms\":%.3f,\"max_ms\":%.3f,"
+            "\"succeeded_p50_ms\":%.3f,\"succeeded_p99_ms\":%.3f",
+            i == 0 ? "" : ",", TCHAR_TO_UTF8(*Result.Name), TCHAR_TO_UTF8(*Result.Api), Result.Requests, Result.Succeeded, Result.Failed,
+            Result.Rejected, Result.SuccessRate, static_cast<long long>(Result.Retries), Result.Seconds, Result.RequestsPerSecond,
+            Result.P50Seconds * 1000.0, Result.P90Seconds * 1000.0, Result.P99Seconds * 1000.0, Result.P999Seconds * 1000.0,
+            Result.MaxSeconds * 1000.0, Result.SucceededP50Seconds * 1000.0, Result.SucceededP99Seconds * 1000.0);
+        Json += Line;
+
+        Json += ",\"status_counts\":{";
+        bool bFirst = true;
+        for (const TPair<int32, int32>& Status : Result.StatusCounts)
+        {
+            snprintf(Line, sizeof(Line), "%s\"%d\":%d", bFirst ? "" : ",", Status.Key, Status.Value);
+            Json += Line;
+            bFirst = false;
+        }
+
+        const FBHttpLoopbackServerStats& Server = Result.Server;
+        snprintf(Line, sizeof(Line),
+            "},\"server\":{\"connections\":%lld,\"requests\":%lld,\"delayed\":%lld,\"dropped_mid_body\":%lld,\"malformed_chunks\":%lld,"
+            "\"too_many_requests\":%lld,\"service_unavailable\":%lld,\"stalled_handshakes\":%lld}}",
+            static_cast<long long>(Server.Connections), static_cast<long long>(Server.Requests), static_cast<long long>(Server.DelayedResponses),
+            static_cast<long long>(Server.DroppedMidBody), static_cast<long long>(Server.MalformedChunks), static_cast<long long>(Server.TooManyRequests),
+            static_cast<long long>(Server.ServiceUnavailable), static_cast<long long>(Server.StalledHandshakes));
+        Json += Line;
+    }
+    Json += "\n]}\n";
+
+    return FString(UTF8_TO_TCHAR(Json.c_str()));
+}
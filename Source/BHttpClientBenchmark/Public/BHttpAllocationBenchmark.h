@@ -0,0 +1,97 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Allocations of one BHttpClient entry point, per request it sends
+struct BHTTPCLIENTBENCHMARK_API FBHttpAllocationResult
+{
+    // SplitPath, Get, GetInto, GetToFile, Delete, Post, PostFile, PostMultipart, Put, Patch, GetPipelined or ExecuteBatch
+    FString Name;
+
+    // Calls measured in the best round, and requests each call sends (GetPipelined and ExecuteBatch send several)
+    int32 Calls = 0;
+    int32 RequestsPerCall = 1;
+
+    double AllocationsPerRequest = 0.0;
+    double BytesPerRequest = 0.0;
+    double NanosecondsPerRequest = 0.0;
+
+    // Filled by CompareToBaseline
+    bool bHasBaseline = false;
+    double BaselineAllocationsPerRequest = 0.0;
+    double BaselineBytesPerRequest = 0.0;
+    bool bRegressed = false;
+};
+
+struct BHTTPCLIENTBENCHMARK_API FBHttpAllocationBenchmarkOptions
+{
+    int32 Calls = 200;
+    // Uncounted calls first, so one-time setup (singletons, thread-local shards, OpenSSL init) stays out
+    int32 WarmupCalls = 20;
+    // Each entry point is measured this many times and the round with the fewest allocations is kept,
+    // so allocations of unrelated engine threads during a round don't show up as regressions
+    int32 Rounds = 3;
+
+    // Response size of the GETs and body size of the uploads
+    int32 PayloadBytes = 1024;
+
+    // Relative increase over the baseline that still passes, one allocation per request is always allowed on top
+    double AllocationTolerance = 0.02;
+    double ByteTolerance = 0.05;
+};
+
+/*
+ * Counts the allocations every public request entry point of BHttpClient makes against a loopback
+ * server, with BHttpAllocationCounter in front of GMalloc. A baseline JSON checked in next to this
+ * module is what later runs compare against, more allocations or bytes per request than it allows
+ * fail the run.
+ *
+ * Allocation counts depend on the build: FString, TArray and logging allocate differently per engine
+ * version, platform and configuration. The baseline keeps the counts of every build that recorded
+ * them, a run only compares against those of its own build and fails if there are none.
+ *
+ * Allocations are counted on every thread but the loopback server's, batch workers included. Run it
+ * in an otherwise idle process (-nullrhi) so engine threads don't add to the counts.
+ *
+ * */
+class BHTTPCLIENTBENCHMARK_API BHttpAllocationBenchmark
+{
+public:
+    //************************************
+    // Method:    Run measures every entry point, installing the allocation counter on first use
+    // FullName:  BHttpAllocationBenchmark::Run
+    // Access:    public static
+    // Returns:   bool false if the loopback server could not be started
+    // Qualifier:
+    // Parameter: const FBHttpAllocationBenchmarkOptions & Options
+    // Parameter: TArray<FBHttpAllocationResult> & OutResults
+    //************************************
+    static bool Run(const FBHttpAllocationBenchmarkOptions& Options, TArray<FBHttpAllocationResult>& OutResults);
+
+    //************************************
+    // Method:    CompareToBaseline fills the baseline fields of the results and flags the ones above it
+    // FullName:  BHttpAllocationBenchmark::CompareToBaseline
+    // Access:    public static
+    // Returns:   bool false if a result regressed, the baseline could not be parsed or has no counts of this build, or an entry point is missing from them
+    // Qualifier:
+    // Parameter: const FString & BaselineJson (UpdateBaseline output of an earlier run)
+    // Parameter: const FBHttpAllocationBenchmarkOptions & Options
+    // Parameter: TArray<FBHttpAllocationResult> & InOutResults
+    //************************************
+    static bool CompareToBaseline(const FString& BaselineJson, const FBHttpAllocationBenchmarkOptions& Options, TArray<FBHttpAllocationResult>& InOutResults);
+
+    // {"benchmark":"BHttpClientLib.Allocations","version":2,"build":"...","passed":true,"results":[...]}
+    static FString ToJson(const TArray<FBHttpAllocationResult>& Results);
+
+    // {"benchmark":"BHttpClientLib.Allocations","version":3,"builds":[{"build":"...","results":[...]}]}, the baseline
+    // with the counts of this build replaced by Results and those of other builds kept
+    static FString UpdateBaseline(const FString& BaselineJson, const TArray<FBHttpAllocationResult>& Results);
+
+    // Platform, configuration and engine version, e.g. "Win64 Development 5.4"
+    static FString GetBuildName();
+
+    // AllocationBaseline.json in this module's source directory
+    static FString GetDefaultBaselinePath();
+};
@@ -0,0 +1,139 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <vector>
+
+// One measured series: a test in one mode and, for throughput tests, one payload size
+struct BHTTPCLIENTBENCHMARK_API FBHttpBenchmarkResult
+{
+    // get_throughput, put_throughput, put_file, put_istream, tiny_get, cold_start or warm_start
+    FString Test;
+
+    bool bKeepAlive = false;
+    bool bTls = false;
+    bool bCompression = false;
+    // Asked for kernel TLS, and whether the kernel took the send and the receive side of the connection
+    bool bKernelTls = false;
+    bool bKernelTlsSend = false;
+    bool bKernelTlsReceive = false;
+    // Sockets read and written through the thread's io_uring instead of poll() + recv()/send()
+    bool bIoUring = false;
+
+    // Uncompressed size of each response (GET) or request body (PUT)
+    int64 PayloadBytes = 0;
+
+    int32 Requests = 0;
+    int32 Failures = 0;
+
+    // Wall time of the series, warm-up excluded
+    double Seconds = 0.0;
+    // Uncompressed payload of the successful requests, 10^6 bytes per second
+    double MegabytesPerSecond = 0.0;
+    double RequestsPerSecond = 0.0;
+
+    // User and system time of the requesting thread, kernel TLS crypto included; the loopback server runs on its own threads
+    double CpuSeconds = 0.0;
+    // Per 10^9 bytes of uncompressed payload of the successful requests
+    double CpuSecondsPerGigabyte = 0.0;
+
+    // Of the successful requests
+    double P50Seconds = 0.0;
+    double P99Seconds = 0.0;
+    double P999Seconds = 0.0;
+    double MaxSeconds = 0.0;
+};
+
+struct BHTTPCLIENTBENCHMARK_API FBHttpBenchmarkOptions
+{
+    // Payload sizes of the GET and PUT throughput tests
+    TArray<int64> PayloadSizes = { 1024ll, 16ll * 1024, 256ll * 1024, 4ll * 1024 * 1024, 64ll * 1024 * 1024, 1024ll * 1024 * 1024, 4096ll * 1024 * 1024 };
+    // Sizes above this are skipped, lower it for quick runs
+    int64 MaxPayloadBytes = 4096ll * 1024 * 1024;
+    // Compressed runs above this are skipped: gzip is far slower than loopback and compressed uploads are built in memory
+    int64 MaxCompressedPayloadBytes = 64ll * 1024 * 1024;
+
+    // A throughput series repeats its request until this many payload bytes moved, within the iteration bounds
+    int64 TargetBytesPerSeries = 256ll * 1024 * 1024;
+    int32 MinIterations = 3;
+    int32 MaxIterations = 500;
+
+    // Sizes of the put_file (FileContent, sendfile on plain HTTP and kernel TLS) and put_istream (std::ifstream through a content provider)
+    // uploads, from one temporary file of the largest size; MaxPayloadBytes applies, compressed modes skip them
+    TArray<int64> FileUploadSizes = { 64ll * 1024 * 1024, 1024ll * 1024 * 1024, 4096ll * 1024 * 1024 };
+    // Where the temporary file goes, the project's Saved directory if empty
+    FString FileUploadDirectory;
+
+    // Small GETs for requests per second and latency percentiles, per mode
+    int32 TinyRequests = 2000;
+    int32 TinyPayloadBytes = 64;
+
+    // Requests of each series that are sent but not measured
+    int32 WarmupRequests = 5;
+
+    // First tiny GETs to the server through BHttpClient, per TLS mode: cold_start with the connection pool
+    // emptied before each, warm_start after BHttpClient::WarmUpConnections opened one; 0 skips both
+    int32 StartupRequests = 50;
+
+    // TLS modes need the loopback server to create a certificate, skip them where that is unwanted
+    bool bIncludeTls = true;
+    // TLS modes without gzip run a second time with kernel TLS, where it is unavailable they report it as not taken
+    bool bIncludeKernelTls = true;
+    // Plain HTTP modes without gzip run a second time on io_uring, skipped where the kernel has none
+    bool bIncludeIoUring = true;
+};
+
+/*
+ * Loopback benchmark of the HTTP client this plugin ships. A BHttpLoopbackServer on 127.0.0.1 stands
+ * in for the remote end, so the numbers follow client changes rather than the network.
+ *
+ * Every test runs in each combination of keep-alive, TLS and gzip, TLS without gzip also with kernel
+ * TLS, plain HTTP without gzip also on io_uring. Without keep-alive each request opens its own connection, so connect and handshake are in its latency. Requests go through
+ * httplib::Client directly, the layer BHttpClient wraps, so the modes can be chosen per series.
+ *
+ * cold_start and warm_start go through BHttpClient instead, they measure what pre-warmed pool
+ * connections save a first request: the connect and, with TLS, the handshake.
+ *
+ * */
+class BHTTPCLIENTBENCHMARK_API BHttpBenchmark
+{
+public:
+    //************************************
+    // Method:    Run blocks until every series finished, minutes with the default sizes
+    // FullName:  BHttpBenchmark::Run
+    // Access:    public static 
+    // Returns:   bool false if a loopback server could not be started
+    // Qualifier:
+    // Parameter: const FBHttpBenchmarkOptions & Options
+    // Parameter: TArray<FBHttpBenchmarkResult> & OutResults
+    //************************************
+    static bool Run(const FBHttpBenchmarkOptions& Options, TArray<FBHttpBenchmarkResult>& OutResults);
+
+    // {"benchmark":"BHttpClientLib","version":1,"options":{...},"results":[...]}, one object per result
+    static FString ToJson(const FBHttpBenchmarkOptions& Options, const TArray<FBHttpBenchmarkResult>& Results);
+
+    //************************************
+    // Method:    RunToFile runs the benchmark and writes ToJson to a file
+    // FullName:  BHttpBenchmark::RunToFile
+    // Access:    public static 
+    // Returns:   bool false if the benchmark could not run or the file could not be written
+    // Qualifier:
+    // Parameter: const FBHttpBenchmarkOptions & Options
+    // Parameter: const FString & FilePath
+    //************************************
+    static bool RunToFile(const FBHttpBenchmarkOptions& Options, const FString& FilePath);
+
+private:
+    // Measures one series, InOutResult comes with its test, mode and payload size filled in; UploadFilePath is for the file tests
+    static void RunSeries(const FString& BaseUrl, int32 Iterations, int32 WarmupRequests, FBHttpBenchmarkResult& InOutResult, const FString& UploadFilePath = FString());
+
+    // cold_start or warm_start, as InOutResult.Test says
+    static void RunStartupSeries(const FString& BaseUrl, int32 Iterations, FBHttpBenchmarkResult& InOutResult);
+
+    // Rates and percentiles of InOutResult from the latencies of its successful requests, Seconds and CpuSeconds set
+    static void SetLatencyStats(std::vector<double>& Latencies, FBHttpBenchmarkResult& InOutResult);
+
+    // Fills a file with Bytes of the loopback payload
+    static bool WriteUploadFile(const FString& FilePath, int64 Bytes);
+};
@@ -0,0 +1,255 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BHttpChecksum.h"
+#include "BHttpClientUtils.h"
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+// Misbehaviour of BHttpLoopbackServer, everything off by default. Probabilities are 0-1 and rolled per request
+struct BHTTPCLIENTBENCHMARK_API FBHttpLoopbackFaults
+{
+    // Wait before every response head, plus up to LatencyJitterSeconds more
+    double LatencySeconds = 0.0;
+    double LatencyJitterSeconds = 0.0;
+
+    // Response and request bodies of one connection, 0 for no limit
+    int64 BytesPerSecond = 0;
+
+    // Closes the connection halfway through the response body, or halfway through reading the request body
+    double DropMidBodyProbability = 0.0;
+
+    // Sends the response chunked and breaks the second chunk size line
+    double MalformedChunkProbability = 0.0;
+
+    // Answers 429 or 503 with Retry-After instead of the response
+    double TooManyRequestsProbability = 0.0;
+    double ServiceUnavailableProbability = 0.0;
+    int32 RetryAfterSeconds = 1;
+
+    // Waits this long before accepting the TLS handshake of a new connection
+    double TlsHandshakeStallProbability = 0.0;
+    double TlsHandshakeStallSeconds = 0.0;
+
+    // The dice of a request depend only on Seed, its request target and how often that target was
+    // requested before, so a replay gets the same faults in any interleaving
+    uint32 Seed = 1;
+};
+
+// What the server did since Start or the last ResetStats
+struct BHTTPCLIENTBENCHMARK_API FBHttpLoopbackServerStats
+{
+    int64 Connections = 0;
+    int64 Requests = 0;
+    int64 DelayedResponses = 0;
+    int64 DroppedMidBody = 0;
+    int64 MalformedChunks = 0;
+    int64 TooManyRequests = 0;
+    int64 ServiceUnavailable = 0;
+    int64 StalledHandshakes = 0;
+    // Answers to "Expect: 100-continue": 100 Continue, or a final status instead of reading the body
+    int64 Continues = 0;
+    int64 RejectedBeforeBody = 0;
+};
+
+/*
+ * Minimal HTTP/1.1 server on 127.0.0.1 for benchmarks and tests, one thread per connection.
+ *
+ * GET /bytes/N                answers N bytes of GetPayloadBlock() repeated, gzip'ed and chunked if the request accepts gzip
+ * PUT, POST, PATCH, DELETE    reads and drops the body, Content-Length or chunked, and answers its size in bytes
+ *
+ * Under /store/<key> it stands in for an object store, enough of S3 (MinIO) and GCS for part uploads:
+ * PUT stores an object, PUT ?compose composes one from up to 32 others, DELETE removes one, and the
+ * S3 multipart upload requests (POST ?uploads, PUT ?partNumber&uploadId, POST ?uploadId, DELETE
+ * ?uploadId) work as S3 documents them, 5 MB minimum part size included. So does a GCS resumable
+ * session: POST ?uploadType=resumable or with x-goog-resumable: start answers its Location, PUT
+ * ?upload_id with Content-Range sends chunks or asks for the committed offset, with 308 and Range
+ * until the last chunk. A session commits in 256 KB steps and keeps what arrived of a dropped chunk.
+ * Bodies are not kept, only their size and ContentHash, which composes, so a test compares the hash
+ * of its file with the object's.
+ *
+ * With ?checksums, GET /bytes/N and the uploads outside /store/ answer x-goog-hash with the CRC32C
+ * and MD5 of the body, as GCS does; ?checksums=bad sends wrong ones, to test verification.
+ *
+ * A request with Expect: 100-continue gets 100 Continue before its body is read. ?expect=<status>
+ * answers that status instead and closes without reading the body, ?expect=ignore answers nothing,
+ * as servers that don't know Expect.
+ *
+ * The query string is ignored for routing otherwise. Keep-alive unless the request asks for Connection: close.
+ * With TLS it serves a self-signed certificate made at Start, the client must not verify it. Its
+ * threads are not counted by the allocation benchmark.
+ *
+ * SetFaults makes it a misbehaving peer for resilience tests: slow, throttled, cutting bodies off,
+ * sending broken chunks, rate limiting or stalling handshakes.
+ *
+ * */
+class BHTTPCLIENTBENCHMARK_API BHttpLoopbackServer
+{
+public:
+    BHttpLoopbackServer() = default;
+    ~BHttpLoopbackServer();
+
+    //************************************
+    // Method:    Start listens on an ephemeral port of 127.0.0.1 and starts accepting
+    // FullName:  BHttpLoopbackServer::Start
+    // Access:    public 
+    // Returns:   bool false if the socket or the TLS context could not be set up
+    // Qualifier:
+    // Parameter: bool bInTls
+    //************************************
+    bool Start(bool bInTls);
+
+    // Closes the listener and every open connection, blocks until their threads exited
+    void Stop();
+
+    int32 GetPort() const { return Port; }
+
+    // http(s)://127.0.0.1:Port
+    FString GetBaseUrl() const;
+
+    // Applies to requests and connections that start afterwards, also clears the per-target attempt counts
+    void SetFaults(const FBHttpLoopbackFaults& InFaults);
+
+    FBHttpLoopbackServerStats GetStats() const;
+
+    void ResetStats();
+
+    // 64 KB of word-like text, about as compressible as JSON
+    static const std::string& GetPayloadBlock();
+
+    // Size and ContentHash of an object under /store/, false if there is none; Key is the path after /store/
+    bool GetStoredObject(const FString& Key, int64& OutBytes, uint64& OutHash) const;
+
+    // Multipart uploads started and neither completed nor aborted
+    int32 GetPendingUploadCount() const;
+
+    // Forgets every resumable session, as GCS does a week after one started; their requests get 404 from then on
+    void ExpireResumableSessions();
+
+    // Hash of Bytes more bytes after the ones Hash covers, start with 0; not cryptographic, only for checking uploads
+    static uint64 ContentHash(const void* Data, int64 Bytes, uint64 Hash = 0);
+
+private:
+    // Faults rolled for one request
+    struct FFaultPlan
+    {
+        double LatencySeconds = 0.0;
+        // 429 or 503 instead of the response, 0 for none
+        int32 StatusCode = 0;
+        bool bDropMidBody = false;
+        bool bMalformedChunk = false;
+        int64 BytesPerSecond = 0;
+        int32 RetryAfterSeconds = 1;
+    };
+
+    struct FConnection
+    {
+        std::thread Thread;
+        std::atomic<bool> bDone{ false };
+    };
+
+    void AcceptLoop();
+    void ServeConnection(socket_t Socket, FConnection* Connection);
+
+    // One request and its response, false once the connection has to close
+    bool ServeRequest(httplib::Stream& Strm);
+
+    FFaultPlan PlanFaults(const std::string& Target);
+
+    // Chunked if gzip'ed or a chunk is to be broken, false if the connection has to close
+    bool WriteBytes(httplib::Stream& Strm, uint64 Size, bool bGzip, const FFaultPlan& Plan);
+    // OutBody collects the body if set, OutHash its ContentHash, Checksums is fed with it
+    bool ReadBody(httplib::Stream& Strm, const httplib::Headers& Headers, const FFaultPlan& Plan, uint64& OutSize, std::string* OutBody = nullptr, uint64* OutHash = nullptr, FBHttpChecksumHasher* Checksums = nullptr);
+
+    // "x-goog-hash: crc32c=...,md5=...\r\n" of what Checksums was fed, both off by one bit if bWrong
+    static std::string MakeGoogHashLine(FBHttpChecksumHasher& Checksums, bool bWrong);
+
+    // A request under /store/, its status line, extra header lines and body go into the out parameters; false if the connection has to close
+    bool ServeObjectStore(httplib::Stream& Strm, const std::string& Method, const std::string& Key, const std::string& Query, const httplib::Headers& Headers,
+        const FFaultPlan& Plan, std::string& OutStatus, std::string& OutHeaders, std::string& OutBody);
+
+    // ContentHash of A followed by B, which is BytesB long
+    static uint64 CombineContentHash(uint64 HashA, uint64 HashB, uint64 BytesB);
+
+    // Next value of a splitmix64 sequence, in [0, 1)
+    static double NextRoll(uint64& State);
+
+    // Sleeps until Bytes took at least Bytes / BytesPerSecond since Start
+    void Pace(double Start, uint64 Bytes, int64 BytesPerSecond);
+
+    // False if Stop was called meanwhile
+    bool SleepUnlessStopping(double Seconds);
+
+    // Joins the threads of closed connections, under ConnectionsMutex
+    void ReapConnections();
+
+    bool CreateTlsContext();
+
+    bool bTls = false;
+    int32 Port = 0;
+
+    socket_t ListenSocket = INVALID_SOCKET;
+    std::thread AcceptThread;
+    std::atomic<bool> bStopping{ false };
+
+    SSL_CTX* SslContext = nullptr;
+    std::mutex SslContextMutex;
+
+    std::mutex ConnectionsMutex;
+    std::list<std::unique_ptr<FConnection>> Connections;
+    std::set<socket_t> OpenSockets;
+
+    struct FStoredObject
+    {
+        uint64 Bytes = 0;
+        uint64 Hash = 0;
+    };
+    struct FPendingUpload
+    {
+        std::string Key;
+        std::map<int32, FStoredObject> Parts;
+    };
+    struct FResumableSession
+    {
+        std::string Key;
+        // -1 until a request tells
+        int64 TotalBytes = -1;
+        uint64 CommittedBytes = 0;
+        uint64 Hash = 0;
+        bool bDone = false;
+    };
+    mutable std::mutex StoreMutex;
+    std::unordered_map<std::string, FStoredObject> Objects;
+    std::unordered_map<std::string, FPendingUpload> Uploads;
+    std::unordered_map<std::string, FResumableSession> Sessions;
+    uint64 NextUploadId = 1;
+
+    mutable std::mutex FaultsMutex;
+    FBHttpLoopbackFaults Faults;
+    // Requests per target so far, for the dice
+    std::unordered_map<std::string, uint64> Attempts;
+    uint64 ConnectionCount = 0;
+
+    struct FAtomicStats
+    {
+        std::atomic<int64> Connections{ 0 };
+        std::atomic<int64> Requests{ 0 };
+        std::atomic<int64> DelayedResponses{ 0 };
+        std::atomic<int64> DroppedMidBody{ 0 };
+        std::atomic<int64> MalformedChunks{ 0 };
+        std::atomic<int64> TooManyRequests{ 0 };
+        std::atomic<int64> ServiceUnavailable{ 0 };
+        std::atomic<int64> StalledHandshakes{ 0 };
+        std::atomic<int64> Continues{ 0 };
+        std::atomic<int64> RejectedBeforeBody{ 0 };
+    } Stats;
+};
@@ -0,0 +1,110 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BHttpClient.h"
+#include "BHttpLoopbackServer.h"
+
+// One kind of request of a traffic mix
+struct BHTTPCLIENTBENCHMARK_API FBHttpTrafficMixEntry
+{
+    // Get sends GET /bytes/PayloadBytes, the others upload PayloadBytes; Delete sends no body
+    EBHttpBatchVerb Verb = EBHttpBatchVerb::Get;
+    int64 PayloadBytes = 1024;
+    // Relative to the other entries of the mix
+    int32 Weight = 1;
+};
+
+enum class EBHttpScenarioApi : uint8
+{
+    // BHttpClient::Get/Put/... from Concurrency threads, with their 10 retries a second apart
+    SingleCalls = 0,
+    // One BHttpClient::ExecuteBatch with Concurrency as its limit
+    Batch = 1
+};
+
+struct BHTTPCLIENTBENCHMARK_API FBHttpScenario
+{
+    FString Name;
+
+    FBHttpLoopbackFaults Faults;
+    bool bTls = false;
+
+    TArray<FBHttpTrafficMixEntry> Mix;
+    int32 Requests = 200;
+    int32 Concurrency = 8;
+    EBHttpScenarioApi Api = EBHttpScenarioApi::Batch;
+    int32 MaxRetriesPerRequest = 2;
+
+    // Picks the mix entry of every request, the faults have their own seed
+    uint32 Seed = 1;
+};
+
+struct BHTTPCLIENTBENCHMARK_API FBHttpScenarioResult
+{
+    FString Name;
+    FString Api;
+
+    int32 Requests = 0;
+    // 2xx responses
+    int32 Succeeded = 0;
+    // No response after all retries
+    int32 Failed = 0;
+    // Responses with another status, 429 and 503 included
+    int32 Rejected = 0;
+    double SuccessRate = 0.0;
+
+    // StatusCode -1 for no response
+    TMap<int32, int32> StatusCounts;
+
+    // BHttpClient's retry counter over the run
+    int64 Retries = 0;
+
+    // Of every request, retries included, whatever its outcome
+    double P50Seconds = 0.0;
+    double P90Seconds = 0.0;
+    double P99Seconds = 0.0;
+    double P999Seconds = 0.0;
+    double MaxSeconds = 0.0;
+    // Of the successful requests only
+    double SucceededP50Seconds = 0.0;
+    double SucceededP99Seconds = 0.0;
+
+    double Seconds = 0.0;
+    double RequestsPerSecond = 0.0;
+
+    // What the server injected
+    FBHttpLoopbackServerStats Server;
+};
+
+/*
+ * Replays traffic mixes against BHttpClient while a BHttpLoopbackServer misbehaves in a chosen way,
+ * for measuring how retries, timeouts and pooling cope. Every request asks for its own URL (?id=N),
+ * so with the same seeds the same requests get the same faults on every run.
+ *
+ * Requests whose connection went down are retried by the client where it can, before any response
+ * byte arrived and with an input stream that rewinds, so those faults show up in Retries and the
+ * latency tail rather than as failures.
+ *
+ * */
+class BHTTPCLIENTBENCHMARK_API BHttpScenarioRunner
+{
+public:
+    // Baseline, latency, throttling, drops, malformed chunks, 429, 503 and stalled TLS handshakes
+    static TArray<FBHttpScenario> GetDefaultScenarios();
+
+    //************************************
+    // Method:    Run starts a loopback server with the scenario's faults and replays its mix
+    // FullName:  BHttpScenarioRunner::Run
+    // Access:    public static
+    // Returns:   bool false if the loopback server could not be started or the mix is empty
+    // Qualifier:
+    // Parameter: const FBHttpScenario & Scenario
+    // Parameter: FBHttpScenarioResult & OutResult
+    //************************************
+    static bool Run(const FBHttpScenario& Scenario, FBHttpScenarioResult& OutResult);
+
+    // {"benchmark":"BHttpClientLib.Scenarios","version":1,"results":[...]}, one object per scenario
+    static FString ToJson(const TArray<FBHttpScenarioResult>& Results);
+};
@@ -0,0 +1,357 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#include "BHttpChecksum.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <openssl/evp.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BHTTP_CRC32C_X86 1
+#include <nmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+// Windows on ARM64 requires the CRC extension, elsewhere the compiler says whether the target has it
+#elif defined(_M_ARM64) || (defined(__aarch64__) && defined(__ARM_FEATURE_CRC32))
+#define BHTTP_CRC32C_ARM 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <arm_acle.h>
+#endif
+#endif
+
+// Castagnoli polynomial, reflected
+static constexpr uint32 Crc32cPolynomial = 0x82F63B78u;
+
+// Slicing-by-8: Tables[k][b] is the CRC of byte b followed by k zero bytes
+struct FCrc32cTables
+{
+    uint32 Tables[8][256];
+
+    FCrc32cTables()
+    {
+        for (uint32 Byte = 0; Byte < 256; Byte++)
+        {
+            uint32 Crc = Byte;
+            for (int32 Bit = 0; Bit < 8; Bit++)
+            {
+                Crc = (Crc >> 1) ^ (Crc & 1 ? Crc32cPolynomial : 0);
+            }
+            Tables[0][Byte] = Crc;
+        }
+        for (uint32 Byte = 0; Byte < 256; Byte++)
+        {
+            for (int32 Slice = 1; Slice < 8; Slice++)
+            {
+                Tables[Slice][Byte] = (Tables[Slice - 1][Byte] >> 8) ^ Tables[0][Tables[Slice - 1][Byte] & 0xFF];
+            }
+        }
+    }
+};
+
+// Takes and returns the CRC before the final inversion
+static uint32 Crc32cSoftware(const uint8* Data, int64 Bytes, uint32 Crc)
+{
+    static const FCrc32cTables Crc32c;
+    const auto& T = Crc32c.Tables;
+
+    for (; Bytes > 0 && (reinterpret_cast<uintptr_t>(Data) & 7) != 0; Bytes--)
+    {
+        Crc = (Crc >> 8) ^ T[0][(Crc ^ *Data++) & 0xFF];
+    }
+    for (; Bytes >= 8; Bytes -= 8, Data += 8)
+    {
+        // Little-endian loads, which every platform the plugin targets is
+        uint32 Low;
+        uint32 High;
+        std::memcpy(&Low, Data, 4);
+        std::memcpy(&High, Data + 4, 4);
+        Low ^= Crc;
+        Crc = T[7][Low & 0xFF] ^ T[6][(Low >> 8) & 0xFF] ^ T[5][(Low >> 16) & 0xFF] ^ T[4][Low >> 24]
+            ^ T[3][High & 0xFF] ^ T[2][(High >> 8) & 0xFF] ^ T[1][(High >> 16) & 0xFF] ^ T[0][High >> 24];
+    }
+    for (; Bytes > 0; Bytes--)
+    {
+        Crc = (Crc >> 8) ^ T[0][(Crc ^ *Data++) & 0xFF];
+    }
+    return Crc;
+}
+
+#if BHTTP_CRC32C_X86
+// Compiled for SSE4.2 on its own, the rest of the module keeps running on CPUs without it
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("sse4.2")))
+#endif
+static uint32 Crc32cHardware(const uint8* Data, int64 Bytes, uint32 Crc)
+{
+    for (; Bytes > 0 && (reinterpret_cast<uintptr_t>(Data) & 7) != 0; Bytes--)
+    {
+        Crc = _mm_crc32_u8(Crc, *Data++);
+    }
+    uint64 Crc64 = Crc;
+    for (; Bytes >= 8; Bytes -= 8, Data += 8)
+    {
+        uint64 Word;
+        std::memcpy(&Word, Data, 8);
+        Crc64 = _mm_crc32_u64(Crc64, Word);
+    }
+    Crc = static_cast<uint32>(Crc64);
+    for (; Bytes > 0; Bytes--)
+    {
+        Crc = _mm_crc32_u8(Crc, *Data++);
+    }
+    return Crc;
+}
+#elif BHTTP_CRC32C_ARM
+static uint32 Crc32cHardware(const uint8* Data, int64 Bytes, uint32 Crc)
+{
+    for (; Bytes > 0 && (reinterpret_cast<uintptr_t>(Data) & 7) != 0; Bytes--)
+    {
+        Crc = __crc32cb(Crc, *Data++);
+    }
+    for (; Bytes >= 8; Bytes -= 8, Data += 8)
+    {
+        uint64 Word;
+        std::memcpy(&Word, Data, 8);
+        Crc = __crc32cd(Crc, Word);
+    }
+    for (; Bytes > 0; Bytes--)
+    {
+        Crc = __crc32cb(Crc, *Data++);
+    }
+    return Crc;
+}
+#endif
+
+bool FBHttpChecksumHasher::HasHardwareCrc32c()
+{
+    static const bool bHardware = []()
+    {
+#if BHTTP_CRC32C_X86 && defined(_MSC_VER)
+        int Info[4];
+        __cpuid(Info, 1);
+        return (Info[2] & (1 << 20)) != 0;
+#elif BHTTP_CRC32C_X86
+        return __builtin_cpu_supports("sse4.2") != 0;
+#elif BHTTP_CRC32C_ARM
+        return true;
+#else
+        return false;
+#endif
+    }();
+    return bHardware;
+}
+
+uint32 FBHttpChecksumHasher::Crc32c(const void* Data, int64 Bytes, uint32 Crc)
+{
+    const uint8* Byte = static_cast<const uint8*>(Data);
+#if BHTTP_CRC32C_X86 || BHTTP_CRC32C_ARM
+    if (HasHardwareCrc32c())
+    {
+        return ~Crc32cHardware(Byte, Bytes, ~Crc);
+    }
+#endif
+    return ~Crc32cSoftware(Byte, Bytes, ~Crc);
+}
+
+FBHttpChecksumHasher::FBHttpChecksumHasher(EBHttpChecksum InAlgorithms)
+    : Algorithms(InAlgorithms)
+{
+    if (EnumHasAnyFlags(Algorithms, EBHttpChecksum::Md5))
+    {
+        Md5Context = EVP_MD_CTX_new();
+    }
+    if (EnumHasAnyFlags(Algorithms, EBHttpChecksum::Sha256))
+    {
+        Sha256Context = EVP_MD_CTX_new();
+    }
+    Reset();
+}
+
+FBHttpChecksumHasher::~FBHttpChecksumHasher()
+{
+    EVP_MD_CTX_free(Md5Context);
+    EVP_MD_CTX_free(Sha256Context);
+}
+
+void FBHttpChecksumHasher::Reset()
+{
+    Bytes = 0;
+    Crc = 0;
+    if (Md5Context)
+    {
+        EVP_DigestInit_ex(Md5Context, EVP_md5(), nullptr);
+    }
+    if (Sha256Context)
+    {
+        EVP_DigestInit_ex(Sha256Context, EVP_sha256(), nullptr);
+    }
+}
+
+void FBHttpChecksumHasher::Update(const void* Data, int64 InBytes)
+{
+    if (InBytes <= 0)
+    {
+        return;
+    }
+    Bytes += static_cast<uint64>(InBytes);
+    if (EnumHasAnyFlags(Algorithms, EBHttpChecksum::Crc32c))
+    {
+        Crc = Crc32c(Data, InBytes, Crc);
+    }
+    if (Md5Context)
+    {
+        EVP_DigestUpdate(Md5Context, Data, static_cast<size_t>(InBytes));
+    }
+    if (Sha256Context)
+    {
+        EVP_DigestUpdate(Sha256Context, Data, static_cast<size_t>(InBytes));
+    }
+}
+
+FBHttpChecksums FBHttpChecksumHasher::Finish()
+{
+    FBHttpChecksums Result;
+    Result.Algorithms = Algorithms;
+    Result.Bytes = Bytes;
+    Result.Crc32c = Crc;
+    if (Md5Context)
+    {
+        EVP_DigestFinal_ex(Md5Context, Result.Md5, nullptr);
+    }
+    if (Sha256Context)
+    {
+        EVP_DigestFinal_ex(Sha256Context, Result.Sha256, nullptr);
+    }
+    return Result;
+}
+
+static FString ToBase64(const uint8* Data, size_t Bytes)
+{
+    return UTF8_TO_TCHAR(httplib::detail::base64_encode(std::string(reinterpret_cast<const char*>(Data), Bytes)).c_str());
+}
+
+static FString ToHex(const uint8* Data, size_t Bytes)
+{
+    static const char Digits[] = "0123456789abcdef";
+    std::string Hex;
+    Hex.reserve(Bytes * 2);
+    for (size_t i = 0; i < Bytes; i++)
+    {
+        Hex += Digits[Data[i] >> 4];
+        Hex += Digits[Data[i] & 15];
+    }
+    return UTF8_TO_TCHAR(Hex.c_str());
+}
+
+FString FBHttpChecksums::GetCrc32cBase64() const
+{
+    const uint8 BigEndian[4] = { static_cast<uint8>(Crc32c >> 24), static_cast<uint8>(Crc32c >> 16), static_cast<uint8>(Crc32c >> 8), static_cast<uint8>(Crc32c) };
+    return ToBase64(BigEndian, sizeof(BigEndian));
+}
+
+FString FBHttpChecksums::GetMd5Base64() const
+{
+    return ToBase64(Md5, sizeof(Md5));
+}
+
+FString FBHttpChecksums::GetMd5Hex() const
+{
+    return ToHex(Md5, sizeof(Md5));
+}
+
+FString FBHttpChecksums::GetSha256Base64() const
+{
+    return ToBase64(Sha256, sizeof(Sha256));
+}
+
+FString FBHttpChecksums::GetSha256Hex() const
+{
+    return ToHex(Sha256, sizeof(Sha256));
+}
+
+static std::string Trim(const std::string& Text)
+{
+    size_t Begin = 0;
+    size_t End = Text.size();
+    while (Begin < End && std::isspace(static_cast<unsigned char>(Text[Begin]))) Begin++;
+    while (End > Begin && std::isspace(static_cast<unsigned char>(Text[End - 1]))) End--;
+    return Text.substr(Begin, End - Begin);
+}
+
+EBHttpChecksumMatch FBHttpChecksumHasher::Verify(FBHttpChecksums& InOutChecksums, const httplib::Headers& Headers, bool bTrustETagAsMd5)
+{
+    const bool bCrc32c = EnumHasAnyFlags(InOutChecksums.Algorithms, EBHttpChecksum::Crc32c);
+    const bool bMd5 = EnumHasAnyFlags(InOutChecksums.Algorithms, EBHttpChecksum::Md5);
+    const bool bSha256 = EnumHasAnyFlags(InOutChecksums.Algorithms, EBHttpChecksum::Sha256);
+    const std::string Crc32cBase64 = bCrc32c ? std::string(TCHAR_TO_UTF8(*InOutChecksums.GetCrc32cBase64())) : std::string();
+    const std::string Md5Base64 = bMd5 ? std::string(TCHAR_TO_UTF8(*InOutChecksums.GetMd5Base64())) : std::string();
+
+    bool bMatched = false;
+    bool bMismatched = false;
+    FString CheckedHeaders;
+    auto Compare = [&](const char* Header, const std::string& Reported, const std::string& Computed)
+    {
+        const FString Name = UTF8_TO_TCHAR(Header);
+        if (!CheckedHeaders.Contains(*Name))
+        {
+            CheckedHeaders += CheckedHeaders.IsEmpty() ? Name : TEXT(",") + Name;
+        }
+        (Reported == Computed ? bMatched : bMismatched) = true;
+    };
+
+    // One header or several, each "crc32c=<base64>,md5=<base64>" or a part of it
+    const auto GoogHash = Headers.equal_range("x-goog-hash");
+    for (auto It = GoogHash.first; It != GoogHash.second; ++It)
+    {
+        size_t Begin = 0;
+        while (Begin <= It->second.size())
+        {
+            size_t End = It->second.find(',', Begin);
+            if (End == std::string::npos) End = It->second.size();
+            const std::string Item = Trim(It->second.substr(Begin, End - Begin));
+            if (bCrc32c && Item.compare(0, 7, "crc32c=") == 0)
+            {
+                Compare("x-goog-hash", Item.substr(7), Crc32cBase64);
+            }
+            else if (bMd5 && Item.compare(0, 4, "md5=") == 0)
+            {
+                Compare("x-goog-hash", Item.substr(4), Md5Base64);
+            }
+            Begin = End + 1;
+        }
+    }
+
+    if (bMd5 && httplib::detail::has_header(Headers, "Content-MD5"))
+    {
+        Compare("Content-MD5", Trim(httplib::detail::get_header_value(Headers, "Content-MD5", 0, "")), Md5Base64);
+    }
+    if (bCrc32c && httplib::detail::has_header(Headers, "x-amz-checksum-crc32c"))
+    {
+        Compare("x-amz-checksum-crc32c", Trim(httplib::detail::get_header_value(Headers, "x-amz-checksum-crc32c", 0, "")), Crc32cBase64);
+    }
+    if (bSha256 && httplib::detail::has_header(Headers, "x-amz-checksum-sha256"))
+    {
+        Compare("x-amz-checksum-sha256", Trim(httplib::detail::get_header_value(Headers, "x-amz-checksum-sha256", 0, "")), TCHAR_TO_UTF8(*InOutChecksums.GetSha256Base64()));
+    }
+
+    // Multipart and composite ETags have a suffix or another length, they are no MD5 of the body
+    if (bMd5 && bTrustETagAsMd5 && httplib::detail::has_header(Headers, "ETag"))
+    {
+        std::string ETag = Trim(httplib::detail::get_header_value(Headers, "ETag", 0, ""));
+        if (ETag.compare(0, 2, "W/") == 0) ETag = ETag.substr(2);
+        if (ETag.size() >= 2 && ETag.front() == '"' && ETag.back() == '"') ETag = ETag.substr(1, ETag.size() - 2);
+        const bool bHex = ETag.size() == 32 && std::all_of(ETag.begin(), ETag.end(), [](char C) { return std::isxdigit(static_cast<unsigned char>(C)) != 0; });
+        if (bHex)
+        {
+            std::transform(ETag.begin(), ETag.end(), ETag.begin(), [](char C) { return static_cast<char>(std::tolower(static_cast<unsigned char>(C))); });
+            Compare("ETag", ETag, TCHAR_TO_UTF8(*InOutChecksums.GetMd5Hex()));
+        }
+    }
+
+    InOutChecksums.CheckedHeaders = CheckedHeaders;
+    InOutChecksums.Match = bMismatched ? EBHttpChecksumMatch::Mismatched : (bMatched ? EBHttpChecksumMatch::Matched : EBHttpChecksumMatch::NotChecked);
+    return InOutChecksums.Match;
+}
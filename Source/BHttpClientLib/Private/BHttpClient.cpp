@@ -1,9 +1,33 @@
 /// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
 
 #include "BHttpClient.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include "BHttpChecksum.h"
 #include "BHttpClientUtils.h"
+#include "BHttpConnectionPool.h"
+#include "BHttpFileSink.h"
+#include "BHttpMetrics.h"
+#include "BHttpProgressSampler.h"
+#include "BHttpRequestScheduler.h"
+#include "BHttpTimingStats.h"
+#include "BHttpTracer.h"
 #include "GenericPlatform/GenericPlatformHttp.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+#if PLATFORM_WINDOWS
+#include <io.h>
+#include "Windows/WindowsHWrapper.h"
+#endif
 
 BHTTPCLIENTLIB_API DEFINE_LOG_CATEGORY(LogBHttpClientLib);
 
@@ -20,6 +44,319 @@ enum BHTTPCLIENTLIB_API EBHttpReadDeleteMethod : uint8
     Delete = 1
 };
 
+// Protocol options applied to every client created below
+static std::atomic<bool> bHttp2Enabled(false);
+static std::atomic<bool> bHttp2PriorKnowledge(false);
+
+void BHttpClient::SetUseHttp2(bool bUseHttp2, bool bCleartextPriorKnowledge)
+{
+    bHttp2Enabled = bUseHttp2;
+    bHttp2PriorKnowledge = bUseHttp2 && bCleartextPriorKnowledge;
+
+    // Pooled clients were configured with the old options
+    BHttpConnectionPool::Get().Empty();
+}
+
+static std::atomic<bool> bKernelTlsEnabled(false);
+
+void BHttpClient::SetUseKernelTls(bool bUseKernelTls)
+{
+    bKernelTlsEnabled = bUseKernelTls;
+
+    // Pooled connections finished their handshake without it
+    BHttpConnectionPool::Get().Empty();
+}
+
+static std::atomic<bool> bIoUringEnabled(false);
+
+void BHttpClient::SetUseIoUring(bool bUseIoUring)
+{
+    bIoUringEnabled = bUseIoUring;
+
+    // Pooled clients were configured with the old option
+    BHttpConnectionPool::Get().Empty();
+}
+
+// Bandwidth limits, the global one always exists so a limit set later reaches running transfers
+static std::shared_ptr<httplib::RateLimiter> GlobalRateLimiter = std::make_shared<httplib::RateLimiter>();
+static std::mutex HostRateLimitersMutex;
+static std::map<std::string, std::shared_ptr<httplib::RateLimiter>> HostRateLimiters;
+
+void BHttpClient::SetBandwidthLimit(int64 MaxDownloadBytesPerSecond, int64 MaxUploadBytesPerSecond)
+{
+    GlobalRateLimiter->set_download_rate(MaxDownloadBytesPerSecond > 0 ? MaxDownloadBytesPerSecond : 0);
+    GlobalRateLimiter->set_upload_rate(MaxUploadBytesPerSecond > 0 ? MaxUploadBytesPerSecond : 0);
+}
+
+void BHttpClient::SetIoBufferSize(int32 Bytes)
+{
+    httplib::detail::BufferPool::get().set_buffer_size(Bytes > 0 ? static_cast<size_t>(Bytes) : 0);
+}
+
+static std::atomic<int64> ExpectContinueMinBytes(1024 * 1024);
+static std::atomic<int64> ExpectContinueTimeoutMilliseconds(1000);
+
+void BHttpClient::SetExpectContinue(int64 MinBodyBytes, float TimeoutSeconds)
+{
+    ExpectContinueMinBytes = MinBodyBytes > 0 ? MinBodyBytes : 0;
+    ExpectContinueTimeoutMilliseconds = TimeoutSeconds > 0.0f ? static_cast<int64>(TimeoutSeconds * 1000.0f) : 0;
+
+    // Pooled clients were configured with the old options
+    BHttpConnectionPool::Get().Empty();
+}
+
+static std::atomic<bool> bMapFileDownloads(false);
+
+void BHttpClient::SetMapFileDownloads(bool bInMapFileDownloads)
+{
+    bMapFileDownloads = bInMapFileDownloads;
+}
+
+void BHttpClient::SetHostBandwidthLimit(const FString& HostOrUrl, int64 MaxDownloadBytesPerSecond, int64 MaxUploadBytesPerSecond)
+{
+    FString HostOnly;
+    FString PathOnly;
+    BHttpClient::SplitPath(HostOrUrl, HostOnly, PathOnly);
+
+    std::shared_ptr<httplib::RateLimiter> Limiter;
+    {
+        std::lock_guard<std::mutex> Lock(HostRateLimitersMutex);
+        auto& Entry = HostRateLimiters[TCHAR_TO_UTF8(*HostOnly)];
+        if (!Entry)
+        {
+            Entry = std::make_shared<httplib::RateLimiter>();
+        }
+        Limiter = Entry;
+    }
+    // Kept even when both are 0, requests holding it pick up a later limit
+    Limiter->set_download_rate(MaxDownloadBytesPerSecond > 0 ? MaxDownloadBytesPerSecond : 0);
+    Limiter->set_upload_rate(MaxUploadBytesPerSecond > 0 ? MaxUploadBytesPerSecond : 0);
+}
+
+static std::vector<std::shared_ptr<httplib::RateLimiter>> GetRateLimiters(const FString& Host, const std::shared_ptr<httplib::RateLimiter>& RequestLimiter)
+{
+    std::vector<std::shared_ptr<httplib::RateLimiter>> Limiters;
+    Limiters.push_back(GlobalRateLimiter);
+    {
+        std::lock_guard<std::mutex> Lock(HostRateLimitersMutex);
+        auto It = HostRateLimiters.find(TCHAR_TO_UTF8(*Host));
+        if (It != HostRateLimiters.end())
+        {
+            Limiters.push_back(It->second);
+        }
+    }
+    if (RequestLimiter)
+    {
+        Limiters.push_back(RequestLimiter);
+    }
+    return Limiters;
+}
+
+static thread_local EBHttpRequestPriority CurrentPriority = EBHttpRequestPriority::Normal;
+
+FBHttpPriorityScope::FBHttpPriorityScope(EBHttpRequestPriority Priority)
+    : Previous(CurrentPriority)
+{
+    CurrentPriority = Priority;
+}
+
+FBHttpPriorityScope::~FBHttpPriorityScope()
+{
+    CurrentPriority = Previous;
+}
+
+EBHttpRequestPriority FBHttpPriorityScope::Current()
+{
+    return CurrentPriority;
+}
+
+void BHttpClient::SetSchedulingOptions(const FBHttpSchedulingOptions& Options)
+{
+    BHttpRequestScheduler::Get().SetOptions(Options);
+}
+
+FBHttpQueueWaitStats BHttpClient::GetQueueWaitStats(EBHttpRequestPriority Priority)
+{
+    FBHttpQueueWaitStats Stats = BHttpRequestScheduler::Get().GetQueueWaitStats(Priority);
+    Stats.AverageSeconds = Stats.Count > 0 ? Stats.TotalSeconds / Stats.Count : 0.0;
+    return Stats;
+}
+
+void BHttpClient::ResetQueueWaitStats()
+{
+    BHttpRequestScheduler::Get().ResetQueueWaitStats();
+}
+
+void BHttpClient::SetTimingCallback(TFunction<void(const FString& Url, int32 StatusCode, const FBHttpRequestTimings& Timings)> Callback)
+{
+    BHttpTimingStats::Get().SetCallback(Callback);
+}
+
+FBHttpTimingHistogram BHttpClient::GetTimingHistogram(EBHttpTimingPhase Phase)
+{
+    return BHttpMetrics::Get().GetPhaseHistogram(Phase);
+}
+
+void BHttpClient::ResetTimingHistograms()
+{
+    BHttpMetrics::Get().ResetPhases();
+}
+
+void BHttpClient::SetLogVerbosity(ELogVerbosity::Type Verbosity)
+{
+    LogBHttpClientLib.SetVerbosity(Verbosity);
+}
+
+void BHttpClient::SetProgressLogOptions(const FBHttpProgressLogOptions& Options)
+{
+    BHttpProgressSampler::SetOptions(Options);
+}
+
+FBHttpMetricsSnapshot BHttpClient::GetMetricsSnapshot()
+{
+    return BHttpMetrics::Get().GetSnapshot();
+}
+
+FString BHttpClient::ExportMetricsPrometheus()
+{
+    return BHttpMetrics::Get().ExportPrometheus();
+}
+
+void BHttpClient::ResetMetrics()
+{
+    BHttpMetrics::Get().Reset();
+}
+
+void BHttpClient::SetTracingEnabled(bool bEnabled, int32 MaxRequests)
+{
+    BHttpTracer::Get().SetEnabled(bEnabled, MaxRequests);
+}
+
+bool BHttpClient::DumpTrace(const FString& FilePath, EBHttpTraceFormat Format)
+{
+    return BHttpTracer::Get().Dump(FilePath, Format);
+}
+
+void BHttpClient::ClearTrace()
+{
+    BHttpTracer::Get().Clear();
+}
+
+static void RecordTimings(EBHttpBatchVerb Verb, const FString& Host, const FString& Path, const httplib::Response& Response, FBHttpTransferStats* Stats)
+{
+    const FBHttpRequestTimings Timings = BHttpTimingStats::Convert(Response.timings);
+    if (Stats)
+    {
+        Stats->Timings = Timings;
+    }
+    BHttpMetrics::Get().RecordResponse(Response.timings);
+    BHttpTimingStats::Get().Notify(Host, Path, Response.status, Timings);
+    if (BHttpTracer::Get().IsEnabled())
+    {
+        BHttpTracer::Get().Record(Verb, Host + Path, Response.status, Response.timings);
+    }
+}
+
+// A request without a response still shows up in the trace, as one span without phases
+static void TraceFailedRequest(EBHttpBatchVerb Verb, const FString& Host, const FString& Path, double StartTime)
+{
+    if (BHttpTracer::Get().IsEnabled())
+    {
+        httplib::RequestTimings Timings;
+        Timings.start = StartTime;
+        Timings.end = httplib::detail::timing_now();
+        BHttpTracer::Get().Record(Verb, Host + Path, -1, Timings);
+    }
+}
+
+static std::unique_ptr<httplib::Client> MakeClient(const FString& Host)
+{
+    std::unique_ptr<httplib::Client> Client(new httplib::Client(TCHAR_TO_UTF8(*Host)));
+    Client->set_keep_alive(true);
+    Client->set_http2(bHttp2Enabled);
+    Client->set_http2_prior_knowledge(bHttp2PriorKnowledge);
+    Client->set_kernel_tls(bKernelTlsEnabled);
+    Client->set_io_uring(bIoUringEnabled);
+    Client->set_expect_continue(static_cast<size_t>(ExpectContinueMinBytes.load()), static_cast<time_t>(ExpectContinueTimeoutMilliseconds.load()));
+    return Client;
+}
+
+/*
+ * WARM UP IMPLEMENTATION
+ *
+ * The connections go into BHttpConnectionPool, whose background thread opens them and keeps them open.
+ * Requests take them from there like any pooled connection.
+ **/
+int32 BHttpClient::WarmUpConnections(const TArray<FString>& HostsOrUrls, const FBHttpWarmUpOptions& Options)
+{
+    TArray<FString> Hosts;
+    for (const FString& HostOrUrl : HostsOrUrls)
+    {
+        FString HostOnly;
+        FString PathOnly;
+        BHttpClient::SplitPath(HostOrUrl, HostOnly, PathOnly);
+        Hosts.AddUnique(HostOnly);
+    }
+
+    const int32 Connections = FMath::Max(Options.ConnectionsPerHost, 0);
+    const int32 TcpKeepAliveSeconds = Options.TcpKeepAliveSeconds;
+    for (const FString& Host : Hosts)
+    {
+        BHttpConnectionPool::FWarmHost Warm;
+        Warm.Connections = Connections;
+        Warm.PingPath = TCHAR_TO_UTF8(*Options.PingPath);
+        Warm.PingIntervalSeconds = Options.PingIntervalSeconds;
+        Warm.MakeClient = [Host, TcpKeepAliveSeconds]()
+        {
+            std::unique_ptr<httplib::Client> Client = MakeClient(Host);
+            if (TcpKeepAliveSeconds > 0)
+            {
+                Client->set_socket_options([TcpKeepAliveSeconds](socket_t Socket) { httplib::tcp_keepalive_socket_options(Socket, TcpKeepAliveSeconds); });
+            }
+            return Client;
+        };
+        BHttpConnectionPool::Get().KeepWarm(TCHAR_TO_UTF8(*Host), Warm);
+    }
+
+    // The hosts are opened at the same time, so they share the wait
+    const double Deadline = FPlatformTime::Seconds() + Options.WaitSeconds;
+    int32 OpenConnections = 0;
+    for (const FString& Host : Hosts)
+    {
+        const std::string PoolKey = TCHAR_TO_UTF8(*Host);
+        if (Options.WaitSeconds > 0.0f)
+        {
+            BHttpConnectionPool::Get().WaitForIdle(PoolKey, Connections, FMath::Max(Deadline - FPlatformTime::Seconds(), 0.0));
+        }
+        OpenConnections += BHttpConnectionPool::Get().GetIdleCount(PoolKey);
+    }
+
+    UE_LOG(LogBHttpClientLib, Display, TEXT("HttpClient->WarmUpConnections ==> Hosts: %d - Open connections: %d"), Hosts.Num(), OpenConnections);
+    return OpenConnections;
+}
+
+int32 BHttpClient::WarmUpConnections(const TArray<FString>& HostsOrUrls)
+{
+    FBHttpWarmUpOptions Options;
+    return BHttpClient::WarmUpConnections(HostsOrUrls, Options);
+}
+
+void BHttpClient::StopWarmUp(const TArray<FString>& HostsOrUrls)
+{
+    for (const FString& HostOrUrl : HostsOrUrls)
+    {
+        FString HostOnly;
+        FString PathOnly;
+        BHttpClient::SplitPath(HostOrUrl, HostOnly, PathOnly);
+        BHttpConnectionPool::Get().KeepWarm(TCHAR_TO_UTF8(*HostOnly), BHttpConnectionPool::FWarmHost());
+    }
+}
+
+void BHttpClient::CloseIdleConnections()
+{
+    BHttpConnectionPool::Get().Empty();
+}
+
 /* 
  * Analyze the full path for extracting the information of host, path and ssl client needed
  * 
@@ -90,28 +427,32 @@ int32 BHttpClient::Get_Or_Delete(EBHttpReadDeleteMethod HttpMethod, std::ostream
 
 	do
 	{
+		if (RetryCount > 0)
+		{
+			BHttpMetrics::Get().AddRetry();
+		}
+		// Not held across the retry sleep
+		BHttpScheduledSlot Slot(Host);
 		Result = Get_Or_Delete_Internal(HttpMethod, OutputStream, Host, Path, HeadersData);
 	} 
     while (Result == -1 && RetryCount++ < 10 && SleepInternal(1.0f));
 
 	return Result;
 }
-int32 BHttpClient::Get_Or_Delete_Internal(EBHttpReadDeleteMethod HttpMethod, std::ostream* OutputStream, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData)
+int32 BHttpClient::Get_Or_Delete_Internal(EBHttpReadDeleteMethod HttpMethod, std::ostream* OutputStream, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData, httplib::Client* Client, FBHttpTransferStats* Stats, std::shared_ptr<httplib::RateLimiter> RequestLimiter)
 {
+    // Byte counts feed the metrics even when the caller doesn't ask for them
+    FBHttpTransferStats LocalStats;
+    if (!Stats)
+    {
+        Stats = &LocalStats;
+    }
+
     // Converting TMap Headers data to httplib::Headers as std::multimap 
     httplib::Headers headers;
-    if (HeadersData.Num() > 0)
+    for (const TPair<FString, FString>& Pair : HeadersData)
     {
-        TArray<FString> KeyArray;
-        HeadersData.GenerateKeyArray(KeyArray);
-
-        TArray<FString> ValueArray;
-        HeadersData.GenerateValueArray(ValueArray);
-
-        for (int i = 0; i < HeadersData.Num(); i++)
-        {
-            headers.emplace(std::make_pair(std::string(TCHAR_TO_UTF8(*KeyArray[i])), std::string(TCHAR_TO_UTF8(*ValueArray[i]))));
-        }
+        headers.emplace(std::string(TCHAR_TO_UTF8(*Pair.Key)), std::string(TCHAR_TO_UTF8(*Pair.Value)));
     }
 
     // ResponseHandler definition for handling response message after sending Get or Delete requests
@@ -122,22 +463,30 @@ int32 BHttpClient::Get_Or_Delete_Internal(EBHttpReadDeleteMethod HttpMethod, std
     };
 
     // ContentReceiver definition for writing the ostream based on read data and length
-    httplib::ContentReceiver content_receiver;
-    if (OutputStream)
-    {
-		content_receiver = [OutputStream](const char* data, size_t data_length) {
-			OutputStream->write(data, data_length);
-			return true;
-		};
-    }
+    // Always set: it counts bytes for the metrics, and pausing it is how background downloads yield to interactive requests
+    const EBHttpRequestPriority Priority = FBHttpPriorityScope::Current();
+    httplib::ContentReceiver content_receiver = [OutputStream, Stats, Priority](const char* data, size_t data_length) {
+        BHttpRequestScheduler::Get().WaitWhilePreempted(Priority);
+        if (OutputStream)
+        {
+            OutputStream->write(data, data_length);
+        }
+        Stats->BytesReceived += data_length;
+        return true;
+    };
     
     // Progress definition for getting progress information about receiving data
+    // Runs for every read, so anything but the completion line is sampled and only evaluated when Verbose is on
+    BHttpProgressSampler ProgressSampler;
     httplib::Progress progress_tracker;
     progress_tracker = [&](uint64_t len, uint64_t total) {
-        int completed_percentage = (int)(len * 100 / total);
-        if (completed_percentage >= 100)
+        if (total > 0 && len >= total)
+        {
+            UE_LOG(LogBHttpClientLib, Display, TEXT("HttpClient->Progress(Get/Delete) ===> Received %lld / %lld bytes (100%% complete) - Request Url: %s%s"), len, total, *Host, *Path);
+        }
+        else if (UE_LOG_ACTIVE(LogBHttpClientLib, Verbose) && ProgressSampler.ShouldLog(len, total))
         {
-            UE_LOG(LogBHttpClientLib, Display, TEXT("HttpClient->Progress(Get/Delete) ===> Received %lld / %lld bytes (%d%% complete) - Request Url: %s%s\n"), len, total, completed_percentage, *Host, *Path);
+            UE_LOG(LogBHttpClientLib, Verbose, TEXT("HttpClient->Progress(Get/Delete) ===> Received %lld / %lld bytes (%d%% complete) - Request Url: %s%s"), len, total, BHttpProgressSampler::GetPercent(len, total), *Host, *Path);
         }
         return true; // return 'false' if you want to cancel the request.
     };
@@ -145,25 +494,52 @@ int32 BHttpClient::Get_Or_Delete_Internal(EBHttpReadDeleteMethod HttpMethod, std
     // Storing result messages
     int ResponseStatusCode = -1;
 
-    httplib::Client normalclient(TCHAR_TO_UTF8(*Host));
-    normalclient.set_keep_alive(true);
+    // Requests on their own take a pooled connection if there is one, warmed up or left by an earlier request
+    const std::string PoolKey = TCHAR_TO_UTF8(*Host);
+    std::unique_ptr<httplib::Client> OwnedClient;
+    if (!Client)
+    {
+        OwnedClient = BHttpConnectionPool::Get().Acquire(PoolKey);
+        if (!OwnedClient)
+        {
+            OwnedClient = MakeClient(Host);
+        }
+        Client = OwnedClient.get();
+    }
+    httplib::Client& normalclient = *Client;
+    normalclient.set_rate_limiters(GetRateLimiters(Host, RequestLimiter));
+    const EBHttpBatchVerb Verb = HttpMethod == EBHttpReadDeleteMethod::Delete ? EBHttpBatchVerb::Delete : EBHttpBatchVerb::Get;
+    // Same clock as the phase timestamps
+    const double RequestStart = httplib::detail::timing_now();
     if (HttpMethod == EBHttpReadDeleteMethod::Delete)
     {
-        auto result = normalclient.Delete(TCHAR_TO_UTF8(*Path), headers, response_handler, content_receiver, progress_tracker);
+        auto result = normalclient.Delete(TCHAR_TO_UTF8(*Path), headers, std::move(response_handler), std::move(content_receiver), std::move(progress_tracker));
         if (result)
         {
             ResponseStatusCode = result->status;
+            RecordTimings(Verb, Host, Path, *result, Stats);
         }
     }
     else
     {
-        auto result = normalclient.Get(TCHAR_TO_UTF8(*Path), headers, response_handler, content_receiver, progress_tracker);
+        auto result = normalclient.Get(TCHAR_TO_UTF8(*Path), headers, std::move(response_handler), std::move(content_receiver), std::move(progress_tracker));
         if (result)
         {
             ResponseStatusCode = result->status;
+            RecordTimings(Verb, Host, Path, *result, Stats);
         }
     }
 
+    if (ResponseStatusCode == -1)
+    {
+        TraceFailedRequest(Verb, Host, Path, RequestStart);
+    }
+    BHttpMetrics::Get().RecordRequest(Verb, Host, ResponseStatusCode, httplib::detail::timing_now() - RequestStart, Stats->BytesSent, Stats->BytesReceived);
+    if (OwnedClient)
+    {
+        BHttpConnectionPool::Get().Release(PoolKey, std::move(OwnedClient));
+    }
+
     return ResponseStatusCode;
 }
 
@@ -182,89 +558,686 @@ int32 BHttpClient::Get(std::ostream* OutputStream, const FString& FullPath)
     return BHttpClient::Get(OutputStream, FullPath, HeadersData);
 }
 
-int32 BHttpClient::Delete(std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData)
-{
-    FString HostOnly;
-    FString PathOnly;
-    BHttpClient::SplitPath(FullPath, HostOnly, PathOnly);
-
-    return BHttpClient::Get_Or_Delete(EBHttpReadDeleteMethod::Delete, OutputStream, HostOnly, PathOnly, HeadersData);
-}
-
-int32 BHttpClient::Delete(std::ostream* OutputStream, const FString& FullPath)
-{
-    TMap<FString, FString> HeadersData;
-    return BHttpClient::Delete(OutputStream, FullPath, HeadersData);
-}
-
 /*
- * POST/PUT/PATCH METHODS IMPLEMENTATIONS
- **/
-int32 BHttpClient::Post_Or_Put_Or_Patch(EBHttpCreateUpdateMethod HttpMethod, std::istream* InputStream, std::ostream* OutputStream, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData, const FString& ContentType, const TMap<FString, FString>& FormData)
+ * Get_Into handles GetInto requests, the body is received into the caller's memory instead of an ostream
+ * 
+ * */
+int32 BHttpClient::Get_Into(const FBHttpBodySpanReceiver& NextSpan, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData, FBHttpTransferStats& Stats, const FBHttpChecksumOptions* ChecksumOptions, FBHttpChecksums* OutChecksums)
 {
-    int32 Result = -1;
-    int32 RetryCount = 0;
+	int32 Result = -1;
+	int32 RetryCount = 0;
 
-    do
-    {
-        Result = Post_Or_Put_Or_Patch_Internal(HttpMethod, InputStream, OutputStream, Host, Path, HeadersData, ContentType, FormData);
-	}
-	while (Result == -1 && RetryCount++ < 10 && SleepInternal(1.0f));
+	do
+	{
+		if (RetryCount > 0)
+		{
+			BHttpMetrics::Get().AddRetry();
+		}
+		// Not held across the retry sleep
+		BHttpScheduledSlot Slot(Host);
+		Stats = FBHttpTransferStats();
+		Result = Get_Into_Internal(NextSpan, Host, Path, HeadersData, Stats, ChecksumOptions, OutChecksums);
+	} 
+    while (Result == -1 && RetryCount++ < 10 && SleepInternal(1.0f));
 
-    return Result;
+	return Result;
 }
-int32 BHttpClient::Post_Or_Put_Or_Patch_Internal(EBHttpCreateUpdateMethod HttpMethod, std::istream* InputStream, std::ostream* OutputStream, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData, const FString& ContentType, const TMap<FString, FString>& FormData)
+int32 BHttpClient::Get_Into_Internal(const FBHttpBodySpanReceiver& NextSpan, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData, FBHttpTransferStats& Stats, const FBHttpChecksumOptions* ChecksumOptions, FBHttpChecksums* OutChecksums)
 {
-    // Converting TMap Headers data to httplib::Headers as std::multimap
+    // Converting TMap Headers data to httplib::Headers as std::multimap 
     httplib::Headers headers;
-    if (HeadersData.Num() > 0)
+    for (const TPair<FString, FString>& Pair : HeadersData)
     {
-        TArray<FString> KeyArray;
-        HeadersData.GenerateKeyArray(KeyArray);
+        headers.emplace(std::string(TCHAR_TO_UTF8(*Pair.Key)), std::string(TCHAR_TO_UTF8(*Pair.Value)));
+    }
+
+    // ResponseHandler definition for handling response message after sending GetInto requests
+    httplib::ResponseHandler response_handler;
+    response_handler = [&](const httplib::Response& response) {
+        UE_LOG(LogBHttpClientLib, Display, TEXT("HttpClient->ResponseHandler(GetInto) ==> Status: %d - %s - Request Url: %s%s"), response.status, ANSI_TO_TCHAR(response.reason.c_str()), *Host, *Path);
+        return true; // return 'false' if you want to cancel the request.
+    };
 
-        TArray<FString> ValueArray;
-        HeadersData.GenerateValueArray(ValueArray);
+    // Checksums are taken from the current view after every read, while the bytes are still in cache
+    std::unique_ptr<FBHttpChecksumHasher> Hasher = ChecksumOptions ? std::make_unique<FBHttpChecksumHasher>(ChecksumOptions->Algorithms) : nullptr;
+    const uint8* SpanData = nullptr;
+    uint64_t SpanStart = 0;
 
-        for (int i = 0; i < HeadersData.Num(); i++)
+    // ContentSpanReceiver definition for passing the caller's views to httplib, socket reads land in them directly
+    httplib::ContentSpanReceiver content_span_receiver = [&NextSpan, &Hasher, &SpanData, &SpanStart](uint64_t content_length, uint64_t received) {
+        const TArrayView<uint8> Span = NextSpan(static_cast<int64>(content_length), static_cast<int64>(received));
+        if (Hasher && received == 0)
         {
-            headers.emplace(std::make_pair(std::string(TCHAR_TO_UTF8(*KeyArray[i])), std::string(TCHAR_TO_UTF8(*ValueArray[i]))));
+            Hasher->Reset();
         }
-    }
+        SpanData = Span.GetData();
+        SpanStart = received;
+        httplib::ContentSpan Result;
+        Result.data = reinterpret_cast<char*>(Span.GetData());
+        Result.size = static_cast<size_t>(Span.Num());
+        return Result;
+    };
 
-    // Converting TMap FormData data to httplib::Params as std::multimap
-    httplib::Params params;
-    if (FormData.Num() > 0)
-    {
-        TArray<FString> KeyArray;
-        FormData.GenerateKeyArray(KeyArray);
+    // Progress definition, it runs after every read with the bytes in the views so far
+    // Counts bytes for the metrics, and pausing it is how background downloads yield to interactive requests
+    const EBHttpRequestPriority Priority = FBHttpPriorityScope::Current();
+    BHttpProgressSampler ProgressSampler;
+    httplib::Progress progress_tracker;
+    progress_tracker = [&](uint64_t len, uint64_t total) {
+        if (Hasher)
+        {
+            Hasher->Update(SpanData + (Hasher->GetBytes() - SpanStart), static_cast<int64>(len - Hasher->GetBytes()));
+        }
+        Stats.BytesReceived = len;
+        BHttpRequestScheduler::Get().WaitWhilePreempted(Priority);
+        if (total > 0 && len >= total)
+        {
+            UE_LOG(LogBHttpClientLib, Display, TEXT("HttpClient->Progress(GetInto) ===> Received %lld / %lld bytes (100%% complete) - Request Url: %s%s"), len, total, *Host, *Path);
+        }
+        else if (UE_LOG_ACTIVE(LogBHttpClientLib, Verbose) && ProgressSampler.ShouldLog(len, total))
+        {
+            UE_LOG(LogBHttpClientLib, Verbose, TEXT("HttpClient->Progress(GetInto) ===> Received %lld / %lld bytes (%d%% complete) - Request Url: %s%s"), len, total, BHttpProgressSampler::GetPercent(len, total), *Host, *Path);
+        }
+        return true; // return 'false' if you want to cancel the request.
+    };
+
+    // Storing result messages
+    int ResponseStatusCode = -1;
 
-        TArray<FString> ValueArray;
-        FormData.GenerateValueArray(ValueArray);
+    // Takes a pooled connection if there is one, a handshake per call would cost more than the copies it saves
+    const std::string PoolKey = TCHAR_TO_UTF8(*Host);
+    std::unique_ptr<httplib::Client> normalclient = BHttpConnectionPool::Get().Acquire(PoolKey);
+    if (!normalclient)
+    {
+        normalclient = MakeClient(Host);
+    }
+    normalclient->set_rate_limiters(GetRateLimiters(Host, nullptr));
+    // Same clock as the phase timestamps
+    const double RequestStart = httplib::detail::timing_now();
+    auto result = normalclient->GetInto(TCHAR_TO_UTF8(*Path), headers, std::move(response_handler), std::move(content_span_receiver), std::move(progress_tracker));
+    if (result)
+    {
+        ResponseStatusCode = result->status;
+        RecordTimings(EBHttpBatchVerb::Get, Host, Path, *result, &Stats);
+    }
 
-        for (int i = 0; i < FormData.Num(); i++)
+    if (Hasher && OutChecksums)
+    {
+        *OutChecksums = Hasher->Finish();
+        // The digests in the headers are of the stored object, not of a decompressed body or a range of it
+        if (ChecksumOptions->bVerify && result && ResponseStatusCode >= 200 && ResponseStatusCode < 300 && ResponseStatusCode != 206 && !result->has_header("Content-Encoding")
+            && FBHttpChecksumHasher::Verify(*OutChecksums, result->headers, ChecksumOptions->bTrustETagAsMd5) == EBHttpChecksumMatch::Mismatched)
         {
-            params.emplace(std::make_pair(std::string(TCHAR_TO_UTF8(*KeyArray[i])), std::string(TCHAR_TO_UTF8(*ValueArray[i]))));
+            UE_LOG(LogBHttpClientLib, Error, TEXT("HttpClient->GetInto ==> Checksum mismatch with %s - Received %lld bytes - Request Url: %s%s"), *OutChecksums->CheckedHeaders, OutChecksums->Bytes, *Host, *Path);
+            ResponseStatusCode = -1;
         }
     }
 
-    // ContentProvider definition for providing istream data to the server
-    httplib::ContentProvider content_provider;
+    if (ResponseStatusCode == -1)
+    {
+        TraceFailedRequest(EBHttpBatchVerb::Get, Host, Path, RequestStart);
+    }
+    BHttpMetrics::Get().RecordRequest(EBHttpBatchVerb::Get, Host, ResponseStatusCode, httplib::detail::timing_now() - RequestStart, Stats.BytesSent, Stats.BytesReceived);
+    // Without a response the body may be cut short on the socket, the client is dropped rather than pooled
+    BHttpConnectionPool::Get().Release(PoolKey, result ? std::move(normalclient) : nullptr);
 
-    size_t StreamSize = 0;
+    return ResponseStatusCode;
+}
 
-    if (InputStream)
+int32 BHttpClient::GetInto(const FBHttpBodySpanReceiver& NextSpan, const FString& FullPath, const TMap<FString, FString>& HeadersData, int64* OutReceivedBytes)
+{
+    FString HostOnly;
+    FString PathOnly;
+    BHttpClient::SplitPath(FullPath, HostOnly, PathOnly);
+
+    FBHttpTransferStats Stats;
+    const int32 Result = BHttpClient::Get_Into(NextSpan, HostOnly, PathOnly, HeadersData, Stats);
+    if (OutReceivedBytes)
     {
-        content_provider = [InputStream](size_t offset, size_t length, httplib::DataSink& sink) {
-            do
-            {
-                char buffer[CPPHTTPLIB_RECV_BUFSIZ];
-                InputStream->read(buffer, CPPHTTPLIB_RECV_BUFSIZ);
+        *OutReceivedBytes = static_cast<int64>(Stats.BytesReceived);
+    }
+    return Result;
+}
+
+int32 BHttpClient::GetInto(TArray<uint8>& OutBody, const FString& FullPath, const TMap<FString, FString>& HeadersData)
+{
+    // Sized to Content-Length up front, bodies without one double the array whenever it is full
+    FBHttpBodySpanReceiver NextSpan = [&OutBody](int64 ContentLength, int64 ReceivedBytes)
+    {
+        int64 NewNum = ReceivedBytes == 0 && ContentLength > 0 ? ContentLength : FMath::Max<int64>(ReceivedBytes * 2, 64 * 1024);
+        NewNum = FMath::Min<int64>(NewNum, MAX_int32);
+        if (NewNum <= ReceivedBytes)
+        {
+            return TArrayView<uint8>();
+        }
+        OutBody.SetNumUninitialized(static_cast<int32>(NewNum));
+        return TArrayView<uint8>(OutBody.GetData() + ReceivedBytes, static_cast<int32>(NewNum - ReceivedBytes));
+    };
+
+    int64 ReceivedBytes = 0;
+    const int32 Result = BHttpClient::GetInto(NextSpan, FullPath, HeadersData, &ReceivedBytes);
+    OutBody.SetNum(Result == -1 ? 0 : static_cast<int32>(ReceivedBytes));
+    return Result;
+}
+
+int32 BHttpClient::GetInto(TArray<uint8>& OutBody, const FString& FullPath)
+{
+    TMap<FString, FString> HeadersData;
+    return BHttpClient::GetInto(OutBody, FullPath, HeadersData);
+}
+
+int32 BHttpClient::GetToFile(const FString& FilePath, const FString& FullPath, const TMap<FString, FString>& HeadersData)
+{
+    return BHttpClient::Get_To_File(FilePath, FullPath, HeadersData, nullptr, nullptr);
+}
+
+int32 BHttpClient::GetToFile(const FString& FilePath, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FBHttpChecksumOptions& ChecksumOptions, FBHttpChecksums& OutChecksums)
+{
+    OutChecksums = FBHttpChecksums();
+    return BHttpClient::Get_To_File(FilePath, FullPath, HeadersData, &ChecksumOptions, &OutChecksums);
+}
+
+int32 BHttpClient::Get_To_File(const FString& FilePath, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FBHttpChecksumOptions* ChecksumOptions, FBHttpChecksums* OutChecksums)
+{
+    BHttpFileSink Sink(FilePath, bMapFileDownloads, bIoUringEnabled);
+    if (!Sink.Open())
+    {
+        UE_LOG(LogBHttpClientLib, Error, TEXT("HttpClient->GetToFile ==> %s.part could not be created - Request Url: %s"), *FilePath, *FullPath);
+        return -1;
+    }
+
+    FBHttpBodySpanReceiver NextSpan = [&Sink](int64 ContentLength, int64 ReceivedBytes)
+    {
+        return Sink.NextSpan(ContentLength, ReceivedBytes);
+    };
+
+    FString HostOnly;
+    FString PathOnly;
+    BHttpClient::SplitPath(FullPath, HostOnly, PathOnly);
+
+    FBHttpTransferStats Stats;
+    const int32 Result = BHttpClient::Get_Into(NextSpan, HostOnly, PathOnly, HeadersData, Stats, ChecksumOptions, OutChecksums);
+    const int64 ReceivedBytes = static_cast<int64>(Stats.BytesReceived);
+    // Error pages and mismatched bodies don't replace the file, the part file goes with the sink
+    if (Result < 200 || Result >= 300)
+    {
+        return Result;
+    }
+    return Sink.Commit(ReceivedBytes) ? Result : -1;
+}
+
+int32 BHttpClient::GetToFile(const FString& FilePath, const FString& FullPath)
+{
+    TMap<FString, FString> HeadersData;
+    return BHttpClient::GetToFile(FilePath, FullPath, HeadersData);
+}
+
+/*
+ * GetPipelined groups the paths by host and sends each group through httplib's pipelined send,
+ * so a batch of tiny GETs costs roughly one round trip per PipelineDepth requests instead of one each.
+ * When the host negotiates HTTP/2 the whole group goes out as concurrent streams instead
+ * 
+ * */
+TArray<int32> BHttpClient::GetPipelined(const TArray<std::ostream*>& OutputStreams, const TArray<FString>& FullPaths, const TMap<FString, FString>& HeadersData, int32 PipelineDepth)
+{
+    TArray<int32> ResponseStatusCodes;
+    ResponseStatusCodes.Init(-1, FullPaths.Num());
+
+    // Converting TMap Headers data to httplib::Headers as std::multimap
+    httplib::Headers headers;
+    for (const TPair<FString, FString>& Pair : HeadersData)
+    {
+        headers.emplace(std::string(TCHAR_TO_UTF8(*Pair.Key)), std::string(TCHAR_TO_UTF8(*Pair.Value)));
+    }
+
+    // Grouping request indexes by host, each host gets its own pipelined connection
+    TArray<FString> Hosts;
+    TArray<TArray<int32>> HostRequestIndexes;
+    TArray<FString> Paths;
+    Paths.SetNum(FullPaths.Num());
+
+    for (int32 i = 0; i < FullPaths.Num(); i++)
+    {
+        FString HostOnly;
+        BHttpClient::SplitPath(FullPaths[i], HostOnly, Paths[i]);
+
+        int32 HostIndex = -1;
+        for (int32 j = 0; j < Hosts.Num(); j++)
+        {
+            if (Hosts[j] == HostOnly)
+            {
+                HostIndex = j;
+                break;
+            }
+        }
+        if (HostIndex < 0)
+        {
+            HostIndex = Hosts.Add(HostOnly);
+            HostRequestIndexes.Add(TArray<int32>());
+        }
+        HostRequestIndexes[HostIndex].Add(i);
+    }
+
+    TArray<uint64> ReceivedBytes;
+    ReceivedBytes.Init(0, FullPaths.Num());
+
+    for (int32 j = 0; j < Hosts.Num(); j++)
+    {
+        std::vector<httplib::Request> requests;
+        requests.reserve(HostRequestIndexes[j].Num());
+
+        for (int32 RequestIndex : HostRequestIndexes[j])
+        {
+            httplib::Request req;
+            req.method = "GET";
+            req.path = TCHAR_TO_UTF8(*Paths[RequestIndex]);
+            req.headers = headers;
+
+            std::ostream* OutputStream = OutputStreams.IsValidIndex(RequestIndex) ? OutputStreams[RequestIndex] : nullptr;
+            // Requests without a stream keep their body in the response, so they can still be replayed
+            if (OutputStream)
+            {
+                uint64* BytesReceived = &ReceivedBytes[RequestIndex];
+                req.content_receiver = [OutputStream, BytesReceived](const char* data, size_t data_length) {
+                    OutputStream->write(data, data_length);
+                    *BytesReceived += data_length;
+                    return true;
+                };
+            }
+            requests.push_back(std::move(req));
+        }
+
+        std::vector<httplib::Response> responses;
+
+        // The whole group travels over one connection, so it takes one slot
+        BHttpScheduledSlot Slot(Hosts[j]);
+
+        const std::string PoolKey = TCHAR_TO_UTF8(*Hosts[j]);
+        std::unique_ptr<httplib::Client> Client = BHttpConnectionPool::Get().Acquire(PoolKey);
+        if (!Client)
+        {
+            Client = MakeClient(Hosts[j]);
+        }
+        Client->set_rate_limiters(GetRateLimiters(Hosts[j], nullptr));
+        Client->send_multiplexed(requests, responses, PipelineDepth > 0 ? PipelineDepth : 1);
+        BHttpConnectionPool::Get().Release(PoolKey, std::move(Client));
+
+        for (int32 k = 0; k < HostRequestIndexes[j].Num() && k < (int32)responses.size(); k++)
+        {
+            const int32 RequestIndex = HostRequestIndexes[j][k];
+            ResponseStatusCodes[RequestIndex] = responses[k].status;
+            if (responses[k].status != -1)
+            {
+                RecordTimings(EBHttpBatchVerb::Get, Hosts[j], Paths[RequestIndex], responses[k], nullptr);
+            }
+            BHttpMetrics::Get().RecordRequest(EBHttpBatchVerb::Get, Hosts[j], responses[k].status, responses[k].timings.total(), 0, ReceivedBytes[RequestIndex] + responses[k].body.size());
+        }
+
+        UE_LOG(LogBHttpClientLib, Display, TEXT("HttpClient->GetPipelined ==> Host: %s - Requests: %d"), *Hosts[j], HostRequestIndexes[j].Num());
+    }
+
+    return ResponseStatusCodes;
+}
+
+TArray<int32> BHttpClient::GetPipelined(const TArray<std::ostream*>& OutputStreams, const TArray<FString>& FullPaths)
+{
+    TMap<FString, FString> HeadersData;
+    return BHttpClient::GetPipelined(OutputStreams, FullPaths, HeadersData);
+}
+
+/*
+ * BATCH IMPLEMENTATION
+ * 
+ * Workers pick the highest priority request among the hosts below MaxConcurrencyPerHost, hosts with
+ * equal priority take turns, so one slow host cannot occupy every worker. Each attempt then waits for
+ * a connection slot from BHttpRequestScheduler, shared with every other request of the process, and
+ * checks a client out of BHttpConnectionPool, consecutive requests to a host reuse the same connections.
+ **/
+void BHttpClient::ExecuteBatchItem(const FBHttpBatchRequest& Request, const FString& Host, const FString& Path, int32 MaxRetries, double BatchStart, FBHttpBatchItemResult& OutItem)
+{
+    FBHttpPriorityScope PriorityScope(Request.Priority);
+
+    const std::string PoolKey = TCHAR_TO_UTF8(*Host);
+
+    std::streampos InputStart = -1;
+    if (Request.InputStream)
+    {
+        InputStart = Request.InputStream->tellg();
+    }
+
+    std::shared_ptr<httplib::RateLimiter> RequestLimiter;
+    if (Request.MaxDownloadBytesPerSecond > 0 || Request.MaxUploadBytesPerSecond > 0)
+    {
+        RequestLimiter = std::make_shared<httplib::RateLimiter>(FMath::Max<int64>(Request.MaxDownloadBytesPerSecond, 0), FMath::Max<int64>(Request.MaxUploadBytesPerSecond, 0));
+    }
+
+    double StartTime = 0.0;
+    int32 StatusCode = -1;
+
+    for (;;)
+    {
+        BHttpScheduledSlot Slot(Host);
+        if (OutItem.Attempts == 0)
+        {
+            StartTime = FPlatformTime::Seconds();
+            OutItem.QueueSeconds = StartTime - BatchStart;
+        }
+        else
+        {
+            BHttpMetrics::Get().AddRetry();
+        }
+
+        std::unique_ptr<httplib::Client> Client = BHttpConnectionPool::Get().Acquire(PoolKey);
+        if (!Client)
+        {
+            Client = MakeClient(Host);
+        }
+
+        FBHttpTransferStats Stats;
+        switch (Request.Verb)
+        {
+        case EBHttpBatchVerb::Get:
+            StatusCode = Get_Or_Delete_Internal(EBHttpReadDeleteMethod::Get, Request.OutputStream, Host, Path, Request.HeadersData, Client.get(), &Stats, RequestLimiter);
+            break;
+        case EBHttpBatchVerb::Delete:
+            StatusCode = Get_Or_Delete_Internal(EBHttpReadDeleteMethod::Delete, Request.OutputStream, Host, Path, Request.HeadersData, Client.get(), &Stats, RequestLimiter);
+            break;
+        case EBHttpBatchVerb::Post:
+            StatusCode = Post_Or_Put_Or_Patch_Internal(EBHttpCreateUpdateMethod::Post, Request.InputStream, Request.OutputStream, Host, Path, Request.HeadersData, Request.ContentType, Request.FormData, Client.get(), &Stats, RequestLimiter);
+            break;
+        case EBHttpBatchVerb::Put:
+            StatusCode = Post_Or_Put_Or_Patch_Internal(EBHttpCreateUpdateMethod::Put, Request.InputStream, Request.OutputStream, Host, Path, Request.HeadersData, Request.ContentType, Request.FormData, Client.get(), &Stats, RequestLimiter);
+            break;
+        case EBHttpBatchVerb::Patch:
+            StatusCode = Post_Or_Put_Or_Patch_Internal(EBHttpCreateUpdateMethod::Patch, Request.InputStream, Request.OutputStream, Host, Path, Request.HeadersData, Request.ContentType, Request.FormData, Client.get(), &Stats, RequestLimiter);
+            break;
+        }
+
+        OutItem.Attempts++;
+        OutItem.Transfer.Timings = Stats.Timings;
+        OutItem.Transfer.BytesSent += Stats.BytesSent;
+        OutItem.Transfer.BytesReceived += Stats.BytesReceived;
+
+        BHttpConnectionPool::Get().Release(PoolKey, std::move(Client));
+
+        if (StatusCode != -1 || OutItem.Attempts > MaxRetries)
+        {
+            break;
+        }
+
+        // A partially written OutputStream cannot be taken back, and a consumed InputStream must rewind
+        if (Stats.BytesReceived > 0)
+        {
+            break;
+        }
+        if (Stats.BytesSent > 0)
+        {
+            if (!Request.InputStream || InputStart == std::streampos(-1))
+            {
+                break;
+            }
+            Request.InputStream->clear();
+            Request.InputStream->seekg(InputStart);
+            if (Request.InputStream->fail())
+            {
+                break;
+            }
+        }
+    }
+
+    OutItem.StatusCode = StatusCode;
+    OutItem.DurationSeconds = FPlatformTime::Seconds() - StartTime;
+}
+
+FBHttpBatchResult BHttpClient::ExecuteBatch(const TArray<FBHttpBatchRequest>& Requests, const FBHttpBatchOptions& Options)
+{
+    FBHttpBatchResult Result;
+    Result.Items.SetNum(Requests.Num());
+    if (Requests.Num() == 0)
+    {
+        return Result;
+    }
+
+    TArray<FString> Hosts;
+    TArray<FString> Paths;
+    Hosts.SetNum(Requests.Num());
+    Paths.SetNum(Requests.Num());
+
+    // Request indexes per host, highest priority first, then in submission order
+    std::map<std::string, std::deque<int32>> Pending;
+    std::map<std::string, int32> InFlightPerHost;
+    std::vector<std::string> HostOrder;
+    for (int32 i = 0; i < Requests.Num(); i++)
+    {
+        BHttpClient::SplitPath(Requests[i].FullPath, Hosts[i], Paths[i]);
+
+        const std::string Key = TCHAR_TO_UTF8(*Hosts[i]);
+        if (Pending.find(Key) == Pending.end())
+        {
+            HostOrder.push_back(Key);
+            InFlightPerHost[Key] = 0;
+        }
+        Pending[Key].push_back(i);
+    }
+    for (auto& Entry : Pending)
+    {
+        std::stable_sort(Entry.second.begin(), Entry.second.end(), [&Requests](int32 A, int32 B) {
+            return Requests[A].Priority > Requests[B].Priority;
+        });
+    }
+
+    const int32 MaxPerHost = Options.MaxConcurrencyPerHost > 0 ? Options.MaxConcurrencyPerHost : 1;
+    const int32 WorkerCount = FMath::Min(Options.MaxConcurrency > 0 ? Options.MaxConcurrency : 1, Requests.Num());
+
+    std::mutex Mutex;
+    std::condition_variable HostFreed;
+    size_t NextHost = 0;
+    int32 Remaining = Requests.Num();
+    bool bAbort = false;
+
+    const double BatchStart = FPlatformTime::Seconds();
+
+    auto Worker = [&]() {
+        for (;;)
+        {
+            int32 Index = -1;
+            std::string Key;
+            {
+                std::unique_lock<std::mutex> Lock(Mutex);
+                for (;;)
+                {
+                    if (bAbort || Remaining == 0)
+                    {
+                        return;
+                    }
+                    size_t BestStep = 0;
+                    for (size_t Step = 0; Step < HostOrder.size(); Step++)
+                    {
+                        const std::string& Candidate = HostOrder[(NextHost + Step) % HostOrder.size()];
+                        auto& Queue = Pending[Candidate];
+                        if (!Queue.empty() && InFlightPerHost[Candidate] < MaxPerHost &&
+                            (Index < 0 || Requests[Queue.front()].Priority > Requests[Index].Priority))
+                        {
+                            Index = Queue.front();
+                            Key = Candidate;
+                            BestStep = Step;
+                        }
+                    }
+                    if (Index >= 0)
+                    {
+                        Pending[Key].pop_front();
+                        NextHost = (NextHost + BestStep + 1) % HostOrder.size();
+                        break;
+                    }
+                    // Everything left is either running or waiting on a host at its limit
+                    HostFreed.wait(Lock);
+                }
+                InFlightPerHost[Key]++;
+                Remaining--;
+            }
+
+            FBHttpBatchItemResult& Item = Result.Items[Index];
+            ExecuteBatchItem(Requests[Index], Hosts[Index], Paths[Index], Options.MaxRetriesPerRequest, BatchStart, Item);
+
+            {
+                std::lock_guard<std::mutex> Lock(Mutex);
+                InFlightPerHost[Key]--;
+                if (Options.bFailFast && (Item.StatusCode == -1 || Item.StatusCode >= 400))
+                {
+                    bAbort = true;
+                }
+            }
+            HostFreed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> Workers;
+    Workers.reserve(WorkerCount);
+    for (int32 i = 0; i < WorkerCount; i++)
+    {
+        Workers.emplace_back(Worker);
+    }
+    for (std::thread& Thread : Workers)
+    {
+        Thread.join();
+    }
+
+    Result.ElapsedSeconds = FPlatformTime::Seconds() - BatchStart;
+    Result.bAborted = bAbort;
+
+    // Whatever is still queued was never started
+    for (auto& Entry : Pending)
+    {
+        for (int32 Index : Entry.second)
+        {
+            Result.Items[Index].bSkipped = true;
+        }
+    }
+
+    for (const FBHttpBatchItemResult& Item : Result.Items)
+    {
+        if (Item.bSkipped)
+        {
+            Result.SkippedCount++;
+        }
+        else if (Item.StatusCode == -1 || Item.StatusCode >= 400)
+        {
+            Result.FailedCount++;
+        }
+        else
+        {
+            Result.SucceededCount++;
+        }
+        Result.TotalBytesSent += Item.Transfer.BytesSent;
+        Result.TotalBytesReceived += Item.Transfer.BytesReceived;
+    }
+
+    if (Result.ElapsedSeconds > 0.0)
+    {
+        Result.RequestsPerSecond = (Result.SucceededCount + Result.FailedCount) / Result.ElapsedSeconds;
+        Result.BytesPerSecond = (Result.TotalBytesSent + Result.TotalBytesReceived) / Result.ElapsedSeconds;
+    }
+
+    UE_LOG(LogBHttpClientLib, Display, TEXT("HttpClient->ExecuteBatch ==> Requests: %d - Succeeded: %d - Failed: %d - Skipped: %d - Elapsed: %.3fs - %.1f req/s - %.1f KB/s"),
+        Requests.Num(), Result.SucceededCount, Result.FailedCount, Result.SkippedCount, Result.ElapsedSeconds, Result.RequestsPerSecond, Result.BytesPerSecond / 1024.0);
+
+    return Result;
+}
+
+FBHttpBatchResult BHttpClient::ExecuteBatch(const TArray<FBHttpBatchRequest>& Requests)
+{
+    FBHttpBatchOptions Options;
+    return BHttpClient::ExecuteBatch(Requests, Options);
+}
+
+int32 BHttpClient::Delete(std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData)
+{
+    FString HostOnly;
+    FString PathOnly;
+    BHttpClient::SplitPath(FullPath, HostOnly, PathOnly);
+
+    return BHttpClient::Get_Or_Delete(EBHttpReadDeleteMethod::Delete, OutputStream, HostOnly, PathOnly, HeadersData);
+}
+
+int32 BHttpClient::Delete(std::ostream* OutputStream, const FString& FullPath)
+{
+    TMap<FString, FString> HeadersData;
+    return BHttpClient::Delete(OutputStream, FullPath, HeadersData);
+}
+
+/*
+ * POST/PUT/PATCH METHODS IMPLEMENTATIONS
+ **/
+int32 BHttpClient::Post_Or_Put_Or_Patch(EBHttpCreateUpdateMethod HttpMethod, std::istream* InputStream, std::ostream* OutputStream, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData, const FString& ContentType, const TMap<FString, FString>& FormData)
+{
+    int32 Result = -1;
+    int32 RetryCount = 0;
+
+    do
+    {
+        if (RetryCount > 0)
+        {
+            BHttpMetrics::Get().AddRetry();
+        }
+        // Not held across the retry sleep
+        BHttpScheduledSlot Slot(Host);
+        Result = Post_Or_Put_Or_Patch_Internal(HttpMethod, InputStream, OutputStream, Host, Path, HeadersData, ContentType, FormData);
+	}
+	while (Result == -1 && RetryCount++ < 10 && SleepInternal(1.0f));
+
+    return Result;
+}
+int32 BHttpClient::Post_Or_Put_Or_Patch_Internal(EBHttpCreateUpdateMethod HttpMethod, std::istream* InputStream, std::ostream* OutputStream, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData, const FString& ContentType, const TMap<FString, FString>& FormData, httplib::Client* Client, FBHttpTransferStats* Stats, std::shared_ptr<httplib::RateLimiter> RequestLimiter)
+{
+    // Byte counts feed the metrics even when the caller doesn't ask for them
+    FBHttpTransferStats LocalStats;
+    if (!Stats)
+    {
+        Stats = &LocalStats;
+    }
+
+    // Converting TMap Headers data to httplib::Headers as std::multimap
+    httplib::Headers headers;
+    for (const TPair<FString, FString>& Pair : HeadersData)
+    {
+        headers.emplace(std::string(TCHAR_TO_UTF8(*Pair.Key)), std::string(TCHAR_TO_UTF8(*Pair.Value)));
+    }
+
+    // Converting TMap FormData data to httplib::Params as std::multimap
+    httplib::Params params;
+    for (const TPair<FString, FString>& Pair : FormData)
+    {
+        params.emplace(std::string(TCHAR_TO_UTF8(*Pair.Key)), std::string(TCHAR_TO_UTF8(*Pair.Value)));
+    }
+
+    // ContentProvider definition for providing istream data to the server
+    httplib::ContentProvider content_provider;
+
+    size_t StreamSize = 0;
+
+    if (InputStream)
+    {
+        content_provider = [InputStream, Stats, &Host, &Path](size_t offset, size_t length, httplib::DataSink& sink) {
+            BHttpProgressSampler UploadSampler;
+            // Pooled, so the stream is read in large blocks without a large stack array
+            httplib::detail::BufferPool::Lease Buffer;
+            char* buffer = Buffer.data();
+            do
+            {
+                InputStream->read(buffer, Buffer.size());
                 //read correct in first pass but fail in second one
                 unsigned int readBytes = InputStream->gcount();
                 if (readBytes > 0)
                 {
-                    sink.write(buffer + offset, readBytes);
-                    UE_LOG(LogBHttpClientLib, Display, TEXT("HttpClient->ContentProvider(Post/Put/Patch) ==> Written Bytes: %lld"), InputStream->gcount());
+                    // offset counts what earlier calls wrote, it is not a position in this buffer
+                    sink.write(buffer, readBytes);
+                    Stats->BytesSent += readBytes;
+
+                    UE_LOG(LogBHttpClientLib, VeryVerbose, TEXT("HttpClient->ContentProvider(Post/Put/Patch) ==> Written Bytes: %u"), readBytes);
+                    if (UE_LOG_ACTIVE(LogBHttpClientLib, Verbose) && UploadSampler.ShouldLog(Stats->BytesSent, 0))
+                    {
+                        UE_LOG(LogBHttpClientLib, Verbose, TEXT("HttpClient->ContentProvider(Post/Put/Patch) ===> Sent %llu bytes - Request Url: %s%s"), Stats->BytesSent, *Host, *Path);
+                    }
                 }
             } while (InputStream->gcount() > 0);
 
@@ -281,144 +1254,1257 @@ int32 BHttpClient::Post_Or_Put_Or_Patch_Internal(EBHttpCreateUpdateMethod HttpMe
         return true; // return 'false' if you want to cancel the request.
     };
 
-    // ContentReceiver definition for writing the ostream based on read data and length
-    httplib::ContentReceiver content_receiver;
-    if (OutputStream)
+    // ContentReceiver definition for writing the ostream based on read data and length
+    // Always set: it counts bytes for the metrics, and pausing it is how background downloads yield to interactive requests
+    const EBHttpRequestPriority Priority = FBHttpPriorityScope::Current();
+    httplib::ContentReceiver content_receiver = [OutputStream, Stats, Priority](const char* data, size_t data_length) {
+        BHttpRequestScheduler::Get().WaitWhilePreempted(Priority);
+        if (OutputStream)
+        {
+            OutputStream->write(data, data_length);
+        }
+        Stats->BytesReceived += data_length;
+        return true;
+    };
+    
+
+    // Progress definition for getting progress information about receiving data
+    // Runs for every read, so anything but the completion line is sampled and only evaluated when Verbose is on
+    BHttpProgressSampler ProgressSampler;
+    httplib::Progress progress_tracker;
+    progress_tracker = [&](uint64_t len, uint64_t total) {
+        if (total > 0 && len >= total)
+        {
+            UE_LOG(LogBHttpClientLib, Display, TEXT("HttpClient->Progress(Post/Put/Patch) ===> Received %lld / %lld bytes (100%% complete) - Request Url: %s%s"), len, total, *Host, *Path);
+        }
+        else if (UE_LOG_ACTIVE(LogBHttpClientLib, Verbose) && ProgressSampler.ShouldLog(len, total))
+        {
+            UE_LOG(LogBHttpClientLib, Verbose, TEXT("HttpClient->Progress(Post/Put/Patch) ===> Received %lld / %lld bytes (%d%% complete) - Request Url: %s%s"), len, total, BHttpProgressSampler::GetPercent(len, total), *Host, *Path);
+        }
+        return true; // return 'false' if you want to cancel the request.
+    };
+
+    // Storing result messages
+    int ResponseStatusCode = -1;
+
+    // If StreamSize is equal to zero, istream is empty or cannot be read
+    // Requests on their own take a pooled connection if there is one, warmed up or left by an earlier request
+    const std::string PoolKey = TCHAR_TO_UTF8(*Host);
+    std::unique_ptr<httplib::Client> OwnedClient;
+    if (!Client)
+    {
+        OwnedClient = BHttpConnectionPool::Get().Acquire(PoolKey);
+        if (!OwnedClient)
+        {
+            OwnedClient = MakeClient(Host);
+        }
+        Client = OwnedClient.get();
+    }
+    httplib::Client& normalclient = *Client;
+    normalclient.set_rate_limiters(GetRateLimiters(Host, RequestLimiter));
+    const EBHttpBatchVerb Verb = HttpMethod == EBHttpCreateUpdateMethod::Post ? EBHttpBatchVerb::Post : (HttpMethod == EBHttpCreateUpdateMethod::Put ? EBHttpBatchVerb::Put : EBHttpBatchVerb::Patch);
+    // Same clock as the phase timestamps
+    const double RequestStart = httplib::detail::timing_now();
+    if (HttpMethod == EBHttpCreateUpdateMethod::Post)
+    {
+        auto result = normalclient.Post(TCHAR_TO_UTF8(*Path), headers, params, StreamSize, std::move(content_provider), TCHAR_TO_UTF8(*ContentType), std::move(response_handler), std::move(content_receiver), std::move(progress_tracker));
+        if (result)
+        {
+            ResponseStatusCode = result->status;
+            RecordTimings(Verb, Host, Path, *result, Stats);
+        }
+    }
+    else if (HttpMethod == EBHttpCreateUpdateMethod::Put)
+    {
+        auto result = normalclient.Put(TCHAR_TO_UTF8(*Path), headers, params, StreamSize, std::move(content_provider), TCHAR_TO_UTF8(*ContentType), std::move(response_handler), std::move(content_receiver), std::move(progress_tracker));
+        if (result)
+        {
+            ResponseStatusCode = result->status;
+            RecordTimings(Verb, Host, Path, *result, Stats);
+        }
+    }
+    else if (HttpMethod == EBHttpCreateUpdateMethod::Patch)
+    {
+        auto result = normalclient.Patch(TCHAR_TO_UTF8(*Path), headers, params, StreamSize, std::move(content_provider), TCHAR_TO_UTF8(*ContentType), std::move(response_handler), std::move(content_receiver), std::move(progress_tracker));
+        if (result)
+        {
+            ResponseStatusCode = result->status;
+            RecordTimings(Verb, Host, Path, *result, Stats);
+        }
+    }
+
+    if (ResponseStatusCode == -1)
+    {
+        TraceFailedRequest(Verb, Host, Path, RequestStart);
+    }
+    BHttpMetrics::Get().RecordRequest(Verb, Host, ResponseStatusCode, httplib::detail::timing_now() - RequestStart, Stats->BytesSent, Stats->BytesReceived);
+    if (OwnedClient)
+    {
+        BHttpConnectionPool::Get().Release(PoolKey, std::move(OwnedClient));
+    }
+    
+    return ResponseStatusCode;
+}
+
+int32 BHttpClient::Post(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType, const TMap<FString, FString>& FormData)
+{
+    FString HostOnly;
+    FString PathOnly;
+    BHttpClient::SplitPath(FullPath, HostOnly, PathOnly);
+
+    return BHttpClient::Post_Or_Put_Or_Patch(EBHttpCreateUpdateMethod::Post, InputStream, OutputStream, HostOnly, PathOnly, HeadersData, ContentType, FormData);
+}
+
+int32 BHttpClient::Post(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType)
+{
+    TMap<FString, FString> FormData;
+    return BHttpClient::Post(InputStream, OutputStream, FullPath, HeadersData, ContentType, FormData);
+}
+
+int32 BHttpClient::Post(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType, const TMap<FString, FString>& FormData)
+{
+    TMap<FString, FString> HeadersData;
+    return BHttpClient::Post(InputStream, OutputStream, FullPath, HeadersData, ContentType, FormData);
+}
+
+int32 BHttpClient::Post(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType)
+{
+    TMap<FString, FString> HeadersData;
+    TMap<FString, FString> FormData;
+    return BHttpClient::Post(InputStream, OutputStream, FullPath, HeadersData, ContentType, FormData);
+}
+
+int32 BHttpClient::Put(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType, const TMap<FString, FString>& FormData)
+{
+    FString HostOnly;
+    FString PathOnly;
+    BHttpClient::SplitPath(FullPath, HostOnly, PathOnly);
+
+    return BHttpClient::Post_Or_Put_Or_Patch(EBHttpCreateUpdateMethod::Put, InputStream, OutputStream, HostOnly, PathOnly, HeadersData, ContentType, FormData);
+}
+
+int32 BHttpClient::Put(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType)
+{
+    TMap<FString, FString> FormData;
+    return BHttpClient::Put(InputStream, OutputStream, FullPath, HeadersData, ContentType, FormData);
+}
+
+int32 BHttpClient::Put(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType, const TMap<FString, FString>& FormData)
+{
+    TMap<FString, FString> HeadersData;
+    return BHttpClient::Put(InputStream, OutputStream, FullPath, HeadersData, ContentType, FormData);
+}
+
+int32 BHttpClient::Put(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType)
+{
+    TMap<FString, FString> HeadersData;
+    TMap<FString, FString> FormData;
+    return BHttpClient::Put(InputStream, OutputStream, FullPath, HeadersData, ContentType, FormData);
+}
+
+int32 BHttpClient::Patch(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType, const TMap<FString, FString>& FormData)
+{
+    FString HostOnly;
+    FString PathOnly;
+    BHttpClient::SplitPath(FullPath, HostOnly, PathOnly);
+
+    return BHttpClient::Post_Or_Put_Or_Patch(EBHttpCreateUpdateMethod::Patch, InputStream, OutputStream, HostOnly, PathOnly, HeadersData, ContentType, FormData);
+}
+
+int32 BHttpClient::Patch(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType)
+{
+    TMap<FString, FString> FormData;
+    return BHttpClient::Patch(InputStream, OutputStream, FullPath, HeadersData, ContentType, FormData);
+}
+
+int32 BHttpClient::Patch(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType, const TMap<FString, FString>& FormData)
+{
+    TMap<FString, FString> HeadersData;
+    return BHttpClient::Patch(InputStream, OutputStream, FullPath, HeadersData, ContentType, FormData);
+}
+
+int32 BHttpClient::Patch(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType)
+{
+    TMap<FString, FString> HeadersData;
+    TMap<FString, FString> FormData;
+    return BHttpClient::Patch(InputStream, OutputStream, FullPath, HeadersData, ContentType, FormData);
+}
+
+// Read-only descriptor for the File uploads, -1 if the file can't be opened
+static int32 OpenUploadFile(const FString& FilePath, uint64& OutFileSize, int64* OutModifiedTime = nullptr)
+{
+#if PLATFORM_WINDOWS
+    const int32 FileDescriptor = _wopen(*FilePath, _O_RDONLY | _O_BINARY);
+    struct _stat64 FileStat;
+    if (FileDescriptor >= 0 && _fstat64(FileDescriptor, &FileStat) != 0)
+    {
+        _close(FileDescriptor);
+        return -1;
+    }
+#else
+    const int32 FileDescriptor = open(TCHAR_TO_UTF8(*FilePath), O_RDONLY | O_CLOEXEC);
+    struct stat FileStat;
+    if (FileDescriptor >= 0 && fstat(FileDescriptor, &FileStat) != 0)
+    {
+        close(FileDescriptor);
+        return -1;
+    }
+#endif
+    if (FileDescriptor >= 0)
+    {
+        OutFileSize = static_cast<uint64>(FileStat.st_size);
+        if (OutModifiedTime)
+        {
+            *OutModifiedTime = static_cast<int64>(FileStat.st_mtime);
+        }
+    }
+    return FileDescriptor;
+}
+
+static void CloseUploadFile(int32 FileDescriptor)
+{
+#if PLATFORM_WINDOWS
+    _close(FileDescriptor);
+#else
+    close(FileDescriptor);
+#endif
+}
+
+/*
+ * Post_Or_Put_Or_Patch_File method handles file uploads, the body is read by httplib from the descriptor
+ * 
+ * */
+int32 BHttpClient::Post_Or_Put_Or_Patch_File(EBHttpCreateUpdateMethod HttpMethod, const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType, const FBHttpChecksumOptions* ChecksumOptions, FBHttpChecksums* OutChecksums)
+{
+    FString HostOnly;
+    FString PathOnly;
+    BHttpClient::SplitPath(FullPath, HostOnly, PathOnly);
+
+    uint64 FileSize = 0;
+    const int32 FileDescriptor = OpenUploadFile(FilePath, FileSize);
+    if (FileDescriptor < 0)
+    {
+        UE_LOG(LogBHttpClientLib, Error, TEXT("HttpClient->Upload ==> %s could not be opened - Request Url: %s"), *FilePath, *FullPath);
+        return -1;
+    }
+
+    int32 Result = -1;
+    int32 RetryCount = 0;
+
+    do
+    {
+        if (RetryCount > 0)
+        {
+            BHttpMetrics::Get().AddRetry();
+        }
+        // Not held across the retry sleep
+        BHttpScheduledSlot Slot(HostOnly);
+        Result = Post_Or_Put_Or_Patch_File_Internal(HttpMethod, FileDescriptor, FileSize, OutputStream, HostOnly, PathOnly, HeadersData, ContentType, ChecksumOptions, OutChecksums);
+    }
+    while (Result == -1 && RetryCount++ < 10 && SleepInternal(1.0f));
+
+    CloseUploadFile(FileDescriptor);
+    return Result;
+}
+int32 BHttpClient::Post_Or_Put_Or_Patch_File_Internal(EBHttpCreateUpdateMethod HttpMethod, int32 FileDescriptor, uint64 FileSize, std::ostream* OutputStream, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData, const FString& ContentType, const FBHttpChecksumOptions* ChecksumOptions, FBHttpChecksums* OutChecksums)
+{
+    FBHttpTransferStats Stats;
+
+    // Converting TMap Headers data to httplib::Headers as std::multimap
+    httplib::Headers headers;
+    for (const TPair<FString, FString>& Pair : HeadersData)
+    {
+        headers.emplace(std::string(TCHAR_TO_UTF8(*Pair.Key)), std::string(TCHAR_TO_UTF8(*Pair.Value)));
+    }
+
+    // Offsets are positional, a retry or redirect sends the whole file again
+    httplib::FileContent file;
+    file.fd = FileDescriptor;
+    file.length = FileSize;
+
+    // Checksums of the buffers the file is sent from, it is read once
+    std::unique_ptr<FBHttpChecksumHasher> Hasher = ChecksumOptions ? std::make_unique<FBHttpChecksumHasher>(ChecksumOptions->Algorithms) : nullptr;
+    if (Hasher)
+    {
+        file.observer = [&Hasher](uint64_t position, const char* data, size_t size) {
+            if (position == 0)
+            {
+                Hasher->Reset();
+            }
+            Hasher->Update(data, static_cast<int64>(size));
+        };
+    }
+
+    // ResponseHandler definition for handling response message after sending Post/Put/Patch requests
+    httplib::ResponseHandler response_handler;
+    response_handler = [&](const httplib::Response& response) {
+        UE_LOG(LogBHttpClientLib, Display, TEXT("HttpClient->ResponseHandler(PostFile/PutFile/PatchFile) ==> Status: %d - %s - Request Url: %s%s"), response.status, ANSI_TO_TCHAR(response.reason.c_str()), *Host, *Path);
+        return true; // return 'false' if you want to cancel the request.
+    };
+
+    // ContentReceiver definition for writing the ostream based on read data and length
+    const EBHttpRequestPriority Priority = FBHttpPriorityScope::Current();
+    httplib::ContentReceiver content_receiver = [OutputStream, &Stats, Priority](const char* data, size_t data_length) {
+        BHttpRequestScheduler::Get().WaitWhilePreempted(Priority);
+        if (OutputStream)
+        {
+            OutputStream->write(data, data_length);
+        }
+        Stats.BytesReceived += data_length;
+        return true;
+    };
+
+    // Storing result messages
+    int ResponseStatusCode = -1;
+
+    // Takes a pooled connection if there is one, warmed up or left by an earlier request
+    const std::string PoolKey = TCHAR_TO_UTF8(*Host);
+    std::unique_ptr<httplib::Client> normalclient = BHttpConnectionPool::Get().Acquire(PoolKey);
+    if (!normalclient)
+    {
+        normalclient = MakeClient(Host);
+    }
+    normalclient->set_rate_limiters(GetRateLimiters(Host, nullptr));
+    const EBHttpBatchVerb Verb = HttpMethod == EBHttpCreateUpdateMethod::Post ? EBHttpBatchVerb::Post : (HttpMethod == EBHttpCreateUpdateMethod::Put ? EBHttpBatchVerb::Put : EBHttpBatchVerb::Patch);
+    // Same clock as the phase timestamps
+    const double RequestStart = httplib::detail::timing_now();
+    httplib::Result result = HttpMethod == EBHttpCreateUpdateMethod::Post
+        ? normalclient->Post(TCHAR_TO_UTF8(*Path), headers, file, TCHAR_TO_UTF8(*ContentType), std::move(response_handler), std::move(content_receiver), nullptr)
+        : (HttpMethod == EBHttpCreateUpdateMethod::Put
+            ? normalclient->Put(TCHAR_TO_UTF8(*Path), headers, file, TCHAR_TO_UTF8(*ContentType), std::move(response_handler), std::move(content_receiver), nullptr)
+            : normalclient->Patch(TCHAR_TO_UTF8(*Path), headers, file, TCHAR_TO_UTF8(*ContentType), std::move(response_handler), std::move(content_receiver), nullptr));
+    if (result)
+    {
+        // The whole body went out once a response arrived
+        Stats.BytesSent = FileSize;
+        ResponseStatusCode = result->status;
+        RecordTimings(Verb, Host, Path, *result, &Stats);
+    }
+
+    if (Hasher && OutChecksums)
+    {
+        *OutChecksums = Hasher->Finish();
+        // What the server says it stored
+        if (ChecksumOptions->bVerify && result && ResponseStatusCode >= 200 && ResponseStatusCode < 300
+            && FBHttpChecksumHasher::Verify(*OutChecksums, result->headers, ChecksumOptions->bTrustETagAsMd5) == EBHttpChecksumMatch::Mismatched)
+        {
+            UE_LOG(LogBHttpClientLib, Error, TEXT("HttpClient->Upload ==> Checksum mismatch with %s - Sent %lld bytes - Request Url: %s%s"), *OutChecksums->CheckedHeaders, OutChecksums->Bytes, *Host, *Path);
+            ResponseStatusCode = -1;
+        }
+    }
+
+    if (ResponseStatusCode == -1)
+    {
+        TraceFailedRequest(Verb, Host, Path, RequestStart);
+    }
+    BHttpMetrics::Get().RecordRequest(Verb, Host, ResponseStatusCode, httplib::detail::timing_now() - RequestStart, Stats.BytesSent, Stats.BytesReceived);
+    // Without a response part of the file may be left unsent, the client is dropped rather than pooled
+    BHttpConnectionPool::Get().Release(PoolKey, result ? std::move(normalclient) : nullptr);
+
+    return ResponseStatusCode;
+}
+
+int32 BHttpClient::PostFile(const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType)
+{
+    return BHttpClient::Post_Or_Put_Or_Patch_File(EBHttpCreateUpdateMethod::Post, FilePath, OutputStream, FullPath, HeadersData, ContentType);
+}
+
+int32 BHttpClient::PostFile(const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType)
+{
+    TMap<FString, FString> HeadersData;
+    return BHttpClient::PostFile(FilePath, OutputStream, FullPath, HeadersData, ContentType);
+}
+
+int32 BHttpClient::PutFile(const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType)
+{
+    return BHttpClient::Post_Or_Put_Or_Patch_File(EBHttpCreateUpdateMethod::Put, FilePath, OutputStream, FullPath, HeadersData, ContentType);
+}
+
+int32 BHttpClient::PutFile(const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType)
+{
+    TMap<FString, FString> HeadersData;
+    return BHttpClient::PutFile(FilePath, OutputStream, FullPath, HeadersData, ContentType);
+}
+
+int32 BHttpClient::PatchFile(const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType)
+{
+    return BHttpClient::Post_Or_Put_Or_Patch_File(EBHttpCreateUpdateMethod::Patch, FilePath, OutputStream, FullPath, HeadersData, ContentType);
+}
+
+int32 BHttpClient::PatchFile(const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType)
+{
+    TMap<FString, FString> HeadersData;
+    return BHttpClient::PatchFile(FilePath, OutputStream, FullPath, HeadersData, ContentType);
+}
+
+int32 BHttpClient::PostFile(const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType, const FBHttpChecksumOptions& ChecksumOptions, FBHttpChecksums& OutChecksums)
+{
+    OutChecksums = FBHttpChecksums();
+    return BHttpClient::Post_Or_Put_Or_Patch_File(EBHttpCreateUpdateMethod::Post, FilePath, OutputStream, FullPath, HeadersData, ContentType, &ChecksumOptions, &OutChecksums);
+}
+
+int32 BHttpClient::PutFile(const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType, const FBHttpChecksumOptions& ChecksumOptions, FBHttpChecksums& OutChecksums)
+{
+    OutChecksums = FBHttpChecksums();
+    return BHttpClient::Post_Or_Put_Or_Patch_File(EBHttpCreateUpdateMethod::Put, FilePath, OutputStream, FullPath, HeadersData, ContentType, &ChecksumOptions, &OutChecksums);
+}
+
+int32 BHttpClient::PatchFile(const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType, const FBHttpChecksumOptions& ChecksumOptions, FBHttpChecksums& OutChecksums)
+{
+    OutChecksums = FBHttpChecksums();
+    return BHttpClient::Post_Or_Put_Or_Patch_File(EBHttpCreateUpdateMethod::Patch, FilePath, OutputStream, FullPath, HeadersData, ContentType, &ChecksumOptions, &OutChecksums);
+}
+
+/*
+ * Post_Or_Put_Or_Patch_Multipart method handles multipart uploads, httplib reads the parts while it sends the body
+ * 
+ * */
+int32 BHttpClient::Post_Or_Put_Or_Patch_Multipart(EBHttpCreateUpdateMethod HttpMethod, const TArray<FBHttpMultipartPart>& Parts, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData)
+{
+    FString HostOnly;
+    FString PathOnly;
+    BHttpClient::SplitPath(FullPath, HostOnly, PathOnly);
+
+    httplib::MultipartFormDataWriter Form;
+    TArray<int32> FileDescriptors;
+    bool bOpened = true;
+
+    for (const FBHttpMultipartPart& Part : Parts)
+    {
+        const std::string Name(TCHAR_TO_UTF8(*Part.Name));
+        const std::string FileName(TCHAR_TO_UTF8(*Part.FileName));
+        const std::string ContentType(TCHAR_TO_UTF8(*Part.ContentType));
+
+        if (!Part.FilePath.IsEmpty())
+        {
+            uint64 FileSize = 0;
+            const int32 FileDescriptor = OpenUploadFile(Part.FilePath, FileSize);
+            if (FileDescriptor < 0)
+            {
+                UE_LOG(LogBHttpClientLib, Error, TEXT("HttpClient->Upload ==> %s could not be opened - Request Url: %s"), *Part.FilePath, *FullPath);
+                bOpened = false;
+                break;
+            }
+            FileDescriptors.Add(FileDescriptor);
+
+            httplib::FileContent File;
+            File.fd = FileDescriptor;
+            File.length = FileSize;
+            Form.add(Name, File, FileName, ContentType);
+        }
+        else if (Part.Stream)
+        {
+            Form.add(Name, *Part.Stream, Part.StreamBytes, FileName, ContentType);
+        }
+        else
+        {
+            Form.add(Name, std::string(TCHAR_TO_UTF8(*Part.Value)), FileName, ContentType);
+        }
+    }
+
+    int32 Result = -1;
+    int32 RetryCount = 0;
+
+    if (bOpened)
+    {
+        do
+        {
+            if (RetryCount > 0)
+            {
+                BHttpMetrics::Get().AddRetry();
+            }
+            // Not held across the retry sleep
+            BHttpScheduledSlot Slot(HostOnly);
+            Result = Post_Or_Put_Or_Patch_Multipart_Internal(HttpMethod, Form, OutputStream, HostOnly, PathOnly, HeadersData);
+        }
+        while (Result == -1 && RetryCount++ < 10 && SleepInternal(1.0f));
+    }
+
+    for (const int32 FileDescriptor : FileDescriptors)
+    {
+        CloseUploadFile(FileDescriptor);
+    }
+    return Result;
+}
+int32 BHttpClient::Post_Or_Put_Or_Patch_Multipart_Internal(EBHttpCreateUpdateMethod HttpMethod, httplib::MultipartFormDataWriter& Form, std::ostream* OutputStream, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData)
+{
+    FBHttpTransferStats Stats;
+
+    // Converting TMap Headers data to httplib::Headers as std::multimap
+    httplib::Headers headers;
+    for (const TPair<FString, FString>& Pair : HeadersData)
+    {
+        headers.emplace(std::string(TCHAR_TO_UTF8(*Pair.Key)), std::string(TCHAR_TO_UTF8(*Pair.Value)));
+    }
+
+    // ResponseHandler definition for handling response message after sending Post/Put/Patch requests
+    httplib::ResponseHandler response_handler;
+    response_handler = [&](const httplib::Response& response) {
+        UE_LOG(LogBHttpClientLib, Display, TEXT("HttpClient->ResponseHandler(PostMultipart/PutMultipart/PatchMultipart) ==> Status: %d - %s - Request Url: %s%s"), response.status, ANSI_TO_TCHAR(response.reason.c_str()), *Host, *Path);
+        return true; // return 'false' if you want to cancel the request.
+    };
+
+    // ContentReceiver definition for writing the ostream based on read data and length
+    const EBHttpRequestPriority Priority = FBHttpPriorityScope::Current();
+    httplib::ContentReceiver content_receiver = [OutputStream, &Stats, Priority](const char* data, size_t data_length) {
+        BHttpRequestScheduler::Get().WaitWhilePreempted(Priority);
+        if (OutputStream)
+        {
+            OutputStream->write(data, data_length);
+        }
+        Stats.BytesReceived += data_length;
+        return true;
+    };
+
+    // Storing result messages
+    int ResponseStatusCode = -1;
+
+    // Takes a pooled connection if there is one, warmed up or left by an earlier request
+    const std::string PoolKey = TCHAR_TO_UTF8(*Host);
+    std::unique_ptr<httplib::Client> normalclient = BHttpConnectionPool::Get().Acquire(PoolKey);
+    if (!normalclient)
+    {
+        normalclient = MakeClient(Host);
+    }
+    normalclient->set_rate_limiters(GetRateLimiters(Host, nullptr));
+    const EBHttpBatchVerb Verb = HttpMethod == EBHttpCreateUpdateMethod::Post ? EBHttpBatchVerb::Post : (HttpMethod == EBHttpCreateUpdateMethod::Put ? EBHttpBatchVerb::Put : EBHttpBatchVerb::Patch);
+    // Same clock as the phase timestamps
+    const double RequestStart = httplib::detail::timing_now();
+    httplib::Result result = HttpMethod == EBHttpCreateUpdateMethod::Post
+        ? normalclient->Post(TCHAR_TO_UTF8(*Path), headers, Form, std::move(response_handler), std::move(content_receiver), nullptr)
+        : (HttpMethod == EBHttpCreateUpdateMethod::Put
+            ? normalclient->Put(TCHAR_TO_UTF8(*Path), headers, Form, std::move(response_handler), std::move(content_receiver), nullptr)
+            : normalclient->Patch(TCHAR_TO_UTF8(*Path), headers, Form, std::move(response_handler), std::move(content_receiver), nullptr));
+    Stats.BytesSent = Form.written();
+    if (result)
+    {
+        ResponseStatusCode = result->status;
+        RecordTimings(Verb, Host, Path, *result, &Stats);
+    }
+
+    if (ResponseStatusCode == -1)
+    {
+        TraceFailedRequest(Verb, Host, Path, RequestStart);
+    }
+    BHttpMetrics::Get().RecordRequest(Verb, Host, ResponseStatusCode, httplib::detail::timing_now() - RequestStart, Stats.BytesSent, Stats.BytesReceived);
+    // Without a response part of the form may be left unsent, the client is dropped rather than pooled
+    BHttpConnectionPool::Get().Release(PoolKey, result ? std::move(normalclient) : nullptr);
+
+    return ResponseStatusCode;
+}
+
+int32 BHttpClient::PostMultipart(const TArray<FBHttpMultipartPart>& Parts, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData)
+{
+    return BHttpClient::Post_Or_Put_Or_Patch_Multipart(EBHttpCreateUpdateMethod::Post, Parts, OutputStream, FullPath, HeadersData);
+}
+
+int32 BHttpClient::PostMultipart(const TArray<FBHttpMultipartPart>& Parts, std::ostream* OutputStream, const FString& FullPath)
+{
+    TMap<FString, FString> HeadersData;
+    return BHttpClient::PostMultipart(Parts, OutputStream, FullPath, HeadersData);
+}
+
+int32 BHttpClient::PutMultipart(const TArray<FBHttpMultipartPart>& Parts, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData)
+{
+    return BHttpClient::Post_Or_Put_Or_Patch_Multipart(EBHttpCreateUpdateMethod::Put, Parts, OutputStream, FullPath, HeadersData);
+}
+
+int32 BHttpClient::PutMultipart(const TArray<FBHttpMultipartPart>& Parts, std::ostream* OutputStream, const FString& FullPath)
+{
+    TMap<FString, FString> HeadersData;
+    return BHttpClient::PutMultipart(Parts, OutputStream, FullPath, HeadersData);
+}
+
+int32 BHttpClient::PatchMultipart(const TArray<FBHttpMultipartPart>& Parts, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData)
+{
+    return BHttpClient::Post_Or_Put_Or_Patch_Multipart(EBHttpCreateUpdateMethod::Patch, Parts, OutputStream, FullPath, HeadersData);
+}
+
+int32 BHttpClient::PatchMultipart(const TArray<FBHttpMultipartPart>& Parts, std::ostream* OutputStream, const FString& FullPath)
+{
+    TMap<FString, FString> HeadersData;
+    return BHttpClient::PatchMultipart(Parts, OutputStream, FullPath, HeadersData);
+}
+
+/*
+ * PART UPLOAD IMPLEMENTATION
+ *
+ * The file is opened once and every part is sent from its own offset of it, with sendfile where
+ * httplib can, so no part is ever copied into memory. Up to MaxConcurrency threads take the next
+ * part in file order, each attempt waits for a BHttpRequestScheduler slot and runs on a client
+ * from BHttpConnectionPool. A part that fails is sent again on its own; the upload only fails once
+ * one part ran out of retries or was refused outright, then the protocol's abort requests clean up.
+ **/
+int32 BHttpClient::ExecuteUploadRequest(const FBHttpUploadRequest& Request, int32 FileDescriptor, int64 Offset, int64 Bytes, FBHttpUploadResponse& OutResponse, uint64& InOutBytesSent)
+{
+    FString Host;
+    FString Path;
+    BHttpClient::SplitPath(Request.FullPath, Host, Path);
+    const std::string PoolKey = TCHAR_TO_UTF8(*Host);
+
+    httplib::Headers headers;
+    for (const TPair<FString, FString>& Pair : Request.HeadersData)
     {
-        content_receiver = [OutputStream](const char* data, size_t data_length) {
-            OutputStream->write(data, data_length);
-            return true;
-        };
+        headers.emplace(std::string(TCHAR_TO_UTF8(*Pair.Key)), std::string(TCHAR_TO_UTF8(*Pair.Value)));
     }
-    
 
-    // Progress definition for getting progress information about receiving data
-    httplib::Progress progress_tracker;
-    progress_tracker = [&](uint64_t len, uint64_t total) {
-		int completed_percentage = (int)(len * 100 / total);
-		if (completed_percentage >= 100)
-		{
-			UE_LOG(LogBHttpClientLib, Display, TEXT("HttpClient->Progress(Post/Put/Patch) ===> Received %lld / %lld bytes (%d%% complete) - Request Url: %s%s\n"), len, total, completed_percentage, *Host, *Path);
-		}
-        return true; // return 'false' if you want to cancel the request.
-    };
+    const std::string PathUtf8 = TCHAR_TO_UTF8(*Path);
+    const std::string ContentType = TCHAR_TO_UTF8(*Request.ContentType);
+    const char* ContentTypeOrNull = ContentType.empty() ? nullptr : ContentType.c_str();
+    const std::string Body = FileDescriptor < 0 ? std::string(TCHAR_TO_UTF8(*Request.Body)) : std::string();
 
-    // Storing result messages
-    int ResponseStatusCode = -1;
+    BHttpScheduledSlot Slot(Host);
+    std::unique_ptr<httplib::Client> Client = BHttpConnectionPool::Get().Acquire(PoolKey);
+    if (!Client)
+    {
+        Client = MakeClient(Host);
+    }
+    Client->set_rate_limiters(GetRateLimiters(Host, nullptr));
 
-    // If StreamSize is equal to zero, istream is empty or cannot be read
-    httplib::Client normalclient(TCHAR_TO_UTF8(*Host));
-    normalclient.set_keep_alive(true);
-    if (HttpMethod == EBHttpCreateUpdateMethod::Post)
+    // Same clock as the phase timestamps
+    const double RequestStart = httplib::detail::timing_now();
+    httplib::Result result(nullptr, httplib::Error::Unknown);
+    if (FileDescriptor >= 0 && Request.Verb != EBHttpBatchVerb::Get && Request.Verb != EBHttpBatchVerb::Delete)
     {
-        auto result = normalclient.Post(TCHAR_TO_UTF8(*Path), headers, params, StreamSize, content_provider, TCHAR_TO_UTF8(*ContentType), response_handler, content_receiver, progress_tracker);
-        if (result)
-        {
-            ResponseStatusCode = result->status;
-        }
+        httplib::FileContent file;
+        file.fd = FileDescriptor;
+        file.offset = static_cast<uint64>(Offset);
+        file.length = static_cast<uint64>(Bytes);
+        result = Request.Verb == EBHttpBatchVerb::Post
+            ? Client->Post(PathUtf8.c_str(), headers, file, ContentTypeOrNull, nullptr, nullptr, nullptr)
+            : (Request.Verb == EBHttpBatchVerb::Put
+                ? Client->Put(PathUtf8.c_str(), headers, file, ContentTypeOrNull, nullptr, nullptr, nullptr)
+                : Client->Patch(PathUtf8.c_str(), headers, file, ContentTypeOrNull, nullptr, nullptr, nullptr));
     }
-    else if (HttpMethod == EBHttpCreateUpdateMethod::Put)
+    else
     {
-        auto result = normalclient.Put(TCHAR_TO_UTF8(*Path), headers, params, StreamSize, content_provider, TCHAR_TO_UTF8(*ContentType), response_handler, content_receiver, progress_tracker);
-        if (result)
+        switch (Request.Verb)
         {
-            ResponseStatusCode = result->status;
+        case EBHttpBatchVerb::Get:
+            result = Client->Get(PathUtf8.c_str(), headers);
+            break;
+        case EBHttpBatchVerb::Delete:
+            result = Client->Delete(PathUtf8.c_str(), headers, Body, ContentTypeOrNull);
+            break;
+        case EBHttpBatchVerb::Post:
+            result = Client->Post(PathUtf8.c_str(), headers, Body, ContentTypeOrNull);
+            break;
+        case EBHttpBatchVerb::Put:
+            result = Client->Put(PathUtf8.c_str(), headers, Body, ContentTypeOrNull);
+            break;
+        case EBHttpBatchVerb::Patch:
+            result = Client->Patch(PathUtf8.c_str(), headers, Body, ContentTypeOrNull);
+            break;
         }
     }
-    else if (HttpMethod == EBHttpCreateUpdateMethod::Patch)
+
+    OutResponse = FBHttpUploadResponse();
+    uint64 BytesSent = 0;
+    uint64 BytesReceived = 0;
+    if (result)
     {
-        auto result = normalclient.Patch(TCHAR_TO_UTF8(*Path), headers, params, StreamSize, content_provider, TCHAR_TO_UTF8(*ContentType), response_handler, content_receiver, progress_tracker);
-        if (result)
+        // The whole body went out once a response arrived
+        BytesSent = FileDescriptor >= 0 ? static_cast<uint64>(Bytes) : Body.size();
+        BytesReceived = result->body.size();
+        OutResponse.StatusCode = result->status;
+        for (const auto& Header : result->headers)
         {
-            ResponseStatusCode = result->status;
+            OutResponse.HeadersData.Add(UTF8_TO_TCHAR(Header.first.c_str()), UTF8_TO_TCHAR(Header.second.c_str()));
         }
+        OutResponse.Body = UTF8_TO_TCHAR(result->body.c_str());
+        RecordTimings(Request.Verb, Host, Path, *result, nullptr);
     }
-    
-    return ResponseStatusCode;
+    else
+    {
+        TraceFailedRequest(Request.Verb, Host, Path, RequestStart);
+        UE_LOG(LogBHttpClientLib, Warning, TEXT("HttpClient->ExecuteUploadRequest ==> No response - Error: %d - Request Url: %s"), static_cast<int32>(result.error()), *Request.FullPath);
+    }
+    BHttpMetrics::Get().RecordRequest(Request.Verb, Host, OutResponse.StatusCode, httplib::detail::timing_now() - RequestStart, BytesSent, BytesReceived);
+    InOutBytesSent += BytesSent;
+
+    BHttpConnectionPool::Get().Release(PoolKey, std::move(Client));
+    return OutResponse.StatusCode;
 }
 
-int32 BHttpClient::Post(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType, const TMap<FString, FString>& FormData)
+// Worth sending again: no response, a timeout, throttling or a server error
+static bool IsRetryableUploadStatus(int32 StatusCode)
 {
-    FString HostOnly;
-    FString PathOnly;
-    BHttpClient::SplitPath(FullPath, HostOnly, PathOnly);
-
-    return BHttpClient::Post_Or_Put_Or_Patch(EBHttpCreateUpdateMethod::Post, InputStream, OutputStream, HostOnly, PathOnly, HeadersData, ContentType, FormData);
+    return StatusCode == -1 || StatusCode == 408 || StatusCode == 429 || StatusCode >= 500;
 }
 
-int32 BHttpClient::Post(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType)
+// Header names are case-insensitive, nullptr if missing
+static const FString* FindUploadResponseHeader(const FBHttpUploadResponse& Response, const TCHAR* Name)
 {
-    TMap<FString, FString> FormData;
-    return BHttpClient::Post(InputStream, OutputStream, FullPath, HeadersData, ContentType, FormData);
+    for (const TPair<FString, FString>& Pair : Response.HeadersData)
+    {
+        if (FCString::Stricmp(*Pair.Key, Name) == 0)
+        {
+            return &Pair.Value;
+        }
+    }
+    return nullptr;
 }
 
-int32 BHttpClient::Post(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType, const TMap<FString, FString>& FormData)
+// Retry-After in seconds, 0 if missing or an HTTP date
+static float GetRetryAfterSeconds(const FBHttpUploadResponse& Response)
 {
-    TMap<FString, FString> HeadersData;
-    return BHttpClient::Post(InputStream, OutputStream, FullPath, HeadersData, ContentType, FormData);
+    const FString* RetryAfter = FindUploadResponseHeader(Response, TEXT("Retry-After"));
+    return RetryAfter ? static_cast<float>(FMath::Clamp<int64>(FCString::Atoi64(**RetryAfter), 0, 60)) : 0.0f;
 }
 
-int32 BHttpClient::Post(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType)
+// Once each as a batch, their outcome does not change the upload's; returns the bytes sent
+static uint64 SendCleanupRequests(const TArray<FBHttpUploadRequest>& Requests, int32 MaxConcurrency, int32 MaxRetries)
 {
-    TMap<FString, FString> HeadersData;
-    TMap<FString, FString> FormData;
-    return BHttpClient::Post(InputStream, OutputStream, FullPath, HeadersData, ContentType, FormData);
+    if (Requests.Num() == 0)
+    {
+        return 0;
+    }
+
+    std::vector<std::istringstream> Bodies;
+    Bodies.reserve(Requests.Num());
+    TArray<FBHttpBatchRequest> BatchRequests;
+    for (const FBHttpUploadRequest& Request : Requests)
+    {
+        FBHttpBatchRequest BatchRequest;
+        BatchRequest.Verb = Request.Verb;
+        BatchRequest.FullPath = Request.FullPath;
+        BatchRequest.HeadersData = Request.HeadersData;
+        BatchRequest.ContentType = Request.ContentType;
+        if (!Request.Body.IsEmpty())
+        {
+            Bodies.emplace_back(std::string(TCHAR_TO_UTF8(*Request.Body)));
+            BatchRequest.InputStream = &Bodies.back();
+        }
+        BatchRequests.Add(BatchRequest);
+    }
+
+    FBHttpBatchOptions Options;
+    Options.MaxConcurrency = FMath::Max(MaxConcurrency, 1);
+    Options.MaxConcurrencyPerHost = Options.MaxConcurrency;
+    Options.MaxRetriesPerRequest = MaxRetries;
+    const FBHttpBatchResult BatchResult = BHttpClient::ExecuteBatch(BatchRequests, Options);
+    if (BatchResult.FailedCount > 0)
+    {
+        UE_LOG(LogBHttpClientLib, Warning, TEXT("HttpClient->UploadFileInParts ==> %d of %d cleanup requests failed"), BatchResult.FailedCount, Requests.Num());
+    }
+    return BatchResult.TotalBytesSent;
 }
 
-int32 BHttpClient::Put(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType, const TMap<FString, FString>& FormData)
+FBHttpPartUploadResult BHttpClient::UploadFileInParts(const FString& FilePath, IBHttpPartUploadProtocol& Protocol, const FBHttpPartUploadOptions& Options)
 {
-    FString HostOnly;
-    FString PathOnly;
-    BHttpClient::SplitPath(FullPath, HostOnly, PathOnly);
+    FBHttpPartUploadResult Result;
+    const double UploadStart = FPlatformTime::Seconds();
 
-    return BHttpClient::Post_Or_Put_Or_Patch(EBHttpCreateUpdateMethod::Put, InputStream, OutputStream, HostOnly, PathOnly, HeadersData, ContentType, FormData);
+    uint64 FileSize = 0;
+    const int32 FileDescriptor = OpenUploadFile(FilePath, FileSize);
+    if (FileDescriptor < 0)
+    {
+        UE_LOG(LogBHttpClientLib, Error, TEXT("HttpClient->UploadFileInParts ==> %s could not be opened"), *FilePath);
+        return Result;
+    }
+
+    const int64 TotalBytes = static_cast<int64>(FileSize);
+    Result.PartBytes = FMath::Max<int64>(Protocol.GetPartBytes(TotalBytes, Options.PartBytes), 1);
+    // An empty file is still one empty part
+    Result.PartCount = static_cast<int32>(FMath::Max<int64>((TotalBytes + Result.PartBytes - 1) / Result.PartBytes, 1));
+
+    const int32 MaxRetries = FMath::Max(Options.MaxRetriesPerPart, 0);
+    std::atomic<int32> PartRetries(0);
+    std::atomic<uint64> TotalBytesSent(0);
+
+    // Sends one request until Accept takes its response, a status is not worth retrying or the retries ran out
+    auto Send = [&](const FBHttpUploadRequest& Request, int32 RequestFileDescriptor, int64 Offset, int64 Bytes, const TFunction<bool(const FBHttpUploadResponse&)>& Accept, const std::atomic<bool>* bCancel, int32& OutStatusCode)
+    {
+        float Delay = FMath::Max(Options.RetryDelaySeconds, 0.0f);
+        for (int32 Attempt = 0;; Attempt++)
+        {
+            FBHttpUploadResponse Response;
+            uint64 BytesSent = 0;
+            OutStatusCode = BHttpClient::ExecuteUploadRequest(Request, RequestFileDescriptor, Offset, Bytes, Response, BytesSent);
+            TotalBytesSent += BytesSent;
+
+            if (OutStatusCode != -1 && Accept(Response))
+            {
+                return true;
+            }
+            // A 2xx the protocol refused, like S3's 200 with an error body, is worth another try
+            const bool bRetryable = IsRetryableUploadStatus(OutStatusCode) || (OutStatusCode >= 200 && OutStatusCode < 300);
+            if (!bRetryable || Attempt >= MaxRetries || (bCancel && *bCancel))
+            {
+                return false;
+            }
+
+            PartRetries++;
+            BHttpMetrics::Get().AddRetry();
+            SleepInternal(FMath::Max(Delay, GetRetryAfterSeconds(Response)));
+            Delay *= 2.0f;
+        }
+    };
+
+    bool bSucceeded = true;
+    FBHttpUploadRequest StartRequest;
+    if (Protocol.MakeStartRequest(StartRequest))
+    {
+        bSucceeded = Send(StartRequest, -1, 0, 0, [&Protocol](const FBHttpUploadResponse& Response) { return Protocol.OnStartResponse(Response); }, nullptr, Result.StatusCode);
+        if (!bSucceeded)
+        {
+            UE_LOG(LogBHttpClientLib, Error, TEXT("HttpClient->UploadFileInParts ==> Starting the upload failed - Status: %d - Request Url: %s"), Result.StatusCode, *StartRequest.FullPath);
+            CloseUploadFile(FileDescriptor);
+            Result.ElapsedSeconds = FPlatformTime::Seconds() - UploadStart;
+            return Result;
+        }
+    }
+
+    TArray<FString> PartTags;
+    PartTags.SetNum(Result.PartCount);
+
+    std::atomic<int32> NextPart(0);
+    std::atomic<bool> bPartFailed(false);
+    std::mutex FailureMutex;
+    int32 FailedPartIndex = -1;
+    int32 FailedStatusCode = -1;
+    const EBHttpRequestPriority Priority = FBHttpPriorityScope::Current();
+
+    auto Worker = [&]() {
+        FBHttpPriorityScope PriorityScope(Priority);
+        while (!bPartFailed)
+        {
+            const int32 PartIndex = NextPart++;
+            if (PartIndex >= Result.PartCount)
+            {
+                return;
+            }
+
+            const int64 Offset = PartIndex * Result.PartBytes;
+            const int64 Bytes = FMath::Min(Result.PartBytes, TotalBytes - Offset);
+            FBHttpUploadRequest PartRequest;
+            Protocol.MakePartRequest(PartIndex, Offset, Bytes, PartRequest);
+
+            FString PartTag;
+            int32 StatusCode = -1;
+            const bool bPartSent = Send(PartRequest, FileDescriptor, Offset, Bytes, [&Protocol, PartIndex, &PartTag](const FBHttpUploadResponse& Response) {
+                return Protocol.OnPartResponse(PartIndex, Response, PartTag);
+            }, &bPartFailed, StatusCode);
+
+            if (bPartSent)
+            {
+                PartTags[PartIndex] = PartTag;
+                continue;
+            }
+
+            std::lock_guard<std::mutex> Lock(FailureMutex);
+            if (!bPartFailed)
+            {
+                FailedPartIndex = PartIndex;
+                FailedStatusCode = StatusCode;
+                bPartFailed = true;
+            }
+        }
+    };
+
+    const int32 WorkerCount = FMath::Clamp(Options.MaxConcurrency, 1, Result.PartCount);
+    std::vector<std::thread> Workers;
+    Workers.reserve(WorkerCount);
+    for (int32 i = 0; i < WorkerCount; i++)
+    {
+        Workers.emplace_back(Worker);
+    }
+    for (std::thread& Thread : Workers)
+    {
+        Thread.join();
+    }
+
+    if (bPartFailed)
+    {
+        bSucceeded = false;
+        Result.StatusCode = FailedStatusCode;
+        UE_LOG(LogBHttpClientLib, Error, TEXT("HttpClient->UploadFileInParts ==> Part %d of %d failed - Status: %d - File: %s"), FailedPartIndex + 1, Result.PartCount, FailedStatusCode, *FilePath);
+    }
+    else
+    {
+        TArray<FBHttpUploadRequest> CompleteRequests;
+        Protocol.MakeCompleteRequests(PartTags, CompleteRequests);
+        for (int32 i = 0; i < CompleteRequests.Num() && bSucceeded; i++)
+        {
+            bSucceeded = Send(CompleteRequests[i], -1, 0, 0, [&Protocol, i](const FBHttpUploadResponse& Response) { return Protocol.OnCompleteResponse(i, Response); }, nullptr, Result.StatusCode);
+            if (!bSucceeded)
+            {
+                UE_LOG(LogBHttpClientLib, Error, TEXT("HttpClient->UploadFileInParts ==> Completing the upload failed - Status: %d - Request Url: %s"), Result.StatusCode, *CompleteRequests[i].FullPath);
+            }
+        }
+    }
+
+    // Parts that were uploaded before a failure still take up space until they are removed
+    TArray<FBHttpUploadRequest> CleanupRequests;
+    if (bSucceeded)
+    {
+        Protocol.MakeCleanupRequests(PartTags, CleanupRequests);
+    }
+    else
+    {
+        Protocol.MakeAbortRequests(PartTags, CleanupRequests);
+        Result.bAborted = CleanupRequests.Num() > 0;
+    }
+    TotalBytesSent += SendCleanupRequests(CleanupRequests, Options.MaxConcurrency, MaxRetries);
+
+    CloseUploadFile(FileDescriptor);
+
+    Result.bSucceeded = bSucceeded;
+    Result.PartRetries = PartRetries;
+    Result.TotalBytesSent = TotalBytesSent;
+    Result.ElapsedSeconds = FPlatformTime::Seconds() - UploadStart;
+    if (bSucceeded && Result.ElapsedSeconds > 0.0)
+    {
+        Result.BytesPerSecond = TotalBytes / Result.ElapsedSeconds;
+    }
+
+    UE_LOG(LogBHttpClientLib, Display, TEXT("HttpClient->UploadFileInParts ==> %s - Parts: %d x %lld bytes - Retries: %d - Elapsed: %.3fs - %.1f MB/s - File: %s"),
+        bSucceeded ? TEXT("Completed") : TEXT("Failed"), Result.PartCount, Result.PartBytes, Result.PartRetries, Result.ElapsedSeconds, Result.BytesPerSecond / (1024.0 * 1024.0), *FilePath);
+
+    return Result;
 }
 
-int32 BHttpClient::Put(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType)
+FBHttpPartUploadResult BHttpClient::UploadFileInParts(const FString& FilePath, IBHttpPartUploadProtocol& Protocol)
 {
-    TMap<FString, FString> FormData;
-    return BHttpClient::Put(InputStream, OutputStream, FullPath, HeadersData, ContentType, FormData);
+    FBHttpPartUploadOptions Options;
+    return BHttpClient::UploadFileInParts(FilePath, Protocol, Options);
 }
 
-int32 BHttpClient::Put(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType, const TMap<FString, FString>& FormData)
+/*
+ * RESUMABLE UPLOAD IMPLEMENTATION
+ *
+ * One session per upload: a POST opens it and returns the session URL, then the file goes up in
+ * chunks, each a PUT with "Content-Range: bytes <first>-<last>/<total>". The server answers 308 with
+ * "Range: bytes=0-<last committed>" until the last chunk, which gets the object's 200 or 201. After a
+ * failed chunk a PUT without a body and with "bytes *" in place of the range asks for the committed offset,
+ * so only what the server lost is sent again, never the whole file. Non-final chunks are multiples of
+ * 256 KB, a server commits nothing finer anyway.
+ *
+ * The state file holds the session, so another process can pick it up: it is written before the
+ * first chunk, kept while the upload can still be resumed, and removed once the object exists.
+ **/
+static constexpr int64 ResumableChunkGranularity = 256ll * 1024;
+
+struct FBHttpResumableUploadState
 {
-    TMap<FString, FString> HeadersData;
-    return BHttpClient::Put(InputStream, OutputStream, FullPath, HeadersData, ContentType, FormData);
-}
+    FString StartUrl;
+    FString SessionUrl;
+    int64 FileBytes = 0;
+    int64 ModifiedTime = 0;
+};
 
-int32 BHttpClient::Put(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType)
+// "key=value" lines, false if missing, unreadable or from another version
+static bool LoadResumableUploadState(const FString& StatePath, FBHttpResumableUploadState& OutState)
 {
-    TMap<FString, FString> HeadersData;
-    TMap<FString, FString> FormData;
-    return BHttpClient::Put(InputStream, OutputStream, FullPath, HeadersData, ContentType, FormData);
+    std::ifstream File(TCHAR_TO_UTF8(*StatePath), std::ios::binary);
+    if (!File)
+    {
+        return false;
+    }
+
+    bool bVersionMatches = false;
+    std::string Line;
+    while (std::getline(File, Line))
+    {
+        const size_t Equals = Line.find('=');
+        if (Equals == std::string::npos)
+        {
+            continue;
+        }
+        const std::string Key = Line.substr(0, Equals);
+        const std::string Value = Line.substr(Equals + 1);
+        if (Key == "version")
+        {
+            bVersionMatches = Value == "1";
+        }
+        else if (Key == "start")
+        {
+            OutState.StartUrl = UTF8_TO_TCHAR(Value.c_str());
+        }
+        else if (Key == "session")
+        {
+            OutState.SessionUrl = UTF8_TO_TCHAR(Value.c_str());
+        }
+        else if (Key == "size")
+        {
+            OutState.FileBytes = std::strtoll(Value.c_str(), nullptr, 10);
+        }
+        else if (Key == "mtime")
+        {
+            OutState.ModifiedTime = std::strtoll(Value.c_str(), nullptr, 10);
+        }
+    }
+    return bVersionMatches && !OutState.SessionUrl.IsEmpty();
 }
 
-int32 BHttpClient::Patch(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType, const TMap<FString, FString>& FormData)
+// Written next to StatePath and renamed over it, a crash leaves the old state or the new one
+static bool SaveResumableUploadState(const FString& StatePath, const FBHttpResumableUploadState& State)
 {
-    FString HostOnly;
-    FString PathOnly;
-    BHttpClient::SplitPath(FullPath, HostOnly, PathOnly);
+    const FString TempPath = StatePath + TEXT(".tmp");
+    {
+        std::ofstream File(TCHAR_TO_UTF8(*TempPath), std::ios::binary | std::ios::trunc);
+        if (!File)
+        {
+            UE_LOG(LogBHttpClientLib, Warning, TEXT("HttpClient->UploadFileResumable ==> %s could not be written"), *TempPath);
+            return false;
+        }
+        File << "version=1\n"
+            << "start=" << TCHAR_TO_UTF8(*State.StartUrl) << "\n"
+            << "session=" << TCHAR_TO_UTF8(*State.SessionUrl) << "\n"
+            << "size=" << State.FileBytes << "\n"
+            << "mtime=" << State.ModifiedTime << "\n";
+        File.flush();
+        if (!File)
+        {
+            return false;
+        }
+    }
 
-    return BHttpClient::Post_Or_Put_Or_Patch(EBHttpCreateUpdateMethod::Patch, InputStream, OutputStream, HostOnly, PathOnly, HeadersData, ContentType, FormData);
+#if PLATFORM_WINDOWS
+    const bool bSucceed = MoveFileExW(*TempPath, *StatePath, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    const bool bSucceed = std::rename(TCHAR_TO_UTF8(*TempPath), TCHAR_TO_UTF8(*StatePath)) == 0;
+#endif
+    if (!bSucceed)
+    {
+        UE_LOG(LogBHttpClientLib, Warning, TEXT("HttpClient->UploadFileResumable ==> %s could not be moved to %s"), *TempPath, *StatePath);
+    }
+    return bSucceed;
 }
 
-int32 BHttpClient::Patch(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType)
+static void RemoveResumableUploadState(const FString& StatePath)
 {
-    TMap<FString, FString> FormData;
-    return BHttpClient::Patch(InputStream, OutputStream, FullPath, HeadersData, ContentType, FormData);
+#if PLATFORM_WINDOWS
+    _wremove(*StatePath);
+#else
+    std::remove(TCHAR_TO_UTF8(*StatePath));
+#endif
 }
 
-int32 BHttpClient::Patch(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType, const TMap<FString, FString>& FormData)
+// From the Range header of a 308, "bytes=0-<last>"; nothing is committed without one
+static int64 GetCommittedBytes(const FBHttpUploadResponse& Response)
 {
-    TMap<FString, FString> HeadersData;
-    return BHttpClient::Patch(InputStream, OutputStream, FullPath, HeadersData, ContentType, FormData);
+    const FString* Range = FindUploadResponseHeader(Response, TEXT("Range"));
+    int32 Dash = INDEX_NONE;
+    if (!Range || !Range->FindChar(TEXT('-'), Dash))
+    {
+        return 0;
+    }
+    return FCString::Atoi64(*Range->Mid(Dash + 1)) + 1;
 }
 
-int32 BHttpClient::Patch(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType)
+FBHttpResumableUploadResult BHttpClient::UploadFileResumable(const FString& FilePath, const FString& StartUrl, const TMap<FString, FString>& HeadersData, const FBHttpResumableUploadOptions& Options, std::ostream* OutputStream)
 {
-    TMap<FString, FString> HeadersData;
-    TMap<FString, FString> FormData;
-    return BHttpClient::Patch(InputStream, OutputStream, FullPath, HeadersData, ContentType, FormData);
+    FBHttpResumableUploadResult Result;
+    const double UploadStart = FPlatformTime::Seconds();
+
+    uint64 FileSize = 0;
+    int64 ModifiedTime = 0;
+    const int32 FileDescriptor = OpenUploadFile(FilePath, FileSize, &ModifiedTime);
+    if (FileDescriptor < 0)
+    {
+        UE_LOG(LogBHttpClientLib, Error, TEXT("HttpClient->UploadFileResumable ==> File could not be opened: %s"), *FilePath);
+        return Result;
+    }
+    const int64 TotalBytes = static_cast<int64>(FileSize);
+    const int64 ChunkBytes = FMath::Max<int64>(
+        (Options.ChunkBytes + ResumableChunkGranularity - 1) / ResumableChunkGranularity * ResumableChunkGranularity, ResumableChunkGranularity);
+    const bool bKeepsState = !Options.StateFilePath.IsEmpty();
+
+    FBHttpResumableUploadState State;
+    State.StartUrl = StartUrl;
+    State.FileBytes = TotalBytes;
+    State.ModifiedTime = ModifiedTime;
+
+    // A session of another file, or of this one before it changed, is of no use
+    FBHttpResumableUploadState SavedState;
+    if (bKeepsState && LoadResumableUploadState(Options.StateFilePath, SavedState))
+    {
+        if (SavedState.StartUrl == StartUrl && SavedState.FileBytes == TotalBytes && SavedState.ModifiedTime == ModifiedTime)
+        {
+            Result.SessionUrl = SavedState.SessionUrl;
+            Result.bResumed = true;
+        }
+        else
+        {
+            UE_LOG(LogBHttpClientLib, Display, TEXT("HttpClient->UploadFileResumable ==> Saved session is for another upload, starting a new one - State: %s"), *Options.StateFilePath);
+        }
+    }
+
+    const int32 MaxRetries = FMath::Max(Options.MaxRetriesWithoutProgress, 0);
+    const float MaxDelay = Options.RetryDelaySeconds * 32.0f;
+    int32 FailuresInRow = 0;
+    float Delay = Options.RetryDelaySeconds;
+    FBHttpUploadResponse Response;
+
+    // Waits before the next attempt, false once the retries without progress ran out
+    auto BackOff = [&]() -> bool
+    {
+        if (FailuresInRow++ >= MaxRetries)
+        {
+            return false;
+        }
+        ++Result.Retries;
+        BHttpMetrics::Get().AddRetry();
+        SleepInternal(FMath::Max(Delay, GetRetryAfterSeconds(Response)));
+        Delay = FMath::Min(Delay * 2.0f, MaxDelay);
+        return true;
+    };
+
+    auto StartSession = [&]() -> bool
+    {
+        FBHttpUploadRequest Request;
+        Request.Verb = EBHttpBatchVerb::Post;
+        Request.FullPath = StartUrl;
+        Request.HeadersData = HeadersData;
+        Request.HeadersData.Add(TEXT("X-Upload-Content-Type"), Options.ContentType);
+        Request.HeadersData.Add(TEXT("X-Upload-Content-Length"), FString::Printf(TEXT("%lld"), TotalBytes));
+        // The JSON API says so in the query, the XML API in a header, which also takes the object's type
+        if (!StartUrl.Contains(TEXT("uploadType=resumable")))
+        {
+            Request.HeadersData.Add(TEXT("x-goog-resumable"), TEXT("start"));
+            Request.ContentType = Options.ContentType;
+        }
+
+        for (;;)
+        {
+            Result.StatusCode = ExecuteUploadRequest(Request, -1, 0, 0, Response, Result.BytesSent);
+            const FString* Location = FindUploadResponseHeader(Response, TEXT("Location"));
+            if (Result.StatusCode >= 200 && Result.StatusCode < 300 && Location && !Location->IsEmpty())
+            {
+                Result.SessionUrl = *Location;
+                State.SessionUrl = *Location;
+                if (bKeepsState)
+                {
+                    SaveResumableUploadState(Options.StateFilePath, State);
+                }
+                return true;
+            }
+            if (!IsRetryableUploadStatus(Result.StatusCode) || !BackOff())
+            {
+                UE_LOG(LogBHttpClientLib, Error, TEXT("HttpClient->UploadFileResumable ==> Session could not be started - Status: %d - Body: %s - Request Url: %s"), Result.StatusCode, *Response.Body, *StartUrl);
+                return false;
+            }
+        }
+    };
+
+    bool bSucceeded = Result.bResumed || StartSession();
+    // A saved session may be ahead of anything this process knows, so it starts with a query
+    bool bQuery = Result.bResumed;
+    bool bFirstResponse = true;
+    int64 Offset = 0;
+    while (bSucceeded)
+    {
+        FBHttpUploadRequest Request;
+        Request.Verb = EBHttpBatchVerb::Put;
+        Request.FullPath = Result.SessionUrl;
+        Request.HeadersData = HeadersData;
+        int64 Bytes = 0;
+        if (bQuery)
+        {
+            Request.HeadersData.Add(TEXT("Content-Range"), FString::Printf(TEXT("bytes */%lld"), TotalBytes));
+            Result.StatusCode = ExecuteUploadRequest(Request, -1, 0, 0, Response, Result.BytesSent);
+        }
+        else
+        {
+            Bytes = FMath::Min(ChunkBytes, TotalBytes - Offset);
+            Request.HeadersData.Add(TEXT("Content-Range"), Bytes > 0
+                ? FString::Printf(TEXT("bytes %lld-%lld/%lld"), Offset, Offset + Bytes - 1, TotalBytes)
+                : FString::Printf(TEXT("bytes */%lld"), TotalBytes));
+            Result.StatusCode = ExecuteUploadRequest(Request, FileDescriptor, Offset, Bytes, Response, Result.BytesSent);
+            ++Result.Chunks;
+        }
+
+        const int32 StatusCode = Result.StatusCode;
+        if (StatusCode == 200 || StatusCode == 201)
+        {
+            if (bFirstResponse && Result.bResumed)
+            {
+                Result.ResumedFromBytes = TotalBytes;
+            }
+            if (OutputStream)
+            {
+                (*OutputStream) << TCHAR_TO_UTF8(*Response.Body);
+            }
+            break;
+        }
+        if (StatusCode == 308)
+        {
+            const int64 Committed = FMath::Min(GetCommittedBytes(Response), TotalBytes);
+            if (bFirstResponse && Result.bResumed)
+            {
+                Result.ResumedFromBytes = Committed;
+            }
+            bFirstResponse = false;
+            // A chunk the server did not take, not even in part, counts as a failure
+            if (Committed > Offset || bQuery)
+            {
+                if (Committed > Offset)
+                {
+                    FailuresInRow = 0;
+                    Delay = Options.RetryDelaySeconds;
+                }
+                Offset = Committed;
+                bQuery = false;
+                continue;
+            }
+            Offset = Committed;
+            if (!BackOff())
+            {
+                UE_LOG(LogBHttpClientLib, Error, TEXT("HttpClient->UploadFileResumable ==> No progress at offset %lld of %lld - Session: %s"), Offset, TotalBytes, *Result.SessionUrl);
+                bSucceeded = false;
+            }
+            continue;
+        }
+        bFirstResponse = false;
+
+        // The session expired or was cancelled: what it committed is lost, a new one starts over once
+        if ((StatusCode == 404 || StatusCode == 410) && !Result.bRestarted)
+        {
+            UE_LOG(LogBHttpClientLib, Warning, TEXT("HttpClient->UploadFileResumable ==> Session is gone (%d), starting a new one - Session: %s"), StatusCode, *Result.SessionUrl);
+            Result.bRestarted = true;
+            Offset = 0;
+            bQuery = false;
+            bSucceeded = StartSession();
+            continue;
+        }
+
+        // The server may have committed part of the chunk before the failure, asking is cheaper than resending it
+        if (!IsRetryableUploadStatus(StatusCode) || !BackOff())
+        {
+            UE_LOG(LogBHttpClientLib, Error, TEXT("HttpClient->UploadFileResumable ==> Failed at offset %lld of %lld - Status: %d - Body: %s - Session: %s"), Offset, TotalBytes, StatusCode, *Response.Body, *Result.SessionUrl);
+            bSucceeded = false;
+            break;
+        }
+        bQuery = true;
+    }
+
+    CloseUploadFile(FileDescriptor);
+
+    // The state stays behind after a failure, unless the session it holds is gone
+    if (bKeepsState && (bSucceeded || Result.StatusCode == 404 || Result.StatusCode == 410))
+    {
+        RemoveResumableUploadState(Options.StateFilePath);
+    }
+
+    Result.bSucceeded = bSucceeded;
+    Result.ElapsedSeconds = FPlatformTime::Seconds() - UploadStart;
+    if (bSucceeded && Result.ElapsedSeconds > 0.0)
+    {
+        Result.BytesPerSecond = (TotalBytes - Result.ResumedFromBytes) / Result.ElapsedSeconds;
+    }
+
+    UE_LOG(LogBHttpClientLib, Display, TEXT("HttpClient->UploadFileResumable ==> %s - %s at %lld - Chunks: %d x %lld bytes - Retries: %d - Elapsed: %.3fs - %.1f MB/s - File: %s"),
+        bSucceeded ? TEXT("Completed") : TEXT("Failed"), Result.bResumed ? TEXT("Resumed") : TEXT("Started"), Result.ResumedFromBytes, Result.Chunks, ChunkBytes,
+        Result.Retries, Result.ElapsedSeconds, Result.BytesPerSecond / (1024.0 * 1024.0), *FilePath);
+
+    return Result;
+}
+
+FBHttpResumableUploadResult BHttpClient::UploadFileResumable(const FString& FilePath, const FString& StartUrl, const TMap<FString, FString>& HeadersData)
+{
+    FBHttpResumableUploadOptions Options;
+    return BHttpClient::UploadFileResumable(FilePath, StartUrl, HeadersData, Options);
 }
 
 bool BHttpClient::SleepInternal(float InSeconds)
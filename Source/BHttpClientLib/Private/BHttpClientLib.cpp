@@ -3,11 +3,17 @@
 #include "BHttpClientLib.h"
 #include "BLambdaRunnable.h"
 #include "BHttpClient.h"
+#include "BHttpConnectionPool.h"
 #include "BQueueStream.h"
 #include <fstream>
 
 void FBHttpClientLibModule::StartupModule()
 {
 }
+
+void FBHttpClientLibModule::ShutdownModule()
+{
+	BHttpConnectionPool::Get().Shutdown();
+}
 	
 IMPLEMENT_MODULE(FBHttpClientLibModule, BHttpClientLib)
@@ -0,0 +1,332 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#include "BHttpConnectionPool.h"
+#include "BHttpMetrics.h"
+
+BHttpConnectionPool& BHttpConnectionPool::Get()
+{
+    static BHttpConnectionPool Instance;
+    return Instance;
+}
+
+BHttpConnectionPool::~BHttpConnectionPool()
+{
+    // Normally done by ShutdownModule already, joining here runs at static destruction
+    Shutdown();
+}
+
+std::unique_ptr<httplib::Client> BHttpConnectionPool::Acquire(const std::string& Host)
+{
+    // Expired clients are destroyed outside the lock, closing a TLS connection takes a while
+    std::vector<FIdleClient> Expired;
+    std::unique_ptr<httplib::Client> Client;
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+
+        auto It = IdleClients.find(Host);
+        if (It == IdleClients.end())
+        {
+            BHttpMetrics::Get().AddPoolLookup(false);
+            return nullptr;
+        }
+
+        const double Now = FPlatformTime::Seconds();
+        auto& Idle = It->second;
+        while (!Idle.empty())
+        {
+            FIdleClient Candidate = std::move(Idle.back());
+            Idle.pop_back();
+
+            if (Now - Candidate.ReleasedAt < IdleTimeoutSeconds && Candidate.Client->is_socket_open())
+            {
+                Client = std::move(Candidate.Client);
+                CheckedOut[Host]++;
+                break;
+            }
+            Expired.push_back(std::move(Candidate));
+        }
+    }
+    BHttpMetrics::Get().AddPoolLookup(Client != nullptr);
+    return Client;
+}
+
+void BHttpConnectionPool::Release(const std::string& Host, std::unique_ptr<httplib::Client> Client)
+{
+    const bool bOpen = Client && Client->is_socket_open();
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    // Clients made after a miss come back too, the count errs towards a spare warm connection
+    auto Out = CheckedOut.find(Host);
+    if (Out != CheckedOut.end() && Out->second > 0)
+    {
+        Out->second--;
+    }
+
+    if (!bOpen)
+    {
+        return;
+    }
+
+    auto& Idle = IdleClients[Host];
+    if ((int32)Idle.size() >= MaxIdlePerHost)
+    {
+        return;
+    }
+
+    FIdleClient Entry;
+    Entry.Client = std::move(Client);
+    Entry.ReleasedAt = FPlatformTime::Seconds();
+    Idle.push_back(std::move(Entry));
+    IdleChanged.notify_all();
+}
+
+void BHttpConnectionPool::Empty()
+{
+    std::map<std::string, std::vector<FIdleClient>> Removed;
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Removed.swap(IdleClients);
+    }
+}
+
+void BHttpConnectionPool::Shutdown()
+{
+    std::thread Stopped;
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        bStopping = true;
+        WarmHosts.clear();
+        Stopped.swap(Keeper);
+    }
+    KeeperWakeUp.notify_all();
+    if (Stopped.joinable())
+    {
+        Stopped.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        bStopping = false;
+    }
+    Empty();
+}
+
+void BHttpConnectionPool::SetMaxIdlePerHost(int32 InMaxIdlePerHost)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    MaxIdlePerHost = InMaxIdlePerHost > 0 ? InMaxIdlePerHost : 0;
+}
+
+void BHttpConnectionPool::SetIdleTimeout(double InSeconds)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    IdleTimeoutSeconds = InSeconds;
+}
+
+void BHttpConnectionPool::KeepWarm(const std::string& Host, const FWarmHost& Options)
+{
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        if (Options.Connections <= 0 || !Options.MakeClient)
+        {
+            // Woken up below, the thread exits once it sees no host is left
+            WarmHosts.erase(Host);
+        }
+        else if (!bStopping)
+        {
+            FWarmState& State = WarmHosts[Host];
+            State.Options = Options;
+            State.RetryAt = 0.0;
+            State.RetryDelaySeconds = 0.0;
+
+            if (!bKeeperRunning)
+            {
+                // Past the point where it exits, this join doesn't wait for anything
+                if (Keeper.joinable())
+                {
+                    Keeper.join();
+                }
+                bKeeperRunning = true;
+                Keeper = std::thread([this]() { KeeperLoop(); });
+            }
+        }
+    }
+    KeeperWakeUp.notify_all();
+}
+
+int32 BHttpConnectionPool::GetIdleCount(const std::string& Host)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    auto It = IdleClients.find(Host);
+    return It == IdleClients.end() ? 0 : (int32)It->second.size();
+}
+
+bool BHttpConnectionPool::WaitForIdle(const std::string& Host, int32 Count, double Seconds)
+{
+    std::unique_lock<std::mutex> Lock(Mutex);
+    return IdleChanged.wait_for(Lock, std::chrono::duration<double>(Seconds), [this, &Host, Count]()
+        {
+            auto It = IdleClients.find(Host);
+            return It != IdleClients.end() && (int32)It->second.size() >= Count;
+        });
+}
+
+void BHttpConnectionPool::KeeperLoop()
+{
+    // One job per connection to open (Client empty) or to ping
+    struct FJob
+    {
+        std::string Host;
+        std::unique_ptr<httplib::Client> Client;
+        bool bPing = false;
+        bool bOpened = false;
+    };
+
+    std::unique_lock<std::mutex> Lock(Mutex);
+    while (!bStopping && !WarmHosts.empty())
+    {
+        const double Now = FPlatformTime::Seconds();
+        double NextTick = Now + 1.0;
+
+        std::vector<FJob> Jobs;
+        std::vector<FIdleClient> Expired;
+        std::map<std::string, FWarmHost> Options;
+        for (auto& Pair : WarmHosts)
+        {
+            FWarmState& State = Pair.second;
+            Options[Pair.first] = State.Options;
+            auto& Idle = IdleClients[Pair.first];
+
+            // The newest clients are the ones requests take, older ones beyond Connections age out unpinged
+            std::vector<FIdleClient> Kept;
+            for (size_t i = Idle.size(); i-- > 0;)
+            {
+                FIdleClient& Entry = Idle[i];
+                if (Now - Entry.ReleasedAt >= IdleTimeoutSeconds || !Entry.Client->is_socket_open())
+                {
+                    Expired.push_back(std::move(Entry));
+                    continue;
+                }
+                if ((int32)Kept.size() < State.Options.Connections && !State.Options.PingPath.empty()
+                    && Now - Entry.ReleasedAt >= State.Options.PingIntervalSeconds)
+                {
+                    FJob Job;
+                    Job.Host = Pair.first;
+                    Job.Client = std::move(Entry.Client);
+                    Job.bPing = true;
+                    Jobs.push_back(std::move(Job));
+                    Kept.emplace_back();
+                    continue;
+                }
+                if ((int32)Kept.size() < State.Options.Connections && !State.Options.PingPath.empty())
+                {
+                    NextTick = FMath::Min(NextTick, Entry.ReleasedAt + State.Options.PingIntervalSeconds);
+                }
+                Kept.push_back(std::move(Entry));
+            }
+            Idle.clear();
+            for (size_t i = Kept.size(); i-- > 0;)
+            {
+                if (Kept[i].Client)
+                {
+                    Idle.push_back(std::move(Kept[i]));
+                }
+            }
+
+            const auto Out = CheckedOut.find(Pair.first);
+            const int32 Missing = FMath::Min(State.Options.Connections, MaxIdlePerHost) - (int32)Kept.size() - (Out != CheckedOut.end() ? Out->second : 0);
+            if (Missing > 0 && Now >= State.RetryAt)
+            {
+                for (int32 i = 0; i < Missing; i++)
+                {
+                    FJob Job;
+                    Job.Host = Pair.first;
+                    Jobs.push_back(std::move(Job));
+                }
+            }
+        }
+        Lock.unlock();
+
+        // In parallel, a host that stalls its handshakes should not hold back the others
+        std::vector<std::thread> Workers;
+        for (FJob& Job : Jobs)
+        {
+            Workers.emplace_back([&Job, &Options]()
+                {
+                    const FWarmHost& Warm = Options.at(Job.Host);
+                    if (Job.bPing)
+                    {
+                        auto Result = Job.Client->Head(Warm.PingPath.c_str());
+                        if (!Result)
+                        {
+                            Job.Client.reset();
+                        }
+                        return;
+                    }
+                    Job.Client = Warm.MakeClient();
+                    Job.bOpened = Job.Client && Job.Client->open_connection();
+                    if (!Job.bOpened)
+                    {
+                        Job.Client.reset();
+                    }
+                });
+        }
+        for (std::thread& Worker : Workers)
+        {
+            Worker.join();
+        }
+        Expired.clear();
+
+        // Per host, whether its connects failed; hosts that only had pings are not in it
+        std::map<std::string, bool> ConnectFailed;
+        for (FJob& Job : Jobs)
+        {
+            if (!Job.bPing)
+            {
+                ConnectFailed[Job.Host] |= !Job.bOpened;
+            }
+        }
+
+        Lock.lock();
+        const double AfterJobs = FPlatformTime::Seconds();
+
+        // As Release does, without counting them as returned by a request
+        bool bLeftOver = false;
+        for (FJob& Job : Jobs)
+        {
+            auto& Idle = IdleClients[Job.Host];
+            if (Job.Client && Job.Client->is_socket_open() && (int32)Idle.size() < MaxIdlePerHost)
+            {
+                FIdleClient Entry;
+                Entry.Client = std::move(Job.Client);
+                Entry.ReleasedAt = AfterJobs;
+                Idle.push_back(std::move(Entry));
+            }
+            bLeftOver |= Job.Client != nullptr;
+        }
+        IdleChanged.notify_all();
+        if (bLeftOver)
+        {
+            Lock.unlock();
+            Jobs.clear();
+            Lock.lock();
+        }
+        for (const auto& Pair : ConnectFailed)
+        {
+            auto It = WarmHosts.find(Pair.first);
+            if (It == WarmHosts.end())
+            {
+                continue;
+            }
+            FWarmState& State = It->second;
+            State.RetryDelaySeconds = Pair.second ? FMath::Min(FMath::Max(State.RetryDelaySeconds * 2.0, 1.0), 60.0) : 0.0;
+            State.RetryAt = Pair.second ? AfterJobs + State.RetryDelaySeconds : 0.0;
+        }
+
+        // Also after jobs, a server that closes every new connection right away is tried once per tick
+        KeeperWakeUp.wait_for(Lock, std::chrono::duration<double>(FMath::Max(NextTick - AfterJobs, 0.01)));
+    }
+    bKeeperRunning = false;
+}
@@ -0,0 +1,124 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BHttpClientUtils.h"
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Idle keep-alive clients per host, so consecutive requests to the same host skip the TCP and TLS
+ * handshakes. A client belongs to exactly one request while it is checked out.
+ *
+ * Hosts given to KeepWarm get their connections opened before the first request, and kept open by a
+ * background thread: it replaces closed ones and pings the idle ones, below the idle timeout. The
+ * thread runs while there are warm hosts, Shutdown stops it for good before the module goes away.
+ *
+ * */
+class BHttpConnectionPool
+{
+public:
+    // How KeepWarm looks after a host
+    struct FWarmHost
+    {
+        // Idle clients kept open
+        int32 Connections = 0;
+        // HEAD request sent on clients idle for PingIntervalSeconds, so the server doesn't close them; empty for none
+        std::string PingPath;
+        double PingIntervalSeconds = 3.0;
+        // Makes a client of the host, configured the way requests want it
+        std::function<std::unique_ptr<httplib::Client>()> MakeClient;
+    };
+
+    static BHttpConnectionPool& Get();
+
+    ~BHttpConnectionPool();
+
+    //************************************
+    // Method:    Acquire takes the most recently used idle client for Host
+    // FullName:  BHttpConnectionPool::Acquire
+    // Access:    public
+    // Returns:   std::unique_ptr<httplib::Client> nullptr if Host has no idle client, caller creates one
+    // Qualifier:
+    // Parameter: const std::string & Host (scheme://host[:port] as produced by BHttpClient::SplitPath)
+    //************************************
+    std::unique_ptr<httplib::Client> Acquire(const std::string& Host);
+
+    //************************************
+    // Method:    Release hands a client back, clients with a closed socket or over the idle limit are destroyed
+    // FullName:  BHttpConnectionPool::Release
+    // Access:    public
+    // Returns:   void
+    // Qualifier:
+    // Parameter: const std::string & Host
+    // Parameter: std::unique_ptr<httplib::Client> Client
+    //************************************
+    void Release(const std::string& Host, std::unique_ptr<httplib::Client> Client);
+
+    void Empty();
+
+    // Stops the warm up thread and waits for it, then empties the pool; KeepWarm starts over afterwards
+    void Shutdown();
+
+    //************************************
+    // Method:    KeepWarm opens Options.Connections clients of Host on the background thread and keeps that many idle from then on
+    // FullName:  BHttpConnectionPool::KeepWarm
+    // Access:    public
+    // Returns:   void
+    // Qualifier:
+    // Parameter: const std::string & Host
+    // Parameter: const FWarmHost & Options (Connections 0 stops looking after the host, its clients age out as any)
+    //************************************
+    void KeepWarm(const std::string& Host, const FWarmHost& Options);
+
+    int32 GetIdleCount(const std::string& Host);
+
+    // Blocks until Host has Count idle clients or Seconds passed, false on the timeout
+    bool WaitForIdle(const std::string& Host, int32 Count, double Seconds);
+
+    void SetMaxIdlePerHost(int32 InMaxIdlePerHost);
+
+    // Servers commonly drop idle keep-alive connections after 5 seconds, stay below that
+    void SetIdleTimeout(double InSeconds);
+
+private:
+    struct FIdleClient
+    {
+        std::unique_ptr<httplib::Client> Client;
+        double ReleasedAt = 0.0;
+    };
+
+    struct FWarmState
+    {
+        FWarmHost Options;
+        // Failed connects are tried again after RetryDelaySeconds, which doubles up to a minute
+        double RetryAt = 0.0;
+        double RetryDelaySeconds = 0.0;
+    };
+
+    // Opens what warm hosts miss and pings their idle clients, until bStopping or no host is left
+    void KeeperLoop();
+
+    std::mutex Mutex;
+    std::map<std::string, std::vector<FIdleClient>> IdleClients;
+    // Pooled clients handed out and not released yet, a warm host only needs idle ones for the rest
+    std::map<std::string, int32> CheckedOut;
+
+    std::map<std::string, FWarmState> WarmHosts;
+    std::thread Keeper;
+    // Cleared by the thread as it exits, under Mutex, a finished Keeper is joined before the next one starts
+    bool bKeeperRunning = false;
+    std::condition_variable KeeperWakeUp;
+    std::condition_variable IdleChanged;
+    bool bStopping = false;
+
+    int32 MaxIdlePerHost = 16;
+    double IdleTimeoutSeconds = 4.0;
+};
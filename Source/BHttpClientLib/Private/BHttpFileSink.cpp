@@ -0,0 +1,364 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#include "BHttpFileSink.h"
+#include "BHttpClient.h"
+#include "BHttpClientUtils.h"
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#if PLATFORM_WINDOWS
+#include <io.h>
+#include "Windows/WindowsHWrapper.h"
+#else
+#include <unistd.h>
+#endif
+#if PLATFORM_LINUX
+#include <sys/mman.h>
+#endif
+
+// Bodies without Content-Length reserve at least this much at a time, then as much as they already got
+static constexpr int64 MinExtentBytes = 64ll * 1024 * 1024;
+// Also the largest mapping, a view holds at most MAX_int32 bytes
+static constexpr int64 MaxExtentBytes = 1024ll * 1024 * 1024;
+// Small enough to stay in cache between the socket read and the write, measured faster than 64 KB and 1 MB
+static constexpr int64 StagingBytes = 256ll * 1024;
+
+BHttpFileSink::BHttpFileSink(const FString& InFilePath, bool bInMapFile, bool bInUseIoUring)
+    : FilePath(InFilePath)
+    , PartPath(InFilePath + TEXT(".part"))
+    , bMapFile(bInMapFile)
+    , bUseIoUring(bInUseIoUring && !bInMapFile)
+{
+}
+
+BHttpFileSink::~BHttpFileSink()
+{
+    Abort();
+}
+
+bool BHttpFileSink::Open()
+{
+    Abort();
+#if PLATFORM_WINDOWS
+    FileDescriptor = _wopen(*PartPath, _O_RDWR | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    FileDescriptor = open(TCHAR_TO_UTF8(*PartPath), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+    ReservedBytes = 0;
+    bCanMap = bMapFile;
+    bPartFileExists = FileDescriptor >= 0;
+    if (bPartFileExists && bUseIoUring)
+    {
+        AcquireRingSlots();
+    }
+    return bPartFileExists;
+}
+
+TArrayView<uint8> BHttpFileSink::NextSpan(int64 ContentLength, int64 ReceivedBytes)
+{
+    // A retry starts the body over, whatever the last attempt wrote gets overwritten
+    if (FileDescriptor < 0 || !FinishWindow(ReceivedBytes))
+    {
+        return TArrayView<uint8>();
+    }
+
+    // Content-Length is reserved at once; without one, or past it (decompressed bodies), the file grows geometrically
+    const int64 EndOffset = ContentLength > ReceivedBytes
+        ? ContentLength
+        : ReceivedBytes + FMath::Clamp<int64>(ReceivedBytes, MinExtentBytes, MaxExtentBytes);
+    if (!Reserve(EndOffset))
+    {
+        UE_LOG(LogBHttpClientLib, Error, TEXT("HttpClient->FileSink ==> %lld bytes could not be reserved for %s"), EndOffset, *PartPath);
+        return TArrayView<uint8>();
+    }
+
+    WindowOffset = ReceivedBytes;
+
+#if PLATFORM_LINUX
+    if (bCanMap)
+    {
+        static const int64 PageBytes = static_cast<int64>(sysconf(_SC_PAGESIZE));
+        MappingOffset = WindowOffset - WindowOffset % PageBytes;
+        WindowBytes = FMath::Min(EndOffset, MappingOffset + MaxExtentBytes) - WindowOffset;
+
+        const size_t MappingBytes = static_cast<size_t>(WindowOffset - MappingOffset + WindowBytes);
+        void* Mapping = mmap(nullptr, MappingBytes, PROT_READ | PROT_WRITE, MAP_SHARED, FileDescriptor, static_cast<off_t>(MappingOffset));
+        if (Mapping != MAP_FAILED)
+        {
+            // Written front to back once, the pages can go as soon as they are clean
+            madvise(Mapping, MappingBytes, MADV_SEQUENTIAL);
+            bMapped = true;
+            Window = static_cast<uint8*>(Mapping) + (WindowOffset - MappingOffset);
+            return TArrayView<uint8>(Window, static_cast<int32>(WindowBytes));
+        }
+
+        UE_LOG(LogBHttpClientLib, Warning, TEXT("HttpClient->FileSink ==> %s could not be mapped (errno %d), writing through a buffer"), *PartPath, errno);
+        bCanMap = false;
+    }
+#endif
+
+    if (Ring)
+    {
+        // The slot about to fill may still be on its way to the disk, and a retry must not race the writes of the last attempt
+        if (!WaitRingWrites(ReceivedBytes == 0))
+        {
+            return TArrayView<uint8>();
+        }
+        const FRingSlot& Slot = RingSlots[CurrentSlot];
+        WindowBytes = FMath::Min(EndOffset - WindowOffset, static_cast<int64>(Slot.Bytes));
+        Window = Slot.Data;
+        return TArrayView<uint8>(Window, static_cast<int32>(WindowBytes));
+    }
+
+    WindowBytes = FMath::Min(EndOffset - WindowOffset, StagingBytes);
+    Staging.SetNumUninitialized(static_cast<int32>(StagingBytes));
+    Window = Staging.GetData();
+    return TArrayView<uint8>(Window, static_cast<int32>(WindowBytes));
+}
+
+bool BHttpFileSink::Commit(int64 ReceivedBytes)
+{
+    if (FileDescriptor < 0 || !FinishWindow(ReceivedBytes) || !WaitRingWrites(true))
+    {
+        Abort();
+        return false;
+    }
+    ReleaseRingSlots();
+
+    // The preallocation past the body goes again
+#if PLATFORM_WINDOWS
+    bool bSucceed = _chsize_s(FileDescriptor, ReceivedBytes) == 0;
+#else
+    bool bSucceed = ftruncate(FileDescriptor, static_cast<off_t>(ReceivedBytes)) == 0;
+#endif
+    CloseFile();
+
+    // Replaces an older FilePath in one step
+#if PLATFORM_WINDOWS
+    bSucceed = bSucceed && MoveFileExW(*PartPath, *FilePath, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bSucceed = bSucceed && std::rename(TCHAR_TO_UTF8(*PartPath), TCHAR_TO_UTF8(*FilePath)) == 0;
+#endif
+    bPartFileExists = !bSucceed;
+    if (!bSucceed)
+    {
+        UE_LOG(LogBHttpClientLib, Error, TEXT("HttpClient->FileSink ==> %s could not be moved to %s"), *PartPath, *FilePath);
+        Abort();
+    }
+    return bSucceed;
+}
+
+void BHttpFileSink::Abort()
+{
+    if (FileDescriptor >= 0)
+    {
+        FinishWindow(0);
+        // The kernel may still write from the ring buffers, and into the descriptor
+        WaitRingWrites(true);
+        CloseFile();
+    }
+    ReleaseRingSlots();
+
+    if (bPartFileExists)
+    {
+#if PLATFORM_WINDOWS
+        _wremove(*PartPath);
+#else
+        std::remove(TCHAR_TO_UTF8(*PartPath));
+#endif
+        bPartFileExists = false;
+    }
+}
+
+bool BHttpFileSink::FinishWindow(int64 ReceivedBytes)
+{
+    if (!Window)
+    {
+        return true;
+    }
+
+    bool bSucceed = true;
+    if (bMapped)
+    {
+#if PLATFORM_LINUX
+        munmap(Window - (WindowOffset - MappingOffset), static_cast<size_t>(WindowOffset - MappingOffset + WindowBytes));
+#endif
+    }
+    else if (ReceivedBytes > WindowOffset)
+    {
+        const int64 Bytes = FMath::Min(ReceivedBytes - WindowOffset, WindowBytes);
+        bSucceed = Ring ? QueueRingWrite(Bytes) : WriteAt(Window, Bytes, WindowOffset);
+    }
+
+    Window = nullptr;
+    WindowBytes = 0;
+    bMapped = false;
+    return bSucceed;
+}
+
+bool BHttpFileSink::Reserve(int64 EndOffset)
+{
+    if (EndOffset <= ReservedBytes)
+    {
+        return true;
+    }
+
+#if PLATFORM_LINUX
+    // Allocated blocks are what make writing through the mapping safe, a full disk fails here instead of with SIGBUS
+    if (posix_fallocate(FileDescriptor, static_cast<off_t>(ReservedBytes), static_cast<off_t>(EndOffset - ReservedBytes)) != 0)
+    {
+        return false;
+    }
+#endif
+    ReservedBytes = EndOffset;
+    return true;
+}
+
+bool BHttpFileSink::WriteAt(const uint8* Data, int64 Bytes, int64 Offset)
+{
+    while (Bytes > 0)
+    {
+#if PLATFORM_WINDOWS
+        OVERLAPPED Overlapped = {};
+        Overlapped.Offset = static_cast<DWORD>(Offset & 0xffffffff);
+        Overlapped.OffsetHigh = static_cast<DWORD>(Offset >> 32);
+        DWORD Written = 0;
+        if (!WriteFile(reinterpret_cast<HANDLE>(_get_osfhandle(FileDescriptor)), Data, static_cast<DWORD>(Bytes), &Written, &Overlapped) || Written == 0)
+        {
+            return false;
+        }
+#else
+        const ssize_t Written = pwrite(FileDescriptor, Data, static_cast<size_t>(Bytes), static_cast<off_t>(Offset));
+        if (Written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (Written <= 0)
+        {
+            return false;
+        }
+#endif
+        Data += Written;
+        Bytes -= Written;
+        Offset += Written;
+    }
+    return true;
+}
+
+void BHttpFileSink::CloseFile()
+{
+#if PLATFORM_WINDOWS
+    _close(FileDescriptor);
+#else
+    close(FileDescriptor);
+#endif
+    FileDescriptor = -1;
+}
+
+bool BHttpFileSink::AcquireRingSlots()
+{
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+    httplib::detail::IoUring* ThreadRing = httplib::detail::IoUring::get();
+    if (!ThreadRing)
+    {
+        return false;
+    }
+
+    // Each ring has a handful of buffers, sinks beyond that write from Staging
+    httplib::detail::IoUring::Buffer Buffers[2];
+    if (!ThreadRing->acquire_buffer(Buffers[0]) || !ThreadRing->acquire_buffer(Buffers[1]))
+    {
+        ThreadRing->release_buffer(Buffers[0]);
+        return false;
+    }
+
+    for (int32 i = 0; i < 2; i++)
+    {
+        RingSlots[i] = FRingSlot();
+        RingSlots[i].Data = reinterpret_cast<uint8*>(Buffers[i].data);
+        RingSlots[i].Bytes = static_cast<int32>(FMath::Min(static_cast<int64>(Buffers[i].size), StagingBytes));
+        RingSlots[i].Index = Buffers[i].index;
+    }
+    Ring = ThreadRing;
+    CurrentSlot = 0;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool BHttpFileSink::QueueRingWrite(int64 Bytes)
+{
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+    FRingSlot& Slot = RingSlots[CurrentSlot];
+    httplib::detail::IoUring::Buffer Buffer;
+    Buffer.data = reinterpret_cast<char*>(Slot.Data);
+    Buffer.size = static_cast<size_t>(Slot.Bytes);
+    Buffer.index = Slot.Index;
+
+    Slot.Ticket = Ring->write_async(FileDescriptor, Buffer, static_cast<size_t>(Bytes), static_cast<uint64_t>(WindowOffset));
+    Slot.PendingBytes = Bytes;
+    Slot.PendingOffset = WindowOffset;
+    CurrentSlot ^= 1;
+    return Slot.Ticket != 0;
+#else
+    return false;
+#endif
+}
+
+bool BHttpFileSink::WaitRingWrites(bool bAllSlots)
+{
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+    if (!Ring)
+    {
+        return true;
+    }
+
+    bool bSucceed = true;
+    for (int32 i = 0; i < 2; i++)
+    {
+        FRingSlot& Slot = RingSlots[i];
+        if (!Slot.Ticket || (!bAllSlots && i != CurrentSlot))
+        {
+            continue;
+        }
+
+        const int64 Written = static_cast<int64>(Ring->wait(Slot.Ticket));
+        if (Written < 0)
+        {
+            UE_LOG(LogBHttpClientLib, Error, TEXT("HttpClient->FileSink ==> Writing %s failed (errno %d)"), *PartPath, static_cast<int32>(-Written));
+            bSucceed = false;
+        }
+        else if (Written < Slot.PendingBytes)
+        {
+            // Short writes are rare on regular files, the rest goes the synchronous way
+            bSucceed = WriteAt(Slot.Data + Written, Slot.PendingBytes - Written, Slot.PendingOffset + Written) && bSucceed;
+        }
+        Slot.Ticket = 0;
+        Slot.PendingBytes = 0;
+    }
+    return bSucceed;
+#else
+    return true;
+#endif
+}
+
+void BHttpFileSink::ReleaseRingSlots()
+{
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+    if (!Ring)
+    {
+        return;
+    }
+
+    for (FRingSlot& Slot : RingSlots)
+    {
+        httplib::detail::IoUring::Buffer Buffer;
+        Buffer.index = Slot.Index;
+        Ring->release_buffer(Buffer);
+        Slot = FRingSlot();
+    }
+    Ring = nullptr;
+#endif
+}
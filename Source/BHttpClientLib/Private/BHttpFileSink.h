@@ -0,0 +1,98 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace httplib { namespace detail { class IoUring; } }
+
+/*
+ * Download target of BHttpClient::GetToFile. The body goes into "<FilePath>.part", which replaces
+ * FilePath only once the whole response arrived, so nobody ever opens a half written file.
+ *
+ * On Linux the part file is preallocated, all of Content-Length up front or in growing extents when it
+ * is missing. Socket reads land in a small staging buffer that is written at its offset, or with
+ * bMapFile straight in a shared mapping of the file. Mapping saves a copy but pays a page fault per
+ * 4 KB, which made it the slower of the two in the loopback measurements so far.
+ *
+ * With bUseIoUring the staging alternates between two buffers of the thread's io_uring: a full one is
+ * queued as a write that goes to the kernel with the next socket read, while the other one fills.
+ *
+ * */
+class BHttpFileSink
+{
+public:
+    // bInMapFile only takes effect on Linux, where the preallocation keeps a full disk from raising SIGBUS.
+    // bInUseIoUring only where the thread has a ring (Linux 5.6+), and never together with a mapping
+    BHttpFileSink(const FString& InFilePath, bool bInMapFile, bool bInUseIoUring = false);
+    // Removes the part file unless Commit succeeded
+    ~BHttpFileSink();
+
+    // Creates or truncates the part file
+    bool Open();
+
+    //************************************
+    // Method:    NextSpan is the FBHttpBodySpanReceiver of the download, the previous view is written out first
+    // FullName:  BHttpFileSink::NextSpan
+    // Access:    public
+    // Returns:   TArrayView<uint8> at ReceivedBytes of the file, empty if the disk is full or the file can't be written
+    // Qualifier:
+    // Parameter: int64 ContentLength (0 if unknown)
+    // Parameter: int64 ReceivedBytes (0 again when a retry starts over)
+    //************************************
+    TArrayView<uint8> NextSpan(int64 ContentLength, int64 ReceivedBytes);
+
+    // Writes out the last view, cuts the preallocation back to ReceivedBytes and renames the part file over FilePath
+    bool Commit(int64 ReceivedBytes);
+
+    // Closes and removes the part file, FilePath stays as it was
+    void Abort();
+
+private:
+    // Unmaps or writes out the current view, up to ReceivedBytes
+    bool FinishWindow(int64 ReceivedBytes);
+    bool Reserve(int64 EndOffset);
+    bool WriteAt(const uint8* Data, int64 Bytes, int64 Offset);
+    void CloseFile();
+    // Claims the two ring buffers, false leaves the sink on Staging
+    bool AcquireRingSlots();
+    // Queues the current slot's first Bytes and switches to the other slot
+    bool QueueRingWrite(int64 Bytes);
+    // Waits for the queued writes, all of them or only the next slot's
+    bool WaitRingWrites(bool bAllSlots);
+    void ReleaseRingSlots();
+
+    FString FilePath;
+    FString PartPath;
+    int32 FileDescriptor = -1;
+    bool bPartFileExists = false;
+    int64 ReservedBytes = 0;
+
+    // The current view: a mapping of the file at WindowOffset, or Staging
+    uint8* Window = nullptr;
+    int64 WindowOffset = 0;
+    int64 WindowBytes = 0;
+    // Where the mapping really starts, mmap offsets are page aligned
+    int64 MappingOffset = 0;
+    bool bMapped = false;
+    bool bMapFile = false;
+    // Cleared for good on the first mapping that fails
+    bool bCanMap = false;
+    TArray<uint8> Staging;
+
+    // The io_uring double buffer, Ring stays null without one
+    struct FRingSlot
+    {
+        uint8* Data = nullptr;
+        int32 Bytes = 0;
+        int32 Index = -1;
+        // The queued write of this slot and how much it has to write, 0 when nothing is pending
+        uint64 Ticket = 0;
+        int64 PendingBytes = 0;
+        int64 PendingOffset = 0;
+    };
+    httplib::detail::IoUring* Ring = nullptr;
+    FRingSlot RingSlots[2];
+    int32 CurrentSlot = 0;
+    bool bUseIoUring = false;
+};
@@ -0,0 +1,463 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#include "BHttpMetrics.h"
+#include <cstdio>
+
+// Prometheus buckets are cumulative and should stay few, these are read off the finer HDR buckets
+static const double PrometheusBucketsSeconds[] = { 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0, 60.0 };
+
+BHttpMetrics& BHttpMetrics::Get()
+{
+    static BHttpMetrics Instance;
+    return Instance;
+}
+
+const char* BHttpMetrics::GetVerbName(EBHttpBatchVerb Verb)
+{
+    static const char* const VerbNames[] = { "GET", "DELETE", "POST", "PUT", "PATCH" };
+    return VerbNames[(int32)Verb];
+}
+
+int32 BHttpMetrics::GetBucketIndex(int64 Micros)
+{
+    const int64 MaxMicros = (int64(1) << MaxValueBits) - 1;
+    Micros = FMath::Clamp<int64>(Micros, 0, MaxMicros);
+    if (Micros < SubBucketCount)
+    {
+        return (int32)Micros;
+    }
+
+    // The top SubBucketBits + 1 bits select the bucket, the rest is the precision given up
+    const int32 Shift = (int32)FMath::FloorLog2_64((uint64)Micros) - SubBucketBits;
+    return (Shift + 1) * SubBucketCount + (int32)((Micros >> Shift) - SubBucketCount);
+}
+
+int64 BHttpMetrics::GetBucketHighestMicros(int32 Index)
+{
+    if (Index < SubBucketCount)
+    {
+        return Index;
+    }
+
+    const int32 Shift = Index / SubBucketCount - 1;
+    const int64 SubBucket = Index % SubBucketCount + SubBucketCount;
+    return ((SubBucket + 1) << Shift) - 1;
+}
+
+void BHttpMetrics::FHistogram::Add(double Seconds)
+{
+    const int64 Micros = (int64)(FMath::Max(Seconds, 0.0) * 1000000.0);
+
+    Buckets[GetBucketIndex(Micros)].fetch_add(1, std::memory_order_relaxed);
+    Count.fetch_add(1, std::memory_order_relaxed);
+    SumMicros.fetch_add(Micros, std::memory_order_relaxed);
+
+    int64 Previous = MaxMicros.load(std::memory_order_relaxed);
+    while (Previous < Micros && !MaxMicros.compare_exchange_weak(Previous, Micros, std::memory_order_relaxed))
+    {
+    }
+    Previous = MinMicros.load(std::memory_order_relaxed);
+    while (Previous > Micros && !MinMicros.compare_exchange_weak(Previous, Micros, std::memory_order_relaxed))
+    {
+    }
+}
+
+void BHttpMetrics::FHistogram::Reset()
+{
+    for (int32 i = 0; i < BucketCount; i++)
+    {
+        Buckets[i].store(0, std::memory_order_relaxed);
+    }
+    Count.store(0, std::memory_order_relaxed);
+    SumMicros.store(0, std::memory_order_relaxed);
+    MaxMicros.store(0, std::memory_order_relaxed);
+    MinMicros.store(MAX_int64, std::memory_order_relaxed);
+}
+
+void BHttpMetrics::FMergedHistogram::Merge(const FHistogram& Histogram)
+{
+    for (int32 i = 0; i < BucketCount; i++)
+    {
+        Buckets[i] += Histogram.Buckets[i].load(std::memory_order_relaxed);
+    }
+    Count += Histogram.Count.load(std::memory_order_relaxed);
+    SumMicros += Histogram.SumMicros.load(std::memory_order_relaxed);
+    MaxMicros = FMath::Max(MaxMicros, Histogram.MaxMicros.load(std::memory_order_relaxed));
+    MinMicros = FMath::Min(MinMicros, Histogram.MinMicros.load(std::memory_order_relaxed));
+}
+
+double BHttpMetrics::FMergedHistogram::GetPercentileSeconds(double Percentile) const
+{
+    if (Count <= 0)
+    {
+        return 0.0;
+    }
+
+    const double Target = FMath::Clamp(Percentile, 0.0, 100.0) / 100.0 * Count;
+    int64 Seen = 0;
+    for (int32 i = 0; i < BucketCount; i++)
+    {
+        Seen += Buckets[i];
+        if (Buckets[i] > 0 && Seen >= Target)
+        {
+            return FMath::Min(GetBucketHighestMicros(i), MaxMicros) / 1000000.0;
+        }
+    }
+    return MaxMicros / 1000000.0;
+}
+
+int64 BHttpMetrics::FMergedHistogram::CountAtOrBelow(double Seconds) const
+{
+    // Whole buckets only, a value is never reported faster than it was
+    const int64 Micros = (int64)(Seconds * 1000000.0);
+    int64 Result = 0;
+    for (int32 i = 0; i < BucketCount && GetBucketHighestMicros(i) <= Micros; i++)
+    {
+        Result += Buckets[i];
+    }
+    return Result;
+}
+
+FBHttpLatencySummary BHttpMetrics::FMergedHistogram::Summarize(const FString& Method) const
+{
+    FBHttpLatencySummary Summary;
+    Summary.Method = Method;
+    Summary.Count = Count;
+    Summary.SumSeconds = SumMicros / 1000000.0;
+    Summary.P50Seconds = GetPercentileSeconds(50.0);
+    Summary.P90Seconds = GetPercentileSeconds(90.0);
+    Summary.P99Seconds = GetPercentileSeconds(99.0);
+    Summary.MaxSeconds = MaxMicros / 1000000.0;
+    return Summary;
+}
+
+bool BHttpMetrics::FRequestKey::operator<(const FRequestKey& Other) const
+{
+    if (Verb != Other.Verb)
+    {
+        return Verb < Other.Verb;
+    }
+    if (StatusCode != Other.StatusCode)
+    {
+        return StatusCode < Other.StatusCode;
+    }
+    return Host < Other.Host;
+}
+
+BHttpMetrics::FShardHandle::~FShardHandle()
+{
+    if (Shard)
+    {
+        std::lock_guard<std::mutex> Lock(BHttpMetrics::Get().ShardsMutex);
+        Shard->bInUse = false;
+    }
+}
+
+BHttpMetrics::FShard& BHttpMetrics::GetLocalShard()
+{
+    static thread_local FShardHandle Handle;
+    if (Handle.Shard)
+    {
+        return *Handle.Shard;
+    }
+
+    std::lock_guard<std::mutex> Lock(ShardsMutex);
+    for (auto& Shard : Shards)
+    {
+        if (!Shard->bInUse)
+        {
+            Handle.Shard = Shard.get();
+            break;
+        }
+    }
+    if (!Handle.Shard)
+    {
+        Shards.push_back(std::unique_ptr<FShard>(new FShard()));
+        Handle.Shard = Shards.back().get();
+    }
+    Handle.Shard->bInUse = true;
+    return *Handle.Shard;
+}
+
+void BHttpMetrics::RecordRequest(EBHttpBatchVerb Verb, const FString& Host, int32 StatusCode, double Seconds, uint64 BytesSent, uint64 BytesReceived)
+{
+    FShard& Shard = GetLocalShard();
+
+    Shard.BytesSent.fetch_add((int64)BytesSent, std::memory_order_relaxed);
+    Shard.BytesReceived.fetch_add((int64)BytesReceived, std::memory_order_relaxed);
+    Shard.Duration[FMath::Min((int32)Verb, VerbCount - 1)].Add(Seconds);
+
+    FRequestKey Key;
+    Key.Verb = Verb;
+    Key.StatusCode = StatusCode;
+    Key.Host = TCHAR_TO_UTF8(*Host);
+
+    std::lock_guard<std::mutex> Lock(Shard.RequestsMutex);
+    Shard.Requests[Key]++;
+}
+
+void BHttpMetrics::RecordResponse(const httplib::RequestTimings& Timings)
+{
+    FShard& Shard = GetLocalShard();
+
+    if (!Timings.reused_connection && Timings.connect_end > 0.0)
+    {
+        Shard.ConnectionsOpened.fetch_add(1, std::memory_order_relaxed);
+        if (Timings.tls_end > 0.0)
+        {
+            Shard.TlsHandshakes.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    FHistogram* Phases = Shard.Phases;
+    if (!Timings.reused_connection)
+    {
+        Phases[(int32)EBHttpTimingPhase::Dns].Add(Timings.dns());
+        Phases[(int32)EBHttpTimingPhase::Connect].Add(Timings.connect());
+        // http:// connections have no handshake, a 0 would drag the TLS percentiles down
+        if (Timings.tls_end > 0.0)
+        {
+            Phases[(int32)EBHttpTimingPhase::Tls].Add(Timings.tls());
+        }
+    }
+    Phases[(int32)EBHttpTimingPhase::Upload].Add(Timings.upload());
+    if (Timings.first_byte > 0.0)
+    {
+        Phases[(int32)EBHttpTimingPhase::TimeToFirstByte].Add(Timings.ttfb());
+    }
+    Phases[(int32)EBHttpTimingPhase::Transfer].Add(Timings.transfer());
+    Phases[(int32)EBHttpTimingPhase::Total].Add(Timings.total());
+}
+
+void BHttpMetrics::AddRetry()
+{
+    GetLocalShard().Retries.fetch_add(1, std::memory_order_relaxed);
+}
+
+void BHttpMetrics::AddPoolLookup(bool bHit)
+{
+    FShard& Shard = GetLocalShard();
+    (bHit ? Shard.PoolHits : Shard.PoolMisses).fetch_add(1, std::memory_order_relaxed);
+}
+
+void BHttpMetrics::Collect(FBHttpMetricsSnapshot& OutCounters, std::map<FRequestKey, int64>& OutRequests, FMergedHistogram OutDuration[VerbCount], FMergedHistogram& OutTimeToFirstByte)
+{
+    std::lock_guard<std::mutex> Lock(ShardsMutex);
+    for (auto& Shard : Shards)
+    {
+        OutCounters.BytesSent += Shard->BytesSent.load(std::memory_order_relaxed);
+        OutCounters.BytesReceived += Shard->BytesReceived.load(std::memory_order_relaxed);
+        OutCounters.Retries += Shard->Retries.load(std::memory_order_relaxed);
+        OutCounters.PoolHits += Shard->PoolHits.load(std::memory_order_relaxed);
+        OutCounters.PoolMisses += Shard->PoolMisses.load(std::memory_order_relaxed);
+        OutCounters.ConnectionsOpened += Shard->ConnectionsOpened.load(std::memory_order_relaxed);
+        OutCounters.TlsHandshakes += Shard->TlsHandshakes.load(std::memory_order_relaxed);
+
+        for (int32 i = 0; i < VerbCount; i++)
+        {
+            OutDuration[i].Merge(Shard->Duration[i]);
+        }
+        OutTimeToFirstByte.Merge(Shard->Phases[(int32)EBHttpTimingPhase::TimeToFirstByte]);
+
+        std::lock_guard<std::mutex> RequestsLock(Shard->RequestsMutex);
+        for (const auto& Entry : Shard->Requests)
+        {
+            OutRequests[Entry.first] += Entry.second;
+        }
+    }
+}
+
+FBHttpMetricsSnapshot BHttpMetrics::GetSnapshot()
+{
+    FBHttpMetricsSnapshot Snapshot;
+    std::map<FRequestKey, int64> Requests;
+    // Large, kept off the stack
+    std::unique_ptr<FMergedHistogram[]> Duration(new FMergedHistogram[VerbCount]);
+    std::unique_ptr<FMergedHistogram> TimeToFirstByte(new FMergedHistogram());
+    Collect(Snapshot, Requests, Duration.get(), *TimeToFirstByte);
+
+    for (const auto& Entry : Requests)
+    {
+        FBHttpRequestCount Count;
+        Count.Method = GetVerbName(Entry.first.Verb);
+        Count.StatusCode = Entry.first.StatusCode;
+        Count.Host = UTF8_TO_TCHAR(Entry.first.Host.c_str());
+        Count.Count = Entry.second;
+        Snapshot.Requests.Add(Count);
+    }
+
+    for (int32 i = 0; i < VerbCount; i++)
+    {
+        if (Duration[i].Count > 0)
+        {
+            Snapshot.RequestDuration.Add(Duration[i].Summarize(GetVerbName((EBHttpBatchVerb)i)));
+        }
+    }
+    Snapshot.TimeToFirstByte = TimeToFirstByte->Summarize(FString());
+    return Snapshot;
+}
+
+FBHttpTimingHistogram BHttpMetrics::GetPhaseHistogram(EBHttpTimingPhase Phase)
+{
+    std::unique_ptr<FMergedHistogram> Merged(new FMergedHistogram());
+    {
+        std::lock_guard<std::mutex> Lock(ShardsMutex);
+        for (auto& Shard : Shards)
+        {
+            Merged->Merge(Shard->Phases[FMath::Clamp((int32)Phase, 0, PhaseCount - 1)]);
+        }
+    }
+
+    FBHttpTimingHistogram Result;
+    Result.Count = Merged->Count;
+    Result.SumSeconds = Merged->SumMicros / 1000000.0;
+    Result.MinSeconds = Merged->Count > 0 ? Merged->MinMicros / 1000000.0 : 0.0;
+    Result.MaxSeconds = Merged->MaxMicros / 1000000.0;
+
+    // Up to the last bucket in use, a bucket holds whole microseconds so its bound is one past the highest
+    int32 LastUsed = -1;
+    for (int32 i = 0; i < BucketCount; i++)
+    {
+        if (Merged->Buckets[i] > 0)
+        {
+            LastUsed = i;
+        }
+    }
+    for (int32 i = 0; i <= LastUsed; i++)
+    {
+        Result.BucketUpperBoundsSeconds.Add((GetBucketHighestMicros(i) + 1) / 1000000.0);
+        Result.BucketCounts.Add(Merged->Buckets[i]);
+    }
+    return Result;
+}
+
+void BHttpMetrics::ResetPhases()
+{
+    std::lock_guard<std::mutex> Lock(ShardsMutex);
+    for (auto& Shard : Shards)
+    {
+        for (int32 i = 0; i < PhaseCount; i++)
+        {
+            Shard->Phases[i].Reset();
+        }
+    }
+}
+
+static std::string EscapeLabelValue(const std::string& Value)
+{
+    std::string Result;
+    Result.reserve(Value.size());
+    for (char c : Value)
+    {
+        if (c == '\\' || c == '"')
+        {
+            Result += '\\';
+            Result += c;
+        }
+        else if (c == '\n')
+        {
+            Result += "\\n";
+        }
+        else
+        {
+            Result += c;
+        }
+    }
+    return Result;
+}
+
+static void AppendCounter(std::string& Text, const char* Name, const char* Help, int64 Value)
+{
+    char Line[256];
+    snprintf(Line, sizeof(Line), "# HELP %s %s\n# TYPE %s counter\n%s %lld\n", Name, Help, Name, Name, (long long)Value);
+    Text += Line;
+}
+
+FString BHttpMetrics::ExportPrometheus()
+{
+    FBHttpMetricsSnapshot Counters;
+    std::map<FRequestKey, int64> Requests;
+    std::unique_ptr<FMergedHistogram[]> Duration(new FMergedHistogram[VerbCount]);
+    std::unique_ptr<FMergedHistogram> TimeToFirstByte(new FMergedHistogram());
+    Collect(Counters, Requests, Duration.get(), *TimeToFirstByte);
+
+    std::string Text;
+    char Line[256];
+
+    Text += "# HELP bhttp_requests_total Finished requests by method, status and host, status -1 means no response.\n";
+    Text += "# TYPE bhttp_requests_total counter\n";
+    for (const auto& Entry : Requests)
+    {
+        snprintf(Line, sizeof(Line), "bhttp_requests_total{method=\"%s\",status=\"%d\",host=\"", GetVerbName(Entry.first.Verb), Entry.first.StatusCode);
+        Text += Line;
+        Text += EscapeLabelValue(Entry.first.Host);
+        snprintf(Line, sizeof(Line), "\"} %lld\n", (long long)Entry.second);
+        Text += Line;
+    }
+
+    AppendCounter(Text, "bhttp_sent_bytes_total", "Request body bytes sent.", (int64)Counters.BytesSent);
+    AppendCounter(Text, "bhttp_received_bytes_total", "Response body bytes received.", (int64)Counters.BytesReceived);
+    AppendCounter(Text, "bhttp_retries_total", "Request attempts beyond the first.", Counters.Retries);
+    AppendCounter(Text, "bhttp_pool_hits_total", "Requests that reused a pooled connection.", Counters.PoolHits);
+    AppendCounter(Text, "bhttp_pool_misses_total", "Pool lookups that found no idle connection.", Counters.PoolMisses);
+    AppendCounter(Text, "bhttp_connections_opened_total", "New TCP connections.", Counters.ConnectionsOpened);
+    AppendCounter(Text, "bhttp_tls_handshakes_total", "TLS handshakes.", Counters.TlsHandshakes);
+
+    auto AppendHistogram = [&Text, &Line](const char* Name, const char* Labels, const FMergedHistogram& Histogram) {
+        const char* Separator = Labels[0] ? "," : "";
+        for (double Bound : PrometheusBucketsSeconds)
+        {
+            snprintf(Line, sizeof(Line), "%s_bucket{%s%sle=\"%g\"} %lld\n", Name, Labels, Separator, Bound, (long long)Histogram.CountAtOrBelow(Bound));
+            Text += Line;
+        }
+        snprintf(Line, sizeof(Line), "%s_bucket{%s%sle=\"+Inf\"} %lld\n", Name, Labels, Separator, (long long)Histogram.Count);
+        Text += Line;
+        snprintf(Line, sizeof(Line), Labels[0] ? "%s_sum{%s} %.6f\n%s_count{%s} %lld\n" : "%s_sum%s %.6f\n%s_count%s %lld\n",
+            Name, Labels, Histogram.SumMicros / 1000000.0, Name, Labels, (long long)Histogram.Count);
+        Text += Line;
+    };
+
+    Text += "# HELP bhttp_request_duration_seconds Request duration by method, from sending until the body was read.\n";
+    Text += "# TYPE bhttp_request_duration_seconds histogram\n";
+    for (int32 i = 0; i < VerbCount; i++)
+    {
+        if (Duration[i].Count > 0)
+        {
+            char Labels[32];
+            snprintf(Labels, sizeof(Labels), "method=\"%s\"", GetVerbName((EBHttpBatchVerb)i));
+            AppendHistogram("bhttp_request_duration_seconds", Labels, Duration[i]);
+        }
+    }
+
+    Text += "# HELP bhttp_time_to_first_byte_seconds Request sent until the status line arrived.\n";
+    Text += "# TYPE bhttp_time_to_first_byte_seconds histogram\n";
+    AppendHistogram("bhttp_time_to_first_byte_seconds", "", *TimeToFirstByte);
+
+    return FString(UTF8_TO_TCHAR(Text.c_str()));
+}
+
+void BHttpMetrics::Reset()
+{
+    std::lock_guard<std::mutex> Lock(ShardsMutex);
+    for (auto& Shard : Shards)
+    {
+        Shard->BytesSent.store(0, std::memory_order_relaxed);
+        Shard->BytesReceived.store(0, std::memory_order_relaxed);
+        Shard->Retries.store(0, std::memory_order_relaxed);
+        Shard->PoolHits.store(0, std::memory_order_relaxed);
+        Shard->PoolMisses.store(0, std::memory_order_relaxed);
+        Shard->ConnectionsOpened.store(0, std::memory_order_relaxed);
+        Shard->TlsHandshakes.store(0, std::memory_order_relaxed);
+
+        for (int32 i = 0; i < VerbCount; i++)
+        {
+            Shard->Duration[i].Reset();
+        }
+        for (int32 i = 0; i < PhaseCount; i++)
+        {
+            Shard->Phases[i].Reset();
+        }
+
+        std::lock_guard<std::mutex> RequestsLock(Shard->RequestsMutex);
+        Shard->Requests.clear();
+    }
+}
@@ -0,0 +1,155 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BHttpClient.h"
+#include "BHttpClientUtils.h"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+ * Process-wide request metrics. Every thread counts into its own shard with relaxed atomics, so the
+ * request path never waits on another thread; readers sum the shards. A shard outlives its thread
+ * and is handed to the next new thread, batch workers come and go without growing the registry.
+ *
+ * Latencies go into HDR-style histograms: 8 linear sub-buckets per power of two microseconds, so any
+ * recorded value is known to within 1/8 while a histogram stays a fixed array of counters. The
+ * per-phase durations of BHttpClient::GetTimingHistogram are histograms of the same kind.
+ *
+ * */
+class BHttpMetrics
+{
+public:
+    static BHttpMetrics& Get();
+
+    // "GET", "DELETE", "POST", "PUT" or "PATCH", shared with the tracer
+    static const char* GetVerbName(EBHttpBatchVerb Verb);
+
+    //************************************
+    // Method:    RecordRequest counts one finished request, retries are recorded as separate requests
+    // FullName:  BHttpMetrics::RecordRequest
+    // Access:    public
+    // Returns:   void
+    // Qualifier:
+    // Parameter: EBHttpBatchVerb Verb
+    // Parameter: const FString & Host (scheme://host[:port] as produced by BHttpClient::SplitPath)
+    // Parameter: int32 StatusCode (-1 if no response arrived)
+    // Parameter: double Seconds
+    // Parameter: uint64 BytesSent
+    // Parameter: uint64 BytesReceived
+    //************************************
+    void RecordRequest(EBHttpBatchVerb Verb, const FString& Host, int32 StatusCode, double Seconds, uint64 BytesSent, uint64 BytesReceived);
+
+    // New connections, TLS handshakes and the phase durations of a response
+    void RecordResponse(const httplib::RequestTimings& Timings);
+
+    void AddRetry();
+
+    void AddPoolLookup(bool bHit);
+
+    FBHttpMetricsSnapshot GetSnapshot();
+
+    // Durations of one phase across all responses since the last reset, for BHttpClient::GetTimingHistogram
+    FBHttpTimingHistogram GetPhaseHistogram(EBHttpTimingPhase Phase);
+
+    // Only the phase histograms, the time to first byte of the snapshot included
+    void ResetPhases();
+
+    FString ExportPrometheus();
+
+    // Increments racing with the reset may survive it
+    void Reset();
+
+private:
+    static constexpr int32 SubBucketBits = 3;
+    static constexpr int32 SubBucketCount = 1 << SubBucketBits;
+    // Microseconds up to 2^41, about 25 days
+    static constexpr int32 MaxValueBits = 41;
+    static constexpr int32 BucketCount = (MaxValueBits - SubBucketBits + 1) * SubBucketCount;
+
+    static constexpr int32 VerbCount = 5;
+    static constexpr int32 PhaseCount = 7;
+
+    struct FHistogram
+    {
+        std::atomic<int64> Buckets[BucketCount];
+        std::atomic<int64> Count;
+        std::atomic<int64> SumMicros;
+        std::atomic<int64> MaxMicros;
+        // MAX_int64 while empty
+        std::atomic<int64> MinMicros;
+
+        FHistogram() { Reset(); }
+        void Add(double Seconds);
+        void Reset();
+    };
+
+    // Plain copy of one or more FHistograms, for reading
+    struct FMergedHistogram
+    {
+        int64 Buckets[BucketCount] = {};
+        int64 Count = 0;
+        int64 SumMicros = 0;
+        int64 MaxMicros = 0;
+        int64 MinMicros = MAX_int64;
+
+        void Merge(const FHistogram& Histogram);
+        double GetPercentileSeconds(double Percentile) const;
+        int64 CountAtOrBelow(double Seconds) const;
+        FBHttpLatencySummary Summarize(const FString& Method) const;
+    };
+
+    struct FRequestKey
+    {
+        EBHttpBatchVerb Verb;
+        int32 StatusCode;
+        std::string Host;
+
+        bool operator<(const FRequestKey& Other) const;
+    };
+
+    struct FShard
+    {
+        std::atomic<int64> BytesSent{ 0 };
+        std::atomic<int64> BytesReceived{ 0 };
+        std::atomic<int64> Retries{ 0 };
+        std::atomic<int64> PoolHits{ 0 };
+        std::atomic<int64> PoolMisses{ 0 };
+        std::atomic<int64> ConnectionsOpened{ 0 };
+        std::atomic<int64> TlsHandshakes{ 0 };
+
+        FHistogram Duration[VerbCount];
+        // By EBHttpTimingPhase, TimeToFirstByte is the one the snapshot summarizes
+        FHistogram Phases[PhaseCount];
+
+        // Labels are open-ended so they can't be fixed counters; only the owning thread and readers
+        // take this lock, the owner never waits on another request
+        std::mutex RequestsMutex;
+        std::map<FRequestKey, int64> Requests;
+
+        bool bInUse = false;
+    };
+
+    // Returns the shard to the free list when its thread exits
+    struct FShardHandle
+    {
+        FShard* Shard = nullptr;
+        ~FShardHandle();
+    };
+
+    static int32 GetBucketIndex(int64 Micros);
+    static int64 GetBucketHighestMicros(int32 Index);
+
+    FShard& GetLocalShard();
+
+    // Sums every shard, the scalar counters go into OutCounters
+    void Collect(FBHttpMetricsSnapshot& OutCounters, std::map<FRequestKey, int64>& OutRequests, FMergedHistogram OutDuration[VerbCount], FMergedHistogram& OutTimeToFirstByte);
+
+    std::mutex ShardsMutex;
+    std::vector<std::unique_ptr<FShard>> Shards;
+};
@@ -0,0 +1,294 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#include "BHttpObjectStoreUpload.h"
+#include <random>
+#include <string>
+
+// Percent-encodes everything but the unreserved characters, and '/' if bKeepSlashes
+static FString EscapeUrlComponent(const FString& Value, bool bKeepSlashes)
+{
+    static const char* const Hex = "0123456789ABCDEF";
+
+    const std::string Utf8 = TCHAR_TO_UTF8(*Value);
+    std::string Result;
+    Result.reserve(Utf8.size() * 3);
+    for (const char Character : Utf8)
+    {
+        const uint8 Byte = static_cast<uint8>(Character);
+        if ((Byte >= 'A' && Byte <= 'Z') || (Byte >= 'a' && Byte <= 'z') || (Byte >= '0' && Byte <= '9')
+            || Byte == '-' || Byte == '_' || Byte == '.' || Byte == '~' || (bKeepSlashes && Byte == '/'))
+        {
+            Result += Character;
+        }
+        else
+        {
+            Result += '%';
+            Result += Hex[Byte >> 4];
+            Result += Hex[Byte & 15];
+        }
+    }
+    return UTF8_TO_TCHAR(Result.c_str());
+}
+
+static FString EscapeXml(const FString& Value)
+{
+    return Value.Replace(TEXT("&"), TEXT("&amp;")).Replace(TEXT("<"), TEXT("&lt;")).Replace(TEXT(">"), TEXT("&gt;")).Replace(TEXT("\""), TEXT("&quot;"));
+}
+
+// Text of the first <Name> element, empty if there is none; the responses of S3 are flat enough for that
+static FString GetXmlElement(const FString& Xml, const TCHAR* Name)
+{
+    const FString Open = FString(TEXT("<")) + Name + TEXT(">");
+    const FString Close = FString(TEXT("</")) + Name + TEXT(">");
+    const int32 Start = Xml.Find(*Open, ESearchCase::CaseSensitive);
+    if (Start < 0)
+    {
+        return FString();
+    }
+    const int32 End = Xml.Find(*Close, ESearchCase::CaseSensitive, ESearchDir::FromStart, Start + Open.Len());
+    if (End < 0)
+    {
+        return FString();
+    }
+    return Xml.Mid(Start + Open.Len(), End - Start - Open.Len()).Replace(TEXT("&quot;"), TEXT("\"")).Replace(TEXT("&amp;"), TEXT("&"));
+}
+
+static const FString* FindHeader(const FBHttpUploadResponse& Response, const TCHAR* Name)
+{
+    for (const TPair<FString, FString>& Pair : Response.HeadersData)
+    {
+        if (FCString::Stricmp(*Pair.Key, Name) == 0)
+        {
+            return &Pair.Value;
+        }
+    }
+    return nullptr;
+}
+
+static bool IsSuccessStatus(int32 StatusCode)
+{
+    return StatusCode >= 200 && StatusCode < 300;
+}
+
+/*
+ * S3
+ * */
+FBHttpS3PartUploadProtocol::FBHttpS3PartUploadProtocol(const FString& InObjectUrl, const TMap<FString, FString>& InHeadersData, const FString& InContentType)
+    : ObjectUrl(InObjectUrl)
+    , HeadersData(InHeadersData)
+    , ContentType(InContentType)
+{
+}
+
+int64 FBHttpS3PartUploadProtocol::GetPartBytes(int64 TotalBytes, int64 RequestedPartBytes) const
+{
+    constexpr int64 MinPartBytes = 5ll * 1024 * 1024;
+    constexpr int64 MaxPartBytes = 5ll * 1024 * 1024 * 1024;
+    constexpr int64 MaxParts = 10000;
+
+    const int64 PartBytes = FMath::Max<int64>(RequestedPartBytes > 0 ? RequestedPartBytes : 8ll * 1024 * 1024, (TotalBytes + MaxParts - 1) / MaxParts);
+    return FMath::Clamp(PartBytes, MinPartBytes, MaxPartBytes);
+}
+
+void FBHttpS3PartUploadProtocol::MakeRequest(EBHttpBatchVerb Verb, const FString& Query, FBHttpUploadRequest& OutRequest) const
+{
+    OutRequest.Verb = Verb;
+    OutRequest.FullPath = ObjectUrl + TEXT("?") + Query;
+    OutRequest.HeadersData = HeadersData;
+    PrepareRequest(OutRequest);
+}
+
+bool FBHttpS3PartUploadProtocol::MakeStartRequest(FBHttpUploadRequest& OutRequest)
+{
+    // The object's Content-Type is set here, the parts have none
+    OutRequest.ContentType = ContentType;
+    MakeRequest(EBHttpBatchVerb::Post, TEXT("uploads"), OutRequest);
+    return true;
+}
+
+bool FBHttpS3PartUploadProtocol::OnStartResponse(const FBHttpUploadResponse& Response)
+{
+    if (!IsSuccessStatus(Response.StatusCode))
+    {
+        return false;
+    }
+    UploadId = GetXmlElement(Response.Body, TEXT("UploadId"));
+    return !UploadId.IsEmpty();
+}
+
+void FBHttpS3PartUploadProtocol::MakePartRequest(int32 PartIndex, int64 Offset, int64 Bytes, FBHttpUploadRequest& OutRequest)
+{
+    MakeRequest(EBHttpBatchVerb::Put, FString::Printf(TEXT("partNumber=%d&uploadId=%s"), PartIndex + 1, *EscapeUrlComponent(UploadId, false)), OutRequest);
+}
+
+bool FBHttpS3PartUploadProtocol::OnPartResponse(int32 PartIndex, const FBHttpUploadResponse& Response, FString& OutPartTag)
+{
+    const FString* ETag = FindHeader(Response, TEXT("ETag"));
+    if (!IsSuccessStatus(Response.StatusCode) || !ETag || ETag->IsEmpty())
+    {
+        return false;
+    }
+    OutPartTag = *ETag;
+    return true;
+}
+
+void FBHttpS3PartUploadProtocol::MakeCompleteRequests(const TArray<FString>& PartTags, TArray<FBHttpUploadRequest>& OutRequests)
+{
+    FBHttpUploadRequest Request;
+    Request.ContentType = TEXT("application/xml");
+    Request.Body = TEXT("<CompleteMultipartUpload>");
+    for (int32 i = 0; i < PartTags.Num(); i++)
+    {
+        Request.Body += FString::Printf(TEXT("<Part><PartNumber>%d</PartNumber><ETag>%s</ETag></Part>"), i + 1, *EscapeXml(PartTags[i]));
+    }
+    Request.Body += TEXT("</CompleteMultipartUpload>");
+    MakeRequest(EBHttpBatchVerb::Post, FString(TEXT("uploadId=")) + EscapeUrlComponent(UploadId, false), Request);
+    OutRequests.Add(Request);
+}
+
+bool FBHttpS3PartUploadProtocol::OnCompleteResponse(int32 RequestIndex, const FBHttpUploadResponse& Response)
+{
+    if (!IsSuccessStatus(Response.StatusCode) || Response.Body.Find(TEXT("<Error>"), ESearchCase::CaseSensitive) >= 0)
+    {
+        return false;
+    }
+    ObjectETag = GetXmlElement(Response.Body, TEXT("ETag"));
+    return true;
+}
+
+void FBHttpS3PartUploadProtocol::MakeAbortRequests(const TArray<FString>& PartTags, TArray<FBHttpUploadRequest>& OutRequests)
+{
+    if (UploadId.IsEmpty())
+    {
+        return;
+    }
+
+    // Also drops the parts that were uploaded
+    FBHttpUploadRequest Request;
+    MakeRequest(EBHttpBatchVerb::Delete, FString(TEXT("uploadId=")) + EscapeUrlComponent(UploadId, false), Request);
+    OutRequests.Add(Request);
+}
+
+/*
+ * GCS compose
+ * */
+FBHttpGcsComposeUploadProtocol::FBHttpGcsComposeUploadProtocol(const FString& InBucketUrl, const FString& InObjectName, const TMap<FString, FString>& InHeadersData, const FString& InContentType)
+    : BucketUrl(InBucketUrl)
+    , ObjectName(InObjectName)
+    , HeadersData(InHeadersData)
+    , ContentType(InContentType)
+{
+    std::random_device Device;
+    const uint64 Random = (static_cast<uint64>(Device()) << 32) ^ Device() ^ FPlatformTime::Cycles64();
+    UploadTag = FString::Printf(TEXT("%016llx"), static_cast<unsigned long long>(Random));
+}
+
+int64 FBHttpGcsComposeUploadProtocol::GetPartBytes(int64 TotalBytes, int64 RequestedPartBytes) const
+{
+    constexpr int64 MaxParts = MaxComposeSources * MaxComposeSources;
+
+    const int64 PartBytes = FMath::Max<int64>(RequestedPartBytes > 0 ? RequestedPartBytes : 16ll * 1024 * 1024, (TotalBytes + MaxParts - 1) / MaxParts);
+    return FMath::Max<int64>(PartBytes, 1);
+}
+
+FString FBHttpGcsComposeUploadProtocol::GetTemporaryObjectName(const TCHAR* Kind, int32 Index) const
+{
+    return FString::Printf(TEXT("%s.%s.%s%d"), *ObjectName, *UploadTag, Kind, Index);
+}
+
+FString FBHttpGcsComposeUploadProtocol::GetObjectUrl(const FString& Name) const
+{
+    return BucketUrl + TEXT("/") + EscapeUrlComponent(Name, true);
+}
+
+void FBHttpGcsComposeUploadProtocol::MakePartRequest(int32 PartIndex, int64 Offset, int64 Bytes, FBHttpUploadRequest& OutRequest)
+{
+    OutRequest.Verb = EBHttpBatchVerb::Put;
+    OutRequest.FullPath = GetObjectUrl(GetTemporaryObjectName(TEXT("part"), PartIndex));
+    OutRequest.HeadersData = HeadersData;
+    OutRequest.ContentType = ContentType;
+}
+
+bool FBHttpGcsComposeUploadProtocol::OnPartResponse(int32 PartIndex, const FBHttpUploadResponse& Response, FString& OutPartTag)
+{
+    if (!IsSuccessStatus(Response.StatusCode))
+    {
+        return false;
+    }
+    OutPartTag = GetTemporaryObjectName(TEXT("part"), PartIndex);
+    return true;
+}
+
+void FBHttpGcsComposeUploadProtocol::MakeComposeRequest(const FString& Destination, const TArray<FString>& Sources, int32 First, int32 Count, FBHttpUploadRequest& OutRequest) const
+{
+    OutRequest.Verb = EBHttpBatchVerb::Put;
+    OutRequest.FullPath = GetObjectUrl(Destination) + TEXT("?compose");
+    OutRequest.HeadersData = HeadersData;
+    // Becomes the Content-Type of the composed object
+    OutRequest.ContentType = ContentType;
+    OutRequest.Body = TEXT("<ComposeRequest>");
+    for (int32 i = First; i < First + Count; i++)
+    {
+        OutRequest.Body += FString(TEXT("<Component><Name>")) + EscapeXml(Sources[i]) + TEXT("</Name></Component>");
+    }
+    OutRequest.Body += TEXT("</ComposeRequest>");
+}
+
+void FBHttpGcsComposeUploadProtocol::MakeDeleteRequest(const FString& Name, FBHttpUploadRequest& OutRequest) const
+{
+    OutRequest.Verb = EBHttpBatchVerb::Delete;
+    OutRequest.FullPath = GetObjectUrl(Name);
+    OutRequest.HeadersData = HeadersData;
+}
+
+void FBHttpGcsComposeUploadProtocol::MakeCompleteRequests(const TArray<FString>& PartTags, TArray<FBHttpUploadRequest>& OutRequests)
+{
+    GroupCount = 0;
+    if (PartTags.Num() <= MaxComposeSources)
+    {
+        FBHttpUploadRequest Request;
+        MakeComposeRequest(ObjectName, PartTags, 0, PartTags.Num(), Request);
+        OutRequests.Add(Request);
+        return;
+    }
+
+    TArray<FString> Groups;
+    for (int32 First = 0; First < PartTags.Num(); First += MaxComposeSources)
+    {
+        Groups.Add(GetTemporaryObjectName(TEXT("group"), GroupCount++));
+
+        FBHttpUploadRequest Request;
+        MakeComposeRequest(Groups.Last(), PartTags, First, FMath::Min(MaxComposeSources, PartTags.Num() - First), Request);
+        OutRequests.Add(Request);
+    }
+
+    FBHttpUploadRequest Request;
+    MakeComposeRequest(ObjectName, Groups, 0, Groups.Num(), Request);
+    OutRequests.Add(Request);
+}
+
+void FBHttpGcsComposeUploadProtocol::MakeCleanupRequests(const TArray<FString>& PartTags, TArray<FBHttpUploadRequest>& OutRequests)
+{
+    MakeAbortRequests(PartTags, OutRequests);
+}
+
+void FBHttpGcsComposeUploadProtocol::MakeAbortRequests(const TArray<FString>& PartTags, TArray<FBHttpUploadRequest>& OutRequests)
+{
+    for (const FString& PartTag : PartTags)
+    {
+        if (!PartTag.IsEmpty())
+        {
+            FBHttpUploadRequest Request;
+            MakeDeleteRequest(PartTag, Request);
+            OutRequests.Add(Request);
+        }
+    }
+
+    // Groups a failed completion did not get to yet are not there, their deletes only get a 404
+    for (int32 i = 0; i < GroupCount; i++)
+    {
+        FBHttpUploadRequest Request;
+        MakeDeleteRequest(GetTemporaryObjectName(TEXT("group"), i), Request);
+        OutRequests.Add(Request);
+    }
+}
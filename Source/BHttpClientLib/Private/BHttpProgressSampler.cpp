@@ -0,0 +1,69 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#include "BHttpProgressSampler.h"
+#include <mutex>
+
+static std::mutex OptionsMutex;
+static FBHttpProgressLogOptions SharedOptions;
+
+BHttpProgressSampler::BHttpProgressSampler()
+{
+    {
+        std::lock_guard<std::mutex> Lock(OptionsMutex);
+        Options = SharedOptions;
+    }
+    LastLogTime = FPlatformTime::Seconds();
+    NextPercent = Options.PercentStep;
+}
+
+bool BHttpProgressSampler::ShouldLog(uint64 Current, uint64 Total)
+{
+    if (bCompleted)
+    {
+        return false;
+    }
+
+    bool bLog = false;
+    if (Total > 0)
+    {
+        if (Current >= Total)
+        {
+            bCompleted = true;
+            return true;
+        }
+
+        const int32 Percent = GetPercent(Current, Total);
+        if (Options.PercentStep > 0 && Percent >= NextPercent)
+        {
+            NextPercent = (Percent / Options.PercentStep + 1) * Options.PercentStep;
+            bLog = true;
+        }
+    }
+
+    const double Now = FPlatformTime::Seconds();
+    if (Options.IntervalSeconds > 0.0 && Now - LastLogTime >= Options.IntervalSeconds)
+    {
+        bLog = true;
+    }
+    if (bLog)
+    {
+        LastLogTime = Now;
+    }
+    return bLog;
+}
+
+int32 BHttpProgressSampler::GetPercent(uint64 Current, uint64 Total)
+{
+    // Chunked responses report a total of 0
+    if (Total == 0)
+    {
+        return -1;
+    }
+    return (int32)(FMath::Min(Current, Total) * 100 / Total);
+}
+
+void BHttpProgressSampler::SetOptions(const FBHttpProgressLogOptions& InOptions)
+{
+    std::lock_guard<std::mutex> Lock(OptionsMutex);
+    SharedOptions = InOptions;
+}
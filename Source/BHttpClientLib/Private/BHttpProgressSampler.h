@@ -0,0 +1,41 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BHttpClient.h"
+
+/*
+ * Picks the progress callbacks of one transfer that are worth a log line, so a multi-GB transfer
+ * logs a handful of lines instead of one per 8 KB. Check UE_LOG_ACTIVE before calling ShouldLog,
+ * then a suppressed category costs neither the sampling nor the formatting.
+ *
+ * */
+class BHttpProgressSampler
+{
+public:
+    // Takes the options set by BHttpClient::SetProgressLogOptions at construction
+    BHttpProgressSampler();
+
+    //************************************
+    // Method:    ShouldLog is true when Current crossed the next percent step, the interval passed, or the transfer just completed
+    // FullName:  BHttpProgressSampler::ShouldLog
+    // Access:    public
+    // Returns:   bool
+    // Qualifier:
+    // Parameter: uint64 Current
+    // Parameter: uint64 Total (0 if unknown)
+    //************************************
+    bool ShouldLog(uint64 Current, uint64 Total);
+
+    // 0-100, -1 if Total is unknown
+    static int32 GetPercent(uint64 Current, uint64 Total);
+
+    static void SetOptions(const FBHttpProgressLogOptions& InOptions);
+
+private:
+    FBHttpProgressLogOptions Options;
+    double LastLogTime;
+    int32 NextPercent;
+    bool bCompleted = false;
+};
@@ -0,0 +1,160 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#include "BHttpRequestScheduler.h"
+#include <chrono>
+
+BHttpRequestScheduler& BHttpRequestScheduler::Get()
+{
+    static BHttpRequestScheduler Instance;
+    return Instance;
+}
+
+void BHttpRequestScheduler::Acquire(const std::string& Host, EBHttpRequestPriority Priority)
+{
+    std::unique_lock<std::mutex> Lock(Mutex);
+
+    FWaiter Waiter;
+    Waiter.Host = Host;
+    Waiter.Priority = Priority;
+    Waiter.EnqueuedAt = FPlatformTime::Seconds();
+
+    Hosts[Host].Waiting++;
+    Waiters.push_back(&Waiter);
+    GrantSlots(Host, Waiter.EnqueuedAt);
+
+    // Waiters that are not granted here get their slot from Release, which re-evaluates aging
+    SlotGranted.wait(Lock, [&Waiter]() { return Waiter.bGranted; });
+
+    RecordWait(Priority, FPlatformTime::Seconds() - Waiter.EnqueuedAt);
+}
+
+void BHttpRequestScheduler::Release(const std::string& Host, EBHttpRequestPriority Priority)
+{
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+
+        Hosts[Host].InFlight--;
+        if (Priority == EBHttpRequestPriority::Interactive)
+        {
+            InteractiveActive--;
+        }
+        GrantSlots(Host, FPlatformTime::Seconds());
+    }
+    SlotGranted.notify_all();
+    InteractiveDone.notify_all();
+}
+
+void BHttpRequestScheduler::GrantSlots(const std::string& Host, double Now)
+{
+    FHostState& State = Hosts[Host];
+    const int32 MaxInFlight = Options.MaxConnectionsPerHost > 0 ? Options.MaxConnectionsPerHost : 1;
+    const double AgingSeconds = Options.AgingSeconds;
+
+    bool bGrantedAny = false;
+    while (State.Waiting > 0 && State.InFlight < MaxInFlight)
+    {
+        auto Best = Waiters.end();
+        double BestScore = 0.0;
+        for (auto It = Waiters.begin(); It != Waiters.end(); ++It)
+        {
+            if ((*It)->Host != Host)
+            {
+                continue;
+            }
+            double Score = (double)(*It)->Priority;
+            if (AgingSeconds > 0.0)
+            {
+                Score += (Now - (*It)->EnqueuedAt) / AgingSeconds;
+            }
+            if (Best == Waiters.end() || Score > BestScore)
+            {
+                Best = It;
+                BestScore = Score;
+            }
+        }
+
+        (*Best)->bGranted = true;
+        if ((*Best)->Priority == EBHttpRequestPriority::Interactive)
+        {
+            InteractiveActive++;
+        }
+        Waiters.erase(Best);
+        State.Waiting--;
+        State.InFlight++;
+        bGrantedAny = true;
+    }
+
+    if (bGrantedAny)
+    {
+        SlotGranted.notify_all();
+    }
+}
+
+void BHttpRequestScheduler::WaitWhilePreempted(EBHttpRequestPriority Priority)
+{
+    if (Priority != EBHttpRequestPriority::Background)
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> Lock(Mutex);
+    if (!Options.bPreemptBackgroundDownloads || InteractiveActive == 0)
+    {
+        return;
+    }
+
+    // Bounded, a reader that stalls for too long gets its connection dropped by the server
+    const auto Deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(Options.MaxPreemptPauseSeconds));
+    InteractiveDone.wait_until(Lock, Deadline, [this]() { return InteractiveActive == 0 || !Options.bPreemptBackgroundDownloads; });
+}
+
+void BHttpRequestScheduler::SetOptions(const FBHttpSchedulingOptions& InOptions)
+{
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Options = InOptions;
+
+        // A raised limit frees slots right away
+        const double Now = FPlatformTime::Seconds();
+        for (auto& Entry : Hosts)
+        {
+            GrantSlots(Entry.first, Now);
+        }
+    }
+    InteractiveDone.notify_all();
+}
+
+void BHttpRequestScheduler::RecordWait(EBHttpRequestPriority Priority, double WaitSeconds)
+{
+    FBHttpQueueWaitStats& Stats = WaitStats[FMath::Min((int32)Priority, PriorityCount - 1)];
+    Stats.Count++;
+    Stats.TotalSeconds += WaitSeconds;
+    Stats.MaxSeconds = FMath::Max(Stats.MaxSeconds, WaitSeconds);
+}
+
+FBHttpQueueWaitStats BHttpRequestScheduler::GetQueueWaitStats(EBHttpRequestPriority Priority)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return WaitStats[FMath::Min((int32)Priority, PriorityCount - 1)];
+}
+
+void BHttpRequestScheduler::ResetQueueWaitStats()
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    for (int32 i = 0; i < PriorityCount; i++)
+    {
+        WaitStats[i] = FBHttpQueueWaitStats();
+    }
+}
+
+BHttpScheduledSlot::BHttpScheduledSlot(const FString& InHost)
+    : Host(TCHAR_TO_UTF8(*InHost))
+    , Priority(FBHttpPriorityScope::Current())
+{
+    BHttpRequestScheduler::Get().Acquire(Host, Priority);
+}
+
+BHttpScheduledSlot::~BHttpScheduledSlot()
+{
+    BHttpRequestScheduler::Get().Release(Host, Priority);
+}
@@ -0,0 +1,105 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BHttpClient.h"
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+
+/*
+ * Connection slots per host. When a slot frees up it goes to the waiting request with the highest
+ * priority, a waiting request gains one priority level every AgingSeconds so background work still
+ * gets through under constant interactive load.
+ *
+ * */
+class BHttpRequestScheduler
+{
+public:
+    static BHttpRequestScheduler& Get();
+
+    //************************************
+    // Method:    Acquire blocks until Host has a free slot and this request is the best waiter for it
+    // FullName:  BHttpRequestScheduler::Acquire
+    // Access:    public
+    // Returns:   void
+    // Qualifier:
+    // Parameter: const std::string & Host (scheme://host[:port] as produced by BHttpClient::SplitPath)
+    // Parameter: EBHttpRequestPriority Priority
+    //************************************
+    void Acquire(const std::string& Host, EBHttpRequestPriority Priority);
+
+    void Release(const std::string& Host, EBHttpRequestPriority Priority);
+
+    //************************************
+    // Method:    WaitWhilePreempted pauses a background download while interactive requests are running
+    // FullName:  BHttpRequestScheduler::WaitWhilePreempted
+    // Access:    public
+    // Returns:   void
+    // Qualifier:
+    // Parameter: EBHttpRequestPriority Priority (only Background ever waits)
+    //************************************
+    void WaitWhilePreempted(EBHttpRequestPriority Priority);
+
+    void SetOptions(const FBHttpSchedulingOptions& InOptions);
+
+    FBHttpQueueWaitStats GetQueueWaitStats(EBHttpRequestPriority Priority);
+
+    void ResetQueueWaitStats();
+
+private:
+    struct FWaiter
+    {
+        std::string Host;
+        EBHttpRequestPriority Priority;
+        double EnqueuedAt = 0.0;
+        bool bGranted = false;
+    };
+
+    struct FHostState
+    {
+        int32 InFlight = 0;
+        int32 Waiting = 0;
+    };
+
+    // Grants free slots to the best waiters, caller holds the lock
+    void GrantSlots(const std::string& Host, double Now);
+
+    void RecordWait(EBHttpRequestPriority Priority, double WaitSeconds);
+
+    std::mutex Mutex;
+    std::condition_variable SlotGranted;
+    std::condition_variable InteractiveDone;
+
+    // In arrival order, ties in effective priority go to the earlier waiter
+    std::list<FWaiter*> Waiters;
+    std::map<std::string, FHostState> Hosts;
+
+    // Granted a slot and not released yet, across all hosts
+    int32 InteractiveActive = 0;
+
+    FBHttpSchedulingOptions Options;
+
+    static constexpr int32 PriorityCount = 3;
+    FBHttpQueueWaitStats WaitStats[PriorityCount];
+};
+
+/*
+ * Holds a slot for the current scope, the priority comes from FBHttpPriorityScope
+ *
+ * */
+class BHttpScheduledSlot
+{
+public:
+    BHttpScheduledSlot(const FString& Host);
+    ~BHttpScheduledSlot();
+
+    EBHttpRequestPriority GetPriority() const { return Priority; }
+
+private:
+    std::string Host;
+    EBHttpRequestPriority Priority;
+};
@@ -0,0 +1,75 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#include "BHttpTimingStats.h"
+
+BHttpTimingStats& BHttpTimingStats::Get()
+{
+    static BHttpTimingStats Instance;
+    return Instance;
+}
+
+FBHttpRequestTimings BHttpTimingStats::Convert(const httplib::RequestTimings& Timings)
+{
+    FBHttpRequestTimings Result;
+    Result.DnsSeconds = Timings.dns();
+    Result.ConnectSeconds = Timings.connect();
+    Result.TlsSeconds = Timings.tls();
+    Result.UploadSeconds = Timings.upload();
+    Result.TimeToFirstByteSeconds = Timings.ttfb();
+    Result.TransferSeconds = Timings.transfer();
+    Result.TotalSeconds = Timings.total();
+    Result.bReusedConnection = Timings.reused_connection;
+    Result.bKernelTlsSend = Timings.kernel_tls_send;
+    Result.bKernelTlsReceive = Timings.kernel_tls_recv;
+    return Result;
+}
+
+void BHttpTimingStats::Notify(const FString& Host, const FString& Path, int32 StatusCode, const FBHttpRequestTimings& Timings)
+{
+    if (!bHasCallback.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    // Copied so a slow callback doesn't block SetCallback, and SetCallback(nullptr) can't pull it away mid-call
+    TFunction<void(const FString&, int32, const FBHttpRequestTimings&)> CallbackCopy;
+    {
+        std::lock_guard<std::mutex> Lock(CallbackMutex);
+        CallbackCopy = Callback;
+    }
+    if (CallbackCopy)
+    {
+        CallbackCopy(Host + Path, StatusCode, Timings);
+    }
+}
+
+void BHttpTimingStats::SetCallback(TFunction<void(const FString&, int32, const FBHttpRequestTimings&)> InCallback)
+{
+    std::lock_guard<std::mutex> Lock(CallbackMutex);
+    Callback = InCallback;
+    bHasCallback.store((bool)Callback, std::memory_order_relaxed);
+}
+
+double FBHttpTimingHistogram::GetPercentile(double Percentile) const
+{
+    if (Count <= 0)
+    {
+        return 0.0;
+    }
+
+    const double Target = FMath::Clamp(Percentile, 0.0, 100.0) / 100.0 * Count;
+    int64 Seen = 0;
+    for (int32 i = 0; i < BucketCounts.Num(); i++)
+    {
+        if (BucketCounts[i] > 0 && Seen + BucketCounts[i] >= Target)
+        {
+            // Linear within the bucket, clamped to what was actually seen
+            const double Lower = FMath::Max(i > 0 ? BucketUpperBoundsSeconds[i - 1] : 0.0, MinSeconds);
+            const double Upper = FMath::Min(BucketUpperBoundsSeconds[i], MaxSeconds);
+            const double Fraction = FMath::Clamp((Target - Seen) / BucketCounts[i], 0.0, 1.0);
+            return Lower + (FMath::Max(Upper, Lower) - Lower) * Fraction;
+        }
+        Seen += BucketCounts[i];
+    }
+    return MaxSeconds;
+}
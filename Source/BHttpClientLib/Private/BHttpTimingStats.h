@@ -0,0 +1,43 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BHttpClient.h"
+#include "BHttpClientUtils.h"
+#include <atomic>
+#include <mutex>
+
+/*
+ * Per-phase durations of a response as BHttpClient hands them out, and the timing callback. Their
+ * histograms are kept by BHttpMetrics, in its per-thread shards.
+ *
+ * */
+class BHttpTimingStats
+{
+public:
+    static BHttpTimingStats& Get();
+
+    static FBHttpRequestTimings Convert(const httplib::RequestTimings& Timings);
+
+    //************************************
+    // Method:    Notify hands one response to the timing callback, a relaxed atomic load if there is none
+    // FullName:  BHttpTimingStats::Notify
+    // Access:    public
+    // Returns:   void
+    // Qualifier:
+    // Parameter: const FString & Host
+    // Parameter: const FString & Path (the callback gets Host + Path, only built when it is set)
+    // Parameter: int32 StatusCode
+    // Parameter: const FBHttpRequestTimings & Timings
+    //************************************
+    void Notify(const FString& Host, const FString& Path, int32 StatusCode, const FBHttpRequestTimings& Timings);
+
+    void SetCallback(TFunction<void(const FString&, int32, const FBHttpRequestTimings&)> InCallback);
+
+private:
+    std::atomic<bool> bHasCallback{ false };
+
+    std::mutex CallbackMutex;
+    TFunction<void(const FString&, int32, const FBHttpRequestTimings&)> Callback;
+};
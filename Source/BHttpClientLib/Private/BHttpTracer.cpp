@@ -0,0 +1,391 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#include "BHttpTracer.h"
+#include "BHttpMetrics.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <set>
+
+BHttpTracer& BHttpTracer::Get()
+{
+    static BHttpTracer Instance;
+    return Instance;
+}
+
+void BHttpTracer::SetEnabled(bool bInEnabled, int32 MaxRequests)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    // Disabling keeps the buffer for Dump, whatever MaxRequests says
+    const size_t Capacity = (size_t)FMath::Max(MaxRequests, 1);
+    if (bInEnabled && Ring.size() != Capacity)
+    {
+        Ring.clear();
+        Ring.resize(Capacity);
+        Recorded = 0;
+    }
+    bEnabled.store(bInEnabled, std::memory_order_relaxed);
+}
+
+void BHttpTracer::Record(EBHttpBatchVerb Verb, const FString& Url, int32 StatusCode, const httplib::RequestTimings& Timings)
+{
+    if (!IsEnabled())
+    {
+        return;
+    }
+
+    const uint32 ThreadId = FPlatformTLS::GetCurrentThreadId();
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (Ring.empty())
+    {
+        return;
+    }
+
+    // Overwrites the oldest entry once full; assigning into the old slot reuses its Url buffer
+    FTracedRequest& Slot = Ring[Recorded % Ring.size()];
+    Slot.Id = ++Recorded;
+    Slot.ThreadId = ThreadId;
+    Slot.Verb = Verb;
+    Slot.StatusCode = StatusCode;
+    Slot.Url = TCHAR_TO_UTF8(*Url);
+    Slot.Timings = Timings;
+}
+
+void BHttpTracer::Clear()
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Recorded = 0;
+}
+
+void BHttpTracer::CopyRequests(std::vector<FTracedRequest>& OutRequests)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (Ring.empty())
+    {
+        return;
+    }
+
+    const uint64 Count = FMath::Min<uint64>(Recorded, Ring.size());
+    OutRequests.reserve((size_t)Count);
+    for (uint64 i = Recorded - Count; i < Recorded; i++)
+    {
+        OutRequests.push_back(Ring[i % Ring.size()]);
+    }
+}
+
+void BHttpTracer::GetPhases(const httplib::RequestTimings& Timings, std::vector<FPhase>& OutPhases)
+{
+    const double Start = Timings.start;
+    const double End = FMath::Max(Timings.end, Start);
+
+    auto Add = [&](const char* Name, double PhaseStart, double PhaseEnd) {
+        PhaseStart = FMath::Clamp(PhaseStart, Start, End);
+        PhaseEnd = FMath::Clamp(PhaseEnd, PhaseStart, End);
+        OutPhases.push_back(FPhase{ Name, PhaseStart, PhaseEnd });
+    };
+
+    // Each phase starts where the previous one that happened ended
+    double Ready = Start;
+    if (Timings.dns_end > 0)
+    {
+        Add("resolve", Timings.dns_start, Timings.dns_end);
+        Ready = Timings.dns_end;
+    }
+    if (Timings.connect_end > 0)
+    {
+        Add("connect", Ready, Timings.connect_end);
+        Ready = Timings.connect_end;
+    }
+    if (Timings.tls_end > 0)
+    {
+        Add("handshake", Ready, Timings.tls_end);
+        Ready = Timings.tls_end;
+    }
+    if (Timings.headers_sent > 0)
+    {
+        Add("send headers", Ready, Timings.headers_sent);
+        Ready = Timings.headers_sent;
+    }
+    if (Timings.request_sent > 0)
+    {
+        if (Timings.headers_sent > 0 && Timings.request_sent > Timings.headers_sent)
+        {
+            Add("send body", Timings.headers_sent, Timings.request_sent);
+        }
+        Ready = FMath::Max(Ready, Timings.request_sent);
+    }
+    if (Timings.first_byte > 0)
+    {
+        Add("wait", Ready, Timings.first_byte);
+        if (Timings.end > 0)
+        {
+            Add("receive", Timings.first_byte, Timings.end);
+        }
+    }
+}
+
+static std::string EscapeJson(const std::string& Value)
+{
+    std::string Result;
+    Result.reserve(Value.size());
+    for (unsigned char c : Value)
+    {
+        if (c == '"' || c == '\\')
+        {
+            Result += '\\';
+            Result += (char)c;
+        }
+        else if (c < 0x20)
+        {
+            char Escaped[8];
+            snprintf(Escaped, sizeof(Escaped), "\\u%04x", c);
+            Result += Escaped;
+        }
+        else
+        {
+            Result += (char)c;
+        }
+    }
+    return Result;
+}
+
+void BHttpTracer::WriteChromeJson(std::ostream& Out, const std::vector<FTracedRequest>& Requests)
+{
+    const uint32 ProcessId = FPlatformProcess::GetCurrentProcessId();
+    std::vector<FPhase> Phases;
+    char Line[512];
+    bool bFirst = true;
+
+    // Async begin/end pairs sharing the request id, phases nest inside their request
+    auto WriteEvent = [&](const char* Phase, const std::string& Name, uint64 Id, uint32 ThreadId, double Seconds, const std::string& Args) {
+        snprintf(Line, sizeof(Line), "%s\n{\"cat\":\"bhttp\",\"ph\":\"%s\",\"id\":\"0x%llx\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"name\":\"",
+            bFirst ? "" : ",", Phase, (unsigned long long)Id, ProcessId, ThreadId, Seconds * 1000000.0);
+        Out << Line << EscapeJson(Name) << "\"" << Args << "}";
+        bFirst = false;
+    };
+
+    Out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (const FTracedRequest& Request : Requests)
+    {
+        const std::string Name = std::string(BHttpMetrics::GetVerbName(Request.Verb)) + " " + Request.Url;
+        snprintf(Line, sizeof(Line), ",\"args\":{\"status\":%d,\"reused_connection\":%s,\"url\":\"", Request.StatusCode, Request.Timings.reused_connection ? "true" : "false");
+        const std::string Args = std::string(Line) + EscapeJson(Request.Url) + "\"}";
+
+        WriteEvent("b", Name, Request.Id, Request.ThreadId, Request.Timings.start, Args);
+
+        Phases.clear();
+        GetPhases(Request.Timings, Phases);
+        for (const FPhase& Phase : Phases)
+        {
+            WriteEvent("b", Phase.Name, Request.Id, Request.ThreadId, Phase.Start, std::string());
+            WriteEvent("e", Phase.Name, Request.Id, Request.ThreadId, Phase.End, std::string());
+        }
+
+        WriteEvent("e", Name, Request.Id, Request.ThreadId, FMath::Max(Request.Timings.end, Request.Timings.start), std::string());
+    }
+    Out << "\n]}\n";
+}
+
+/*
+ * Just enough of the protobuf wire format for perfetto.protos.Trace: TracePacket (1) holding either a
+ * TrackDescriptor (60) or a TrackEvent (11) slice begin/end.
+ *
+ * */
+static void AppendVarint(std::string& Out, uint64 Value)
+{
+    while (Value >= 0x80)
+    {
+        Out += (char)((Value & 0x7F) | 0x80);
+        Value >>= 7;
+    }
+    Out += (char)Value;
+}
+
+static void AppendUInt(std::string& Out, uint32 Field, uint64 Value)
+{
+    AppendVarint(Out, (uint64)Field << 3);
+    AppendVarint(Out, Value);
+}
+
+static void AppendBytes(std::string& Out, uint32 Field, const std::string& Value)
+{
+    AppendVarint(Out, ((uint64)Field << 3) | 2);
+    AppendVarint(Out, Value.size());
+    Out += Value;
+}
+
+namespace BHttpPerfetto
+{
+    // perfetto.protos field numbers
+    enum : uint32
+    {
+        TracePacket = 1,
+
+        PacketTimestamp = 8,
+        PacketSequenceId = 10,
+        PacketTrackEvent = 11,
+        PacketSequenceFlags = 13,
+        PacketTrackDescriptor = 60,
+
+        TrackUuid = 1,
+        TrackName = 2,
+        TrackThread = 4,
+        TrackParentUuid = 5,
+
+        ThreadPid = 1,
+        ThreadTid = 2,
+
+        EventDebugAnnotations = 4,
+        EventType = 9,
+        EventTrackUuid = 11,
+        EventName = 23,
+
+        AnnotationIntValue = 4,
+        AnnotationStringValue = 6,
+        AnnotationName = 10,
+
+        TypeSliceBegin = 1,
+        TypeSliceEnd = 2,
+
+        SequenceId = 1,
+        SeqIncrementalStateCleared = 1
+    };
+}
+
+void BHttpTracer::WritePerfettoProtobuf(std::ostream& Out, const std::vector<FTracedRequest>& Requests)
+{
+    using namespace BHttpPerfetto;
+
+    const uint32 ProcessId = FPlatformProcess::GetCurrentProcessId();
+    auto ThreadUuid = [](uint32 ThreadId) { return (1ull << 48) | ThreadId; };
+    auto RequestUuid = [](uint64 Id) { return (2ull << 48) | Id; };
+
+    std::string Trace;
+    bool bFirstPacket = true;
+    auto WritePacket = [&](const std::string& Packet) {
+        std::string Framed = Packet;
+        AppendUInt(Framed, PacketSequenceId, SequenceId);
+        if (bFirstPacket)
+        {
+            AppendUInt(Framed, PacketSequenceFlags, SeqIncrementalStateCleared);
+            bFirstPacket = false;
+        }
+        AppendBytes(Trace, TracePacket, Framed);
+    };
+
+    // One track per thread, each request is a child track of the thread that made it
+    std::set<uint32> Threads;
+    for (const FTracedRequest& Request : Requests)
+    {
+        if (Threads.insert(Request.ThreadId).second)
+        {
+            std::string Thread;
+            AppendUInt(Thread, ThreadPid, ProcessId);
+            AppendUInt(Thread, ThreadTid, Request.ThreadId);
+
+            std::string Descriptor;
+            AppendUInt(Descriptor, TrackUuid, ThreadUuid(Request.ThreadId));
+            AppendBytes(Descriptor, TrackThread, Thread);
+
+            std::string Packet;
+            AppendBytes(Packet, PacketTrackDescriptor, Descriptor);
+            WritePacket(Packet);
+        }
+
+        std::string Descriptor;
+        AppendUInt(Descriptor, TrackUuid, RequestUuid(Request.Id));
+        AppendBytes(Descriptor, TrackName, std::string(BHttpMetrics::GetVerbName(Request.Verb)) + " " + Request.Url);
+        AppendUInt(Descriptor, TrackParentUuid, ThreadUuid(Request.ThreadId));
+
+        std::string Packet;
+        AppendBytes(Packet, PacketTrackDescriptor, Descriptor);
+        WritePacket(Packet);
+    }
+
+    // Slices are emitted in time order; stable, so an end stays ahead of a begin with the same timestamp
+    struct FSliceEvent
+    {
+        double Seconds;
+        std::string Packet;
+    };
+    std::vector<FSliceEvent> Events;
+    std::vector<FPhase> Phases;
+
+    auto AddSlice = [&](uint64 Track, double Seconds, bool bBegin, const char* Name, const std::string& Annotations) {
+        std::string Event;
+        AppendUInt(Event, EventType, bBegin ? TypeSliceBegin : TypeSliceEnd);
+        AppendUInt(Event, EventTrackUuid, Track);
+        if (bBegin)
+        {
+            AppendBytes(Event, EventName, Name);
+        }
+        Event += Annotations;
+
+        FSliceEvent Slice;
+        Slice.Seconds = Seconds;
+        AppendUInt(Slice.Packet, PacketTimestamp, (uint64)(Seconds * 1000000000.0));
+        AppendBytes(Slice.Packet, PacketTrackEvent, Event);
+        Events.push_back(std::move(Slice));
+    };
+
+    for (const FTracedRequest& Request : Requests)
+    {
+        const uint64 Track = RequestUuid(Request.Id);
+
+        std::string Status;
+        AppendBytes(Status, AnnotationName, "status");
+        AppendUInt(Status, AnnotationIntValue, (uint64)(int64)Request.StatusCode);
+        std::string Url;
+        AppendBytes(Url, AnnotationName, "url");
+        AppendBytes(Url, AnnotationStringValue, Request.Url);
+        std::string Annotations;
+        AppendBytes(Annotations, EventDebugAnnotations, Status);
+        AppendBytes(Annotations, EventDebugAnnotations, Url);
+
+        AddSlice(Track, Request.Timings.start, true, BHttpMetrics::GetVerbName(Request.Verb), Annotations);
+
+        Phases.clear();
+        GetPhases(Request.Timings, Phases);
+        for (const FPhase& Phase : Phases)
+        {
+            AddSlice(Track, Phase.Start, true, Phase.Name, std::string());
+            AddSlice(Track, Phase.End, false, Phase.Name, std::string());
+        }
+
+        AddSlice(Track, FMath::Max(Request.Timings.end, Request.Timings.start), false, nullptr, std::string());
+    }
+
+    std::stable_sort(Events.begin(), Events.end(), [](const FSliceEvent& A, const FSliceEvent& B) { return A.Seconds < B.Seconds; });
+    for (const FSliceEvent& Event : Events)
+    {
+        WritePacket(Event.Packet);
+    }
+
+    Out.write(Trace.data(), Trace.size());
+}
+
+bool BHttpTracer::Dump(const FString& FilePath, EBHttpTraceFormat Format)
+{
+    // Formatting happens on a copy, recording threads only wait for the copy
+    std::vector<FTracedRequest> Requests;
+    CopyRequests(Requests);
+
+    std::ofstream File(TCHAR_TO_UTF8(*FilePath), std::ios::binary | std::ios::trunc);
+    if (!File)
+    {
+        UE_LOG(LogBHttpClientLib, Error, TEXT("HttpClient->DumpTrace ==> Cannot open %s"), *FilePath);
+        return false;
+    }
+
+    if (Format == EBHttpTraceFormat::PerfettoProtobuf)
+    {
+        WritePerfettoProtobuf(File, Requests);
+    }
+    else
+    {
+        WriteChromeJson(File, Requests);
+    }
+    File.flush();
+    return File.good();
+}
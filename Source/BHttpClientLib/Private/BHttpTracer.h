@@ -0,0 +1,80 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BHttpClient.h"
+#include "BHttpClientUtils.h"
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+ * Ring buffer of finished requests with their phase timestamps, written out as Chrome trace JSON or
+ * Perfetto protobuf on demand. Each request gets its own async track so concurrent and multiplexed
+ * requests don't overlap; the requesting thread is recorded with it.
+ *
+ * While disabled, recording costs one relaxed atomic load.
+ *
+ * */
+class BHttpTracer
+{
+public:
+    static BHttpTracer& Get();
+
+    bool IsEnabled() const { return bEnabled.load(std::memory_order_relaxed); }
+
+    void SetEnabled(bool bInEnabled, int32 MaxRequests);
+
+    //************************************
+    // Method:    Record stores one request, called on the requesting thread once it finished
+    // FullName:  BHttpTracer::Record
+    // Access:    public
+    // Returns:   void
+    // Qualifier:
+    // Parameter: EBHttpBatchVerb Verb
+    // Parameter: const FString & Url
+    // Parameter: int32 StatusCode (-1 if no response arrived)
+    // Parameter: const httplib::RequestTimings & Timings (start and end at least)
+    //************************************
+    void Record(EBHttpBatchVerb Verb, const FString& Url, int32 StatusCode, const httplib::RequestTimings& Timings);
+
+    bool Dump(const FString& FilePath, EBHttpTraceFormat Format);
+
+    void Clear();
+
+private:
+    struct FTracedRequest
+    {
+        uint64 Id = 0;
+        uint32 ThreadId = 0;
+        EBHttpBatchVerb Verb = EBHttpBatchVerb::Get;
+        int32 StatusCode = -1;
+        std::string Url;
+        httplib::RequestTimings Timings;
+    };
+
+    struct FPhase
+    {
+        const char* Name;
+        double Start;
+        double End;
+    };
+
+    // Phases that happened, in order, clamped to the request's start and end
+    static void GetPhases(const httplib::RequestTimings& Timings, std::vector<FPhase>& OutPhases);
+
+    // Oldest first, under Mutex
+    void CopyRequests(std::vector<FTracedRequest>& OutRequests);
+
+    void WriteChromeJson(std::ostream& Out, const std::vector<FTracedRequest>& Requests);
+    void WritePerfettoProtobuf(std::ostream& Out, const std::vector<FTracedRequest>& Requests);
+
+    std::atomic<bool> bEnabled{ false };
+
+    std::mutex Mutex;
+    std::vector<FTracedRequest> Ring;
+    uint64 Recorded = 0;
+};
@@ -0,0 +1,59 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BHttpClient.h"
+#include "BHttpClientUtils.h"
+
+/*
+ * Incremental CRC32C, MD5 and SHA-256 of a body, fed with its bytes while they are sent or received,
+ * so integrity checks don't need another read of a multi-GB file afterwards. CRC32C runs on the
+ * SSE4.2 or ARMv8 CRC instructions when the CPU has them, slicing-by-8 tables otherwise; MD5 and
+ * SHA-256 are OpenSSL's. One hasher per body, not thread-safe.
+ *
+ * */
+class BHTTPCLIENTLIB_API FBHttpChecksumHasher
+{
+public:
+    explicit FBHttpChecksumHasher(EBHttpChecksum InAlgorithms);
+    ~FBHttpChecksumHasher();
+
+    FBHttpChecksumHasher(const FBHttpChecksumHasher&) = delete;
+    FBHttpChecksumHasher& operator=(const FBHttpChecksumHasher&) = delete;
+
+    // Starts over, for a body that is sent or received again
+    void Reset();
+
+    void Update(const void* Data, int64 Bytes);
+
+    // Digests of everything since the last Reset, which has to come before further use
+    FBHttpChecksums Finish();
+
+    uint64 GetBytes() const { return Bytes; }
+
+    // CRC32C of Bytes more bytes after the ones Crc covers, start with 0
+    static uint32 Crc32c(const void* Data, int64 Bytes, uint32 Crc = 0);
+
+    // SSE4.2 or ARMv8 CRC32 instructions, detected once
+    static bool HasHardwareCrc32c();
+
+    //************************************
+    // Method:    Verify compares computed digests with the ones the response headers carry: x-goog-hash, Content-MD5, x-amz-checksum-crc32c, x-amz-checksum-sha256 and, if trusted, an ETag
+    // FullName:  FBHttpChecksumHasher::Verify
+    // Access:    public static
+    // Returns:   EBHttpChecksumMatch Mismatched if any of them differs, Matched if one was compared, also set on InOutChecksums with CheckedHeaders
+    // Qualifier:
+    // Parameter: FBHttpChecksums & InOutChecksums
+    // Parameter: const httplib::Headers & Headers
+    // Parameter: bool bTrustETagAsMd5
+    //************************************
+    static EBHttpChecksumMatch Verify(FBHttpChecksums& InOutChecksums, const httplib::Headers& Headers, bool bTrustETagAsMd5);
+
+private:
+    EBHttpChecksum Algorithms;
+    uint64 Bytes = 0;
+    uint32 Crc = 0;
+    EVP_MD_CTX* Md5Context = nullptr;
+    EVP_MD_CTX* Sha256Context = nullptr;
+};
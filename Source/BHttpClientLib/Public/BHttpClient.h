@@ -3,12 +3,473 @@
 #pragma once
 
 #include <iostream>
+#include <memory>
 
-BHTTPCLIENTLIB_API DECLARE_LOG_CATEGORY_EXTERN(LogBHttpClientLib, Log, All);
+// Messages above this verbosity are compiled out, e.g. Display for shipping builds; SetLogVerbosity lowers it further at runtime
+#ifndef BHTTPCLIENT_COMPILE_TIME_LOG_VERBOSITY
+#define BHTTPCLIENT_COMPILE_TIME_LOG_VERBOSITY All
+#endif
+
+BHTTPCLIENTLIB_API DECLARE_LOG_CATEGORY_EXTERN(LogBHttpClientLib, Log, BHTTPCLIENT_COMPILE_TIME_LOG_VERBOSITY);
 
 enum BHTTPCLIENTLIB_API EBHttpCreateUpdateMethod : uint8;
 enum BHTTPCLIENTLIB_API EBHttpReadDeleteMethod : uint8;
 
+namespace httplib
+{
+    class Client;
+    class RateLimiter;
+    class MultipartFormDataWriter;
+}
+
+enum class EBHttpRequestPriority : uint8
+{
+    // Bulk transfers (DLC, patches), may be paused while interactive requests run
+    Background = 0,
+    Normal = 1,
+    // Latency-critical calls (login, matchmaking)
+    Interactive = 2
+};
+
+// Priority of the requests started by this thread while the scope is alive, Normal otherwise
+struct BHTTPCLIENTLIB_API FBHttpPriorityScope
+{
+    explicit FBHttpPriorityScope(EBHttpRequestPriority Priority);
+    ~FBHttpPriorityScope();
+
+    static EBHttpRequestPriority Current();
+
+private:
+    EBHttpRequestPriority Previous;
+};
+
+struct BHTTPCLIENTLIB_API FBHttpSchedulingOptions
+{
+    // Requests running at once to a single scheme://host:port, the rest wait in priority order
+    int32 MaxConnectionsPerHost = 8;
+    // A waiting request gains one priority level per AgingSeconds, 0 disables aging
+    double AgingSeconds = 5.0;
+    // Background downloads stop reading while Interactive requests are running; queued ones wait for slots
+    // the downloads may hold, pausing those would only delay them
+    bool bPreemptBackgroundDownloads = false;
+    // Upper bound of a single pause, so servers don't drop the stalled connection
+    double MaxPreemptPauseSeconds = 2.0;
+};
+
+struct BHTTPCLIENTLIB_API FBHttpWarmUpOptions
+{
+    // Idle connections kept open per host
+    int32 ConnectionsPerHost = 2;
+    // Requested with HEAD on connections idle for PingIntervalSeconds so servers don't close them; empty for
+    // no pings, the connections then close after the 4 idle seconds the pool keeps them
+    FString PingPath = TEXT("/");
+    // Below the servers' keep-alive timeout and the pool's 4 idle seconds
+    float PingIntervalSeconds = 3.0f;
+    // Kernel keepalive probes after this many silent seconds, for NATs and firewalls; 0 for none
+    int32 TcpKeepAliveSeconds = 15;
+    // Blocks until the connections are open or this much time passed, 0 returns right away
+    float WaitSeconds = 0.0f;
+};
+
+struct BHTTPCLIENTLIB_API FBHttpQueueWaitStats
+{
+    int64 Count = 0;
+    double TotalSeconds = 0.0;
+    double MaxSeconds = 0.0;
+    double AverageSeconds = 0.0;
+};
+
+enum class EBHttpBatchVerb : uint8
+{
+    Get = 0,
+    Delete = 1,
+    Post = 2,
+    Put = 3,
+    Patch = 4
+};
+
+// Seconds spent in each phase of one request, 0 for phases that did not happen
+struct BHTTPCLIENTLIB_API FBHttpRequestTimings
+{
+    // Only on a new connection
+    double DnsSeconds = 0.0;
+    double ConnectSeconds = 0.0;
+    double TlsSeconds = 0.0;
+
+    // Request line, headers and body
+    double UploadSeconds = 0.0;
+    // Request sent until the status line arrived: server think time plus one round trip
+    double TimeToFirstByteSeconds = 0.0;
+    double TransferSeconds = 0.0;
+    double TotalSeconds = 0.0;
+
+    bool bReusedConnection = false;
+    // The kernel encrypted (send) or decrypted (receive) the connection's TLS records, see BHttpClient::SetUseKernelTls
+    bool bKernelTlsSend = false;
+    bool bKernelTlsReceive = false;
+};
+
+enum class EBHttpTimingPhase : uint8
+{
+    Dns = 0,
+    Connect = 1,
+    Tls = 2,
+    Upload = 3,
+    TimeToFirstByte = 4,
+    Transfer = 5,
+    Total = 6
+};
+
+// HDR-style histogram, 8 linear buckets per power of two microseconds; bucket i counts durations below
+// BucketUpperBoundsSeconds[i], buckets past the last used one are left out
+struct BHTTPCLIENTLIB_API FBHttpTimingHistogram
+{
+    TArray<double> BucketUpperBoundsSeconds;
+    TArray<int64> BucketCounts;
+
+    int64 Count = 0;
+    double SumSeconds = 0.0;
+    double MinSeconds = 0.0;
+    double MaxSeconds = 0.0;
+
+    // Estimate of the given percentile (0-100): linear within the bucket holding it, clamped to MinSeconds and
+    // MaxSeconds, so only as exact as the bucket is narrow; 0 if empty
+    double GetPercentile(double Percentile) const;
+};
+
+// Completed requests with one method, status and host; StatusCode -1 counts requests that got no response
+struct BHTTPCLIENTLIB_API FBHttpRequestCount
+{
+    FString Method;
+    int32 StatusCode = -1;
+    FString Host;
+    int64 Count = 0;
+};
+
+// Latency distribution read from a metrics histogram, percentiles are within 1/8 of the true value
+struct BHTTPCLIENTLIB_API FBHttpLatencySummary
+{
+    // GET/DELETE/POST/PUT/PATCH, empty for the time to first byte summary
+    FString Method;
+    int64 Count = 0;
+    double SumSeconds = 0.0;
+    double P50Seconds = 0.0;
+    double P90Seconds = 0.0;
+    double P99Seconds = 0.0;
+    double MaxSeconds = 0.0;
+};
+
+// Process-wide counters since start or the last ResetMetrics
+struct BHTTPCLIENTLIB_API FBHttpMetricsSnapshot
+{
+    TArray<FBHttpRequestCount> Requests;
+
+    uint64 BytesSent = 0;
+    uint64 BytesReceived = 0;
+    // Attempts beyond the first, by the single-request retry loops and batches
+    int64 Retries = 0;
+    // Pooled clients handed out, and lookups that found none so a new client was made
+    int64 PoolHits = 0;
+    int64 PoolMisses = 0;
+    // New TCP connections, and TLS handshakes on top of them
+    int64 ConnectionsOpened = 0;
+    int64 TlsHandshakes = 0;
+
+    // Request duration per method, retries excluded
+    TArray<FBHttpLatencySummary> RequestDuration;
+    FBHttpLatencySummary TimeToFirstByte;
+};
+
+// Which progress callbacks of a request get a Verbose log line
+struct BHTTPCLIENTLIB_API FBHttpProgressLogOptions
+{
+    // A line each time the transfer crosses another PercentStep of its size, 0 disables
+    int32 PercentStep = 25;
+    // A line once IntervalSeconds passed without one, the only trigger when the size is unknown (chunked), 0 disables
+    double IntervalSeconds = 2.0;
+};
+
+enum class EBHttpTraceFormat : uint8
+{
+    // Trace Event JSON, opens in chrome://tracing and ui.perfetto.dev
+    ChromeJson = 0,
+    // Perfetto TracePacket protobuf, opens in ui.perfetto.dev and trace_processor
+    PerfettoProtobuf = 1
+};
+
+// Hands out the memory the next part of a response body goes into, asked again whenever the last view is full.
+// ContentLength is 0 if unknown, ReceivedBytes 0 means the body (re)starts, e.g. on a retry.
+// An empty view means there is no more room, the request fails if the body goes on
+using FBHttpBodySpanReceiver = TFunction<TArrayView<uint8>(int64 ContentLength, int64 ReceivedBytes)>;
+
+// Bytes moved by one request, filled by the internal request functions when asked for
+struct BHTTPCLIENTLIB_API FBHttpTransferStats
+{
+    uint64 BytesSent = 0;
+    uint64 BytesReceived = 0;
+
+    // Of the last response
+    FBHttpRequestTimings Timings;
+};
+
+// Digests a transfer computes on its body as it passes, combinable
+enum class EBHttpChecksum : uint8
+{
+    None = 0,
+    // What GCS and S3 check objects with, on the CRC instructions of SSE4.2 and ARMv8 CPUs
+    Crc32c = 1 << 0,
+    Md5 = 1 << 1,
+    Sha256 = 1 << 2
+};
+ENUM_CLASS_FLAGS(EBHttpChecksum)
+
+enum class EBHttpChecksumMatch : uint8
+{
+    // The response carried no digest that was computed, or its body was decompressed or partial
+    NotChecked = 0,
+    Matched = 1,
+    Mismatched = 2
+};
+
+struct BHTTPCLIENTLIB_API FBHttpChecksumOptions
+{
+    EBHttpChecksum Algorithms = EBHttpChecksum::Crc32c;
+    // Compares with x-goog-hash, Content-MD5 and x-amz-checksum-crc32c/sha256 of a 2xx response; a mismatch fails the attempt, so it is retried
+    bool bVerify = true;
+    // Also takes an ETag of 32 hex digits for the MD5, which it is for S3 and GCS objects uploaded in one piece without KMS encryption
+    bool bTrustETagAsMd5 = false;
+};
+
+// Digests of the body of a request's last attempt, sent or received
+struct BHTTPCLIENTLIB_API FBHttpChecksums
+{
+    EBHttpChecksum Algorithms = EBHttpChecksum::None;
+    uint64 Bytes = 0;
+    uint32 Crc32c = 0;
+    uint8 Md5[16] = {};
+    uint8 Sha256[32] = {};
+
+    EBHttpChecksumMatch Match = EBHttpChecksumMatch::NotChecked;
+    // Response headers it was compared with, comma separated
+    FString CheckedHeaders;
+
+    // Of the big-endian CRC, as x-goog-hash and x-amz-checksum-crc32c carry it
+    FString GetCrc32cBase64() const;
+    // As Content-MD5 carries it
+    FString GetMd5Base64() const;
+    FString GetMd5Hex() const;
+    FString GetSha256Base64() const;
+    FString GetSha256Hex() const;
+};
+
+// One part of a multipart/form-data upload, its content is the file at FilePath if set, else Stream if set, else Value
+struct BHTTPCLIENTLIB_API FBHttpMultipartPart
+{
+    FString Name;
+    // Optional, file parts usually have one
+    FString FileName;
+    FString ContentType;
+
+    FString Value;
+    // Read while the request goes out, never loaded into memory
+    FString FilePath;
+    // Read from its current position; retries need it to be seekable
+    std::istream* Stream = nullptr;
+    // Bytes left in Stream, -1 if unknown, which sends the whole body chunked
+    int64 StreamBytes = -1;
+};
+
+// One entry of a batch, the same inputs the single-request functions take
+struct BHTTPCLIENTLIB_API FBHttpBatchRequest
+{
+    EBHttpBatchVerb Verb = EBHttpBatchVerb::Get;
+    EBHttpRequestPriority Priority = EBHttpRequestPriority::Normal;
+    FString FullPath;
+    TMap<FString, FString> HeadersData;
+
+    // Post/Put/Patch only
+    std::istream* InputStream = nullptr;
+    FString ContentType;
+    TMap<FString, FString> FormData;
+
+    // Response body destination, discarded if nullptr
+    std::ostream* OutputStream = nullptr;
+
+    // Bytes per second for this request alone, 0 for no limit; global and host limits still apply
+    int64 MaxDownloadBytesPerSecond = 0;
+    int64 MaxUploadBytesPerSecond = 0;
+};
+
+struct BHTTPCLIENTLIB_API FBHttpBatchOptions
+{
+    // Requests in flight across all hosts
+    int32 MaxConcurrency = 16;
+    // Requests in flight to a single scheme://host:port
+    int32 MaxConcurrencyPerHost = 6;
+    // Stop starting new requests once one fails (no response, or a 4xx/5xx status)
+    bool bFailFast = false;
+    // Retries for a request that got no response and whose streams can be replayed
+    int32 MaxRetriesPerRequest = 2;
+};
+
+struct BHTTPCLIENTLIB_API FBHttpBatchItemResult
+{
+    // -1 if no response arrived
+    int32 StatusCode = -1;
+    // Never started because a fail-fast batch was aborted
+    bool bSkipped = false;
+    int32 Attempts = 0;
+    // Seconds from the batch start until the request got a connection slot
+    double QueueSeconds = 0.0;
+    // Seconds spent executing, retries included
+    double DurationSeconds = 0.0;
+    // Bytes of all attempts, timings of the last one
+    FBHttpTransferStats Transfer;
+};
+
+struct BHTTPCLIENTLIB_API FBHttpBatchResult
+{
+    // Same order as the requests
+    TArray<FBHttpBatchItemResult> Items;
+
+    int32 SucceededCount = 0;
+    int32 FailedCount = 0;
+    int32 SkippedCount = 0;
+    bool bAborted = false;
+
+    double ElapsedSeconds = 0.0;
+    uint64 TotalBytesSent = 0;
+    uint64 TotalBytesReceived = 0;
+    double RequestsPerSecond = 0.0;
+    double BytesPerSecond = 0.0;
+};
+
+// One request an IBHttpPartUploadProtocol asks for; FullPath must already be escaped
+struct BHTTPCLIENTLIB_API FBHttpUploadRequest
+{
+    EBHttpBatchVerb Verb = EBHttpBatchVerb::Put;
+    FString FullPath;
+    TMap<FString, FString> HeadersData;
+    FString ContentType;
+    // Body of the protocol's own requests, e.g. a part list; part requests send their file range instead
+    FString Body;
+};
+
+struct BHTTPCLIENTLIB_API FBHttpUploadResponse
+{
+    // -1 if no response arrived
+    int32 StatusCode = -1;
+    // Names as the server sent them, the last value of a repeated header
+    TMap<FString, FString> HeadersData;
+    FString Body;
+};
+
+/*
+ * Object store side of BHttpClient::UploadFileInParts: which requests start an upload, carry a part
+ * and put the parts together. BHttpObjectStoreUpload.h has S3 (MinIO and other S3 compatible stores)
+ * and GCS compose implementations.
+ *
+ * Part functions are called from several upload threads at once, the others from the calling thread
+ * before the first or after the last part.
+ *
+ * */
+class BHTTPCLIENTLIB_API IBHttpPartUploadProtocol
+{
+public:
+    virtual ~IBHttpPartUploadProtocol() = default;
+
+    // Bytes of every part but the last, within the store's part size and part count limits; RequestedPartBytes is 0 for the protocol's default
+    virtual int64 GetPartBytes(int64 TotalBytes, int64 RequestedPartBytes) const = 0;
+
+    // The request that creates the upload, false if the store needs none
+    virtual bool MakeStartRequest(FBHttpUploadRequest& OutRequest) { return false; }
+
+    // PartIndex counts from 0, the engine fills in the body from [Offset, Offset + Bytes) of the file
+    virtual void MakePartRequest(int32 PartIndex, int64 Offset, int64 Bytes, FBHttpUploadRequest& OutRequest) = 0;
+    // What completing needs to know about the part, its ETag for S3
+    virtual bool OnPartResponse(int32 PartIndex, const FBHttpUploadResponse& Response, FString& OutPartTag) = 0;
+
+    // Requests that assemble the object from the parts, sent one after the other
+    virtual void MakeCompleteRequests(const TArray<FString>& PartTags, TArray<FBHttpUploadRequest>& OutRequests) = 0;
+
+    // The On*Response functions see every response. Refusing one sends the request again if it was
+    // a 2xx, 408, 429 or 5xx and retries are left, and fails the upload otherwise
+    virtual bool OnStartResponse(const FBHttpUploadResponse& Response) { return Response.StatusCode >= 200 && Response.StatusCode < 300; }
+    virtual bool OnCompleteResponse(int32 RequestIndex, const FBHttpUploadResponse& Response) { return Response.StatusCode >= 200 && Response.StatusCode < 300; }
+
+    // Sent in parallel once the object is complete, e.g. to delete temporary part objects; failures are only logged
+    virtual void MakeCleanupRequests(const TArray<FString>& PartTags, TArray<FBHttpUploadRequest>& OutRequests) {}
+    // Sent instead after a failure, best effort; PartTags is empty where a part never made it
+    virtual void MakeAbortRequests(const TArray<FString>& PartTags, TArray<FBHttpUploadRequest>& OutRequests) = 0;
+};
+
+struct BHTTPCLIENTLIB_API FBHttpPartUploadOptions
+{
+    // Parts in flight, each on its own pooled connection
+    int32 MaxConcurrency = 4;
+    // 0 lets the protocol choose, it also clamps this to the store's limits
+    int64 PartBytes = 0;
+    // Attempts of one part (or start and complete request) after the first, before the whole upload fails
+    int32 MaxRetriesPerPart = 3;
+    // Wait before the first retry of a part, doubled for each further one; a longer Retry-After wins
+    float RetryDelaySeconds = 0.5f;
+};
+
+struct BHTTPCLIENTLIB_API FBHttpPartUploadResult
+{
+    bool bSucceeded = false;
+    // Of the request that failed the upload, -1 if it got no response; the last complete request's otherwise
+    int32 StatusCode = -1;
+
+    int32 PartCount = 0;
+    int64 PartBytes = 0;
+    int32 PartRetries = 0;
+    // Aborted after a failure
+    bool bAborted = false;
+
+    // Bytes of every attempt, protocol requests included
+    uint64 TotalBytesSent = 0;
+    double ElapsedSeconds = 0.0;
+    // File bytes per second of wall time
+    double BytesPerSecond = 0.0;
+};
+
+struct BHTTPCLIENTLIB_API FBHttpResumableUploadOptions
+{
+    // Rounded up to a multiple of 256 KB, what GCS commits in; only the last chunk is shorter
+    int64 ChunkBytes = 8ll * 1024 * 1024;
+    // Keeps the session across process restarts: a later upload of the unchanged file to the same StartUrl with this state file resumes it. None if empty
+    FString StateFilePath;
+    FString ContentType = TEXT("application/octet-stream");
+    // Failed requests in a row, without anything committed in between, before giving up; the state file stays for a later attempt
+    int32 MaxRetriesWithoutProgress = 10;
+    // Wait before the first retry, doubled for each further one in a row up to 32 times; a longer Retry-After wins
+    float RetryDelaySeconds = 1.0f;
+};
+
+struct BHTTPCLIENTLIB_API FBHttpResumableUploadResult
+{
+    bool bSucceeded = false;
+    // Of the last response, 200 or 201 once the object exists, -1 if no response arrived
+    int32 StatusCode = -1;
+    // Where the chunks go, GCS keeps a session for a week
+    FString SessionUrl;
+
+    // The session came from the state file, with this much of the file already committed
+    bool bResumed = false;
+    int64 ResumedFromBytes = 0;
+    // A session the server no longer knew was replaced by a new one, which started over
+    bool bRestarted = false;
+
+    // Chunk requests sent, retries included
+    int32 Chunks = 0;
+    int32 Retries = 0;
+    uint64 BytesSent = 0;
+    double ElapsedSeconds = 0.0;
+    // Bytes this call uploaded per second of wall time
+    double BytesPerSecond = 0.0;
+};
+
 class BHTTPCLIENTLIB_API BHttpClient
 {
 public:
@@ -25,10 +486,304 @@ public:
     //************************************
     static void SplitPath(const FString& FullPath, FString& HostOnly, FString& PathOnly);
 
+    //************************************
+    // Method:    SetUseHttp2 offers HTTP/2 (ALPN "h2") on https connections, HTTP/1.1 remains the fallback
+    // FullName:  BHttpClient::SetUseHttp2
+    // Access:    public static 
+    // Returns:   void
+    // Qualifier:
+    // Parameter: bool bUseHttp2
+    // Parameter: bool bCleartextPriorKnowledge (also speak HTTP/2 on http:// hosts, only for servers known to support h2c)
+    //************************************
+    static void SetUseHttp2(bool bUseHttp2, bool bCleartextPriorKnowledge = false);
+
+    //************************************
+    // Method:    SetUseKernelTls lets the kernel encrypt and decrypt https connections (kTLS) after the handshake, so file uploads go out with sendfile
+    // FullName:  BHttpClient::SetUseKernelTls
+    // Access:    public static 
+    // Returns:   void
+    // Qualifier:
+    // Parameter: bool bUseKernelTls (Linux with an OpenSSL 3 built with kTLS and the tls kernel module; elsewhere, or for ciphers the kernel lacks, connections stay in user space)
+    //************************************
+    static void SetUseKernelTls(bool bUseKernelTls);
+
+    //************************************
+    // Method:    SetUseIoUring moves socket reads and writes of http:// connections, and GetToFile's disk writes, onto a per thread io_uring
+    // FullName:  BHttpClient::SetUseIoUring
+    // Access:    public static 
+    // Returns:   void
+    // Qualifier:
+    // Parameter: bool bUseIoUring (Linux 5.6+; where io_uring is missing or disabled requests keep using poll() and recv()/send())
+    //************************************
+    static void SetUseIoUring(bool bUseIoUring);
+
+    //************************************
+    // Method:    SetBandwidthLimit caps the combined throughput of all requests, also applies to transfers already running
+    // FullName:  BHttpClient::SetBandwidthLimit
+    // Access:    public static 
+    // Returns:   void
+    // Qualifier:
+    // Parameter: int64 MaxDownloadBytesPerSecond (0 for no limit)
+    // Parameter: int64 MaxUploadBytesPerSecond (0 for no limit)
+    //************************************
+    static void SetBandwidthLimit(int64 MaxDownloadBytesPerSecond, int64 MaxUploadBytesPerSecond);
+
+    //************************************
+    // Method:    SetIoBufferSize sets the size of the pooled buffers responses are read into and uploads are read from the stream into
+    // FullName:  BHttpClient::SetIoBufferSize
+    // Access:    public static 
+    // Returns:   void
+    // Qualifier:
+    // Parameter: int32 Bytes (64 KB to 1 MB, 64 KB by default; larger means fewer socket reads on fast links)
+    //************************************
+    static void SetIoBufferSize(int32 Bytes);
+
+    //************************************
+    // Method:    SetExpectContinue makes large uploads send "Expect: 100-continue" and hold the body back until the server accepts it, so a 401, 403 or 413 doesn't cost the whole upload
+    // FullName:  BHttpClient::SetExpectContinue
+    // Access:    public static 
+    // Returns:   void
+    // Qualifier:
+    // Parameter: int64 MinBodyBytes (bodies this large or of unknown size wait, 1 MB by default; 0 turns it off)
+    // Parameter: float TimeoutSeconds (how long to wait for servers that ignore Expect before the body goes anyway, 1 second by default)
+    //************************************
+    static void SetExpectContinue(int64 MinBodyBytes, float TimeoutSeconds = 1.0f);
+
+    //************************************
+    // Method:    SetMapFileDownloads makes GetToFile receive into a mapping of the file instead of writing it from a small buffer, Linux only
+    // FullName:  BHttpClient::SetMapFileDownloads
+    // Access:    public static 
+    // Returns:   void
+    // Qualifier:
+    // Parameter: bool bMapFileDownloads (off by default: one copy less, but a page fault per 4 KB, which measured slower on loopback)
+    //************************************
+    static void SetMapFileDownloads(bool bMapFileDownloads);
+
+    //************************************
+    // Method:    SetHostBandwidthLimit caps the combined throughput of all requests to one host
+    // FullName:  BHttpClient::SetHostBandwidthLimit
+    // Access:    public static 
+    // Returns:   void
+    // Qualifier:
+    // Parameter: const FString & HostOrUrl (scheme://host[:port], any URL on the host works too)
+    // Parameter: int64 MaxDownloadBytesPerSecond (0 for no limit)
+    // Parameter: int64 MaxUploadBytesPerSecond (0 for no limit)
+    //************************************
+    static void SetHostBandwidthLimit(const FString& HostOrUrl, int64 MaxDownloadBytesPerSecond, int64 MaxUploadBytesPerSecond);
+
+    //************************************
+    // Method:    SetSchedulingOptions sets the per-host connection slots every request waits for, and how waiters are ordered
+    // FullName:  BHttpClient::SetSchedulingOptions
+    // Access:    public static 
+    // Returns:   void
+    // Qualifier:
+    // Parameter: const FBHttpSchedulingOptions & Options
+    //************************************
+    static void SetSchedulingOptions(const FBHttpSchedulingOptions& Options);
+
+    //************************************
+    // Method:    GetQueueWaitStats returns how long requests of a priority class waited for a connection slot
+    // FullName:  BHttpClient::GetQueueWaitStats
+    // Access:    public static 
+    // Returns:   FBHttpQueueWaitStats
+    // Qualifier:
+    // Parameter: EBHttpRequestPriority Priority
+    //************************************
+    static FBHttpQueueWaitStats GetQueueWaitStats(EBHttpRequestPriority Priority);
+
+    static void ResetQueueWaitStats();
+
+    //************************************
+    // Method:    WarmUpConnections resolves, connects and handshakes connections to hosts in the background, so their first requests skip that; they stay open until StopWarmUp
+    // FullName:  BHttpClient::WarmUpConnections
+    // Access:    public static 
+    // Returns:   int32 idle connections to the hosts when it returns, for a WaitSeconds of 0 usually none yet
+    // Qualifier:
+    // Parameter: const TArray<FString> & HostsOrUrls (scheme://host[:port], any URL on the host works too)
+    // Parameter: const FBHttpWarmUpOptions & Options
+    //************************************
+    static int32 WarmUpConnections(const TArray<FString>& HostsOrUrls, const FBHttpWarmUpOptions& Options);
+
+    static int32 WarmUpConnections(const TArray<FString>& HostsOrUrls);
+
+    // Stops keeping connections to the hosts open, the idle ones close once they are past the pool's idle time
+    static void StopWarmUp(const TArray<FString>& HostsOrUrls);
+
+    // Closes every idle pooled connection, e.g. after the network changed; warmed up hosts get new ones
+    static void CloseIdleConnections();
+
+    //************************************
+    // Method:    SetTimingCallback is called on the requesting thread after every response, pass nullptr to remove it
+    // FullName:  BHttpClient::SetTimingCallback
+    // Access:    public static 
+    // Returns:   void
+    // Qualifier:
+    // Parameter: TFunction<void(const FString & Url, int32 StatusCode, const FBHttpRequestTimings & Timings)> Callback
+    //************************************
+    static void SetTimingCallback(TFunction<void(const FString& Url, int32 StatusCode, const FBHttpRequestTimings& Timings)> Callback);
+
+    //************************************
+    // Method:    GetTimingHistogram returns the durations of one phase across all responses since the last reset
+    // FullName:  BHttpClient::GetTimingHistogram
+    // Access:    public static 
+    // Returns:   FBHttpTimingHistogram
+    // Qualifier:
+    // Parameter: EBHttpTimingPhase Phase
+    //************************************
+    static FBHttpTimingHistogram GetTimingHistogram(EBHttpTimingPhase Phase);
+
+    // Also clears the TimeToFirstByte of GetMetricsSnapshot, the two read the same histogram
+    static void ResetTimingHistograms();
+
+    //************************************
+    // Method:    GetMetricsSnapshot sums the per-thread counters and latency histograms of the whole process
+    // FullName:  BHttpClient::GetMetricsSnapshot
+    // Access:    public static 
+    // Returns:   FBHttpMetricsSnapshot
+    // Qualifier:
+    //************************************
+    static FBHttpMetricsSnapshot GetMetricsSnapshot();
+
+    //************************************
+    // Method:    ExportMetricsPrometheus formats the same counters in the Prometheus text exposition format (version 0.0.4)
+    // FullName:  BHttpClient::ExportMetricsPrometheus
+    // Access:    public static 
+    // Returns:   FString bhttp_* counters and histograms, ready to serve on a /metrics endpoint
+    // Qualifier:
+    //************************************
+    static FString ExportMetricsPrometheus();
+
+    // The timing histograms included
+    static void ResetMetrics();
+
+    //************************************
+    // Method:    SetLogVerbosity sets the runtime verbosity of LogBHttpClientLib, progress lines are Verbose and per-slice upload lines VeryVerbose
+    // FullName:  BHttpClient::SetLogVerbosity
+    // Access:    public static 
+    // Returns:   void
+    // Qualifier:
+    // Parameter: ELogVerbosity::Type Verbosity (messages above BHTTPCLIENT_COMPILE_TIME_LOG_VERBOSITY stay compiled out)
+    //************************************
+    static void SetLogVerbosity(ELogVerbosity::Type Verbosity);
+
+    static void SetProgressLogOptions(const FBHttpProgressLogOptions& Options);
+
+    //************************************
+    // Method:    SetTracingEnabled starts or stops recording request lifecycles, disabling keeps what was recorded for DumpTrace
+    // FullName:  BHttpClient::SetTracingEnabled
+    // Access:    public static 
+    // Returns:   void
+    // Qualifier:
+    // Parameter: bool bEnabled
+    // Parameter: int32 MaxRequests (ring buffer size when enabling, the oldest requests are dropped first; changing it clears the buffer)
+    //************************************
+    static void SetTracingEnabled(bool bEnabled, int32 MaxRequests = 10000);
+
+    //************************************
+    // Method:    DumpTrace writes the recorded requests and their phases (resolve, connect, handshake, send headers, send body, wait, receive)
+    // FullName:  BHttpClient::DumpTrace
+    // Access:    public static 
+    // Returns:   bool false if the file could not be written
+    // Qualifier:
+    // Parameter: const FString & FilePath
+    // Parameter: EBHttpTraceFormat Format
+    //************************************
+    static bool DumpTrace(const FString& FilePath, EBHttpTraceFormat Format = EBHttpTraceFormat::ChromeJson);
+
+    static void ClearTrace();
+
     static int32 Get(std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData);
 
     static int32 Get(std::ostream* OutputStream, const FString& FullPath);
 
+    //************************************
+    // Method:    GetInto receives the body straight into OutBody, presized from Content-Length, without going through a stream
+    // FullName:  BHttpClient::GetInto
+    // Access:    public static 
+    // Returns:   int32 status code, -1 if it failed
+    // Qualifier:
+    // Parameter: TArray<uint8> & OutBody (holds exactly the body afterwards, grows as needed if Content-Length is missing)
+    // Parameter: const FString & FullPath
+    // Parameter: const TMap<FString
+    // Parameter: FString> & HeadersData
+    //************************************
+    static int32 GetInto(TArray<uint8>& OutBody, const FString& FullPath, const TMap<FString, FString>& HeadersData);
+
+    static int32 GetInto(TArray<uint8>& OutBody, const FString& FullPath);
+
+    //************************************
+    // Method:    GetInto receives the body straight into the memory NextSpan hands out, e.g. the mips of a texture
+    // FullName:  BHttpClient::GetInto
+    // Access:    public static 
+    // Returns:   int32 status code, -1 if it failed
+    // Qualifier:
+    // Parameter: const FBHttpBodySpanReceiver & NextSpan
+    // Parameter: const FString & FullPath
+    // Parameter: const TMap<FString
+    // Parameter: FString> & HeadersData
+    // Parameter: int64 * OutReceivedBytes (body bytes written to the views, optional)
+    //************************************
+    static int32 GetInto(const FBHttpBodySpanReceiver& NextSpan, const FString& FullPath, const TMap<FString, FString>& HeadersData, int64* OutReceivedBytes = nullptr);
+
+    //************************************
+    // Method:    GetToFile downloads into a file, preallocated from Content-Length on Linux and renamed into place when complete, without going through a stream
+    // FullName:  BHttpClient::GetToFile
+    // Access:    public static 
+    // Returns:   int32 status code, -1 if it failed or the file could not be written
+    // Qualifier:
+    // Parameter: const FString & FilePath (replaced only by a complete 2xx body, "<FilePath>.part" holds the download until then)
+    // Parameter: const FString & FullPath
+    // Parameter: const TMap<FString
+    // Parameter: FString> & HeadersData
+    //************************************
+    static int32 GetToFile(const FString& FilePath, const FString& FullPath, const TMap<FString, FString>& HeadersData);
+
+    static int32 GetToFile(const FString& FilePath, const FString& FullPath);
+
+    //************************************
+    // Method:    GetToFile with checksums computed on the body as it lands in the file, no second pass over it; a mismatch with the response's digests fails the attempt and keeps the file from being replaced
+    // FullName:  BHttpClient::GetToFile
+    // Access:    public static
+    // Returns:   int32 status code, -1 if it failed, the file could not be written or every attempt mismatched
+    // Qualifier:
+    // Parameter: const FString & FilePath
+    // Parameter: const FString & FullPath
+    // Parameter: const TMap<FString
+    // Parameter: FString> & HeadersData
+    // Parameter: const FBHttpChecksumOptions & ChecksumOptions
+    // Parameter: FBHttpChecksums & OutChecksums
+    //************************************
+    static int32 GetToFile(const FString& FilePath, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FBHttpChecksumOptions& ChecksumOptions, FBHttpChecksums& OutChecksums);
+
+    //************************************
+    // Method:    GetPipelined sends a batch of small GET requests, pipelining up to PipelineDepth requests per host on one keep-alive connection
+    // FullName:  BHttpClient::GetPipelined
+    // Access:    public static 
+    // Returns:   TArray<int32> status code for each FullPaths entry, -1 if it failed
+    // Qualifier:
+    // Parameter: const TArray<std::ostream * > & OutputStreams (same length as FullPaths, entries may be nullptr)
+    // Parameter: const TArray<FString> & FullPaths
+    // Parameter: const TMap<FString
+    // Parameter: FString> & HeadersData
+    // Parameter: int32 PipelineDepth
+    //************************************
+    static TArray<int32> GetPipelined(const TArray<std::ostream*>& OutputStreams, const TArray<FString>& FullPaths, const TMap<FString, FString>& HeadersData, int32 PipelineDepth = 8);
+
+    static TArray<int32> GetPipelined(const TArray<std::ostream*>& OutputStreams, const TArray<FString>& FullPaths);
+
+    //************************************
+    // Method:    ExecuteBatch runs the requests on worker threads over pooled keep-alive connections and blocks until all are done
+    // FullName:  BHttpClient::ExecuteBatch
+    // Access:    public static 
+    // Returns:   FBHttpBatchResult per-request status and timing plus aggregate throughput
+    // Qualifier:
+    // Parameter: const TArray<FBHttpBatchRequest> & Requests
+    // Parameter: const FBHttpBatchOptions & Options
+    //************************************
+    static FBHttpBatchResult ExecuteBatch(const TArray<FBHttpBatchRequest>& Requests, const FBHttpBatchOptions& Options);
+
+    static FBHttpBatchResult ExecuteBatch(const TArray<FBHttpBatchRequest>& Requests);
+
     static int32 Delete(std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData);
 
     static int32 Delete(std::ostream* OutputStream, const FString& FullPath);
@@ -60,6 +815,108 @@ public:
 
     static int32 Patch(std::istream* InputStream, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType);
 
+
+    //************************************
+    // Method:    PostFile uploads a file as the request body, over plain HTTP (and https with SetUseKernelTls) it goes from the page cache to the socket with sendfile()
+    // FullName:  BHttpClient::PostFile
+    // Access:    public static 
+    // Returns:   int32 status code, -1 if it failed or the file could not be opened
+    // Qualifier:
+    // Parameter: const FString & FilePath
+    // Parameter: std::ostream * OutputStream
+    // Parameter: const FString & FullPath
+    // Parameter: const TMap<FString
+    // Parameter: FString> & HeadersData
+    // Parameter: const FString & ContentType
+    //************************************
+    static int32 PostFile(const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType);
+
+    static int32 PostFile(const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType);
+
+    static int32 PutFile(const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType);
+
+    static int32 PutFile(const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType);
+
+    static int32 PatchFile(const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType);
+
+    static int32 PatchFile(const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const FString& ContentType);
+
+    //************************************
+    // Method:    PostFile with checksums computed on the file as it is sent, verified against the digests the response reports; the file is read through user space then, not with sendfile()
+    // FullName:  BHttpClient::PostFile
+    // Access:    public static
+    // Returns:   int32 status code, -1 if it failed, the file could not be opened or every attempt mismatched
+    // Qualifier:
+    // Parameter: const FString & FilePath
+    // Parameter: std::ostream * OutputStream
+    // Parameter: const FString & FullPath
+    // Parameter: const TMap<FString
+    // Parameter: FString> & HeadersData
+    // Parameter: const FString & ContentType
+    // Parameter: const FBHttpChecksumOptions & ChecksumOptions
+    // Parameter: FBHttpChecksums & OutChecksums
+    //************************************
+    static int32 PostFile(const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType, const FBHttpChecksumOptions& ChecksumOptions, FBHttpChecksums& OutChecksums);
+
+    static int32 PutFile(const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType, const FBHttpChecksumOptions& ChecksumOptions, FBHttpChecksums& OutChecksums);
+
+    static int32 PatchFile(const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType, const FBHttpChecksumOptions& ChecksumOptions, FBHttpChecksums& OutChecksums);
+
+    //************************************
+    // Method:    PostMultipart uploads multipart/form-data whose parts are streamed from memory, files and streams, memory use stays at one I/O buffer
+    // FullName:  BHttpClient::PostMultipart
+    // Access:    public static 
+    // Returns:   int32 status code, -1 if it failed or a file could not be opened
+    // Qualifier:
+    // Parameter: const TArray<FBHttpMultipartPart> & Parts (with Content-Length when all sizes are known, chunked otherwise)
+    // Parameter: std::ostream * OutputStream
+    // Parameter: const FString & FullPath
+    // Parameter: const TMap<FString
+    // Parameter: FString> & HeadersData
+    //************************************
+    static int32 PostMultipart(const TArray<FBHttpMultipartPart>& Parts, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData);
+
+    static int32 PostMultipart(const TArray<FBHttpMultipartPart>& Parts, std::ostream* OutputStream, const FString& FullPath);
+
+    static int32 PutMultipart(const TArray<FBHttpMultipartPart>& Parts, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData);
+
+    static int32 PutMultipart(const TArray<FBHttpMultipartPart>& Parts, std::ostream* OutputStream, const FString& FullPath);
+
+    static int32 PatchMultipart(const TArray<FBHttpMultipartPart>& Parts, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData);
+
+    static int32 PatchMultipart(const TArray<FBHttpMultipartPart>& Parts, std::ostream* OutputStream, const FString& FullPath);
+
+    //************************************
+    // Method:    UploadFileInParts uploads a file as parts sent in parallel over pooled connections, retrying parts on their own, then completes the object
+    // FullName:  BHttpClient::UploadFileInParts
+    // Access:    public static
+    // Returns:   FBHttpPartUploadResult, aborted through the protocol if a part or the completion failed for good
+    // Qualifier:
+    // Parameter: const FString & FilePath (read in place, parts are sent from their offsets)
+    // Parameter: IBHttpPartUploadProtocol & Protocol
+    // Parameter: const FBHttpPartUploadOptions & Options
+    //************************************
+    static FBHttpPartUploadResult UploadFileInParts(const FString& FilePath, IBHttpPartUploadProtocol& Protocol, const FBHttpPartUploadOptions& Options);
+
+    static FBHttpPartUploadResult UploadFileInParts(const FString& FilePath, IBHttpPartUploadProtocol& Protocol);
+
+    //************************************
+    // Method:    UploadFileResumable uploads a file through a GCS style resumable session in chunks with Content-Range, after a failure it asks what was committed and goes on from there
+    // FullName:  BHttpClient::UploadFileResumable
+    // Access:    public static
+    // Returns:   FBHttpResumableUploadResult
+    // Qualifier:
+    // Parameter: const FString & FilePath
+    // Parameter: const FString & StartUrl (POSTed to open the session: a JSON API ...?uploadType=resumable&name=... URL, or an XML API object URL, which gets x-goog-resumable: start)
+    // Parameter: const TMap<FString
+    // Parameter: FString> & HeadersData (on every request, e.g. Authorization)
+    // Parameter: const FBHttpResumableUploadOptions & Options
+    // Parameter: std::ostream * OutputStream (body of the final response, the object's metadata)
+    //************************************
+    static FBHttpResumableUploadResult UploadFileResumable(const FString& FilePath, const FString& StartUrl, const TMap<FString, FString>& HeadersData, const FBHttpResumableUploadOptions& Options, std::ostream* OutputStream = nullptr);
+
+    static FBHttpResumableUploadResult UploadFileResumable(const FString& FilePath, const FString& StartUrl, const TMap<FString, FString>& HeadersData);
+
 private:
     //************************************
     // Method:    Get_Or_Delete to handle Get and Delete requests extracts ostream for downloading the response
@@ -75,7 +932,28 @@ private:
     // Parameter: FString> & HeadersData
     //************************************
     static int32 Get_Or_Delete(EBHttpReadDeleteMethod HttpMethod, std::ostream* OutputStream, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData);
-    static int32 Get_Or_Delete_Internal(EBHttpReadDeleteMethod HttpMethod, std::ostream* OutputStream, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData);
+    static int32 Get_Or_Delete_Internal(EBHttpReadDeleteMethod HttpMethod, std::ostream* OutputStream, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData, httplib::Client* Client = nullptr, FBHttpTransferStats* Stats = nullptr, std::shared_ptr<httplib::RateLimiter> RequestLimiter = nullptr);
+
+    //************************************
+    // Method:    Get_Into to handle GetInto requests, retrying like Get_Or_Delete
+    // FullName:  BHttpClient::Get_Into
+    // Access:    private static 
+    // Returns:   int32
+    // Qualifier:
+    // Parameter: const FBHttpBodySpanReceiver & NextSpan
+    // Parameter: const FString & Host
+    // Parameter: const FString & Path
+    // Parameter: const TMap<FString
+    // Parameter: FString> & HeadersData
+    // Parameter: FBHttpTransferStats & Stats (of the last attempt)
+    // Parameter: const FBHttpChecksumOptions * ChecksumOptions (computes OutChecksums if set, a mismatch fails the attempt)
+    // Parameter: FBHttpChecksums * OutChecksums
+    //************************************
+    static int32 Get_Into(const FBHttpBodySpanReceiver& NextSpan, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData, FBHttpTransferStats& Stats, const FBHttpChecksumOptions* ChecksumOptions = nullptr, FBHttpChecksums* OutChecksums = nullptr);
+    static int32 Get_Into_Internal(const FBHttpBodySpanReceiver& NextSpan, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData, FBHttpTransferStats& Stats, const FBHttpChecksumOptions* ChecksumOptions, FBHttpChecksums* OutChecksums);
+
+    // GetToFile with or without checksums
+    static int32 Get_To_File(const FString& FilePath, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FBHttpChecksumOptions* ChecksumOptions, FBHttpChecksums* OutChecksums);
 
     //************************************
     // Method:    Post_Or_Put_Or_Patch to handle Post/Put/Patch requests with istream and extracts ostream if there is available output from server
@@ -95,7 +973,70 @@ private:
     // Parameter: FString> & FormData
     //************************************
     static int32 Post_Or_Put_Or_Patch(EBHttpCreateUpdateMethod HttpMethod, std::istream* InputStream, std::ostream* OutputStream, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData, const FString& ContentType, const TMap<FString, FString>& FormData);
-    static int32 Post_Or_Put_Or_Patch_Internal(EBHttpCreateUpdateMethod HttpMethod, std::istream* InputStream, std::ostream* OutputStream, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData, const FString& ContentType, const TMap<FString, FString>& FormData);
+    static int32 Post_Or_Put_Or_Patch_Internal(EBHttpCreateUpdateMethod HttpMethod, std::istream* InputStream, std::ostream* OutputStream, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData, const FString& ContentType, const TMap<FString, FString>& FormData, httplib::Client* Client = nullptr, FBHttpTransferStats* Stats = nullptr, std::shared_ptr<httplib::RateLimiter> RequestLimiter = nullptr);
+
+    //************************************
+    // Method:    Post_Or_Put_Or_Patch_File opens the file once and sends it with the retries of Post_Or_Put_Or_Patch, every attempt reads it from the start
+    // FullName:  BHttpClient::Post_Or_Put_Or_Patch_File
+    // Access:    private static 
+    // Returns:   int32
+    // Qualifier:
+    // Parameter: EBHttpCreateUpdateMethod HttpMethod
+    // Parameter: const FString & FilePath
+    // Parameter: std::ostream * OutputStream
+    // Parameter: const FString & FullPath
+    // Parameter: const TMap<FString
+    // Parameter: FString> & HeadersData
+    // Parameter: const FString & ContentType
+    //************************************
+    static int32 Post_Or_Put_Or_Patch_File(EBHttpCreateUpdateMethod HttpMethod, const FString& FilePath, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData, const FString& ContentType, const FBHttpChecksumOptions* ChecksumOptions = nullptr, FBHttpChecksums* OutChecksums = nullptr);
+    static int32 Post_Or_Put_Or_Patch_File_Internal(EBHttpCreateUpdateMethod HttpMethod, int32 FileDescriptor, uint64 FileSize, std::ostream* OutputStream, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData, const FString& ContentType, const FBHttpChecksumOptions* ChecksumOptions, FBHttpChecksums* OutChecksums);
+
+    //************************************
+    // Method:    Post_Or_Put_Or_Patch_Multipart opens the file parts once and sends the form with the retries of Post_Or_Put_Or_Patch
+    // FullName:  BHttpClient::Post_Or_Put_Or_Patch_Multipart
+    // Access:    private static 
+    // Returns:   int32
+    // Qualifier:
+    // Parameter: EBHttpCreateUpdateMethod HttpMethod
+    // Parameter: const TArray<FBHttpMultipartPart> & Parts
+    // Parameter: std::ostream * OutputStream
+    // Parameter: const FString & FullPath
+    // Parameter: const TMap<FString
+    // Parameter: FString> & HeadersData
+    //************************************
+    static int32 Post_Or_Put_Or_Patch_Multipart(EBHttpCreateUpdateMethod HttpMethod, const TArray<FBHttpMultipartPart>& Parts, std::ostream* OutputStream, const FString& FullPath, const TMap<FString, FString>& HeadersData);
+    static int32 Post_Or_Put_Or_Patch_Multipart_Internal(EBHttpCreateUpdateMethod HttpMethod, httplib::MultipartFormDataWriter& Form, std::ostream* OutputStream, const FString& Host, const FString& Path, const TMap<FString, FString>& HeadersData);
+
+    //************************************
+    // Method:    ExecuteBatchItem runs one batch entry on a pooled client, retrying while nothing was transferred
+    // FullName:  BHttpClient::ExecuteBatchItem
+    // Access:    private static 
+    // Returns:   void
+    // Qualifier:
+    // Parameter: const FBHttpBatchRequest & Request
+    // Parameter: const FString & Host
+    // Parameter: const FString & Path
+    // Parameter: int32 MaxRetries
+    // Parameter: double BatchStart (FPlatformTime::Seconds() when the batch started, for QueueSeconds)
+    // Parameter: FBHttpBatchItemResult & OutItem
+    //************************************
+    static void ExecuteBatchItem(const FBHttpBatchRequest& Request, const FString& Host, const FString& Path, int32 MaxRetries, double BatchStart, FBHttpBatchItemResult& OutItem);
+
+    //************************************
+    // Method:    ExecuteUploadRequest sends one request of an IBHttpPartUploadProtocol on a pooled client, once
+    // FullName:  BHttpClient::ExecuteUploadRequest
+    // Access:    private static
+    // Returns:   int32 status code, -1 if no response arrived
+    // Qualifier:
+    // Parameter: const FBHttpUploadRequest & Request
+    // Parameter: int32 FileDescriptor (-1 to send Request.Body)
+    // Parameter: int64 Offset
+    // Parameter: int64 Bytes
+    // Parameter: FBHttpUploadResponse & OutResponse
+    // Parameter: uint64 & InOutBytesSent
+    //************************************
+    static int32 ExecuteUploadRequest(const FBHttpUploadRequest& Request, int32 FileDescriptor, int64 Offset, int64 Bytes, FBHttpUploadResponse& OutResponse, uint64& InOutBytesSent);
 
     static bool SleepInternal(float InSeconds);
 };
\ No newline at end of file
@@ -10,4 +10,6 @@ class FBHttpClientLibModule : public IModuleInterface
 public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
+	/** Stops the connection pool's background thread, before static destruction or DLL unload */
+	virtual void ShutdownModule() override;
 };
\ No newline at end of file
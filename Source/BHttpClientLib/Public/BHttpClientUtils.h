@@ -79,6 +79,35 @@
 #define CPPHTTPLIB_REDIRECT_MAX_COUNT 20
 #endif
 
+#ifndef CPPHTTPLIB_PIPELINE_DEPTH
+#define CPPHTTPLIB_PIPELINE_DEPTH 8
+#endif
+
+#ifndef CPPHTTPLIB_PIPELINE_MAX_REPLAY
+#define CPPHTTPLIB_PIPELINE_MAX_REPLAY 3
+#endif
+
+#ifndef CPPHTTPLIB_HTTP2_STREAM_WINDOW_SIZE
+#define CPPHTTPLIB_HTTP2_STREAM_WINDOW_SIZE (16u * 1024u * 1024u)
+#endif
+
+#ifndef CPPHTTPLIB_HTTP2_CONNECTION_WINDOW_SIZE
+#define CPPHTTPLIB_HTTP2_CONNECTION_WINDOW_SIZE (64u * 1024u * 1024u)
+#endif
+
+#ifndef CPPHTTPLIB_HTTP2_MAX_FRAME_SIZE
+#define CPPHTTPLIB_HTTP2_MAX_FRAME_SIZE (256u * 1024u)
+#endif
+
+#ifndef CPPHTTPLIB_RATE_LIMIT_BURST_MSEC
+#define CPPHTTPLIB_RATE_LIMIT_BURST_MSEC 50
+#endif
+
+// How long a request with "Expect: 100-continue" holds its body back for servers that never answer
+#ifndef CPPHTTPLIB_EXPECT_CONTINUE_TIMEOUT_MSECOND
+#define CPPHTTPLIB_EXPECT_CONTINUE_TIMEOUT_MSECOND 1000
+#endif
+
 #ifndef CPPHTTPLIB_PAYLOAD_MAX_LENGTH
 #define CPPHTTPLIB_PAYLOAD_MAX_LENGTH ((std::numeric_limits<size_t>::max)())
 #endif
@@ -91,8 +120,57 @@
 #define CPPHTTPLIB_RECV_BUFSIZ size_t(8192u)
 #endif
 
-#ifndef CPPHTTPLIB_COMPRESSION_BUFSIZ
-#define CPPHTTPLIB_COMPRESSION_BUFSIZ size_t(16384u)
+// Arena block inside every client, enough for the head of a typical request
+#ifndef CPPHTTPLIB_REQUEST_ARENA_BLOCK_SIZE
+#define CPPHTTPLIB_REQUEST_ARENA_BLOCK_SIZE 1024
+#endif
+
+// Scratch memory a client keeps between requests, larger arena blocks and bodies are released
+#ifndef CPPHTTPLIB_REQUEST_ARENA_MAX_RETAINED
+#define CPPHTTPLIB_REQUEST_ARENA_MAX_RETAINED size_t(262144u)
+#endif
+
+#ifndef CPPHTTPLIB_HEADER_NODE_CACHE_SIZE
+#define CPPHTTPLIB_HEADER_NODE_CACHE_SIZE 64
+#endif
+
+// Pooled buffers for socket reads, upload staging and (de)compression, see detail::BufferPool
+#ifndef CPPHTTPLIB_IO_BUFFER_SIZE
+#define CPPHTTPLIB_IO_BUFFER_SIZE size_t(65536u)
+#endif
+
+#ifndef CPPHTTPLIB_IO_BUFFER_MIN_SIZE
+#define CPPHTTPLIB_IO_BUFFER_MIN_SIZE size_t(65536u)
+#endif
+
+#ifndef CPPHTTPLIB_IO_BUFFER_MAX_SIZE
+#define CPPHTTPLIB_IO_BUFFER_MAX_SIZE size_t(1048576u)
+#endif
+
+#ifndef CPPHTTPLIB_IO_BUFFER_ALIGNMENT
+#define CPPHTTPLIB_IO_BUFFER_ALIGNMENT size_t(4096u)
+#endif
+
+// Buffers a thread keeps for itself, and ones kept for all threads together
+#ifndef CPPHTTPLIB_IO_BUFFER_THREAD_CACHE
+#define CPPHTTPLIB_IO_BUFFER_THREAD_CACHE 4
+#endif
+
+#ifndef CPPHTTPLIB_IO_BUFFER_SHARED_CACHE
+#define CPPHTTPLIB_IO_BUFFER_SHARED_CACHE 32
+#endif
+
+// Submission queue size and registered buffers of each thread's io_uring, see detail::IoUring
+#ifndef CPPHTTPLIB_IO_URING_ENTRIES
+#define CPPHTTPLIB_IO_URING_ENTRIES 64u
+#endif
+
+#ifndef CPPHTTPLIB_IO_URING_BUFFERS
+#define CPPHTTPLIB_IO_URING_BUFFERS 8
+#endif
+
+#ifndef CPPHTTPLIB_IO_URING_BUFFER_SIZE
+#define CPPHTTPLIB_IO_URING_BUFFER_SIZE size_t(262144u)
 #endif
 
 #ifndef CPPHTTPLIB_THREAD_POOL_COUNT
@@ -181,9 +259,24 @@ using socket_t = SOCKET;
 #include <csignal>
 #include <pthread.h>
 #include <sys/select.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+#endif
 #include <sys/socket.h>
 #include <unistd.h>
 
+// io_uring for plain sockets and file sinks, needs the kernel headers of 5.12 or later to build
+#if defined(IORING_FEAT_NATIVE_WORKERS) && defined(__NR_io_uring_setup) && !defined(CPPHTTPLIB_NO_IO_URING)
+#define CPPHTTPLIB_IO_URING_SUPPORT
+#endif
+
 using socket_t = int;
 #define INVALID_SOCKET (-1)
 #endif //_WIN32
@@ -191,8 +284,11 @@ using socket_t = int;
 #include <array>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <climits>
 #include <condition_variable>
+#include <cstddef>
+#include <deque>
 #include <errno.h>
 #include <fcntl.h>
 #include <fstream>
@@ -249,6 +345,11 @@ inline const unsigned char* ASN1_STRING_get0_data(const ASN1_STRING* asn1) {
 }
 #endif
 
+// Kernel TLS (SSL_OP_ENABLE_KTLS, SSL_sendfile) needs Linux and an OpenSSL 3 built with it
+#if defined(__linux__) && OPENSSL_VERSION_NUMBER >= 0x30000000L && !defined(OPENSSL_NO_KTLS)
+#define CPPHTTPLIB_KTLS_SUPPORT
+#endif
+
 #undef UI
 
 #endif
@@ -339,6 +440,87 @@ namespace httplib {
     using ContentReceiver =
         std::function<bool(const char* data, size_t data_length)>;
 
+    // Caller memory the response body is received into, without an intermediate buffer
+    struct ContentSpan {
+        char* data = nullptr;
+        size_t size = 0;
+    };
+
+    // Asked for the first span once the headers are in and for the next one whenever the last is full.
+    // content_length is 0 if unknown, received 0 means the body (re)starts, e.g. after a redirect.
+    // An empty span means there is no more room, the request is canceled if the body goes on.
+    using ContentSpanReceiver =
+        std::function<ContentSpan(uint64_t content_length, uint64_t received)>;
+
+    // Request body taken from an open file, the caller keeps fd open until the request returns.
+    // On plain sockets it goes out with sendfile() and never passes through user space
+    struct FileContent {
+        int fd = -1;
+        uint64_t offset = 0;
+        uint64_t length = 0;
+        // Sees the body as it is read from fd, position 0 again when it is sent again (e.g. checksums).
+        // The file then passes through user space, not sendfile()
+        std::function<void(uint64_t position, const char* data, size_t size)> observer;
+    };
+
+    // multipart/form-data body whose parts are read while the request is sent, through one pooled
+    // buffer, so file parts never have to fit in memory. Strings are copied, streams and descriptors
+    // only referenced: they have to outlive the request
+    class MultipartFormDataWriter {
+    public:
+        MultipartFormDataWriter();
+
+        void add(const std::string& name, const std::string& content,
+            const std::string& filename = std::string(), const std::string& content_type = std::string());
+        // Read from the stream's current position. length is what is left in it, -1 if unknown,
+        // which sends the body chunked. Sending it again (redirects, retries) needs a seekable stream
+        void add(const std::string& name, std::istream& content, int64_t length,
+            const std::string& filename = std::string(), const std::string& content_type = std::string());
+        void add(const std::string& name, const FileContent& content,
+            const std::string& filename = std::string(), const std::string& content_type = std::string());
+
+        const std::string& boundary() const { return boundary_; }
+        std::string content_type() const;
+        // The body size, 0 if a stream part has no known length
+        size_t content_length() const;
+        // Of the body written by the last send
+        size_t written() const { return written_; }
+
+        // ContentProvider of the body: one buffer from offset with a known length, the whole body
+        // followed by sink.done() with length -1
+        bool provide(size_t offset, size_t length, DataSink& sink);
+
+    private:
+        // Delimiters and part headers are text, contents text, a stream or a file
+        struct Segment {
+            std::string text;
+            std::istream* stream = nullptr;
+            std::streampos stream_start;
+            FileContent file;
+            // -1 for a stream of unknown length
+            int64_t length = 0;
+            // Start within the body, only meaningful while all lengths are known
+            size_t offset = 0;
+        };
+
+        // Appends the part before the closing delimiter, which stays the last segment
+        void add_part(const std::string& name, const std::string& filename,
+            const std::string& content_type, Segment&& content);
+        static uint64_t segment_length(const Segment& segment);
+        // Writes up to length bytes of the segment from rel. 0 at its end, -1 on read errors and
+        // on contents shorter than announced
+        ssize_t write_segment(Segment& segment, uint64_t rel, size_t length, char* buf,
+            DataSink& sink);
+
+        std::string boundary_;
+        std::vector<Segment> segments_;
+        bool has_unknown_length_ = false;
+        size_t written_ = 0;
+        // Read position of the last stream segment, to skip seekg() while the body goes out in order
+        const Segment* stream_cursor_segment_ = nullptr;
+        uint64_t stream_cursor_ = 0;
+    };
+
     using MultipartContentHeader =
         std::function<bool(const MultipartFormData& file)>;
 
@@ -365,6 +547,42 @@ namespace httplib {
     using Range = std::pair<ssize_t, ssize_t>;
     using Ranges = std::vector<Range>;
 
+    // Token bucket pair (download/upload) that any number of clients and requests can share.
+    // A rate of 0 means unlimited, rates may change while transfers are running.
+    class RateLimiter {
+    public:
+        explicit RateLimiter(uint64_t download_bytes_per_sec = 0,
+            uint64_t upload_bytes_per_sec = 0);
+
+        RateLimiter(const RateLimiter&) = delete;
+        RateLimiter& operator=(const RateLimiter&) = delete;
+
+        void set_download_rate(uint64_t bytes_per_sec);
+        void set_upload_rate(uint64_t bytes_per_sec);
+
+        uint64_t download_rate() const;
+        uint64_t upload_rate() const;
+
+        // Blocks until n more bytes fit under the rate
+        void acquire_download(size_t n);
+        void acquire_upload(size_t n);
+
+    private:
+        struct Bucket {
+            std::atomic<uint64_t> rate{ 0 };
+            double tokens = 0;
+            std::chrono::steady_clock::time_point last;
+        };
+
+        void refill(Bucket& bucket, double rate);
+        void set_rate(Bucket& bucket, uint64_t bytes_per_sec);
+        void acquire(Bucket& bucket, size_t n);
+
+        std::mutex mutex_;
+        Bucket download_;
+        Bucket upload_;
+    };
+
     struct Request {
         std::string method;
         std::string path;
@@ -386,9 +604,15 @@ namespace httplib {
         size_t redirect_count = CPPHTTPLIB_REDIRECT_MAX_COUNT;
         ResponseHandler response_handler = nullptr;
         ContentReceiver content_receiver = nullptr;
+        // Takes precedence over content_receiver
+        ContentSpanReceiver content_span_receiver = nullptr;
         size_t content_length = 0;
         ContentProvider content_provider = nullptr;
+        // Used instead of body and content_provider when fd is set
+        FileContent content_file;
         Progress progress = nullptr;
+        // Applied on top of the client's own limiter, e.g. a global and a per-host one
+        std::vector<std::shared_ptr<RateLimiter>> rate_limiters;
 
 #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
         const SSL* ssl;
@@ -415,6 +639,38 @@ namespace httplib {
         size_t authorization_count_ = 0;
     };
 
+    // Monotonic timestamps in seconds (steady clock), 0 for phases that did not happen. A request
+    // on a reused connection has no dns/connect/tls phases.
+    struct RequestTimings {
+        double start = 0;
+        double dns_start = 0;
+        double dns_end = 0;
+        double connect_end = 0;
+        double tls_end = 0;
+        // Request line and headers written, the body follows
+        double headers_sent = 0;
+        double request_sent = 0;
+        double first_byte = 0;
+        double end = 0;
+        bool reused_connection = false;
+        // The kernel seals outgoing / opens incoming TLS records of the connection (kTLS)
+        bool kernel_tls_send = false;
+        bool kernel_tls_recv = false;
+
+        double dns() const { return dns_end > 0 ? dns_end - dns_start : 0; }
+        double connect() const { return connect_end > 0 ? connect_end - dns_end : 0; }
+        double tls() const { return tls_end > 0 ? tls_end - connect_end : 0; }
+        // Request line, headers and body
+        double upload() const {
+            auto ready = (std::max)((std::max)(start, connect_end), tls_end);
+            return request_sent > 0 ? request_sent - ready : 0;
+        }
+        // Server think time plus one round trip
+        double ttfb() const { return first_byte > 0 && request_sent > 0 ? first_byte - request_sent : 0; }
+        double transfer() const { return end > 0 && first_byte > 0 ? end - first_byte : 0; }
+        double total() const { return end > 0 ? end - start : 0; }
+    };
+
     struct Response {
         std::string version;
         int status = -1;
@@ -422,6 +678,9 @@ namespace httplib {
         Headers headers;
         std::string body;
 
+        // Filled by the client
+        RequestTimings timings;
+
         bool has_header(const char* key) const;
         std::string get_header_value(const char* key, size_t id = 0) const;
         template <typename T>
@@ -476,6 +735,13 @@ namespace httplib {
         virtual ssize_t write(const char* ptr, size_t size) = 0;
         virtual void get_remote_ip_and_port(std::string& ip, int& port) const = 0;
 
+        // Writes up to size bytes of the file at offset without copying them, -1 if this stream
+        // can't; callers then read the file and write() it
+        virtual ssize_t send_file(int fd, uint64_t offset, size_t size);
+
+        // Waits up to sec/usec, not the read timeout, for something to read
+        virtual bool wait_readable(time_t sec, time_t usec) const;
+
         template <typename... Args>
         ssize_t write_format(const char* fmt, const Args&... args);
         ssize_t write(const char* ptr);
@@ -585,6 +851,30 @@ namespace httplib {
 #endif
     }
 
+    // SocketOptions for long lived connections: the kernel probes one that sat idle for idle_sec, so
+    // NATs and firewalls keep its mapping and a dead peer is noticed
+    inline void tcp_keepalive_socket_options(socket_t sock, int idle_sec) {
+        int yes = 1;
+#ifdef _WIN32
+        setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, reinterpret_cast<char*>(&yes),
+            sizeof(yes));
+#ifdef TCP_KEEPIDLE
+        setsockopt(sock, IPPROTO_TCP, TCP_KEEPIDLE, reinterpret_cast<char*>(&idle_sec),
+            sizeof(idle_sec));
+#endif
+#else
+        setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, reinterpret_cast<void*>(&yes),
+            sizeof(yes));
+#if defined(TCP_KEEPIDLE)
+        setsockopt(sock, IPPROTO_TCP, TCP_KEEPIDLE, reinterpret_cast<void*>(&idle_sec),
+            sizeof(idle_sec));
+#elif defined(TCP_KEEPALIVE)
+        setsockopt(sock, IPPROTO_TCP, TCP_KEEPALIVE, reinterpret_cast<void*>(&idle_sec),
+            sizeof(idle_sec));
+#endif
+#endif
+    }
+
     enum Error {
         Success = 0,
         Unknown,
@@ -616,6 +906,169 @@ namespace httplib {
         Error err_;
     };
 
+    namespace detail {
+        class Http2Session;
+
+        /* Bump allocator for the scratch memory of a request: the request head being written, the
+         * headers added to it, the chunk framing of uploads, the status line match. Nothing is freed
+         * one by one; once the outermost Scope ends everything is released at once and the blocks
+         * stay for the next request, so a pooled client sends steady-state requests without going
+         * to the heap for them. Not thread-safe, a client uses its arena under its request mutex. */
+        class RequestArena {
+        public:
+            RequestArena() = default;
+            ~RequestArena();
+
+            RequestArena(const RequestArena&) = delete;
+            RequestArena& operator=(const RequestArena&) = delete;
+
+            void* allocate(size_t size, size_t alignment);
+
+            // Forgets every allocation, keeps blocks up to CPPHTTPLIB_REQUEST_ARENA_MAX_RETAINED bytes
+            void reset();
+
+            size_t capacity() const;
+
+            // Memory handed out inside a Scope is valid until the outermost Scope ends, so a request
+            // can send another one (an auth retry) without losing its own scratch
+            class Scope {
+            public:
+                explicit Scope(RequestArena& arena) : arena_(arena) { arena_.depth_++; }
+                ~Scope() {
+                    if (--arena_.depth_ == 0) { arena_.reset(); }
+                }
+
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+
+            private:
+                RequestArena& arena_;
+            };
+
+        private:
+            struct Block {
+                char* data;
+                size_t size;
+            };
+
+            static void* bump(char* data, size_t block_size, size_t& offset,
+                size_t size, size_t alignment);
+
+            // Used first, so a client that sends a single request has no block of its own to allocate
+            alignas(std::max_align_t) char initial_[CPPHTTPLIB_REQUEST_ARENA_BLOCK_SIZE];
+            size_t initial_offset_ = 0;
+
+            // Heap blocks once the initial one is full, each twice the size of the one before
+            std::vector<Block> blocks_;
+            size_t block_index_ = 0;
+            size_t offset_ = 0;
+            int depth_ = 0;
+        };
+
+        // Allocates from an arena and never frees, or from the heap as usual without one
+        template <typename T>
+        class ArenaAllocator {
+        public:
+            using value_type = T;
+
+            ArenaAllocator(RequestArena* arena = nullptr) noexcept : arena_(arena) {}
+            template <typename U>
+            ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+            T* allocate(size_t n) {
+                if (!arena_) { return static_cast<T*>(::operator new(n * sizeof(T))); }
+                return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+            }
+
+            void deallocate(T* p, size_t) noexcept {
+                if (!arena_) { ::operator delete(p); }
+            }
+
+            RequestArena* arena() const noexcept { return arena_; }
+
+            template <typename U>
+            bool operator==(const ArenaAllocator<U>& other) const noexcept { return arena_ == other.arena(); }
+            template <typename U>
+            bool operator!=(const ArenaAllocator<U>& other) const noexcept { return arena_ != other.arena(); }
+
+        private:
+            RequestArena* arena_;
+        };
+
+        using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+        using ArenaHeaders = std::multimap<std::string, std::string, ci,
+            ArenaAllocator<std::pair<const std::string, std::string>>>;
+
+        /* Large aligned buffers that reads from a socket, uploads and (de)compression are staged in,
+         * instead of 8-16 KB arrays on the stack of every call. A lease takes a buffer from the calling
+         * thread's cache, then from the shared cache, and only then allocates one; it goes back the same
+         * way. Bigger buffers mean fewer recv() calls (and fewer select() calls before them) per
+         * response, the pool means they cost no allocation once warm. */
+        class BufferPool {
+        public:
+            static BufferPool& get();
+
+            // Rounded up to the alignment and kept within CPPHTTPLIB_IO_BUFFER_MIN_SIZE and
+            // CPPHTTPLIB_IO_BUFFER_MAX_SIZE. Leases already out keep their size, cached buffers of
+            // another size are freed as they come back
+            void set_buffer_size(size_t size);
+            size_t buffer_size() const { return buffer_size_.load(std::memory_order_relaxed); }
+
+            // Frees the shared cache, thread caches go back to it when their thread ends
+            void trim();
+
+            class Lease {
+            public:
+                Lease();
+                ~Lease();
+
+                Lease(const Lease&) = delete;
+                Lease& operator=(const Lease&) = delete;
+
+                char* data() const { return data_; }
+                size_t size() const { return size_; }
+
+            private:
+                char* data_;
+                size_t size_;
+            };
+
+        private:
+            BufferPool() { shared_.reserve(CPPHTTPLIB_IO_BUFFER_SHARED_CACHE); }
+
+            struct Block {
+                char* data;
+                size_t size;
+            };
+
+            struct ThreadCache {
+                Block blocks[CPPHTTPLIB_IO_BUFFER_THREAD_CACHE];
+                size_t count = 0;
+                ~ThreadCache();
+            };
+
+            static ThreadCache& thread_cache();
+            static void free_block(const Block& block);
+
+            Block acquire();
+            void release(const Block& block);
+            void release_shared(const Block& block);
+
+            std::atomic<size_t> buffer_size_{ CPPHTTPLIB_IO_BUFFER_SIZE };
+            std::mutex mutex_;
+            std::vector<Block> shared_;
+        };
+
+        // Header nodes taken out of finished requests and responses, key and value keep their capacity.
+        // Node handles need C++17, before that headers are allocated as they always were
+#ifdef __cpp_lib_node_extract
+        using HeaderNodes = std::vector<Headers::node_type>;
+#else
+        struct HeaderNodes {};
+#endif
+    } // namespace detail
+
     class ClientImpl {
     public:
         explicit ClientImpl(const std::string& host);
@@ -642,6 +1095,8 @@ namespace httplib {
         Result Get(const char* path, const Headers& headers, ResponseHandler response_handler, ContentReceiver content_receiver);
         Result Get(const char* path, ResponseHandler response_handler, ContentReceiver content_receiver, Progress progress);
         Result Get(const char* path, const Headers& headers, ResponseHandler response_handler, ContentReceiver content_receiver, Progress progress);
+        // The body goes into the spans content_span_receiver hands out instead of Response::body
+        Result GetInto(const char* path, const Headers& headers, ResponseHandler response_handler, ContentSpanReceiver content_span_receiver, Progress progress);
 
         Result Head(const char* path);
         Result Head(const char* path, const Headers& headers);
@@ -690,6 +1145,15 @@ namespace httplib {
         Result Patch(const char* path, const Headers& headers, const Params& params, size_t content_length, ContentProvider content_provider, const char* content_type, Progress progress);
         Result Patch(const char* path, const Headers& headers, const Params& params, size_t content_length, ContentProvider content_provider, const char* content_type, ContentReceiver content_receiver, Progress progress);
         Result Patch(const char* path, const Headers& headers, const Params& params, size_t content_length, ContentProvider content_provider, const char* content_type, ResponseHandler response_handler, ContentReceiver content_receiver, Progress progress);
+
+        // The body is read from the file, see FileContent
+        Result Post(const char* path, const Headers& headers, const FileContent& file, const char* content_type, ResponseHandler response_handler, ContentReceiver content_receiver, Progress progress);
+        Result Put(const char* path, const Headers& headers, const FileContent& file, const char* content_type, ResponseHandler response_handler, ContentReceiver content_receiver, Progress progress);
+        Result Patch(const char* path, const Headers& headers, const FileContent& file, const char* content_type, ResponseHandler response_handler, ContentReceiver content_receiver, Progress progress);
+        // The body is streamed from the parts, see MultipartFormDataWriter. Without set_compress() too
+        Result Post(const char* path, const Headers& headers, MultipartFormDataWriter& form, ResponseHandler response_handler, ContentReceiver content_receiver, Progress progress);
+        Result Put(const char* path, const Headers& headers, MultipartFormDataWriter& form, ResponseHandler response_handler, ContentReceiver content_receiver, Progress progress);
+        Result Patch(const char* path, const Headers& headers, MultipartFormDataWriter& form, ResponseHandler response_handler, ContentReceiver content_receiver, Progress progress);
         /* New functions end */
 
         Result Delete(const char* path);
@@ -711,8 +1175,25 @@ namespace httplib {
 
         bool send(const Request& req, Response& res);
 
+        /* Writes up to max_in_flight idempotent requests back-to-back on one connection and
+         * reads the responses in order. Unanswered requests are replayed on a new connection
+         * when the server closes it mid-pipeline. Redirects and auth challenges are returned as-is.
+         * Falls back to sequential send() if any request is not a body-less GET/HEAD/OPTIONS. */
+        bool send_pipelined(const std::vector<Request>& requests, std::vector<Response>& responses,
+            size_t max_in_flight = CPPHTTPLIB_PIPELINE_DEPTH);
+
+        /* Sends a batch of requests over one connection. On HTTP/2 they run as concurrent
+         * streams (any method, bodies included); on HTTP/1.1 this is send_pipelined().
+         * Streams the server refused or cut off with GOAWAY are replayed on a new connection. */
+        bool send_multiplexed(const std::vector<Request>& requests, std::vector<Response>& responses,
+            size_t max_in_flight = CPPHTTPLIB_PIPELINE_DEPTH);
+
         size_t is_socket_open() const;
 
+        // Resolves, connects and on https handshakes now, so the next request finds the connection open.
+        // Does nothing if it is open already; false if it could not be opened
+        bool open_connection();
+
         void stop();
 
         void set_default_headers(Headers headers);
@@ -737,6 +1218,27 @@ namespace httplib {
 
         void set_decompress(bool on);
 
+        // Offer "h2" through ALPN on TLS connections, HTTP/1.1 stays the fallback
+        void set_http2(bool on);
+        // Speak HTTP/2 right away on cleartext connections (h2c), the server must support it
+        void set_http2_prior_knowledge(bool on);
+
+        // Ask OpenSSL to hand the record layer of TLS connections to the kernel after the handshake.
+        // Where the kernel, the cipher or the OpenSSL build can't, the connection stays in user space
+        void set_kernel_tls(bool on);
+
+        // Send and receive through a per thread io_uring on cleartext connections (Linux 5.6+), without one
+        // the client silently stays on poll() + recv()/send()
+        void set_io_uring(bool on);
+
+        // Paces every request body and response body of this client, an empty list removes the limits
+        void set_rate_limiters(std::vector<std::shared_ptr<RateLimiter>> limiters);
+
+        // Bodies of min_body_size bytes or more, or of unknown size, go out after an "Expect: 100-continue"
+        // and the server's 100 Continue, or after timeout_msec without an answer. 0 turns it off
+        void set_expect_continue(size_t min_body_size,
+            time_t timeout_msec = CPPHTTPLIB_EXPECT_CONTINUE_TIMEOUT_MSECOND);
+
         void set_interface(const char* intf);
 
         void set_proxy(const char* host, int port);
@@ -753,16 +1255,24 @@ namespace httplib {
             socket_t sock = INVALID_SOCKET;
 #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
             SSL* ssl = nullptr;
+            bool is_kernel_tls_send = false;
+            bool is_kernel_tls_recv = false;
 #endif
+            bool is_http2 = false;
 
             bool is_open() const { return sock != INVALID_SOCKET; }
         };
 
-        virtual bool create_and_connect_socket(Socket& socket);
+        virtual bool create_and_connect_socket(Socket& socket, RequestTimings* timings);
         virtual void close_socket(Socket& socket, bool process_socket_ret);
 
         bool process_request(Stream& strm, const Request& req, Response& res,
             bool close_connection);
+        bool read_response(Stream& strm, const Request& req, Response& res,
+            bool head_received = false);
+        // Status line and headers, interim 1xx responses are passed over
+        bool read_response_head(Stream& strm, Response& res);
+        bool read_content_into_spans(Stream& strm, const Request& req, Response& res);
 
         Error get_last_error() const;
 
@@ -776,12 +1286,19 @@ namespace httplib {
 
         // Current open socket
         Socket socket_;
+        std::shared_ptr<detail::Http2Session> http2_session_;
         mutable std::mutex socket_mutex_;
         std::recursive_mutex request_mutex_;
 
         // Default headers
         Headers default_headers_;
 
+        // Kept from one request to the next, used under request_mutex_
+        detail::RequestArena arena_;
+        detail::HeaderNodes header_nodes_;
+        Request request_;
+        std::shared_ptr<Response> response_;
+
         // Settings
         std::string client_cert_path_;
         std::string client_key_path_;
@@ -810,6 +1327,17 @@ namespace httplib {
         bool compress_ = false;
         bool decompress_ = true;
 
+        bool http2_ = false;
+        bool http2_prior_knowledge_ = false;
+
+        bool kernel_tls_ = false;
+        bool io_uring_ = false;
+
+        std::vector<std::shared_ptr<RateLimiter>> rate_limiters_;
+
+        size_t expect_continue_min_size_ = 0;
+        time_t expect_continue_timeout_msec_ = CPPHTTPLIB_EXPECT_CONTINUE_TIMEOUT_MSECOND;
+
         std::string interface_;
 
         std::string proxy_host_;
@@ -846,6 +1374,13 @@ namespace httplib {
             socket_options_ = rhs.socket_options_;
             compress_ = rhs.compress_;
             decompress_ = rhs.decompress_;
+            http2_ = rhs.http2_;
+            http2_prior_knowledge_ = rhs.http2_prior_knowledge_;
+            kernel_tls_ = rhs.kernel_tls_;
+            io_uring_ = rhs.io_uring_;
+            rate_limiters_ = rhs.rate_limiters_;
+            expect_continue_min_size_ = rhs.expect_continue_min_size_;
+            expect_continue_timeout_msec_ = rhs.expect_continue_timeout_msec_;
             interface_ = rhs.interface_;
             proxy_host_ = rhs.proxy_host_;
             proxy_port_ = rhs.proxy_port_;
@@ -860,13 +1395,27 @@ namespace httplib {
         }
 
     private:
-        socket_t create_client_socket() const;
+        socket_t create_client_socket(RequestTimings* timings) const;
+        bool open_socket_if_needed(Response& res, bool& success);
+        // Under socket_mutex_, for an open HTTP/1.1 connection
+        bool is_idle_socket_closed() const;
         bool read_response_line(Stream& strm, Response& res);
-        bool write_request(Stream& strm, const Request& req, bool close_connection);
+        // With early_res, a body held back by "Expect: 100-continue" and turned down with a final
+        // status is never sent; that status and its headers are left in *early_res
+        bool write_request(Stream& strm, const Request& req, bool close_connection,
+            RequestTimings* timings = nullptr, Response* early_res = nullptr);
         bool redirect(const Request& req, Response& res);
         bool handle_request(Stream& strm, const Request& req, Response& res,
             bool close_connection);
+        bool handle_response(const Request& req, Response& res);
+        bool send_http2(const std::vector<const Request*>& requests,
+            const std::vector<Response*>& responses);
+        void make_http2_header_fields(const Request& req,
+            std::vector<std::pair<std::string, std::string>>& fields) const;
         void stop_core();
+        Request& prepare_request(const char* method, const char* path,
+            const Headers& headers);
+        std::shared_ptr<Response> send_prepared_request(Request& req);
         std::shared_ptr<Response> send_with_content_provider(
             const char* method, const char* path, const Headers& headers,
             const std::string& body, size_t content_length,
@@ -874,6 +1423,18 @@ namespace httplib {
             ResponseHandler response_handler,
             ContentReceiver content_receiver,
             Progress progress);
+        std::shared_ptr<Response> send_with_file_content(
+            const char* method, const char* path, const Headers& headers,
+            const FileContent& file, const char* content_type,
+            ResponseHandler response_handler,
+            ContentReceiver content_receiver,
+            Progress progress);
+        std::shared_ptr<Response> send_with_multipart_writer(
+            const char* method, const char* path, const Headers& headers,
+            MultipartFormDataWriter& form,
+            ResponseHandler response_handler,
+            ContentReceiver content_receiver,
+            Progress progress);
 
         virtual bool process_socket(Socket& socket,
             std::function<bool(Stream& strm)> callback);
@@ -912,6 +1473,7 @@ namespace httplib {
         Result Get(const char* path, const Headers& headers, ResponseHandler response_handler, ContentReceiver content_receiver);
         Result Get(const char* path, const Headers& headers, ResponseHandler response_handler, ContentReceiver content_receiver, Progress progress);
         Result Get(const char* path, ResponseHandler response_handler, ContentReceiver content_receiver, Progress progress);
+        Result GetInto(const char* path, const Headers& headers, ResponseHandler response_handler, ContentSpanReceiver content_span_receiver, Progress progress);
 
         Result Head(const char* path);
         Result Head(const char* path, const Headers& headers);
@@ -960,6 +1522,15 @@ namespace httplib {
         Result Patch(const char* path, const Headers& headers, const Params& params, size_t content_length, ContentProvider content_provider, const char* content_type, Progress progress);
         Result Patch(const char* path, const Headers& headers, const Params& params, size_t content_length, ContentProvider content_provider, const char* content_type, ContentReceiver content_receiver, Progress progress);
         Result Patch(const char* path, const Headers& headers, const Params& params, size_t content_length, ContentProvider content_provider, const char* content_type, ResponseHandler response_handler, ContentReceiver content_receiver, Progress progress);
+
+        // The body is read from the file, see FileContent
+        Result Post(const char* path, const Headers& headers, const FileContent& file, const char* content_type, ResponseHandler response_handler, ContentReceiver content_receiver, Progress progress);
+        Result Put(const char* path, const Headers& headers, const FileContent& file, const char* content_type, ResponseHandler response_handler, ContentReceiver content_receiver, Progress progress);
+        Result Patch(const char* path, const Headers& headers, const FileContent& file, const char* content_type, ResponseHandler response_handler, ContentReceiver content_receiver, Progress progress);
+        // The body is streamed from the parts, see MultipartFormDataWriter. Without set_compress() too
+        Result Post(const char* path, const Headers& headers, MultipartFormDataWriter& form, ResponseHandler response_handler, ContentReceiver content_receiver, Progress progress);
+        Result Put(const char* path, const Headers& headers, MultipartFormDataWriter& form, ResponseHandler response_handler, ContentReceiver content_receiver, Progress progress);
+        Result Patch(const char* path, const Headers& headers, MultipartFormDataWriter& form, ResponseHandler response_handler, ContentReceiver content_receiver, Progress progress);
         /* New functions end */
 
         Result Delete(const char* path);
@@ -981,8 +1552,21 @@ namespace httplib {
 
         bool send(const Request& req, Response& res);
 
+        bool send_pipelined(const std::vector<Request>& requests, std::vector<Response>& responses,
+            size_t max_in_flight = CPPHTTPLIB_PIPELINE_DEPTH);
+
+        /* Sends a batch of requests over one connection. On HTTP/2 they run as concurrent
+         * streams (any method, bodies included); on HTTP/1.1 this is send_pipelined().
+         * Streams the server refused or cut off with GOAWAY are replayed on a new connection. */
+        bool send_multiplexed(const std::vector<Request>& requests, std::vector<Response>& responses,
+            size_t max_in_flight = CPPHTTPLIB_PIPELINE_DEPTH);
+
         size_t is_socket_open() const;
 
+        // Resolves, connects and on https handshakes now, so the next request finds the connection open.
+        // Does nothing if it is open already; false if it could not be opened
+        bool open_connection();
+
         void stop();
 
         void set_default_headers(Headers headers);
@@ -1007,6 +1591,27 @@ namespace httplib {
 
         void set_decompress(bool on);
 
+        // Offer "h2" through ALPN on TLS connections, HTTP/1.1 stays the fallback
+        void set_http2(bool on);
+        // Speak HTTP/2 right away on cleartext connections (h2c), the server must support it
+        void set_http2_prior_knowledge(bool on);
+
+        // Ask OpenSSL to hand the record layer of TLS connections to the kernel after the handshake.
+        // Where the kernel, the cipher or the OpenSSL build can't, the connection stays in user space
+        void set_kernel_tls(bool on);
+
+        // Send and receive through a per thread io_uring on cleartext connections (Linux 5.6+), without one
+        // the client silently stays on poll() + recv()/send()
+        void set_io_uring(bool on);
+
+        // Paces every request body and response body of this client, an empty list removes the limits
+        void set_rate_limiters(std::vector<std::shared_ptr<RateLimiter>> limiters);
+
+        // Bodies of min_body_size bytes or more, or of unknown size, go out after an "Expect: 100-continue"
+        // and the server's 100 Continue, or after timeout_msec without an answer. 0 turns it off
+        void set_expect_continue(size_t min_body_size,
+            time_t timeout_msec = CPPHTTPLIB_EXPECT_CONTINUE_TIMEOUT_MSECOND);
+
         void set_interface(const char* intf);
 
         void set_proxy(const char* host, int port);
@@ -1044,7 +1649,7 @@ namespace httplib {
         bool is_valid() const override;
 
     private:
-        bool create_and_connect_socket(Socket& socket) override;
+        bool create_and_connect_socket(Socket& socket, RequestTimings* timings) override;
         void close_socket(Socket& socket, bool process_socket_ret) override;
 
         bool process_socket(Socket& socket,
@@ -1576,8 +2181,12 @@ namespace httplib {
             ssize_t read(char* ptr, size_t size) override;
             ssize_t write(const char* ptr, size_t size) override;
             void get_remote_ip_and_port(std::string& ip, int& port) const override;
+            bool wait_readable(time_t sec, time_t usec) const override;
+#ifdef __linux__
+            ssize_t send_file(int fd, uint64_t offset, size_t size) override;
+#endif
 
-        private:
+        protected:
             socket_t sock_;
             time_t read_timeout_sec_;
             time_t read_timeout_usec_;
@@ -1585,6 +2194,96 @@ namespace httplib {
             time_t write_timeout_usec_;
         };
 
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+        // One ring per thread, shared by every connection and file sink of the thread. Socket reads
+        // and writes wait for their own completion; file writes are only queued and go to the kernel
+        // with the next submission, usually the socket read that follows them.
+        class IoUring {
+        public:
+            // nullptr where the kernel has no io_uring or forbids it (seccomp, io_uring_disabled), tried once per thread
+            static IoUring* get();
+
+            ~IoUring();
+
+            IoUring(const IoUring&) = delete;
+            IoUring& operator=(const IoUring&) = delete;
+
+            // Like recv()/send(), -1 on errors and timeouts. What would block is submitted again with a linked timeout
+            ssize_t recv(socket_t sock, char* ptr, size_t size, time_t sec, time_t usec);
+            ssize_t send(socket_t sock, const char* ptr, size_t size, time_t sec, time_t usec);
+
+            // A buffer of CPPHTTPLIB_IO_URING_BUFFER_SIZE bytes, registered with the ring if the
+            // memlock limit allowed it. false when all of them are out
+            struct Buffer {
+                char* data = nullptr;
+                size_t size = 0;
+                int index = -1;
+            };
+            bool acquire_buffer(Buffer& buf);
+            void release_buffer(const Buffer& buf);
+
+            // Queues a write of a regular file, `buf` must stay untouched until wait() returned.
+            // Returns the ticket to wait for
+            uint64_t write_async(int fd, const Buffer& buf, size_t size, uint64_t offset);
+            // Bytes written, or -errno
+            ssize_t wait(uint64_t ticket);
+
+        private:
+            IoUring() = default;
+            bool init();
+            // Room for `count` linked entries, submitting what is queued if the ring is too full
+            bool reserve(unsigned count);
+            io_uring_sqe* next_sqe(uint8_t opcode, int fd, uint64_t ticket);
+            ssize_t submit_socket_op(uint8_t opcode, socket_t sock, const char* ptr, size_t size, time_t sec, time_t usec);
+            bool enter(unsigned min_complete);
+            void reap();
+            bool take_result(uint64_t ticket, ssize_t& res);
+
+            int fd_ = -1;
+            // Submission and completion ring share one mapping (IORING_FEAT_SINGLE_MMAP)
+            void* rings_ = nullptr;
+            size_t rings_size_ = 0;
+            io_uring_sqe* sqes_ = nullptr;
+            size_t sqes_size_ = 0;
+
+            unsigned* sq_head_ = nullptr;
+            unsigned* sq_tail_ = nullptr;
+            unsigned* sq_array_ = nullptr;
+            unsigned sq_mask_ = 0;
+            unsigned sq_entries_ = 0;
+            // Prepared but not yet published to the kernel
+            unsigned sqe_tail_ = 0;
+
+            unsigned* cq_head_ = nullptr;
+            unsigned* cq_tail_ = nullptr;
+            io_uring_cqe* cqes_ = nullptr;
+            unsigned cq_mask_ = 0;
+
+            uint64_t next_ticket_ = 1;
+            // Completions that arrived while waiting for another ticket
+            std::vector<std::pair<uint64_t, ssize_t>> results_;
+
+            char* buffers_ = nullptr;
+            bool buffers_registered_ = false;
+            uint32_t free_buffers_ = 0;
+        };
+
+        // SocketStream whose reads and writes go through the thread's IoUring, one io_uring_enter()
+        // each instead of poll() plus recv()/send(). File uploads keep sendfile(), which needs no copy
+        class UringSocketStream : public SocketStream {
+        public:
+            UringSocketStream(IoUring& ring, socket_t sock, time_t read_timeout_sec,
+                time_t read_timeout_usec, time_t write_timeout_sec,
+                time_t write_timeout_usec);
+
+            ssize_t read(char* ptr, size_t size) override;
+            ssize_t write(const char* ptr, size_t size) override;
+
+        private:
+            IoUring& ring_;
+        };
+#endif
+
 #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
         class SSLSocketStream : public Stream {
         public:
@@ -1598,6 +2297,10 @@ namespace httplib {
             ssize_t read(char* ptr, size_t size) override;
             ssize_t write(const char* ptr, size_t size) override;
             void get_remote_ip_and_port(std::string& ip, int& port) const override;
+            bool wait_readable(time_t sec, time_t usec) const override;
+#ifdef CPPHTTPLIB_KTLS_SUPPORT
+            ssize_t send_file(int fd, uint64_t offset, size_t size) override;
+#endif
 
         private:
             socket_t sock_;
@@ -1611,7 +2314,7 @@ namespace httplib {
 
         class BufferStream : public Stream {
         public:
-            BufferStream() = default;
+            explicit BufferStream(RequestArena* arena = nullptr) : buffer(ArenaAllocator<char>(arena)) {}
             ~BufferStream() override = default;
 
             bool is_readable() const override;
@@ -1620,10 +2323,10 @@ namespace httplib {
             ssize_t write(const char* ptr, size_t size) override;
             void get_remote_ip_and_port(std::string& ip, int& port) const override;
 
-            const std::string& get_buffer() const;
+            const ArenaString& get_buffer() const;
 
         private:
-            std::string buffer;
+            ArenaString buffer;
             size_t position = 0;
         };
 
@@ -1667,10 +2370,16 @@ namespace httplib {
 #endif
         }
 
+        inline double timing_now() {
+            return std::chrono::duration<double>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
         template <typename BindOrConnect>
         socket_t create_socket(const char* host, int port, int socket_flags,
             bool tcp_nodelay, SocketOptions socket_options,
-            BindOrConnect bind_or_connect) {
+            BindOrConnect bind_or_connect,
+            RequestTimings* timings = nullptr) {
             // Get address info
             struct addrinfo hints;
             struct addrinfo* result;
@@ -1683,6 +2392,8 @@ namespace httplib {
 
             auto service = std::to_string(port);
 
+            if (timings) { timings->dns_start = timing_now(); }
+
             if (getaddrinfo(host, service.c_str(), &hints, &result)) {
 #ifdef __linux__
                 res_init();
@@ -1690,6 +2401,8 @@ namespace httplib {
                 return INVALID_SOCKET;
             }
 
+            if (timings) { timings->dns_end = timing_now(); }
+
             for (auto rp = result; rp; rp = rp->ai_next) {
                 // Create a socket
 #ifdef _WIN32
@@ -1820,7 +2533,8 @@ namespace httplib {
             bool tcp_nodelay,
             SocketOptions socket_options,
             time_t timeout_sec, time_t timeout_usec,
-            const std::string& intf, Error& error) {
+            const std::string& intf, Error& error,
+            RequestTimings* timings = nullptr) {
             auto sock = create_socket(
                 host, port, 0, tcp_nodelay, socket_options,
                 [&](socket_t sock, struct addrinfo& ai) -> bool {
@@ -1852,10 +2566,11 @@ namespace httplib {
                     set_nonblocking(sock, false);
                     error = Error::Success;
                     return true;
-                });
+                }, timings);
 
             if (sock != INVALID_SOCKET) {
                 error = Error::Success;
+                if (timings) { timings->connect_end = timing_now(); }
             }
             else {
                 if (error == Error::Success) { error = Error::Connection; }
@@ -2107,9 +2822,9 @@ namespace httplib {
 
                 int ret = Z_OK;
 
-                std::array<char, CPPHTTPLIB_COMPRESSION_BUFSIZ> buff{};
+                BufferPool::Lease buff;
                 do {
-                    strm_.avail_out = buff.size();
+                    strm_.avail_out = static_cast<decltype(strm_.avail_out)>(buff.size());
                     strm_.next_out = reinterpret_cast<Bytef*>(buff.data());
 
                     ret = deflate(&strm_, flush);
@@ -2158,9 +2873,9 @@ namespace httplib {
                 strm_.avail_in = static_cast<decltype(strm_.avail_in)>(data_length);
                 strm_.next_in = const_cast<Bytef*>(reinterpret_cast<const Bytef*>(data));
 
-                std::array<char, CPPHTTPLIB_COMPRESSION_BUFSIZ> buff{};
+                BufferPool::Lease buff;
                 while (strm_.avail_in > 0) {
-                    strm_.avail_out = buff.size();
+                    strm_.avail_out = static_cast<decltype(strm_.avail_out)>(buff.size());
                     strm_.next_out = reinterpret_cast<Bytef*>(buff.data());
 
                     ret = inflate(&strm_, Z_NO_FLUSH);
@@ -2196,7 +2911,8 @@ namespace httplib {
 
             bool compress(const char* data, size_t data_length, bool last,
                 Callback callback) override {
-                std::array<uint8_t, CPPHTTPLIB_COMPRESSION_BUFSIZ> buff{};
+                BufferPool::Lease lease;
+                auto buff_data = reinterpret_cast<uint8_t*>(lease.data());
 
                 auto operation = last ? BROTLI_OPERATION_FINISH : BROTLI_OPERATION_PROCESS;
                 auto available_in = data_length;
@@ -2210,8 +2926,8 @@ namespace httplib {
                         if (!available_in) { break; }
                     }
 
-                    auto available_out = buff.size();
-                    auto next_out = buff.data();
+                    auto available_out = lease.size();
+                    auto next_out = buff_data;
 
                     if (!BrotliEncoderCompressStream(state_, operation, &available_in,
                         &next_in, &available_out, &next_out,
@@ -2219,9 +2935,9 @@ namespace httplib {
                         return false;
                     }
 
-                    auto output_bytes = buff.size() - available_out;
+                    auto output_bytes = lease.size() - available_out;
                     if (output_bytes) {
-                        callback(reinterpret_cast<const char*>(buff.data()), output_bytes);
+                        callback(reinterpret_cast<const char*>(buff_data), output_bytes);
                     }
                 }
 
@@ -2259,7 +2975,7 @@ namespace httplib {
 
                 decoder_r = BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT;
 
-                std::array<char, CPPHTTPLIB_COMPRESSION_BUFSIZ> buff{};
+                BufferPool::Lease buff;
                 while (decoder_r == BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT) {
                     char* next_out = buff.data();
                     size_t avail_out = buff.size();
@@ -2315,8 +3031,9 @@ namespace httplib {
             return def;
         }
 
-        template <typename T>
-        inline bool parse_header(const char* beg, const char* end, T fn) {
+        // Finds key and value of a header line without copying them, false if it is not a header
+        inline bool split_header(const char* beg, const char*& end,
+            const char*& key_end, const char*& val_beg) {
             // Skip trailing spaces and tabs.
             while (beg < end && is_space_or_tab(end[-1])) {
                 end--;
@@ -2329,7 +3046,7 @@ namespace httplib {
 
             if (p == end) { return false; }
 
-            auto key_end = p;
+            key_end = p;
 
             if (*p++ != ':') { return false; }
 
@@ -2337,15 +3054,49 @@ namespace httplib {
                 p++;
             }
 
-            if (p < end) {
-                fn(std::string(beg, key_end), decode_url(std::string(p, end), false));
-                return true;
+            val_beg = p;
+            return p < end;
+        }
+
+        // Moves the nodes of headers into nodes for later requests, up to CPPHTTPLIB_HEADER_NODE_CACHE_SIZE
+        inline void recycle_headers(Headers& headers, HeaderNodes& nodes) {
+#ifdef __cpp_lib_node_extract
+            while (!headers.empty()) {
+                auto node = headers.extract(headers.begin());
+                if (nodes.size() < CPPHTTPLIB_HEADER_NODE_CACHE_SIZE) {
+                    nodes.push_back(std::move(node));
+                }
             }
+#else
+            (void)nodes;
+            headers.clear();
+#endif
+        }
 
-            return false;
+        // emplace() into a recycled node if there is one
+        inline void emplace_header(Headers& headers, HeaderNodes* nodes,
+            const char* key, size_t key_len, const char* val, size_t val_len) {
+#ifdef __cpp_lib_node_extract
+            if (nodes && !nodes->empty()) {
+                auto node = std::move(nodes->back());
+                nodes->pop_back();
+                node.key().assign(key, key_len);
+                node.mapped().assign(val, val_len);
+                headers.insert(std::move(node));
+                return;
+            }
+#else
+            (void)nodes;
+#endif
+            headers.emplace(std::string(key, key_len), std::string(val, val_len));
         }
 
-        inline bool read_headers(Stream& strm, Headers& headers) {
+        inline void emplace_header(Headers& headers, HeaderNodes* nodes,
+            const std::string& key, const std::string& val) {
+            emplace_header(headers, nodes, key.data(), key.size(), val.data(), val.size());
+        }
+
+        inline bool read_headers(Stream& strm, Headers& headers, HeaderNodes* nodes) {
             const auto bufsiz = 2048;
             char buf[bufsiz];
             stream_line_reader line_reader(strm, buf, bufsiz);
@@ -2363,28 +3114,41 @@ namespace httplib {
                 }
 
                 // Exclude CRLF
-                auto end = line_reader.ptr() + line_reader.size() - 2;
+                auto beg = line_reader.ptr();
+                auto end = beg + line_reader.size() - 2;
 
-                parse_header(line_reader.ptr(), end,
-                    [&](std::string&& key, std::string&& val) {
-                        headers.emplace(std::move(key), std::move(val));
-                    });
+                const char* key_end;
+                const char* val_beg;
+                if (!split_header(beg, end, key_end, val_beg)) { continue; }
+
+                // Without an escape decode_url() would return the value as it is
+                if (std::find(val_beg, end, '%') == end) {
+                    emplace_header(headers, nodes, beg, key_end - beg, val_beg, end - val_beg);
+                }
+                else {
+                    auto val = decode_url(std::string(val_beg, end), false);
+                    emplace_header(headers, nodes, beg, key_end - beg, val.data(), val.size());
+                }
             }
 
             return true;
         }
 
+        inline bool read_headers(Stream& strm, Headers& headers) {
+            return read_headers(strm, headers, nullptr);
+        }
+
         inline bool read_content_with_length(Stream& strm, uint64_t len,
             Progress progress, ContentReceiver out) {
-            char buf[CPPHTTPLIB_RECV_BUFSIZ];
+            BufferPool::Lease buf;
 
             uint64_t r = 0;
             while (r < len) {
                 auto read_len = static_cast<size_t>(len - r);
-                auto n = strm.read(buf, (std::min)(read_len, CPPHTTPLIB_RECV_BUFSIZ));
+                auto n = strm.read(buf.data(), (std::min)(read_len, buf.size()));
                 if (n <= 0) { return false; }
 
-                if (!out(buf, static_cast<size_t>(n))) { return false; }
+                if (!out(buf.data(), static_cast<size_t>(n))) { return false; }
 
                 r += static_cast<uint64_t>(n);
 
@@ -2397,33 +3161,112 @@ namespace httplib {
         }
 
         inline void skip_content_with_length(Stream& strm, uint64_t len) {
-            char buf[CPPHTTPLIB_RECV_BUFSIZ];
+            BufferPool::Lease buf;
             uint64_t r = 0;
             while (r < len) {
                 auto read_len = static_cast<size_t>(len - r);
-                auto n = strm.read(buf, (std::min)(read_len, CPPHTTPLIB_RECV_BUFSIZ));
+                auto n = strm.read(buf.data(), (std::min)(read_len, buf.size()));
                 if (n <= 0) { return; }
                 r += static_cast<uint64_t>(n);
             }
         }
 
         inline bool read_content_without_length(Stream& strm, ContentReceiver out) {
-            char buf[CPPHTTPLIB_RECV_BUFSIZ];
+            BufferPool::Lease buf;
             for (;;) {
-                auto n = strm.read(buf, CPPHTTPLIB_RECV_BUFSIZ);
+                auto n = strm.read(buf.data(), buf.size());
                 if (n < 0) {
                     return false;
                 }
                 else if (n == 0) {
                     return true;
                 }
-                if (!out(buf, static_cast<size_t>(n))) { return false; }
+                if (!out(buf.data(), static_cast<size_t>(n))) { return false; }
             }
 
             return true;
         }
 
-        inline bool read_content_chunked(Stream& strm, ContentReceiver out) {
+        // Receives into the spans of a ContentSpanReceiver, reads land in caller memory without a copy.
+        // Progress counts the bytes in the spans, so it stays right for decompressed bodies
+        class SpanWriter {
+        public:
+            void reset(const ContentSpanReceiver* next, const Progress* progress,
+                uint64_t content_length) {
+                next_ = next;
+                progress_ = progress;
+                content_length_ = content_length;
+                received_ = 0;
+                span_ = ContentSpan();
+                used_ = 0;
+                canceled_ = false;
+                out_of_room_ = false;
+            }
+
+            uint64_t received() const { return received_; }
+            bool canceled() const { return canceled_; }
+            // The receiver handed out an empty span
+            bool out_of_room() const { return out_of_room_; }
+
+            // One read of at most len bytes straight into the current span,
+            // 0 if the peer closed and -1 on errors or cancellation
+            ssize_t read(Stream& strm, uint64_t len) {
+                if (!reserve()) { return -1; }
+                auto size = (std::min)(static_cast<uint64_t>(span_.size - used_), len);
+                auto n = strm.read(span_.data + used_, static_cast<size_t>(size));
+                if (n > 0 && !commit(static_cast<size_t>(n))) { return -1; }
+                return n;
+            }
+
+            // For bytes that are already in memory, decompressed ones or HTTP/2 frames
+            bool write(const char* buf, size_t n) {
+                while (n) {
+                    if (!reserve()) { return false; }
+                    auto size = (std::min)(span_.size - used_, n);
+                    memcpy(span_.data + used_, buf, size);
+                    if (!commit(size)) { return false; }
+                    buf += size;
+                    n -= size;
+                }
+                return true;
+            }
+
+        private:
+            bool reserve() {
+                if (used_ < span_.size) { return true; }
+                span_ = (*next_)(content_length_, received_);
+                used_ = 0;
+                if (!span_.data || !span_.size) {
+                    span_ = ContentSpan();
+                    canceled_ = out_of_room_ = true;
+                    return false;
+                }
+                return true;
+            }
+
+            bool commit(size_t n) {
+                used_ += n;
+                received_ += n;
+                if (progress_ && *progress_ && !(*progress_)(received_, content_length_)) {
+                    canceled_ = true;
+                    return false;
+                }
+                return true;
+            }
+
+            const ContentSpanReceiver* next_ = nullptr;
+            const Progress* progress_ = nullptr;
+            uint64_t content_length_ = 0;
+            uint64_t received_ = 0;
+            ContentSpan span_;
+            size_t used_ = 0;
+            bool canceled_ = false;
+            bool out_of_room_ = false;
+        };
+
+        // Walks the chunk framing, read_chunk(len) consumes the data of each chunk
+        template <typename F>
+        bool read_chunks(Stream& strm, F read_chunk) {
             const auto bufsiz = 16;
             char buf[bufsiz];
 
@@ -2442,9 +3285,7 @@ namespace httplib {
 
                 if (chunk_len == 0) { break; }
 
-                if (!read_content_with_length(strm, chunk_len, nullptr, out)) {
-                    return false;
-                }
+                if (!read_chunk(static_cast<uint64_t>(chunk_len))) { return false; }
 
                 if (!line_reader.getline()) { return false; }
 
@@ -2462,6 +3303,12 @@ namespace httplib {
             return true;
         }
 
+        inline bool read_content_chunked(Stream& strm, ContentReceiver out) {
+            return read_chunks(strm, [&](uint64_t len) {
+                return read_content_with_length(strm, len, nullptr, out);
+            });
+        }
+
         inline bool is_chunked_transfer_encoding(const Headers& headers) {
             return !strcasecmp(get_header_value(headers, "Transfer-Encoding", 0, ""),
                 "chunked");
@@ -2546,9 +3393,9 @@ namespace httplib {
                 });
         }
 
-        template <typename T>
+        template <typename T, typename H>
         inline ssize_t write_headers(Stream& strm, const T& info,
-            const Headers& headers) {
+            const H& headers) {
             ssize_t write_len = 0;
             for (const auto& x : info.headers) {
                 if (x.first == "EXCEPTION_WHAT") { continue; }
@@ -2579,6 +3426,139 @@ namespace httplib {
             return true;
         }
 
+        using RateLimiters = std::vector<std::shared_ptr<RateLimiter>>;
+
+        // For the places that start over with a fresh Response for the same request
+        inline void reset_response_keep_timings(Response& res) {
+            auto timings = res.timings;
+            res = Response();
+            res.timings = timings;
+        }
+
+        // Empties a response for the next request, keeping its header nodes and string capacity
+        inline void reset_response(Response& res, HeaderNodes& nodes) {
+            res.version.clear();
+            res.status = -1;
+            res.reason.clear();
+            recycle_headers(res.headers, nodes);
+            if (res.body.capacity() > CPPHTTPLIB_REQUEST_ARENA_MAX_RETAINED) { std::string().swap(res.body); }
+            else { res.body.clear(); }
+            res.timings = RequestTimings();
+
+            if (res.content_provider_resource_releaser_) {
+                res.content_provider_resource_releaser_();
+                res.content_provider_resource_releaser_ = nullptr;
+            }
+            res.content_length_ = 0;
+            res.content_provider_ = nullptr;
+            res.is_chunked_content_provider = false;
+        }
+
+        inline bool is_rate_limited(const RateLimiters& client_limiters,
+            const Request& req) {
+            return !client_limiters.empty() || !req.rate_limiters.empty();
+        }
+
+        // Checked per write, a limiter may get a rate while the upload is running
+        inline bool is_upload_rate_limited(const RateLimiters& client_limiters,
+            const Request& req) {
+            for (const auto& limiter : client_limiters) {
+                if (limiter && limiter->upload_rate()) { return true; }
+            }
+            for (const auto& limiter : req.rate_limiters) {
+                if (limiter && limiter->upload_rate()) { return true; }
+            }
+            return false;
+        }
+
+        // Each limiter sleeps off its own deficit, the slowest one sets the pace
+        inline void throttle_download(const RateLimiters& client_limiters,
+            const Request& req, size_t n) {
+            for (const auto& limiter : client_limiters) {
+                if (limiter) { limiter->acquire_download(n); }
+            }
+            for (const auto& limiter : req.rate_limiters) {
+                if (limiter) { limiter->acquire_download(n); }
+            }
+        }
+
+        inline void throttle_upload(const RateLimiters& client_limiters,
+            const Request& req, size_t n) {
+            for (const auto& limiter : client_limiters) {
+                if (limiter) { limiter->acquire_upload(n); }
+            }
+            for (const auto& limiter : req.rate_limiters) {
+                if (limiter) { limiter->acquire_upload(n); }
+            }
+        }
+
+        // Small slices keep a large write paced evenly instead of one long sleep and a burst
+        inline bool write_data_throttled(Stream& strm, const char* d, size_t l,
+            const RateLimiters& client_limiters, const Request& req) {
+            if (!is_upload_rate_limited(client_limiters, req)) { return write_data(strm, d, l); }
+
+            while (l > 0) {
+                auto n = (std::min)(l, CPPHTTPLIB_RECV_BUFSIZ);
+                throttle_upload(client_limiters, req, n);
+                if (!write_data(strm, d, n)) { return false; }
+                d += n;
+                l -= n;
+            }
+            return true;
+        }
+
+        // Positional, so a body sent again after a redirect or an auth challenge starts over at the same offset
+        inline ssize_t read_file_at(int fd, char* buf, size_t size, uint64_t offset) {
+#ifdef _WIN32
+            OVERLAPPED overlapped = {};
+            overlapped.Offset = static_cast<DWORD>(offset);
+            overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD n = 0;
+            auto handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+            if (!ReadFile(handle, buf, static_cast<DWORD>((std::min)(size, static_cast<size_t>(MAXDWORD))),
+                &n, &overlapped)) {
+                return GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+            }
+            return static_cast<ssize_t>(n);
+#else
+            return handle_EINTR([&]() {
+                return pread(fd, buf, size, static_cast<off_t>(offset));
+            });
+#endif
+        }
+
+        // Stream::send_file() as far as the stream takes it, pooled buffers of the file for the rest
+        inline bool write_file_content(Stream& strm, const FileContent& file,
+            const RateLimiters& client_limiters, const Request& req) {
+            auto throttled = is_upload_rate_limited(client_limiters, req);
+            // sendfile() moves at most 0x7ffff000 bytes per call
+            const uint64_t max_send = throttled ? CPPHTTPLIB_RECV_BUFSIZ : 0x7ffff000;
+
+            uint64_t sent = 0;
+            while (!file.observer && sent < file.length) {
+                auto n = static_cast<size_t>((std::min)(file.length - sent, max_send));
+                if (throttled) { throttle_upload(client_limiters, req, n); }
+                auto ret = strm.send_file(file.fd, file.offset + sent, n);
+                if (ret <= 0) { break; }
+                sent += static_cast<uint64_t>(ret);
+            }
+
+            BufferPool::Lease buf;
+            while (sent < file.length) {
+                auto n = read_file_at(file.fd, buf.data(),
+                    static_cast<size_t>((std::min)(static_cast<uint64_t>(buf.size()), file.length - sent)),
+                    file.offset + sent);
+                // Shorter than file.length says
+                if (n <= 0) { return false; }
+                if (file.observer) { file.observer(sent, buf.data(), static_cast<size_t>(n)); }
+                if (!write_data_throttled(strm, buf.data(), static_cast<size_t>(n), client_limiters, req)) {
+                    return false;
+                }
+                sent += static_cast<uint64_t>(n);
+            }
+            return true;
+        }
+
         template <typename T>
         inline ssize_t write_content(Stream& strm, ContentProvider content_provider,
             size_t offset, size_t length, T is_shutting_down) {
@@ -3388,6 +4368,228 @@ namespace httplib {
         return std::make_pair(key, field);
     }
 
+    // RateLimiter implementation
+    inline RateLimiter::RateLimiter(uint64_t download_bytes_per_sec,
+        uint64_t upload_bytes_per_sec) {
+        set_download_rate(download_bytes_per_sec);
+        set_upload_rate(upload_bytes_per_sec);
+    }
+
+    inline void RateLimiter::set_download_rate(uint64_t bytes_per_sec) {
+        set_rate(download_, bytes_per_sec);
+    }
+
+    inline void RateLimiter::set_upload_rate(uint64_t bytes_per_sec) {
+        set_rate(upload_, bytes_per_sec);
+    }
+
+    inline uint64_t RateLimiter::download_rate() const { return download_.rate; }
+
+    inline uint64_t RateLimiter::upload_rate() const { return upload_.rate; }
+
+    inline void RateLimiter::acquire_download(size_t n) { acquire(download_, n); }
+
+    inline void RateLimiter::acquire_upload(size_t n) { acquire(upload_, n); }
+
+    inline void RateLimiter::refill(Bucket& bucket, double rate) {
+        auto now = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::duration<double>(now - bucket.last).count();
+        bucket.last = now;
+
+        // A small capacity keeps an idle period from turning into a burst
+        auto capacity = rate * CPPHTTPLIB_RATE_LIMIT_BURST_MSEC / 1000.0;
+        bucket.tokens = (std::min)(capacity, bucket.tokens + elapsed * rate);
+    }
+
+    inline void RateLimiter::set_rate(Bucket& bucket, uint64_t bytes_per_sec) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        refill(bucket, static_cast<double>(bucket.rate));
+        bucket.rate = bytes_per_sec;
+        if (!bytes_per_sec) { bucket.tokens = 0; }
+    }
+
+    inline void RateLimiter::acquire(Bucket& bucket, size_t n) {
+        double wait_sec = 0;
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            auto rate = static_cast<double>(bucket.rate);
+            if (rate <= 0) { return; }
+
+            refill(bucket, rate);
+
+            // Going into debt reserves the bytes, so concurrent callers line up behind each other
+            bucket.tokens -= static_cast<double>(n);
+            if (bucket.tokens < 0) { wait_sec = -bucket.tokens / rate; }
+        }
+
+        if (wait_sec > 0) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(wait_sec));
+        }
+    }
+
+    // MultipartFormDataWriter implementation
+    inline MultipartFormDataWriter::MultipartFormDataWriter()
+        : boundary_(detail::make_multipart_data_boundary()) {
+        Segment closing;
+        closing.text = "--" + boundary_ + "--\r\n";
+        segments_.push_back(std::move(closing));
+    }
+
+    inline void MultipartFormDataWriter::add(const std::string& name,
+        const std::string& content, const std::string& filename,
+        const std::string& content_type) {
+        Segment segment;
+        segment.text = content;
+        segment.length = static_cast<int64_t>(content.size());
+        add_part(name, filename, content_type, std::move(segment));
+    }
+
+    inline void MultipartFormDataWriter::add(const std::string& name,
+        std::istream& content, int64_t length, const std::string& filename,
+        const std::string& content_type) {
+        Segment segment;
+        segment.stream = &content;
+        // -1 for pipes and the like, which can only be sent once
+        segment.stream_start = content.tellg();
+        segment.length = length < 0 ? -1 : length;
+        if (length < 0) { has_unknown_length_ = true; }
+        add_part(name, filename, content_type, std::move(segment));
+    }
+
+    inline void MultipartFormDataWriter::add(const std::string& name,
+        const FileContent& content, const std::string& filename,
+        const std::string& content_type) {
+        Segment segment;
+        segment.file = content;
+        segment.length = static_cast<int64_t>(content.length);
+        add_part(name, filename, content_type, std::move(segment));
+    }
+
+    inline std::string MultipartFormDataWriter::content_type() const {
+        return "multipart/form-data; boundary=" + boundary_;
+    }
+
+    inline size_t MultipartFormDataWriter::content_length() const {
+        if (has_unknown_length_) { return 0; }
+        const auto& last = segments_.back();
+        return last.offset + static_cast<size_t>(segment_length(last));
+    }
+
+    inline void MultipartFormDataWriter::add_part(const std::string& name,
+        const std::string& filename, const std::string& content_type,
+        Segment&& content) {
+        auto closing = std::move(segments_.back());
+        segments_.pop_back();
+
+        // Same part headers as Post(path, headers, MultipartFormDataItems)
+        Segment header;
+        header.text = "--" + boundary_ + "\r\n";
+        header.text += "Content-Disposition: form-data; name=\"" + name + "\"";
+        if (!filename.empty()) { header.text += "; filename=\"" + filename + "\""; }
+        header.text += "\r\n";
+        if (!content_type.empty()) { header.text += "Content-Type: " + content_type + "\r\n"; }
+        header.text += "\r\n";
+
+        Segment crlf;
+        crlf.text = "\r\n";
+
+        for (auto segment : { &header, &content, &crlf, &closing }) {
+            if (segments_.empty()) {
+                segment->offset = 0;
+            }
+            else {
+                const auto& last = segments_.back();
+                segment->offset = last.offset + static_cast<size_t>(segment_length(last));
+            }
+            segments_.push_back(std::move(*segment));
+        }
+        stream_cursor_segment_ = nullptr;
+    }
+
+    inline uint64_t MultipartFormDataWriter::segment_length(const Segment& segment) {
+        if (segment.stream || segment.file.fd >= 0) {
+            return segment.length < 0 ? 0 : static_cast<uint64_t>(segment.length);
+        }
+        return segment.text.size();
+    }
+
+    inline ssize_t MultipartFormDataWriter::write_segment(Segment& segment,
+        uint64_t rel, size_t length, char* buf, DataSink& sink) {
+        ssize_t n = 0;
+
+        if (segment.file.fd >= 0) {
+            if (rel >= segment.file.length) { return 0; }
+            n = detail::read_file_at(segment.file.fd, buf,
+                static_cast<size_t>((std::min)(static_cast<uint64_t>(length), segment.file.length - rel)),
+                segment.file.offset + rel);
+            if (n <= 0) { return -1; }
+            sink.write(buf, static_cast<size_t>(n));
+        }
+        else if (segment.stream) {
+            if (segment.length >= 0) {
+                if (rel >= static_cast<uint64_t>(segment.length)) { return 0; }
+                length = static_cast<size_t>((std::min)(static_cast<uint64_t>(length),
+                    static_cast<uint64_t>(segment.length) - rel));
+            }
+
+            auto& stream = *segment.stream;
+            if (stream_cursor_segment_ != &segment || stream_cursor_ != rel) {
+                if (segment.stream_start == std::streampos(-1)) { return -1; }
+                stream.clear();
+                stream.seekg(segment.stream_start + static_cast<std::streamoff>(rel));
+                if (!stream) { return -1; }
+            }
+
+            stream.read(buf, static_cast<std::streamsize>(length));
+            n = static_cast<ssize_t>(stream.gcount());
+            stream_cursor_segment_ = &segment;
+            stream_cursor_ = rel + static_cast<uint64_t>(n);
+            if (n == 0) { return segment.length < 0 ? 0 : -1; }
+            sink.write(buf, static_cast<size_t>(n));
+        }
+        else {
+            if (rel >= segment.text.size()) { return 0; }
+            n = static_cast<ssize_t>((std::min)(static_cast<uint64_t>(length), segment.text.size() - rel));
+            sink.write(segment.text.data() + rel, static_cast<size_t>(n));
+        }
+
+        written_ += static_cast<size_t>(n);
+        return n;
+    }
+
+    inline bool MultipartFormDataWriter::provide(size_t offset, size_t length,
+        DataSink& sink) {
+        detail::BufferPool::Lease buf;
+
+        // Unknown length: write_request() asks once, for everything
+        if (length == static_cast<size_t>(-1)) {
+            written_ = 0;
+            for (auto& segment : segments_) {
+                uint64_t rel = 0;
+                while (true) {
+                    // A peer that went away ends it here, not after reading the rest of the files
+                    if (sink.is_writable && !sink.is_writable()) { return false; }
+                    auto n = write_segment(segment, rel, buf.size(), buf.data(), sink);
+                    if (n < 0) { return false; }
+                    if (n == 0) { break; }
+                    rel += static_cast<uint64_t>(n);
+                }
+            }
+            if (sink.done) { sink.done(); }
+            return true;
+        }
+
+        if (offset == 0) { written_ = 0; }
+        for (auto& segment : segments_) {
+            auto end = segment.offset + static_cast<size_t>(segment_length(segment));
+            if (offset < end) {
+                return write_segment(segment, offset - segment.offset,
+                    (std::min)(length, buf.size()), buf.data(), sink) > 0;
+            }
+        }
+        return false;
+    }
+
     // Request implementation
     inline bool Request::has_header(const char* key) const {
         return detail::has_header(headers, key);
@@ -3552,6 +4754,14 @@ namespace httplib {
         return write(s.data(), s.size());
     }
 
+    inline ssize_t Stream::send_file(int /*fd*/, uint64_t /*offset*/, size_t /*size*/) {
+        return -1;
+    }
+
+    inline bool Stream::wait_readable(time_t /*sec*/, time_t /*usec*/) const {
+        return is_readable();
+    }
+
     template <typename... Args>
     inline ssize_t Stream::write_format(const char* fmt, const Args&... args) {
         const auto bufsiz = 2048;
@@ -3605,6 +4815,10 @@ namespace httplib {
             return select_read(sock_, read_timeout_sec_, read_timeout_usec_) > 0;
         }
 
+        inline bool SocketStream::wait_readable(time_t sec, time_t usec) const {
+            return select_read(sock_, sec, usec) > 0;
+        }
+
         inline bool SocketStream::is_writable() const {
             return select_write(sock_, write_timeout_sec_, write_timeout_usec_) > 0;
         }
@@ -3630,8 +4844,13 @@ namespace httplib {
                 return -1;
             }
             return send(sock_, ptr, static_cast<int>(size), 0);
+#else
+            // A peer that closed mid-pipeline must surface as a write error, not SIGPIPE
+#ifdef MSG_NOSIGNAL
+            return handle_EINTR([&]() { return send(sock_, ptr, size, MSG_NOSIGNAL); });
 #else
             return handle_EINTR([&]() { return send(sock_, ptr, size, 0); });
+#endif
 #endif
         }
 
@@ -3640,169 +4859,2252 @@ namespace httplib {
             return detail::get_remote_ip_and_port(sock_, ip, port);
         }
 
-        // Buffer stream implementation
-        inline bool BufferStream::is_readable() const { return true; }
+#ifdef __linux__
+        // sendfile() has no MSG_NOSIGNAL. SIGPIPE is blocked for the call, and one it raised is
+        // taken off the thread again, so a closed peer surfaces as a write error like in write()
+        class SigpipeBlock {
+        public:
+            SigpipeBlock() {
+                sigemptyset(&sigpipe_);
+                sigaddset(&sigpipe_, SIGPIPE);
+                sigset_t pending;
+                sigpending(&pending);
+                was_pending_ = sigismember(&pending, SIGPIPE) == 1;
+                blocked_ = pthread_sigmask(SIG_BLOCK, &sigpipe_, &previous_) == 0;
+            }
+
+            ~SigpipeBlock() {
+                if (!blocked_) { return; }
+                if (!was_pending_) {
+                    sigset_t pending;
+                    sigpending(&pending);
+                    if (sigismember(&pending, SIGPIPE) == 1) {
+                        timespec zero = { 0, 0 };
+                        sigtimedwait(&sigpipe_, nullptr, &zero);
+                    }
+                }
+                pthread_sigmask(SIG_SETMASK, &previous_, nullptr);
+            }
 
-        inline bool BufferStream::is_writable() const { return true; }
+        private:
+            sigset_t sigpipe_;
+            sigset_t previous_;
+            bool was_pending_ = false;
+            bool blocked_ = false;
+        };
 
-        inline ssize_t BufferStream::read(char* ptr, size_t size) {
-#if defined(_MSC_VER) && _MSC_VER <= 1900
-            auto len_read = buffer._Copy_s(ptr, size, size, position);
-#else
-            auto len_read = buffer.copy(ptr, size, position);
-#endif
-            position += static_cast<size_t>(len_read);
-            return static_cast<ssize_t>(len_read);
-        }
+        inline ssize_t SocketStream::send_file(int fd, uint64_t offset, size_t size) {
+            if (!is_writable()) { return -1; }
 
-        inline ssize_t BufferStream::write(const char* ptr, size_t size) {
-            buffer.append(ptr, size);
-            return static_cast<ssize_t>(size);
+            SigpipeBlock sigpipe_block;
+            auto off = static_cast<off_t>(offset);
+            return handle_EINTR([&]() { return sendfile(sock_, fd, &off, size); });
         }
+#endif
 
-        inline void BufferStream::get_remote_ip_and_port(std::string& /*ip*/,
-            int& /*port*/) const {}
-
-        inline const std::string& BufferStream::get_buffer() const { return buffer; }
-
-    } // namespace detail
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+        // io_uring implementation
+        inline IoUring* IoUring::get() {
+            // Kernels without io_uring, or with it disabled, say so for every thread
+            static std::atomic<bool> unavailable{ false };
+            static thread_local std::unique_ptr<IoUring> ring;
+            static thread_local bool tried = false;
+
+            if (!tried && !unavailable.load(std::memory_order_relaxed)) {
+                tried = true;
+                std::unique_ptr<IoUring> candidate(new IoUring());
+                if (candidate->init()) {
+                    ring = std::move(candidate);
+                }
+                else if (errno == ENOSYS || errno == EPERM) {
+                    unavailable = true;
+                }
+            }
+            return ring.get();
+        }
 
-    // HTTP client implementation
-    inline ClientImpl::ClientImpl(const std::string& host)
-        : ClientImpl(host, 80, std::string(), std::string()) {}
+        inline IoUring::~IoUring() {
+            if (sqes_) { munmap(sqes_, sqes_size_); }
+            if (rings_) { munmap(rings_, rings_size_); }
+            if (fd_ >= 0) { close(fd_); }
+            if (buffers_) { FMemory::Free(buffers_); }
+        }
 
-    inline ClientImpl::ClientImpl(const std::string& host, int port)
-        : ClientImpl(host, port, std::string(), std::string()) {}
+        inline bool IoUring::init() {
+            io_uring_params params;
+            memset(&params, 0, sizeof(params));
+            fd_ = static_cast<int>(syscall(__NR_io_uring_setup, CPPHTTPLIB_IO_URING_ENTRIES, &params));
+            if (fd_ < 0) { return false; }
 
-    inline ClientImpl::ClientImpl(const std::string& host, int port,
-        const std::string& client_cert_path,
-        const std::string& client_key_path)
-        : host_(host), port_(port),
-        host_and_port_(host_ + ":" + std::to_string(port_)),
-        client_cert_path_(client_cert_path), client_key_path_(client_key_path) {}
+            // Both features came with 5.5, the opcodes below with 5.6
+            if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP)) {
+                return false;
+            }
 
-    inline ClientImpl::~ClientImpl() { stop_core(); }
+            const unsigned probe_ops = 256;
+            std::vector<char> probe_memory(sizeof(io_uring_probe) + probe_ops * sizeof(io_uring_probe_op));
+            auto probe = reinterpret_cast<io_uring_probe*>(probe_memory.data());
+            if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe, probe_ops) < 0) {
+                return false;
+            }
+            for (auto op : { IORING_OP_RECV, IORING_OP_SEND, IORING_OP_LINK_TIMEOUT, IORING_OP_WRITE, IORING_OP_WRITE_FIXED }) {
+                if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) { return false; }
+            }
+
+            rings_size_ = (std::max)(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+            auto rings = mmap(nullptr, rings_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                fd_, IORING_OFF_SQ_RING);
+            if (rings == MAP_FAILED) { return false; }
+            rings_ = rings;
+
+            sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+            auto sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                fd_, IORING_OFF_SQES);
+            if (sqes == MAP_FAILED) { return false; }
+            sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+            auto base = static_cast<char*>(rings_);
+            sq_head_ = reinterpret_cast<unsigned*>(base + params.sq_off.head);
+            sq_tail_ = reinterpret_cast<unsigned*>(base + params.sq_off.tail);
+            sq_array_ = reinterpret_cast<unsigned*>(base + params.sq_off.array);
+            sq_mask_ = *reinterpret_cast<unsigned*>(base + params.sq_off.ring_mask);
+            sq_entries_ = *reinterpret_cast<unsigned*>(base + params.sq_off.ring_entries);
+            sqe_tail_ = *sq_tail_;
+            cq_head_ = reinterpret_cast<unsigned*>(base + params.cq_off.head);
+            cq_tail_ = reinterpret_cast<unsigned*>(base + params.cq_off.tail);
+            cqes_ = reinterpret_cast<io_uring_cqe*>(base + params.cq_off.cqes);
+            cq_mask_ = *reinterpret_cast<unsigned*>(base + params.cq_off.ring_mask);
+
+            // Registering pins the pages against RLIMIT_MEMLOCK; where that is too low they are used unregistered
+            buffers_ = static_cast<char*>(FMemory::Malloc(CPPHTTPLIB_IO_URING_BUFFERS * CPPHTTPLIB_IO_URING_BUFFER_SIZE,
+                CPPHTTPLIB_IO_BUFFER_ALIGNMENT));
+            iovec iovecs[CPPHTTPLIB_IO_URING_BUFFERS];
+            for (int i = 0; i < CPPHTTPLIB_IO_URING_BUFFERS; i++) {
+                iovecs[i].iov_base = buffers_ + i * CPPHTTPLIB_IO_URING_BUFFER_SIZE;
+                iovecs[i].iov_len = CPPHTTPLIB_IO_URING_BUFFER_SIZE;
+            }
+            buffers_registered_ = syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS, iovecs,
+                CPPHTTPLIB_IO_URING_BUFFERS) == 0;
+            free_buffers_ = (uint32_t(1) << CPPHTTPLIB_IO_URING_BUFFERS) - 1;
+            return true;
+        }
 
-    inline bool ClientImpl::is_valid() const { return true; }
+        inline bool IoUring::acquire_buffer(Buffer& buf) {
+            if (!free_buffers_) { return false; }
 
-    inline Error ClientImpl::get_last_error() const { return error_; }
+            int index = 0;
+            while (!(free_buffers_ & (uint32_t(1) << index))) { index++; }
+            free_buffers_ &= ~(uint32_t(1) << index);
 
-    inline socket_t ClientImpl::create_client_socket() const {
-        if (!proxy_host_.empty() && proxy_port_ != -1) {
-            return detail::create_client_socket(
-                proxy_host_.c_str(), proxy_port_, tcp_nodelay_, socket_options_,
-                connection_timeout_sec_, connection_timeout_usec_, interface_, error_);
+            buf.data = buffers_ + index * CPPHTTPLIB_IO_URING_BUFFER_SIZE;
+            buf.size = CPPHTTPLIB_IO_URING_BUFFER_SIZE;
+            buf.index = index;
+            return true;
         }
-        return detail::create_client_socket(
-            host_.c_str(), port_, tcp_nodelay_, socket_options_,
-            connection_timeout_sec_, connection_timeout_usec_, interface_, error_);
-    }
 
-    inline bool ClientImpl::create_and_connect_socket(Socket& socket) {
-        auto sock = create_client_socket();
-        if (sock == INVALID_SOCKET) { return false; }
-        socket.sock = sock;
-        return true;
-    }
-
-    inline void ClientImpl::close_socket(Socket& socket,
-        bool /*process_socket_ret*/) {
-        detail::close_socket(socket.sock);
-        socket_.sock = INVALID_SOCKET;
-#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
-        socket_.ssl = nullptr;
-#endif
-    }
+        inline void IoUring::release_buffer(const Buffer& buf) {
+            if (buf.index >= 0) { free_buffers_ |= uint32_t(1) << buf.index; }
+        }
 
-    inline bool ClientImpl::read_response_line(Stream& strm, Response& res) {
-        std::array<char, 2048> buf;
+        inline bool IoUring::reserve(unsigned count) {
+            while (sqe_tail_ + count - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) > sq_entries_) {
+                if (!enter(0)) { return false; }
+            }
+            return true;
+        }
 
-        detail::stream_line_reader line_reader(strm, buf.data(), buf.size());
+        inline io_uring_sqe* IoUring::next_sqe(uint8_t opcode, int fd, uint64_t ticket) {
+            auto index = sqe_tail_ & sq_mask_;
+            auto sqe = &sqes_[index];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = opcode;
+            sqe->fd = fd;
+            sqe->user_data = ticket;
+            sq_array_[index] = index;
+            sqe_tail_++;
+            return sqe;
+        }
 
-        if (!line_reader.getline()) { return false; }
+        inline bool IoUring::enter(unsigned min_complete) {
+            auto to_submit = sqe_tail_ - *sq_tail_;
+            __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
 
-        const static std::regex re("(HTTP/1\\.[01]) (\\d+) (.*?)\r\n");
+            while (true) {
+                auto ret = syscall(__NR_io_uring_enter, fd_, to_submit, min_complete,
+                    min_complete ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+                if (ret >= 0) { break; }
+                // Completions kept back from a full queue, reaping them makes room
+                if (errno == EBUSY || errno == EAGAIN) {
+                    reap();
+                    continue;
+                }
+                if (errno != EINTR) { return false; }
+            }
+            reap();
+            return true;
+        }
 
-        std::cmatch m;
-        if (std::regex_match(line_reader.ptr(), m, re)) {
-            res.version = std::string(m[1]);
-            res.status = std::stoi(std::string(m[2]));
-            res.reason = std::string(m[3]);
+        inline void IoUring::reap() {
+            auto head = *cq_head_;
+            auto tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+            for (; head != tail; head++) {
+                const auto& cqe = cqes_[head & cq_mask_];
+                // Linked timeouts have ticket 0, nobody waits for them
+                if (cqe.user_data) { results_.emplace_back(cqe.user_data, static_cast<ssize_t>(cqe.res)); }
+            }
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
         }
 
-        return true;
-    }
+        inline bool IoUring::take_result(uint64_t ticket, ssize_t& res) {
+            for (size_t i = 0; i < results_.size(); i++) {
+                if (results_[i].first == ticket) {
+                    res = results_[i].second;
+                    results_[i] = results_.back();
+                    results_.pop_back();
+                    return true;
+                }
+            }
+            return false;
+        }
 
-    inline bool ClientImpl::send(const Request& req, Response& res) {
-        std::lock_guard<std::recursive_mutex> request_mutex_guard(request_mutex_);
+        inline ssize_t IoUring::submit_socket_op(uint8_t opcode, socket_t sock, const char* ptr,
+            size_t size, time_t sec, time_t usec) {
+            const auto len = static_cast<uint32_t>((std::min)(size, static_cast<size_t>(UINT32_MAX)));
+            const auto flags = opcode == IORING_OP_SEND ? MSG_NOSIGNAL : 0;
 
-        {
-            std::lock_guard<std::mutex> guard(socket_mutex_);
+            // Most of the time the socket is ready, and then arming and cancelling a timer costs more than the
+            // operation. Only what would block goes again with the timeout linked
+            if (!reserve(1)) { return -1; }
+            auto ticket = next_ticket_++;
+            auto sqe = next_sqe(opcode, sock, ticket);
+            sqe->addr = reinterpret_cast<uint64_t>(ptr);
+            sqe->len = len;
+            sqe->msg_flags = flags | MSG_DONTWAIT;
 
-            auto is_alive = false;
-            if (socket_.is_open()) {
-                is_alive = detail::select_write(socket_.sock, 0, 0) > 0;
-                if (!is_alive) { close_socket(socket_, false); }
-            }
+            auto res = wait(ticket);
+            if (res != -EAGAIN) { return res < 0 ? -1 : res; }
 
-            if (!is_alive) {
-                if (!create_and_connect_socket(socket_)) { return false; }
+            if (!reserve(2)) { return -1; }
+            ticket = next_ticket_++;
+            sqe = next_sqe(opcode, sock, ticket);
+            sqe->addr = reinterpret_cast<uint64_t>(ptr);
+            sqe->len = len;
+            sqe->msg_flags = flags;
+            sqe->flags = IOSQE_IO_LINK;
 
-#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
-                // TODO: refactoring
-                if (is_ssl()) {
-                    auto& scli = static_cast<SSLClient&>(*this);
-                    if (!proxy_host_.empty() && proxy_port_ != -1) {
-                        bool success = false;
-                        if (!scli.connect_with_proxy(socket_, res, success)) {
-                            return success;
-                        }
-                    }
+            // Read by the kernel while submitting, which happens before this returns
+            __kernel_timespec timeout;
+            timeout.tv_sec = sec;
+            timeout.tv_nsec = usec * 1000;
+            auto timeout_sqe = next_sqe(IORING_OP_LINK_TIMEOUT, -1, 0);
+            timeout_sqe->addr = reinterpret_cast<uint64_t>(&timeout);
+            timeout_sqe->len = 1;
 
-                    if (!scli.initialize_ssl(socket_)) { return false; }
-                }
-#endif
-            }
+            res = wait(ticket);
+            // A timeout cancels the operation
+            return res < 0 ? -1 : res;
         }
 
-        auto close_connection = !keep_alive_;
+        inline ssize_t IoUring::recv(socket_t sock, char* ptr, size_t size, time_t sec, time_t usec) {
+            return submit_socket_op(IORING_OP_RECV, sock, ptr, size, sec, usec);
+        }
 
-        auto ret = process_socket(socket_, [&](Stream& strm) {
-            return handle_request(strm, req, res, close_connection);
-            });
+        inline ssize_t IoUring::send(socket_t sock, const char* ptr, size_t size, time_t sec, time_t usec) {
+            return submit_socket_op(IORING_OP_SEND, sock, ptr, size, sec, usec);
+        }
 
-        if (close_connection || !ret) { stop_core(); }
+        inline uint64_t IoUring::write_async(int fd, const Buffer& buf, size_t size, uint64_t offset) {
+            if (!reserve(1)) { return 0; }
 
-        if (!ret) {
-            if (error_ == Error::Success) { error_ = Error::Unknown; }
+            auto ticket = next_ticket_++;
+            auto sqe = next_sqe(buffers_registered_ ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE, fd, ticket);
+            sqe->addr = reinterpret_cast<uint64_t>(buf.data);
+            sqe->len = static_cast<uint32_t>(size);
+            sqe->off = offset;
+            if (buffers_registered_) { sqe->buf_index = static_cast<uint16_t>(buf.index); }
+            return ticket;
         }
 
-        return ret;
-    }
+        inline ssize_t IoUring::wait(uint64_t ticket) {
+            if (!ticket) { return -EIO; }
 
-    inline bool ClientImpl::handle_request(Stream& strm, const Request& req,
-        Response& res, bool close_connection) {
-        if (req.path.empty()) {
-            error_ = Error::Connection;
-            return false;
+            ssize_t res = 0;
+            while (!take_result(ticket, res)) {
+                if (!enter(1)) { return -errno; }
+            }
+            return res;
         }
 
-        bool ret;
+        inline UringSocketStream::UringSocketStream(IoUring& ring, socket_t sock,
+            time_t read_timeout_sec, time_t read_timeout_usec,
+            time_t write_timeout_sec, time_t write_timeout_usec)
+            : SocketStream(sock, read_timeout_sec, read_timeout_usec, write_timeout_sec,
+                write_timeout_usec),
+            ring_(ring) {}
 
-        if (!is_ssl() && !proxy_host_.empty() && proxy_port_ != -1) {
-            auto req2 = req;
-            req2.path = "http://" + host_and_port_ + req.path;
-            ret = process_request(strm, req2, res, close_connection);
+        inline ssize_t UringSocketStream::read(char* ptr, size_t size) {
+            return ring_.recv(sock_, ptr, size, read_timeout_sec_, read_timeout_usec_);
         }
-        else {
-            ret = process_request(strm, req, res, close_connection);
+
+        inline ssize_t UringSocketStream::write(const char* ptr, size_t size) {
+            return ring_.send(sock_, ptr, size, write_timeout_sec_, write_timeout_usec_);
         }
+#endif
 
-        if (!ret) { return false; }
+        // Buffer stream implementation
+        inline bool BufferStream::is_readable() const { return true; }
 
-        if (300 < res.status && res.status < 400 && follow_location_) {
-            ret = redirect(req, res);
-        }
+        inline bool BufferStream::is_writable() const { return true; }
+
+        inline ssize_t BufferStream::read(char* ptr, size_t size) {
+#if defined(_MSC_VER) && _MSC_VER <= 1900
+            auto len_read = buffer._Copy_s(ptr, size, size, position);
+#else
+            auto len_read = buffer.copy(ptr, size, position);
+#endif
+            position += static_cast<size_t>(len_read);
+            return static_cast<ssize_t>(len_read);
+        }
+
+        inline ssize_t BufferStream::write(const char* ptr, size_t size) {
+            buffer.append(ptr, size);
+            return static_cast<ssize_t>(size);
+        }
+
+        inline void BufferStream::get_remote_ip_and_port(std::string& /*ip*/,
+            int& /*port*/) const {}
+
+        inline const ArenaString& BufferStream::get_buffer() const { return buffer; }
+
+        // Request arena implementation
+        inline RequestArena::~RequestArena() {
+            for (auto& block : blocks_) { ::operator delete(block.data); }
+        }
+
+        inline void* RequestArena::bump(char* data, size_t block_size, size_t& offset,
+            size_t size, size_t alignment) {
+            auto aligned = (offset + alignment - 1) & ~(alignment - 1);
+            if (aligned + size > block_size) { return nullptr; }
+            offset = aligned + size;
+            return data + aligned;
+        }
+
+        inline void* RequestArena::allocate(size_t size, size_t alignment) {
+            if (auto p = bump(initial_, sizeof(initial_), initial_offset_, size, alignment)) {
+                return p;
+            }
+
+            while (block_index_ < blocks_.size()) {
+                auto& block = blocks_[block_index_];
+                if (auto p = bump(block.data, block.size, offset_, size, alignment)) { return p; }
+                // The rest of this block is skipped until the next reset
+                block_index_++;
+                offset_ = 0;
+            }
+
+            // Blocks come from operator new, aligned for anything but over-aligned types
+            auto block_size = (blocks_.empty() ? sizeof(initial_) : blocks_.back().size) * 2;
+            block_size = (std::max)(block_size, size);
+            blocks_.push_back(Block{ static_cast<char*>(::operator new(block_size)), block_size });
+            block_index_ = blocks_.size() - 1;
+            offset_ = size;
+            return blocks_.back().data;
+        }
+
+        inline void RequestArena::reset() {
+            initial_offset_ = 0;
+
+            size_t retained = 0;
+            size_t kept = 0;
+            for (auto& block : blocks_) {
+                if (retained + block.size <= CPPHTTPLIB_REQUEST_ARENA_MAX_RETAINED) {
+                    retained += block.size;
+                    blocks_[kept++] = block;
+                }
+                else {
+                    ::operator delete(block.data);
+                }
+            }
+            blocks_.resize(kept);
+            block_index_ = 0;
+            offset_ = 0;
+        }
+
+        // Buffer pool implementation
+        inline BufferPool& BufferPool::get() {
+            static BufferPool instance;
+            return instance;
+        }
+
+        inline void BufferPool::set_buffer_size(size_t size) {
+            size = (std::max)(size, CPPHTTPLIB_IO_BUFFER_MIN_SIZE);
+            size = (std::min)(size, CPPHTTPLIB_IO_BUFFER_MAX_SIZE);
+            size = (size + CPPHTTPLIB_IO_BUFFER_ALIGNMENT - 1) & ~(CPPHTTPLIB_IO_BUFFER_ALIGNMENT - 1);
+            buffer_size_.store(size, std::memory_order_relaxed);
+        }
+
+        inline void BufferPool::trim() {
+            std::vector<Block> blocks;
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                blocks.swap(shared_);
+            }
+            for (const auto& block : blocks) { free_block(block); }
+        }
+
+        inline BufferPool::ThreadCache::~ThreadCache() {
+            for (size_t i = 0; i < count; i++) { BufferPool::get().release_shared(blocks[i]); }
+        }
+
+        inline BufferPool::ThreadCache& BufferPool::thread_cache() {
+            static thread_local ThreadCache cache;
+            return cache;
+        }
+
+        inline void BufferPool::free_block(const Block& block) { FMemory::Free(block.data); }
+
+        inline BufferPool::Block BufferPool::acquire() {
+            const auto size = buffer_size();
+
+            auto& cache = thread_cache();
+            while (cache.count > 0) {
+                auto block = cache.blocks[--cache.count];
+                if (block.size == size) { return block; }
+                free_block(block);
+            }
+
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                while (!shared_.empty()) {
+                    auto block = shared_.back();
+                    shared_.pop_back();
+                    if (block.size == size) { return block; }
+                    free_block(block);
+                }
+            }
+
+            return Block{ static_cast<char*>(FMemory::Malloc(size, CPPHTTPLIB_IO_BUFFER_ALIGNMENT)), size };
+        }
+
+        inline void BufferPool::release(const Block& block) {
+            if (block.size != buffer_size()) {
+                free_block(block);
+                return;
+            }
+
+            auto& cache = thread_cache();
+            if (cache.count < CPPHTTPLIB_IO_BUFFER_THREAD_CACHE) {
+                cache.blocks[cache.count++] = block;
+                return;
+            }
+            release_shared(block);
+        }
+
+        inline void BufferPool::release_shared(const Block& block) {
+            if (block.size == buffer_size()) {
+                std::lock_guard<std::mutex> guard(mutex_);
+                if (shared_.size() < CPPHTTPLIB_IO_BUFFER_SHARED_CACHE) {
+                    shared_.push_back(block);
+                    return;
+                }
+            }
+            free_block(block);
+        }
+
+        inline BufferPool::Lease::Lease() {
+            auto block = BufferPool::get().acquire();
+            data_ = block.data;
+            size_ = block.size;
+        }
+
+        inline BufferPool::Lease::~Lease() { BufferPool::get().release(Block{ data_, size_ }); }
+
+        inline size_t RequestArena::capacity() const {
+            size_t size = sizeof(initial_);
+            for (const auto& block : blocks_) { size += block.size; }
+            return size;
+        }
+
+    } // namespace detail
+
+    /*
+     * HTTP/2 client transport (RFC 7540) with HPACK header compression (RFC 7541).
+     * ClientImpl switches a connection to it when ALPN selects "h2", or up front
+     * for cleartext connections opened with prior knowledge.
+     */
+    namespace detail {
+
+        // Body-less requests without side effects, safe to pipeline and to replay
+        inline bool is_pipelinable(const Request& req) {
+            return (req.method == "GET" || req.method == "HEAD" || req.method == "OPTIONS") &&
+                req.body.empty() && !req.content_provider;
+        }
+
+        namespace http2 {
+
+            enum class FrameType : uint8_t {
+                Data = 0x0,
+                Headers = 0x1,
+                Priority = 0x2,
+                RstStream = 0x3,
+                Settings = 0x4,
+                PushPromise = 0x5,
+                Ping = 0x6,
+                GoAway = 0x7,
+                WindowUpdate = 0x8,
+                Continuation = 0x9,
+            };
+
+            enum FrameFlag : uint8_t {
+                FlagEndStream = 0x1,
+                FlagAck = 0x1,
+                FlagEndHeaders = 0x4,
+                FlagPadded = 0x8,
+                FlagPriority = 0x20,
+            };
+
+            enum SettingId : uint16_t {
+                SettingHeaderTableSize = 0x1,
+                SettingEnablePush = 0x2,
+                SettingMaxConcurrentStreams = 0x3,
+                SettingInitialWindowSize = 0x4,
+                SettingMaxFrameSize = 0x5,
+                SettingMaxHeaderListSize = 0x6,
+            };
+
+            enum class ErrorCode : uint32_t {
+                NoError = 0x0,
+                ProtocolError = 0x1,
+                InternalError = 0x2,
+                FlowControlError = 0x3,
+                SettingsTimeout = 0x4,
+                StreamClosed = 0x5,
+                FrameSizeError = 0x6,
+                RefusedStream = 0x7,
+                Cancel = 0x8,
+                CompressionError = 0x9,
+            };
+
+            const char connection_preface[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+            const size_t frame_header_size = 9;
+            const uint32_t default_window_size = 65535;
+            const uint32_t default_max_frame_size = 16384;
+            const uint32_t max_frame_size_limit = 16777215;
+            const uint32_t max_window_size = 0x7fffffff;
+            const uint32_t max_stream_id = 0x7fffffff;
+            const size_t hpack_default_table_size = 4096;
+            const size_t max_header_block_size = 1024 * 1024;
+
+            using HeaderField = std::pair<std::string, std::string>;
+            using HeaderFields = std::vector<HeaderField>;
+
+            // RFC 7541 Appendix B
+            inline const uint32_t* huffman_codes() {
+                static const uint32_t codes[256] = {
+                    0x1ff8, 0x7fffd8, 0xfffffe2, 0xfffffe3, 0xfffffe4, 0xfffffe5, 0xfffffe6, 0xfffffe7,
+                    0xfffffe8, 0xffffea, 0x3ffffffc, 0xfffffe9, 0xfffffea, 0x3ffffffd, 0xfffffeb, 0xfffffec,
+                    0xfffffed, 0xfffffee, 0xfffffef, 0xffffff0, 0xffffff1, 0xffffff2, 0x3ffffffe, 0xffffff3,
+                    0xffffff4, 0xffffff5, 0xffffff6, 0xffffff7, 0xffffff8, 0xffffff9, 0xffffffa, 0xffffffb,
+                    0x14, 0x3f8, 0x3f9, 0xffa, 0x1ff9, 0x15, 0xf8, 0x7fa,
+                    0x3fa, 0x3fb, 0xf9, 0x7fb, 0xfa, 0x16, 0x17, 0x18,
+                    0x0, 0x1, 0x2, 0x19, 0x1a, 0x1b, 0x1c, 0x1d,
+                    0x1e, 0x1f, 0x5c, 0xfb, 0x7ffc, 0x20, 0xffb, 0x3fc,
+                    0x1ffa, 0x21, 0x5d, 0x5e, 0x5f, 0x60, 0x61, 0x62,
+                    0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+                    0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72,
+                    0xfc, 0x73, 0xfd, 0x1ffb, 0x7fff0, 0x1ffc, 0x3ffc, 0x22,
+                    0x7ffd, 0x3, 0x23, 0x4, 0x24, 0x5, 0x25, 0x26,
+                    0x27, 0x6, 0x74, 0x75, 0x28, 0x29, 0x2a, 0x7,
+                    0x2b, 0x76, 0x2c, 0x8, 0x9, 0x2d, 0x77, 0x78,
+                    0x79, 0x7a, 0x7b, 0x7ffe, 0x7fc, 0x3ffd, 0x1ffd, 0xffffffc,
+                    0xfffe6, 0x3fffd2, 0xfffe7, 0xfffe8, 0x3fffd3, 0x3fffd4, 0x3fffd5, 0x7fffd9,
+                    0x3fffd6, 0x7fffda, 0x7fffdb, 0x7fffdc, 0x7fffdd, 0x7fffde, 0xffffeb, 0x7fffdf,
+                    0xffffec, 0xffffed, 0x3fffd7, 0x7fffe0, 0xffffee, 0x7fffe1, 0x7fffe2, 0x7fffe3,
+                    0x7fffe4, 0x1fffdc, 0x3fffd8, 0x7fffe5, 0x3fffd9, 0x7fffe6, 0x7fffe7, 0xffffef,
+                    0x3fffda, 0x1fffdd, 0xfffe9, 0x3fffdb, 0x3fffdc, 0x7fffe8, 0x7fffe9, 0x1fffde,
+                    0x7fffea, 0x3fffdd, 0x3fffde, 0xfffff0, 0x1fffdf, 0x3fffdf, 0x7fffeb, 0x7fffec,
+                    0x1fffe0, 0x1fffe1, 0x3fffe0, 0x1fffe2, 0x7fffed, 0x3fffe1, 0x7fffee, 0x7fffef,
+                    0xfffea, 0x3fffe2, 0x3fffe3, 0x3fffe4, 0x7ffff0, 0x3fffe5, 0x3fffe6, 0x7ffff1,
+                    0x3ffffe0, 0x3ffffe1, 0xfffeb, 0x7fff1, 0x3fffe7, 0x7ffff2, 0x3fffe8, 0x1ffffec,
+                    0x3ffffe2, 0x3ffffe3, 0x3ffffe4, 0x7ffffde, 0x7ffffdf, 0x3ffffe5, 0xfffff1, 0x1ffffed,
+                    0x7fff2, 0x1fffe3, 0x3ffffe6, 0x7ffffe0, 0x7ffffe1, 0x3ffffe7, 0x7ffffe2, 0xfffff2,
+                    0x1fffe4, 0x1fffe5, 0x3ffffe8, 0x3ffffe9, 0xffffffd, 0x7ffffe3, 0x7ffffe4, 0x7ffffe5,
+                    0xfffec, 0xfffff3, 0xfffed, 0x1fffe6, 0x3fffe9, 0x1fffe7, 0x1fffe8, 0x7ffff3,
+                    0x3fffea, 0x3fffeb, 0x1ffffee, 0x1ffffef, 0xfffff4, 0xfffff5, 0x3ffffea, 0x7ffff4,
+                    0x3ffffeb, 0x7ffffe6, 0x3ffffec, 0x3ffffed, 0x7ffffe7, 0x7ffffe8, 0x7ffffe9, 0x7ffffea,
+                    0x7ffffeb, 0xffffffe, 0x7ffffec, 0x7ffffed, 0x7ffffee, 0x7ffffef, 0x7fffff0, 0x3ffffee,
+                };
+                return codes;
+            }
+
+            inline const uint8_t* huffman_code_lengths() {
+                static const uint8_t lengths[256] = {
+                    13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28,
+                    28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+                    6, 10, 10, 12, 13, 6, 8, 11, 10, 10, 8, 11, 8, 6, 6, 6,
+                    5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 7, 8, 15, 6, 12, 10,
+                    13, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+                    7, 7, 7, 7, 7, 7, 7, 7, 8, 7, 8, 13, 19, 13, 14, 6,
+                    15, 5, 6, 5, 6, 5, 6, 6, 6, 5, 7, 7, 6, 6, 6, 5,
+                    6, 7, 6, 5, 5, 6, 7, 7, 7, 7, 7, 15, 11, 14, 13, 28,
+                    20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,
+                    24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24,
+                    22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22, 24, 21, 22, 23, 23,
+                    21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,
+                    26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25,
+                    19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27,
+                    20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,
+                    26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26,
+                };
+                return lengths;
+            }
+
+            // RFC 7541 Appendix A, index 1 is the first entry
+            const size_t hpack_static_table_size = 61;
+
+            inline const std::pair<const char*, const char*>* hpack_static_table() {
+                static const std::pair<const char*, const char*> entries[hpack_static_table_size] = {
+                    { ":authority", "" },
+                    { ":method", "GET" },
+                    { ":method", "POST" },
+                    { ":path", "/" },
+                    { ":path", "/index.html" },
+                    { ":scheme", "http" },
+                    { ":scheme", "https" },
+                    { ":status", "200" },
+                    { ":status", "204" },
+                    { ":status", "206" },
+                    { ":status", "304" },
+                    { ":status", "400" },
+                    { ":status", "404" },
+                    { ":status", "500" },
+                    { "accept-charset", "" },
+                    { "accept-encoding", "gzip, deflate" },
+                    { "accept-language", "" },
+                    { "accept-ranges", "" },
+                    { "accept", "" },
+                    { "access-control-allow-origin", "" },
+                    { "age", "" },
+                    { "allow", "" },
+                    { "authorization", "" },
+                    { "cache-control", "" },
+                    { "content-disposition", "" },
+                    { "content-encoding", "" },
+                    { "content-language", "" },
+                    { "content-length", "" },
+                    { "content-location", "" },
+                    { "content-range", "" },
+                    { "content-type", "" },
+                    { "cookie", "" },
+                    { "date", "" },
+                    { "etag", "" },
+                    { "expect", "" },
+                    { "expires", "" },
+                    { "from", "" },
+                    { "host", "" },
+                    { "if-match", "" },
+                    { "if-modified-since", "" },
+                    { "if-none-match", "" },
+                    { "if-range", "" },
+                    { "if-unmodified-since", "" },
+                    { "last-modified", "" },
+                    { "link", "" },
+                    { "location", "" },
+                    { "max-forwards", "" },
+                    { "proxy-authenticate", "" },
+                    { "proxy-authorization", "" },
+                    { "range", "" },
+                    { "referer", "" },
+                    { "refresh", "" },
+                    { "retry-after", "" },
+                    { "server", "" },
+                    { "set-cookie", "" },
+                    { "strict-transport-security", "" },
+                    { "transfer-encoding", "" },
+                    { "user-agent", "" },
+                    { "vary", "" },
+                    { "via", "" },
+                    { "www-authenticate", "" },
+                };
+                return entries;
+            }
+
+            // The HPACK code is canonical: codes of one length are consecutive and
+            // ordered by symbol, so a first-code/count table per length decodes it.
+            const uint32_t huffman_eos_code = 0x3fffffff;
+            const uint8_t huffman_eos_length = 30;
+            const uint16_t huffman_eos_symbol = 256;
+
+            struct huffman_decode_table {
+                uint32_t first_code[huffman_eos_length + 1];
+                uint16_t first_index[huffman_eos_length + 1];
+                uint16_t count[huffman_eos_length + 1];
+                uint16_t symbols[huffman_eos_symbol + 1];
+
+                huffman_decode_table() {
+                    uint16_t n = 0;
+                    for (uint8_t len = 0; len <= huffman_eos_length; len++) {
+                        first_code[len] = 0;
+                        first_index[len] = n;
+                        count[len] = 0;
+                        for (uint16_t sym = 0; sym <= huffman_eos_symbol; sym++) {
+                            auto sym_len = sym == huffman_eos_symbol ? huffman_eos_length : huffman_code_lengths()[sym];
+                            if (sym_len != len) { continue; }
+                            if (count[len] == 0) {
+                                first_code[len] = sym == huffman_eos_symbol ? huffman_eos_code : huffman_codes()[sym];
+                            }
+                            symbols[n++] = sym;
+                            count[len]++;
+                        }
+                    }
+                }
+            };
+
+            inline size_t huffman_encoded_length(const std::string& s) {
+                size_t bits = 0;
+                for (auto c : s) { bits += huffman_code_lengths()[static_cast<uint8_t>(c)]; }
+                return (bits + 7) / 8;
+            }
+
+            inline void huffman_encode(const std::string& s, std::string& out) {
+                uint64_t acc = 0;
+                size_t bits = 0;
+                for (auto c : s) {
+                    auto sym = static_cast<uint8_t>(c);
+                    acc = (acc << huffman_code_lengths()[sym]) | huffman_codes()[sym];
+                    bits += huffman_code_lengths()[sym];
+                    while (bits >= 8) {
+                        bits -= 8;
+                        out += static_cast<char>(acc >> bits);
+                    }
+                    acc &= (uint64_t(1) << bits) - 1;
+                }
+                // Pad with the most significant bits of EOS
+                if (bits) { out += static_cast<char>((acc << (8 - bits)) | (0xff >> bits)); }
+            }
+
+            inline bool huffman_decode(const uint8_t* p, size_t len, std::string& out) {
+                static const huffman_decode_table table;
+
+                uint32_t code = 0;
+                uint8_t bits = 0;
+                for (size_t i = 0; i < len; i++) {
+                    for (int b = 7; b >= 0; b--) {
+                        code = (code << 1) | ((p[i] >> b) & 1);
+                        if (++bits > huffman_eos_length) { return false; }
+                        if (code >= table.first_code[bits] &&
+                            code - table.first_code[bits] < table.count[bits]) {
+                            auto sym = table.symbols[table.first_index[bits] + code - table.first_code[bits]];
+                            if (sym == huffman_eos_symbol) { return false; }
+                            out += static_cast<char>(sym);
+                            code = 0;
+                            bits = 0;
+                        }
+                    }
+                }
+                // Padding is shorter than a byte and all ones
+                return bits < 8 && code == (1u << bits) - 1;
+            }
+
+            inline void hpack_encode_integer(std::string& out, uint8_t flags,
+                uint8_t prefix_bits, uint64_t value) {
+                const uint8_t max_prefix = static_cast<uint8_t>((1u << prefix_bits) - 1);
+                if (value < max_prefix) {
+                    out += static_cast<char>(flags | value);
+                    return;
+                }
+                out += static_cast<char>(flags | max_prefix);
+                value -= max_prefix;
+                while (value >= 0x80) {
+                    out += static_cast<char>((value & 0x7f) | 0x80);
+                    value >>= 7;
+                }
+                out += static_cast<char>(value);
+            }
+
+            inline bool hpack_decode_integer(const uint8_t*& p, const uint8_t* end,
+                uint8_t prefix_bits, uint64_t& value) {
+                if (p == end) { return false; }
+                const uint8_t max_prefix = static_cast<uint8_t>((1u << prefix_bits) - 1);
+                value = *p++ & max_prefix;
+                if (value < max_prefix) { return true; }
+                for (unsigned shift = 0; p != end && shift <= 28; shift += 7) {
+                    auto b = *p++;
+                    value += uint64_t(b & 0x7f) << shift;
+                    if (!(b & 0x80)) { return true; }
+                }
+                return false;
+            }
+
+            inline void hpack_encode_string(std::string& out, const std::string& s) {
+                auto huffman_length = huffman_encoded_length(s);
+                if (huffman_length < s.size()) {
+                    hpack_encode_integer(out, 0x80, 7, huffman_length);
+                    huffman_encode(s, out);
+                }
+                else {
+                    hpack_encode_integer(out, 0x00, 7, s.size());
+                    out += s;
+                }
+            }
+
+            inline bool hpack_decode_string(const uint8_t*& p, const uint8_t* end,
+                std::string& s) {
+                if (p == end) { return false; }
+                auto huffman = (*p & 0x80) != 0;
+                uint64_t len = 0;
+                if (!hpack_decode_integer(p, end, 7, len)) { return false; }
+                if (len > static_cast<uint64_t>(end - p)) { return false; }
+                s.clear();
+                if (huffman) {
+                    if (!huffman_decode(p, static_cast<size_t>(len), s)) { return false; }
+                }
+                else {
+                    s.assign(reinterpret_cast<const char*>(p), static_cast<size_t>(len));
+                }
+                p += len;
+                return true;
+            }
+
+            // Static table followed by the dynamic table, newest entry first
+            class hpack_table {
+            public:
+                size_t max_size() const { return max_size_; }
+
+                void set_max_size(size_t size) {
+                    max_size_ = size;
+                    evict(0);
+                }
+
+                void add(const std::string& name, const std::string& value) {
+                    auto entry_size = name.size() + value.size() + 32;
+                    evict(entry_size);
+                    if (entry_size <= max_size_) {
+                        entries_.emplace_front(name, value);
+                        size_ += entry_size;
+                    }
+                }
+
+                bool get(uint64_t index, HeaderField& field) const {
+                    if (index == 0) { return false; }
+                    if (index <= hpack_static_table_size) {
+                        const auto& entry = hpack_static_table()[index - 1];
+                        field.first = entry.first;
+                        field.second = entry.second;
+                        return true;
+                    }
+                    index -= hpack_static_table_size + 1;
+                    if (index >= entries_.size()) { return false; }
+                    field = entries_[static_cast<size_t>(index)];
+                    return true;
+                }
+
+                // Index of an exact match, else of the first name match (value_match false), else 0
+                size_t find(const std::string& name, const std::string& value,
+                    bool& value_match) const {
+                    size_t name_index = 0;
+                    value_match = false;
+                    for (size_t i = 0; i < hpack_static_table_size; i++) {
+                        const auto& entry = hpack_static_table()[i];
+                        if (name != entry.first) { continue; }
+                        if (value == entry.second) {
+                            value_match = true;
+                            return i + 1;
+                        }
+                        if (!name_index) { name_index = i + 1; }
+                    }
+                    for (size_t i = 0; i < entries_.size(); i++) {
+                        if (name != entries_[i].first) { continue; }
+                        if (value == entries_[i].second) {
+                            value_match = true;
+                            return hpack_static_table_size + 1 + i;
+                        }
+                        if (!name_index) { name_index = hpack_static_table_size + 1 + i; }
+                    }
+                    return name_index;
+                }
+
+            private:
+                void evict(size_t incoming) {
+                    while (!entries_.empty() && size_ + incoming > max_size_) {
+                        const auto& entry = entries_.back();
+                        size_ -= entry.first.size() + entry.second.size() + 32;
+                        entries_.pop_back();
+                    }
+                }
+
+                std::deque<HeaderField> entries_;
+                size_t size_ = 0;
+                size_t max_size_ = hpack_default_table_size;
+            };
+
+            class hpack_encoder {
+            public:
+                // Never grows past the default so the peer's decoder state stays small
+                void set_peer_table_size(size_t size) {
+                    auto new_size = (std::min)(size, hpack_default_table_size);
+                    if (new_size != table_.max_size()) {
+                        table_.set_max_size(new_size);
+                        size_update_pending_ = true;
+                    }
+                }
+
+                void encode(const HeaderFields& fields, std::string& out) {
+                    if (size_update_pending_) {
+                        hpack_encode_integer(out, 0x20, 5, table_.max_size());
+                        size_update_pending_ = false;
+                    }
+
+                    for (const auto& field : fields) {
+                        auto value_match = false;
+                        auto index = table_.find(field.first, field.second, value_match);
+                        if (index && value_match) {
+                            hpack_encode_integer(out, 0x80, 7, index);
+                            continue;
+                        }
+
+                        // Values that differ on every request would only churn the table
+                        auto indexing = field.first != ":path" &&
+                            field.first != "content-length" &&
+                            field.first != "content-range";
+
+                        hpack_encode_integer(out, indexing ? 0x40 : 0x00, indexing ? 6 : 4, index);
+                        if (!index) { hpack_encode_string(out, field.first); }
+                        hpack_encode_string(out, field.second);
+
+                        if (indexing) { table_.add(field.first, field.second); }
+                    }
+                }
+
+            private:
+                hpack_table table_;
+                bool size_update_pending_ = false;
+            };
+
+            class hpack_decoder {
+            public:
+                bool decode(const std::string& block, HeaderFields& fields) {
+                    auto p = reinterpret_cast<const uint8_t*>(block.data());
+                    auto end = p + block.size();
+
+                    while (p != end) {
+                        auto b = *p;
+                        uint64_t index = 0;
+
+                        if (b & 0x80) {
+                            // Indexed field
+                            HeaderField field;
+                            if (!hpack_decode_integer(p, end, 7, index) ||
+                                !table_.get(index, field)) {
+                                return false;
+                            }
+                            fields.push_back(std::move(field));
+                        }
+                        else if ((b & 0xe0) == 0x20) {
+                            // Dynamic table size update, bounded by our SETTINGS_HEADER_TABLE_SIZE
+                            uint64_t size = 0;
+                            if (!hpack_decode_integer(p, end, 5, size) ||
+                                size > hpack_default_table_size) {
+                                return false;
+                            }
+                            table_.set_max_size(static_cast<size_t>(size));
+                        }
+                        else {
+                            // Literal with incremental indexing, without indexing, or never indexed
+                            auto indexing = (b & 0xc0) == 0x40;
+                            if (!hpack_decode_integer(p, end, indexing ? 6 : 4, index)) {
+                                return false;
+                            }
+
+                            HeaderField field;
+                            if (index) {
+                                if (!table_.get(index, field)) { return false; }
+                            }
+                            else if (!hpack_decode_string(p, end, field.first)) {
+                                return false;
+                            }
+                            if (!hpack_decode_string(p, end, field.second)) { return false; }
+
+                            if (indexing) { table_.add(field.first, field.second); }
+                            fields.push_back(std::move(field));
+                        }
+                    }
+
+                    return true;
+                }
+
+            private:
+                hpack_table table_;
+            };
+
+            inline uint32_t read_uint32(const char* p) {
+                auto u = reinterpret_cast<const uint8_t*>(p);
+                return (uint32_t(u[0]) << 24) | (uint32_t(u[1]) << 16) |
+                    (uint32_t(u[2]) << 8) | uint32_t(u[3]);
+            }
+
+            inline void write_uint32(char* p, uint32_t value) {
+                p[0] = static_cast<char>(value >> 24);
+                p[1] = static_cast<char>(value >> 16);
+                p[2] = static_cast<char>(value >> 8);
+                p[3] = static_cast<char>(value);
+            }
+
+            inline bool read_exact(Stream& strm, char* buf, size_t len) {
+                size_t offset = 0;
+                while (offset < len) {
+                    auto n = strm.read(buf + offset, len - offset);
+                    if (n <= 0) { return false; }
+                    offset += static_cast<size_t>(n);
+                }
+                return true;
+            }
+
+        } // namespace http2
+
+        /*
+         * One HTTP/2 connection. run() multiplexes a batch of requests as concurrent
+         * streams (bounded by the peer's SETTINGS_MAX_CONCURRENT_STREAMS) and keeps
+         * the HPACK and flow-control state for the next batch on the same socket.
+         */
+        class Http2Session {
+        public:
+            // What became of each request handed to run()
+            enum class Outcome { Pending, Completed, Failed, Retryable };
+
+            // False once the connection failed or the peer sent GOAWAY
+            bool is_usable() const {
+                return !broken_ && !goaway_received_ && next_stream_id_ < http2::max_stream_id;
+            }
+
+            bool run(Stream& strm, const std::vector<const Request*>& requests,
+                const std::vector<http2::HeaderFields>& fields,
+                const std::vector<Response*>& responses, bool decompress,
+                const std::vector<std::shared_ptr<RateLimiter>>& rate_limiters,
+                std::vector<Outcome>& outcomes, Error& error) {
+                requests_ = &requests;
+                rate_limiters_ = &rate_limiters;
+                fields_ = &fields;
+                responses_ = &responses;
+                outcomes_ = &outcomes;
+                error_ = &error;
+                decompress_ = decompress;
+
+                outcomes.assign(requests.size(), Outcome::Pending);
+
+                auto ok = !broken_;
+                if (ok && !started_) {
+                    ok = start(strm);
+                    started_ = true;
+                }
+
+                size_t next = 0;
+                while (ok) {
+                    while (ok && next < requests.size() && is_usable() &&
+                        streams_.size() < peer_max_concurrent_streams_) {
+                        ok = open_stream(strm, next++);
+                    }
+                    if (!ok || streams_.empty()) { break; }
+                    ok = read_frame(strm);
+                }
+
+                if (!ok) {
+                    broken_ = true;
+                    if (error == Error::Success) { error = Error::Read; }
+                }
+
+                // Streams cut off before the response started are safe to replay if idempotent
+                for (const auto& x : streams_) {
+                    const auto& s = x.second;
+                    outcomes[s.index] = !s.headers_done && is_pipelinable(*requests[s.index]) ?
+                        Outcome::Retryable : Outcome::Failed;
+                }
+                streams_.clear();
+
+                for (; next < requests.size(); next++) {
+                    if (outcomes[next] == Outcome::Pending) { outcomes[next] = Outcome::Retryable; }
+                }
+
+                requests_ = nullptr;
+                fields_ = nullptr;
+                responses_ = nullptr;
+                outcomes_ = nullptr;
+                error_ = nullptr;
+
+                return ok;
+            }
+
+        private:
+            struct StreamState {
+                size_t index = 0;
+                int64_t send_window = 0;
+                uint32_t recv_unacked = 0;
+                bool headers_done = false;
+                uint64_t received = 0;
+                uint64_t content_length = 0;
+                std::shared_ptr<detail::decompressor> decompressor;
+                // DATA frames are copied into the spans of Request::content_span_receiver
+                detail::SpanWriter spans;
+            };
+
+            bool start(Stream& strm) {
+                if (!write_data(strm, http2::connection_preface,
+                    sizeof(http2::connection_preface) - 1)) {
+                    return false;
+                }
+
+                char settings[3 * 6];
+                auto p = settings;
+                auto put = [&](uint16_t id, uint32_t value) {
+                    p[0] = static_cast<char>(id >> 8);
+                    p[1] = static_cast<char>(id);
+                    http2::write_uint32(p + 2, value);
+                    p += 6;
+                };
+                put(http2::SettingEnablePush, 0);
+                put(http2::SettingInitialWindowSize, CPPHTTPLIB_HTTP2_STREAM_WINDOW_SIZE);
+                put(http2::SettingMaxFrameSize, CPPHTTPLIB_HTTP2_MAX_FRAME_SIZE);
+
+                if (!write_frame(strm, http2::FrameType::Settings, 0, 0, settings, sizeof(settings))) {
+                    return false;
+                }
+
+                // The connection window can only be raised with WINDOW_UPDATE
+                return CPPHTTPLIB_HTTP2_CONNECTION_WINDOW_SIZE <= http2::default_window_size ||
+                    write_window_update(strm, 0,
+                        CPPHTTPLIB_HTTP2_CONNECTION_WINDOW_SIZE - http2::default_window_size);
+            }
+
+            bool write_frame(Stream& strm, http2::FrameType type, uint8_t flags,
+                uint32_t stream_id, const char* payload, size_t len) {
+                frame_buf_.resize(http2::frame_header_size + len);
+                auto p = &frame_buf_[0];
+                p[0] = static_cast<char>(len >> 16);
+                p[1] = static_cast<char>(len >> 8);
+                p[2] = static_cast<char>(len);
+                p[3] = static_cast<char>(type);
+                p[4] = static_cast<char>(flags);
+                http2::write_uint32(p + 5, stream_id);
+                if (len) { memcpy(p + http2::frame_header_size, payload, len); }
+                return write_data(strm, frame_buf_.data(), frame_buf_.size());
+            }
+
+            bool write_window_update(Stream& strm, uint32_t stream_id, uint32_t increment) {
+                char payload[4];
+                http2::write_uint32(payload, increment);
+                return write_frame(strm, http2::FrameType::WindowUpdate, 0, stream_id, payload, 4);
+            }
+
+            bool write_rst_stream(Stream& strm, uint32_t stream_id, http2::ErrorCode code) {
+                char payload[4];
+                http2::write_uint32(payload, static_cast<uint32_t>(code));
+                return write_frame(strm, http2::FrameType::RstStream, 0, stream_id, payload, 4);
+            }
+
+            // Sends GOAWAY and gives up on the connection; always returns false
+            bool connection_error(Stream& strm, http2::ErrorCode code) {
+                char payload[8];
+                http2::write_uint32(payload, 0);
+                http2::write_uint32(payload + 4, static_cast<uint32_t>(code));
+                write_frame(strm, http2::FrameType::GoAway, 0, 0, payload, 8);
+                broken_ = true;
+                return false;
+            }
+
+            void finish_stream(uint32_t stream_id, Outcome outcome) {
+                auto it = streams_.find(stream_id);
+                if (it == streams_.end()) { return; }
+                (*outcomes_)[it->second.index] = outcome;
+                if (outcome == Outcome::Completed) {
+                    (*responses_)[it->second.index]->timings.end = timing_now();
+                }
+                streams_.erase(it);
+            }
+
+            // Resets a stream we no longer want; the connection stays usable
+            bool cancel_stream(Stream& strm, uint32_t stream_id, http2::ErrorCode code, Error error) {
+                if (*error_ == Error::Success) { *error_ = error; }
+                finish_stream(stream_id, Outcome::Failed);
+                return write_rst_stream(strm, stream_id, code);
+            }
+
+            bool open_stream(Stream& strm, size_t index) {
+                const auto& req = *(*requests_)[index];
+
+                auto stream_id = next_stream_id_;
+                next_stream_id_ += 2;
+
+                std::string block;
+                encoder_.encode((*fields_)[index], block);
+
+                StreamState s;
+                s.index = index;
+                s.send_window = peer_initial_window_;
+                streams_.emplace(stream_id, std::move(s));
+
+                auto has_body = !req.body.empty() || req.content_provider || req.content_file.fd >= 0;
+
+                size_t offset = 0;
+                auto first = true;
+                do {
+                    auto n = (std::min)(block.size() - offset, static_cast<size_t>(peer_max_frame_size_));
+                    uint8_t flags = 0;
+                    if (offset + n == block.size()) { flags |= http2::FlagEndHeaders; }
+                    if (first && !has_body) { flags |= http2::FlagEndStream; }
+                    if (!write_frame(strm, first ? http2::FrameType::Headers : http2::FrameType::Continuation,
+                        flags, stream_id, block.data() + offset, n)) {
+                        *error_ = Error::Write;
+                        return false;
+                    }
+                    offset += n;
+                    first = false;
+                } while (offset < block.size());
+
+                auto& timings = (*responses_)[index]->timings;
+                timings.headers_sent = timing_now();
+                if (!has_body) {
+                    timings.request_sent = timings.headers_sent;
+                    return true;
+                }
+
+                // DATA frames are copies anyway, the file is read into pooled buffers
+                if (req.content_file.fd >= 0) {
+                    const auto& file = req.content_file;
+                    BufferPool::Lease buf;
+                    uint64_t written = 0;
+                    do {
+                        auto n = read_file_at(file.fd, buf.data(),
+                            static_cast<size_t>((std::min)(static_cast<uint64_t>(buf.size()), file.length - written)),
+                            file.offset + written);
+                        if (n < 0 || (n == 0 && written < file.length)) {
+                            return cancel_stream(strm, stream_id, http2::ErrorCode::Cancel, Error::Write);
+                        }
+                        if (file.observer) { file.observer(written, buf.data(), static_cast<size_t>(n)); }
+                        written += static_cast<uint64_t>(n);
+                        if (!write_body(strm, stream_id, buf.data(), static_cast<size_t>(n), written == file.length)) {
+                            return false;
+                        }
+                        if (!streams_.count(stream_id)) { return true; }
+                    } while (written < file.length);
+                    return true;
+                }
+
+                // Same order as write_request(): provider content, then body
+                if (req.content_provider) {
+                    auto ok = true;
+                    size_t written = 0;
+
+                    DataSink data_sink;
+                    data_sink.write = [&](const char* d, size_t l) {
+                        if (ok && streams_.count(stream_id)) {
+                            ok = write_body(strm, stream_id, d, l, false);
+                            written += l;
+                        }
+                    };
+                    data_sink.done = [&](void) {};
+                    data_sink.is_writable = [&](void) { return ok && streams_.count(stream_id) > 0; };
+
+                    do {
+                        auto length = req.content_length > 0 ? req.content_length - written : size_t(-1);
+                        if (!req.content_provider(written, length, data_sink)) {
+                            return cancel_stream(strm, stream_id, http2::ErrorCode::Cancel, Error::Canceled);
+                        }
+                        if (!ok) {
+                            *error_ = Error::Write;
+                            return false;
+                        }
+                        if (!streams_.count(stream_id)) { return true; }
+                    } while (req.content_length > 0 && written < req.content_length);
+                }
+
+                return write_body(strm, stream_id, req.body.data(), req.body.size(), true);
+            }
+
+            // Sends DATA frames within both send windows, reading frames while blocked
+            bool write_body(Stream& strm, uint32_t stream_id, const char* d, size_t l,
+                bool end_stream) {
+                while (true) {
+                    auto it = streams_.find(stream_id);
+                    if (it == streams_.end()) { return true; }
+                    auto& s = it->second;
+
+                    if (l == 0 && !end_stream) { return true; }
+
+                    auto window = (std::min)(conn_send_window_, s.send_window);
+                    if (l > 0 && window <= 0) {
+                        if (!read_frame(strm)) { return false; }
+                        continue;
+                    }
+
+                    auto n = (std::min)(l, static_cast<size_t>(peer_max_frame_size_));
+                    if (l > 0) { n = (std::min)(n, static_cast<size_t>(window)); }
+                    auto last = end_stream && n == l;
+
+                    if (n > 0) {
+                        const auto& req = *(*requests_)[s.index];
+                        if (detail::is_upload_rate_limited(*rate_limiters_, req)) {
+                            n = (std::min)(n, CPPHTTPLIB_RECV_BUFSIZ);
+                            last = end_stream && n == l;
+                            detail::throttle_upload(*rate_limiters_, req, n);
+                        }
+                    }
+
+                    if (!write_frame(strm, http2::FrameType::Data, last ? http2::FlagEndStream : 0,
+                        stream_id, d, n)) {
+                        *error_ = Error::Write;
+                        return false;
+                    }
+
+                    conn_send_window_ -= n;
+                    s.send_window -= n;
+                    d += n;
+                    l -= n;
+
+                    if (last) { (*responses_)[s.index]->timings.request_sent = timing_now(); }
+
+                    if (l == 0) { return true; }
+                }
+            }
+
+            bool read_frame(Stream& strm) {
+                char header[http2::frame_header_size];
+                if (!http2::read_exact(strm, header, sizeof(header))) { return false; }
+
+                auto u = reinterpret_cast<const uint8_t*>(header);
+                auto len = (uint32_t(u[0]) << 16) | (uint32_t(u[1]) << 8) | uint32_t(u[2]);
+                auto type = static_cast<http2::FrameType>(u[3]);
+                auto flags = u[4];
+                auto stream_id = http2::read_uint32(header + 5) & http2::max_stream_id;
+
+                if (len > CPPHTTPLIB_HTTP2_MAX_FRAME_SIZE) {
+                    return connection_error(strm, http2::ErrorCode::FrameSizeError);
+                }
+
+                payload_.resize(len);
+                if (len && !http2::read_exact(strm, &payload_[0], len)) { return false; }
+
+                // A header block must not be interleaved with any other frame
+                if (continuation_stream_ &&
+                    (type != http2::FrameType::Continuation || stream_id != continuation_stream_)) {
+                    return connection_error(strm, http2::ErrorCode::ProtocolError);
+                }
+
+                switch (type) {
+                case http2::FrameType::Data: return on_data(strm, flags, stream_id);
+                case http2::FrameType::Headers: return on_headers(strm, flags, stream_id);
+                case http2::FrameType::Continuation: return on_continuation(strm, flags, stream_id);
+                case http2::FrameType::RstStream: return on_rst_stream(strm, stream_id);
+                case http2::FrameType::Settings: return on_settings(strm, flags, stream_id);
+                case http2::FrameType::Ping: return on_ping(strm, flags, stream_id);
+                case http2::FrameType::GoAway: return on_goaway(strm, stream_id);
+                case http2::FrameType::WindowUpdate: return on_window_update(strm, stream_id);
+                case http2::FrameType::PushPromise:
+                    // SETTINGS_ENABLE_PUSH is 0
+                    return connection_error(strm, http2::ErrorCode::ProtocolError);
+                default:
+                    // PRIORITY and unknown frame types are ignored
+                    return true;
+                }
+            }
+
+            bool strip_padding(uint8_t flags, const char*& data, size_t& len) {
+                if (!(flags & http2::FlagPadded)) { return true; }
+                if (len < 1) { return false; }
+                auto pad = static_cast<uint8_t>(data[0]);
+                data++;
+                len--;
+                if (pad > len) { return false; }
+                len -= pad;
+                return true;
+            }
+
+            bool on_data(Stream& strm, uint8_t flags, uint32_t stream_id) {
+                auto frame_len = static_cast<uint32_t>(payload_.size());
+
+                // Flow control counts the whole frame, padding included
+                conn_recv_unacked_ += frame_len;
+                if (conn_recv_unacked_ >= CPPHTTPLIB_HTTP2_CONNECTION_WINDOW_SIZE / 2) {
+                    if (!write_window_update(strm, 0, conn_recv_unacked_)) { return false; }
+                    conn_recv_unacked_ = 0;
+                }
+
+                if (!stream_id) { return connection_error(strm, http2::ErrorCode::ProtocolError); }
+
+                auto it = streams_.find(stream_id);
+                if (it == streams_.end()) { return true; }
+                auto& s = it->second;
+
+                if (!s.headers_done) {
+                    return cancel_stream(strm, stream_id, http2::ErrorCode::ProtocolError, Error::Read);
+                }
+
+                const char* data = payload_.data();
+                size_t len = payload_.size();
+                if (!strip_padding(flags, data, len)) {
+                    return connection_error(strm, http2::ErrorCode::ProtocolError);
+                }
+
+                const auto& req = *(*requests_)[s.index];
+                auto& res = *(*responses_)[s.index];
+
+                if (len) {
+                    // Every stream shares this connection, so a per-request limit also
+                    // holds back the other streams while this one is being paced
+                    detail::throttle_download(*rate_limiters_, req, len);
+
+                    auto canceled = false;
+                    ContentReceiver out = [&](const char* buf, size_t n) {
+                        if (req.content_span_receiver) {
+                            if (!s.spans.write(buf, n)) {
+                                canceled = true;
+                                return false;
+                            }
+                            return true;
+                        }
+                        if (req.content_receiver) {
+                            if (!req.content_receiver(buf, n)) {
+                                canceled = true;
+                                return false;
+                            }
+                            return true;
+                        }
+                        if (res.body.size() + n > res.body.max_size()) { return false; }
+                        res.body.append(buf, n);
+                        return true;
+                    };
+
+                    auto ret = s.decompressor ? s.decompressor->decompress(data, len, out) : out(data, len);
+                    if (!ret) {
+                        return cancel_stream(strm, stream_id, http2::ErrorCode::Cancel,
+                            canceled ? Error::Canceled : Error::Read);
+                    }
+
+                    s.received += len;
+                    if (!req.content_span_receiver && req.progress && !req.progress(s.received, s.content_length)) {
+                        return cancel_stream(strm, stream_id, http2::ErrorCode::Cancel, Error::Canceled);
+                    }
+                }
+
+                if (flags & http2::FlagEndStream) {
+                    finish_stream(stream_id, Outcome::Completed);
+                    return true;
+                }
+
+                s.recv_unacked += frame_len;
+                if (s.recv_unacked >= CPPHTTPLIB_HTTP2_STREAM_WINDOW_SIZE / 2) {
+                    if (!write_window_update(strm, stream_id, s.recv_unacked)) { return false; }
+                    s.recv_unacked = 0;
+                }
+
+                return true;
+            }
+
+            bool on_headers(Stream& strm, uint8_t flags, uint32_t stream_id) {
+                if (!stream_id) { return connection_error(strm, http2::ErrorCode::ProtocolError); }
+
+                const char* data = payload_.data();
+                size_t len = payload_.size();
+                if (!strip_padding(flags, data, len)) {
+                    return connection_error(strm, http2::ErrorCode::ProtocolError);
+                }
+                if (flags & http2::FlagPriority) {
+                    if (len < 5) { return connection_error(strm, http2::ErrorCode::ProtocolError); }
+                    data += 5;
+                    len -= 5;
+                }
+
+                header_block_.assign(data, len);
+                header_block_end_stream_ = (flags & http2::FlagEndStream) != 0;
+
+                if (!(flags & http2::FlagEndHeaders)) {
+                    continuation_stream_ = stream_id;
+                    return true;
+                }
+                return on_header_block(strm, stream_id);
+            }
+
+            bool on_continuation(Stream& strm, uint8_t flags, uint32_t stream_id) {
+                if (!continuation_stream_) {
+                    return connection_error(strm, http2::ErrorCode::ProtocolError);
+                }
+
+                header_block_.append(payload_);
+                if (header_block_.size() > http2::max_header_block_size) {
+                    return connection_error(strm, http2::ErrorCode::ProtocolError);
+                }
+
+                if (!(flags & http2::FlagEndHeaders)) { return true; }
+                continuation_stream_ = 0;
+                return on_header_block(strm, stream_id);
+            }
+
+            bool on_header_block(Stream& strm, uint32_t stream_id) {
+                // Decode even for streams we dropped, the HPACK state is per connection
+                http2::HeaderFields fields;
+                if (!decoder_.decode(header_block_, fields)) {
+                    return connection_error(strm, http2::ErrorCode::CompressionError);
+                }
+                header_block_.clear();
+
+                auto it = streams_.find(stream_id);
+                if (it == streams_.end()) { return true; }
+                auto& s = it->second;
+
+                const auto& req = *(*requests_)[s.index];
+                auto& res = *(*responses_)[s.index];
+
+                if (s.headers_done) {
+                    // Trailers
+                    for (auto& field : fields) {
+                        if (!field.first.empty() && field.first[0] != ':') {
+                            res.headers.emplace(std::move(field.first), std::move(field.second));
+                        }
+                    }
+                }
+                else {
+                    auto status = -1;
+                    Headers headers;
+                    for (auto& field : fields) {
+                        if (field.first == ":status") {
+                            status = std::atoi(field.second.c_str());
+                        }
+                        else if (!field.first.empty() && field.first[0] != ':') {
+                            headers.emplace(std::move(field.first), std::move(field.second));
+                        }
+                    }
+
+                    if (status < 100) {
+                        return cancel_stream(strm, stream_id, http2::ErrorCode::ProtocolError, Error::Read);
+                    }
+
+                    if (!res.timings.first_byte) { res.timings.first_byte = timing_now(); }
+
+                    // Interim response, the final one follows on the same stream
+                    if (status < 200) { return true; }
+
+                    res.version = "HTTP/2";
+                    res.status = status;
+                    res.reason = status_message(status);
+                    res.headers = std::move(headers);
+                    s.headers_done = true;
+
+                    if (req.response_handler && !req.response_handler(res)) {
+                        return cancel_stream(strm, stream_id, http2::ErrorCode::Cancel, Error::Canceled);
+                    }
+
+                    if (res.has_header("Content-Length")) {
+                        s.content_length = std::strtoull(res.get_header_value("Content-Length").c_str(), nullptr, 10);
+                    }
+
+                    if (decompress_) {
+                        auto encoding = res.get_header_value("Content-Encoding");
+                        auto gzip = encoding.find("gzip") != std::string::npos ||
+                            encoding.find("deflate") != std::string::npos;
+                        auto brotli = !gzip && encoding.find("br") != std::string::npos;
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+                        if (gzip) { s.decompressor = std::make_shared<gzip_decompressor>(); }
+#endif
+#ifdef CPPHTTPLIB_BROTLI_SUPPORT
+                        if (brotli) { s.decompressor = std::make_shared<brotli_decompressor>(); }
+#endif
+                        if ((gzip || brotli) && (!s.decompressor || !s.decompressor->is_valid())) {
+                            return cancel_stream(strm, stream_id, http2::ErrorCode::Cancel, Error::Read);
+                        }
+                    }
+
+                    if (req.content_span_receiver) {
+                        s.spans.reset(&req.content_span_receiver, &req.progress,
+                            s.decompressor ? 0 : s.content_length);
+                    }
+                }
+
+                if (header_block_end_stream_) { finish_stream(stream_id, Outcome::Completed); }
+                return true;
+            }
+
+            bool on_rst_stream(Stream& strm, uint32_t stream_id) {
+                if (!stream_id || payload_.size() != 4) {
+                    return connection_error(strm, http2::ErrorCode::ProtocolError);
+                }
+
+                auto it = streams_.find(stream_id);
+                if (it == streams_.end()) { return true; }
+
+                // REFUSED_STREAM guarantees the server did not process the request
+                auto code = static_cast<http2::ErrorCode>(http2::read_uint32(payload_.data()));
+                if (code == http2::ErrorCode::RefusedStream && !it->second.headers_done) {
+                    finish_stream(stream_id, Outcome::Retryable);
+                }
+                else {
+                    if (*error_ == Error::Success) { *error_ = Error::Read; }
+                    finish_stream(stream_id, Outcome::Failed);
+                }
+                return true;
+            }
+
+            bool on_settings(Stream& strm, uint8_t flags, uint32_t stream_id) {
+                if (stream_id) { return connection_error(strm, http2::ErrorCode::ProtocolError); }
+                if (flags & http2::FlagAck) { return true; }
+                if (payload_.size() % 6) {
+                    return connection_error(strm, http2::ErrorCode::FrameSizeError);
+                }
+
+                for (size_t i = 0; i < payload_.size(); i += 6) {
+                    auto u = reinterpret_cast<const uint8_t*>(payload_.data() + i);
+                    auto id = static_cast<uint16_t>((u[0] << 8) | u[1]);
+                    auto value = http2::read_uint32(payload_.data() + i + 2);
+
+                    switch (id) {
+                    case http2::SettingHeaderTableSize:
+                        encoder_.set_peer_table_size(value);
+                        break;
+                    case http2::SettingMaxConcurrentStreams:
+                        peer_max_concurrent_streams_ = value;
+                        break;
+                    case http2::SettingInitialWindowSize: {
+                        if (value > http2::max_window_size) {
+                            return connection_error(strm, http2::ErrorCode::FlowControlError);
+                        }
+                        // Applies retroactively to every open stream
+                        auto delta = static_cast<int64_t>(value) - peer_initial_window_;
+                        for (auto& x : streams_) { x.second.send_window += delta; }
+                        peer_initial_window_ = value;
+                        break;
+                    }
+                    case http2::SettingMaxFrameSize:
+                        if (value < http2::default_max_frame_size || value > http2::max_frame_size_limit) {
+                            return connection_error(strm, http2::ErrorCode::ProtocolError);
+                        }
+                        peer_max_frame_size_ = value;
+                        break;
+                    default:
+                        break;
+                    }
+                }
+
+                return write_frame(strm, http2::FrameType::Settings, http2::FlagAck, 0, nullptr, 0);
+            }
+
+            bool on_ping(Stream& strm, uint8_t flags, uint32_t stream_id) {
+                if (stream_id) { return connection_error(strm, http2::ErrorCode::ProtocolError); }
+                if (payload_.size() != 8) {
+                    return connection_error(strm, http2::ErrorCode::FrameSizeError);
+                }
+                if (flags & http2::FlagAck) { return true; }
+                return write_frame(strm, http2::FrameType::Ping, http2::FlagAck, 0,
+                    payload_.data(), payload_.size());
+            }
+
+            bool on_goaway(Stream& strm, uint32_t stream_id) {
+                if (stream_id || payload_.size() < 8) {
+                    return connection_error(strm, http2::ErrorCode::ProtocolError);
+                }
+
+                goaway_received_ = true;
+
+                // Streams above last_stream_id were never processed and can be replayed
+                auto last_stream_id = http2::read_uint32(payload_.data()) & http2::max_stream_id;
+                for (auto it = streams_.begin(); it != streams_.end();) {
+                    if (it->first > last_stream_id) {
+                        (*outcomes_)[it->second.index] = Outcome::Retryable;
+                        it = streams_.erase(it);
+                    }
+                    else {
+                        ++it;
+                    }
+                }
+                return true;
+            }
+
+            bool on_window_update(Stream& strm, uint32_t stream_id) {
+                if (payload_.size() != 4) {
+                    return connection_error(strm, http2::ErrorCode::FrameSizeError);
+                }
+
+                auto increment = http2::read_uint32(payload_.data()) & http2::max_window_size;
+
+                if (!stream_id) {
+                    if (!increment) { return connection_error(strm, http2::ErrorCode::ProtocolError); }
+                    conn_send_window_ += increment;
+                    if (conn_send_window_ > http2::max_window_size) {
+                        return connection_error(strm, http2::ErrorCode::FlowControlError);
+                    }
+                    return true;
+                }
+
+                auto it = streams_.find(stream_id);
+                if (it == streams_.end()) { return true; }
+
+                if (!increment) {
+                    return cancel_stream(strm, stream_id, http2::ErrorCode::ProtocolError, Error::Read);
+                }
+                it->second.send_window += increment;
+                if (it->second.send_window > http2::max_window_size) {
+                    return cancel_stream(strm, stream_id, http2::ErrorCode::FlowControlError, Error::Read);
+                }
+                return true;
+            }
+
+            // Connection state
+            bool started_ = false;
+            bool broken_ = false;
+            bool goaway_received_ = false;
+            uint32_t next_stream_id_ = 1;
+
+            http2::hpack_encoder encoder_;
+            http2::hpack_decoder decoder_;
+
+            // Peer settings
+            uint32_t peer_max_concurrent_streams_ = 100;
+            int64_t peer_initial_window_ = http2::default_window_size;
+            uint32_t peer_max_frame_size_ = http2::default_max_frame_size;
+
+            // Flow control
+            int64_t conn_send_window_ = http2::default_window_size;
+            uint32_t conn_recv_unacked_ = 0;
+
+            std::map<uint32_t, StreamState> streams_;
+
+            // Header block spread over HEADERS + CONTINUATION
+            uint32_t continuation_stream_ = 0;
+            std::string header_block_;
+            bool header_block_end_stream_ = false;
+
+            std::string payload_;
+            std::string frame_buf_;
+
+            // The batch being processed by run()
+            const std::vector<const Request*>* requests_ = nullptr;
+            const std::vector<http2::HeaderFields>* fields_ = nullptr;
+            const std::vector<Response*>* responses_ = nullptr;
+            std::vector<Outcome>* outcomes_ = nullptr;
+            Error* error_ = nullptr;
+            bool decompress_ = true;
+            const std::vector<std::shared_ptr<RateLimiter>>* rate_limiters_ = nullptr;
+        };
+
+    } // namespace detail
+
+    // HTTP client implementation
+    inline ClientImpl::ClientImpl(const std::string& host)
+        : ClientImpl(host, 80, std::string(), std::string()) {}
+
+    inline ClientImpl::ClientImpl(const std::string& host, int port)
+        : ClientImpl(host, port, std::string(), std::string()) {}
+
+    inline ClientImpl::ClientImpl(const std::string& host, int port,
+        const std::string& client_cert_path,
+        const std::string& client_key_path)
+        : host_(host), port_(port),
+        host_and_port_(host_ + ":" + std::to_string(port_)),
+        client_cert_path_(client_cert_path), client_key_path_(client_key_path) {}
+
+    inline ClientImpl::~ClientImpl() { stop_core(); }
+
+    inline bool ClientImpl::is_valid() const { return true; }
+
+    inline Error ClientImpl::get_last_error() const { return error_; }
+
+    inline socket_t ClientImpl::create_client_socket(RequestTimings* timings) const {
+        if (!proxy_host_.empty() && proxy_port_ != -1) {
+            return detail::create_client_socket(
+                proxy_host_.c_str(), proxy_port_, tcp_nodelay_, socket_options_,
+                connection_timeout_sec_, connection_timeout_usec_, interface_, error_,
+                timings);
+        }
+        return detail::create_client_socket(
+            host_.c_str(), port_, tcp_nodelay_, socket_options_,
+            connection_timeout_sec_, connection_timeout_usec_, interface_, error_,
+            timings);
+    }
+
+    inline bool ClientImpl::create_and_connect_socket(Socket& socket,
+        RequestTimings* timings) {
+        auto sock = create_client_socket(timings);
+        if (sock == INVALID_SOCKET) { return false; }
+        socket.sock = sock;
+        // h2c with prior knowledge; a plain HTTP proxy would not understand the preface
+        socket.is_http2 = http2_prior_knowledge_ && !is_ssl() && proxy_host_.empty();
+        return true;
+    }
+
+    inline void ClientImpl::close_socket(Socket& socket,
+        bool /*process_socket_ret*/) {
+        detail::close_socket(socket.sock);
+        socket_.sock = INVALID_SOCKET;
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+        socket_.ssl = nullptr;
+#endif
+        socket_.is_http2 = false;
+        http2_session_.reset();
+    }
+
+    inline bool ClientImpl::read_response_line(Stream& strm, Response& res) {
+        std::array<char, 2048> buf;
+
+        detail::stream_line_reader line_reader(strm, buf.data(), buf.size());
+
+        if (!line_reader.getline()) { return false; }
+
+        // "HTTP/1.[01] <status> <reason>\r\n", parsed in place: std::regex_match() allocates its state
+        // on every call. A line that doesn't match leaves the response as it is
+        const char* beg = line_reader.ptr();
+        const char* end = beg + line_reader.size();
+        if (end - beg < 2 || end[-2] != '\r' || end[-1] != '\n') { return true; }
+        end -= 2;
+
+        if (end - beg < 9 || strncmp(beg, "HTTP/1.", 7) != 0 ||
+            (beg[7] != '0' && beg[7] != '1') || beg[8] != ' ') {
+            return true;
+        }
+
+        const char* status_beg = beg + 9;
+        const char* p = status_beg;
+        while (p < end && isdigit(static_cast<unsigned char>(*p))) { p++; }
+        if (p == status_beg || p == end || *p != ' ') { return true; }
+
+        res.version.assign(beg, 8);
+        res.status = atoi(status_beg);
+        res.reason.assign(p + 1, end);
+
+        return true;
+    }
+
+    // Reuses the current connection if it is still alive, otherwise connects (and handshakes).
+    // On false, `success` holds what send() should report (a proxy may have answered instead).
+    inline bool ClientImpl::open_socket_if_needed(Response& res, bool& success) {
+        std::lock_guard<std::mutex> guard(socket_mutex_);
+
+        success = false;
+
+        auto is_alive = false;
+        if (socket_.is_open()) {
+            is_alive = detail::select_write(socket_.sock, 0, 0) > 0 &&
+                (socket_.is_http2 || !is_idle_socket_closed());
+            if (!is_alive) { close_socket(socket_, false); }
+        }
+
+        // send() hands HTTP/2 on to send_http2(), which comes back here for the same response
+        res.timings.reused_connection = is_alive && !res.timings.connect_end;
+
+        if (!is_alive) {
+            if (!create_and_connect_socket(socket_, &res.timings)) { return false; }
+
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+            // TODO: refactoring
+            if (is_ssl()) {
+                auto& scli = static_cast<SSLClient&>(*this);
+                if (!proxy_host_.empty() && proxy_port_ != -1) {
+                    if (!scli.connect_with_proxy(socket_, res, success)) {
+                        return false;
+                    }
+                }
+
+                if (!scli.initialize_ssl(socket_)) {
+                    success = false;
+                    return false;
+                }
+                res.timings.tls_end = detail::timing_now();
+            }
+#else
+            (void)res;
+#endif
+        }
+
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+        res.timings.kernel_tls_send = socket_.is_kernel_tls_send;
+        res.timings.kernel_tls_recv = socket_.is_kernel_tls_recv;
+#endif
+        return true;
+    }
+
+    // Between HTTP/1.1 requests a server sends nothing but its close, the request would fail on that.
+    // HTTP/2 servers send frames any time and are not asked
+    inline bool ClientImpl::is_idle_socket_closed() const {
+        if (detail::select_read(socket_.sock, 0, 0) <= 0) { return false; }
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+        // TLS 1.3 session tickets arrive after the handshake, a connection opened without a request has them unread
+        if (socket_.ssl) {
+            char c;
+            detail::set_nonblocking(socket_.sock, true);
+            auto n = SSL_peek(socket_.ssl, &c, 1);
+            auto err = n > 0 ? SSL_ERROR_NONE : SSL_get_error(socket_.ssl, n);
+            detail::set_nonblocking(socket_.sock, false);
+            return err != SSL_ERROR_WANT_READ;
+        }
+#endif
+        return true;
+    }
+
+    inline bool ClientImpl::send(const Request& req, Response& res) {
+        std::lock_guard<std::recursive_mutex> request_mutex_guard(request_mutex_);
+
+        res.timings.start = detail::timing_now();
+
+        bool success = false;
+        if (!open_socket_if_needed(res, success)) { return success; }
+
+        if (socket_.is_http2) {
+            if (req.path.empty()) {
+                error_ = Error::Connection;
+                return false;
+            }
+
+            auto ret = send_http2({ &req }, { &res }) && handle_response(req, res);
+            if (!ret && error_ == Error::Success) { error_ = Error::Unknown; }
+            return ret;
+        }
+
+        auto close_connection = !keep_alive_;
+
+        // By reference, the captures don't fit into std::function's small buffer
+        auto handler = [&](Stream& strm) {
+            return handle_request(strm, req, res, close_connection);
+        };
+        auto ret = process_socket(socket_, std::ref(handler));
+
+        if (close_connection || !ret) { stop_core(); }
+
+        if (!ret) {
+            if (error_ == Error::Success) { error_ = Error::Unknown; }
+        }
+
+        return ret;
+    }
+
+    inline bool ClientImpl::send_pipelined(const std::vector<Request>& requests,
+        std::vector<Response>& responses, size_t max_in_flight) {
+        std::lock_guard<std::recursive_mutex> request_mutex_guard(request_mutex_);
+
+        responses.clear();
+        responses.resize(requests.size());
+
+        if (max_in_flight == 0) { max_in_flight = 1; }
+
+        auto all_ok = true;
+
+        for (const auto& req : requests) {
+            if (!detail::is_pipelinable(req) || req.path.empty()) {
+                for (size_t i = 0; i < requests.size(); i++) {
+                    if (!send(requests[i], responses[i])) { all_ok = false; }
+                }
+                return all_ok;
+            }
+        }
+
+        // Plain HTTP proxies need the absolute form, same as handle_request()
+        auto via_http_proxy = !is_ssl() && !proxy_host_.empty() && proxy_port_ != -1;
+
+        auto start = detail::timing_now();
+        for (auto& res : responses) { res.timings.start = start; }
+
+        size_t answered = 0;
+        size_t replay_count = 0;
+
+        while (answered < requests.size()) {
+            bool success = false;
+            if (!open_socket_if_needed(responses[answered], success)) {
+                if (error_ == Error::Success) { error_ = Error::Connection; }
+                return false;
+            }
+
+            // Nothing to pipeline on HTTP/2, the rest go out as concurrent streams
+            if (socket_.is_http2) {
+                std::vector<const Request*> rest_requests;
+                std::vector<Response*> rest_responses;
+                for (auto i = answered; i < requests.size(); i++) {
+                    rest_requests.push_back(&requests[i]);
+                    rest_responses.push_back(&responses[i]);
+                }
+                return send_http2(rest_requests, rest_responses) && all_ok;
+            }
+
+            // Only the first response in flight paid for the connection
+            for (auto i = answered + 1; i < requests.size(); i++) {
+                responses[i].timings.reused_connection = true;
+                responses[i].timings.kernel_tls_send = responses[answered].timings.kernel_tls_send;
+                responses[i].timings.kernel_tls_recv = responses[answered].timings.kernel_tls_recv;
+            }
+
+            auto answered_on_connect = answered;
+            auto written = answered;
+
+            auto ret = process_socket(socket_, [&](Stream& strm) {
+                while (answered < requests.size()) {
+                    while (written < requests.size() && written - answered < max_in_flight) {
+                        auto ok = true;
+                        if (via_http_proxy) {
+                            auto req2 = requests[written];
+                            req2.path = "http://" + host_and_port_ + req2.path;
+                            ok = write_request(strm, req2, false, &responses[written].timings);
+                        }
+                        else {
+                            ok = write_request(strm, requests[written], false, &responses[written].timings);
+                        }
+                        if (!ok) { return false; }
+                        responses[written].timings.request_sent = detail::timing_now();
+                        written++;
+                    }
+
+                    auto& res = responses[answered];
+                    detail::reset_response_keep_timings(res);
+                    if (!read_response(strm, requests[answered], res)) {
+                        // Bytes already handed to a receiver can't be taken back, so only
+                        // requests that never got a status line are safe to replay.
+                        if (res.status != -1 && requests[answered].content_receiver) {
+                            res = Response();
+                            all_ok = false;
+                            answered++;
+                        }
+                        return false;
+                    }
+                    answered++;
+
+                    // Server asked to close after this response; replay the rest
+                    if (!is_socket_open()) { return true; }
+                }
+                return true;
+                });
+
+            if (!ret || answered < requests.size()) { stop_core(); }
+
+            if (answered == answered_on_connect) {
+                if (++replay_count > CPPHTTPLIB_PIPELINE_MAX_REPLAY) {
+                    if (error_ == Error::Success) { error_ = Error::Read; }
+                    return false;
+                }
+            }
+            else {
+                replay_count = 0;
+            }
+        }
+
+        if (!keep_alive_) { stop_core(); }
+
+        if (!all_ok && error_ == Error::Success) { error_ = Error::Read; }
+
+        return all_ok;
+    }
+
+    inline bool ClientImpl::send_multiplexed(const std::vector<Request>& requests,
+        std::vector<Response>& responses, size_t max_in_flight) {
+        std::lock_guard<std::recursive_mutex> request_mutex_guard(request_mutex_);
+
+        responses.clear();
+        responses.resize(requests.size());
+
+        if (requests.empty()) { return true; }
+
+        // ALPN decides the protocol, so connect before choosing
+        bool success = false;
+        if (!open_socket_if_needed(responses[0], success)) {
+            if (error_ == Error::Success) { error_ = Error::Connection; }
+            return false;
+        }
+
+        if (!socket_.is_http2) {
+            return send_pipelined(requests, responses, max_in_flight);
+        }
+
+        std::vector<const Request*> request_ptrs;
+        std::vector<Response*> response_ptrs;
+        for (size_t i = 0; i < requests.size(); i++) {
+            if (requests[i].path.empty()) {
+                error_ = Error::Connection;
+                return false;
+            }
+            request_ptrs.push_back(&requests[i]);
+            response_ptrs.push_back(&responses[i]);
+        }
+
+        return send_http2(request_ptrs, response_ptrs);
+    }
+
+    inline bool ClientImpl::send_http2(const std::vector<const Request*>& requests,
+        const std::vector<Response*>& responses) {
+        std::vector<size_t> pending;
+        for (size_t i = 0; i < requests.size(); i++) { pending.push_back(i); }
+
+        auto start = detail::timing_now();
+        for (auto res : responses) {
+            if (!res->timings.start) { res->timings.start = start; }
+        }
+
+        auto all_ok = true;
+        size_t replay_count = 0;
+
+        while (!pending.empty()) {
+            bool success = false;
+            if (!open_socket_if_needed(*responses[pending.front()], success)) {
+                if (error_ == Error::Success) { error_ = Error::Connection; }
+                return false;
+            }
+
+            // The replacement connection may have settled on HTTP/1.1
+            if (!socket_.is_http2) {
+                for (auto i : pending) {
+                    if (!send(*requests[i], *responses[i])) { all_ok = false; }
+                }
+                return all_ok;
+            }
+
+            // Streams share the connection, only the first one paid for it
+            for (size_t i = 1; i < pending.size(); i++) {
+                responses[pending[i]]->timings.reused_connection = true;
+                responses[pending[i]]->timings.kernel_tls_send = responses[pending[0]]->timings.kernel_tls_send;
+                responses[pending[i]]->timings.kernel_tls_recv = responses[pending[0]]->timings.kernel_tls_recv;
+            }
+
+            if (!http2_session_) { http2_session_ = std::make_shared<detail::Http2Session>(); }
+            auto session = http2_session_;
+
+            std::vector<const Request*> batch_requests;
+            std::vector<Response*> batch_responses;
+            std::vector<detail::http2::HeaderFields> fields(pending.size());
+            for (size_t k = 0; k < pending.size(); k++) {
+                batch_requests.push_back(requests[pending[k]]);
+                batch_responses.push_back(responses[pending[k]]);
+                detail::reset_response_keep_timings(*batch_responses[k]);
+                make_http2_header_fields(*batch_requests[k], fields[k]);
+            }
+
+            std::vector<detail::Http2Session::Outcome> outcomes;
+            auto ret = process_socket(socket_, [&](Stream& strm) {
+                return session->run(strm, batch_requests, fields, batch_responses,
+                    decompress_, rate_limiters_, outcomes, error_);
+                });
+
+            if (!ret || !session->is_usable()) { stop_core(); }
+
+            std::vector<size_t> retry;
+            for (size_t k = 0; k < pending.size(); k++) {
+                switch (outcomes[k]) {
+                case detail::Http2Session::Outcome::Completed:
+                    if (logger_) { logger_(*batch_requests[k], *batch_responses[k]); }
+                    break;
+                case detail::Http2Session::Outcome::Retryable:
+                    retry.push_back(pending[k]);
+                    break;
+                default:
+                    *batch_responses[k] = Response();
+                    all_ok = false;
+                    break;
+                }
+            }
+
+            if (!retry.empty() && retry.size() == pending.size()) {
+                if (++replay_count > CPPHTTPLIB_PIPELINE_MAX_REPLAY) {
+                    for (auto i : retry) { *responses[i] = Response(); }
+                    if (error_ == Error::Success) { error_ = Error::Read; }
+                    return false;
+                }
+            }
+            else {
+                replay_count = 0;
+            }
+
+            pending.swap(retry);
+        }
+
+        if (!keep_alive_) { stop_core(); }
+
+        if (!all_ok && error_ == Error::Success) { error_ = Error::Read; }
+
+        return all_ok;
+    }
+
+    inline void ClientImpl::make_http2_header_fields(const Request& req,
+        std::vector<std::pair<std::string, std::string>>& fields) const {
+        auto authority = req.get_header_value("Host");
+        if (authority.empty()) {
+            auto default_port = is_ssl() ? 443 : 80;
+            authority = port_ == default_port ? host_ : host_and_port_;
+        }
+
+        fields.emplace_back(":method", req.method);
+        fields.emplace_back(":scheme", is_ssl() ? "https" : "http");
+        fields.emplace_back(":authority", authority);
+        fields.emplace_back(":path", req.path);
+
+        auto add = [&](const std::string& key, const std::string& val) {
+            std::string name;
+            for (auto c : key) { name += static_cast<char>(::tolower(c)); }
+            // Connection-specific headers are not allowed in HTTP/2
+            if (name == "host" || name == "connection" || name == "keep-alive" ||
+                name == "proxy-connection" || name == "transfer-encoding" ||
+                name == "upgrade" || (name == "te" && val != "trailers")) {
+                return;
+            }
+            fields.emplace_back(std::move(name), val);
+        };
+
+        for (const auto& x : req.headers) { add(x.first, x.second); }
+
+        if (!req.has_header("Accept")) { add("Accept", "*/*"); }
+        if (!req.has_header("User-Agent")) { add("User-Agent", "cpp-httplib/0.7"); }
+
+        if (!req.has_header("Content-Length")) {
+            if (req.content_file.fd >= 0) {
+                add("Content-Length", std::to_string(req.content_file.length));
+            }
+            else if (req.content_provider) {
+                if (req.content_length > 0 && req.body.empty()) {
+                    add("Content-Length", std::to_string(req.content_length));
+                }
+            }
+            else if (!req.body.empty()) {
+                add("Content-Length", std::to_string(req.body.size()));
+            }
+        }
+
+        if (!req.body.empty() && !req.has_header("Content-Type")) {
+            add("Content-Type", "text/plain");
+        }
+
+        if (!basic_auth_password_.empty()) {
+            auto header = make_basic_authentication_header(
+                basic_auth_username_, basic_auth_password_, false);
+            add(header.first, header.second);
+        }
+
+        if (!bearer_token_auth_token_.empty()) {
+            auto header = make_bearer_token_authentication_header(
+                bearer_token_auth_token_, false);
+            add(header.first, header.second);
+        }
+    }
+
+    inline bool ClientImpl::handle_request(Stream& strm, const Request& req,
+        Response& res, bool close_connection) {
+        if (req.path.empty()) {
+            error_ = Error::Connection;
+            return false;
+        }
+
+        bool ret;
+
+        if (!is_ssl() && !proxy_host_.empty() && proxy_port_ != -1) {
+            auto req2 = req;
+            req2.path = "http://" + host_and_port_ + req.path;
+            ret = process_request(strm, req2, res, close_connection);
+        }
+        else {
+            ret = process_request(strm, req, res, close_connection);
+        }
+
+        if (!ret) { return false; }
+
+        return handle_response(req, res);
+    }
+
+    // Redirects and digest auth challenges, shared by the HTTP/1.1 and HTTP/2 paths
+    inline bool ClientImpl::handle_response(const Request& req, Response& res) {
+        auto ret = true;
+
+        if (300 < res.status && res.status < 400 && follow_location_) {
+            ret = redirect(req, res);
+        }
 
 #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
         if ((res.status == 401 || res.status == 407) &&
@@ -3896,8 +7198,10 @@ namespace httplib {
     }
 
     inline bool ClientImpl::write_request(Stream& strm, const Request& req,
-        bool close_connection) {
-        detail::BufferStream bstrm;
+        bool close_connection, RequestTimings* timings, Response* early_res) {
+        // Everything below but the socket writes comes from the arena, released when this returns
+        detail::RequestArena::Scope arena_scope(arena_);
+        detail::BufferStream bstrm(&arena_);
 
         // Request line
         //const auto& path = detail::encode_url(req.path);
@@ -3906,7 +7210,7 @@ namespace httplib {
         bstrm.write_format("%s %s HTTP/1.1\r\n", req.method.c_str(), path.c_str());
 
 		// Additonal headers
-		Headers headers;
+		detail::ArenaHeaders headers{ detail::ArenaAllocator<char>(&arena_) };
         if (close_connection) { headers.emplace("Connection", "close"); }
 
         if (!req.has_header("Host")) {
@@ -3936,7 +7240,10 @@ namespace httplib {
 
         bool bChunked = false;
 
-        if (req.body.empty()) {
+        if (req.content_file.fd >= 0) {
+            headers.emplace("Content-Length", std::to_string(req.content_file.length));
+        }
+        else if (req.body.empty()) {
             if (req.content_provider) {
                 //for google cloud storage
                 if (req.content_length > 0)
@@ -3944,11 +7251,11 @@ namespace httplib {
                     auto length = std::to_string(req.content_length);
                     headers.emplace("Content-Length", length);
                 }
-                else if (!req.has_header("Transfer-Encoding")) {
-                    //headers.emplace("Transfer-Encoding", "chunked");
-                    bChunked = true;
-                }
                 else {
+                    // Unknown length, without the header the server would take the request as bodiless
+                    if (!req.has_header("Transfer-Encoding")) {
+                        headers.emplace("Transfer-Encoding", "chunked");
+                    }
                     bChunked = true;
                 }
             }
@@ -3988,6 +7295,24 @@ namespace httplib {
                 proxy_bearer_token_auth_token_, true));
         }
 
+        // Large bodies wait for the server to accept them, a 401, 403 or 413 then costs a
+        // round trip instead of the upload. Pipelined requests, without early_res, never wait
+        auto expect_continue = false;
+        if (early_res) {
+            if (req.has_header("Expect")) {
+                expect_continue = !strcasecmp(req.get_header_value("Expect").c_str(), "100-continue");
+            }
+            else if (expect_continue_min_size_ > 0) {
+                auto body_size = req.content_file.fd >= 0 ? req.content_file.length :
+                    !req.body.empty() ? req.body.size() :
+                    req.content_provider ? (bChunked ? (std::numeric_limits<size_t>::max)() : req.content_length) : 0;
+                if (body_size > 0 && body_size >= expect_continue_min_size_) {
+                    headers.emplace("Expect", "100-continue");
+                    expect_continue = true;
+                }
+            }
+        }
+
         detail::write_headers(bstrm, req, headers);
 
         // Flush buffer
@@ -3996,6 +7321,43 @@ namespace httplib {
             error_ = Error::Write;
             return false;
         }
+        if (timings) { timings->headers_sent = detail::timing_now(); }
+
+        // Servers that ignore Expect say nothing, the body goes out after the timeout then
+        if (expect_continue && strm.wait_readable(expect_continue_timeout_msec_ / 1000,
+            (expect_continue_timeout_msec_ % 1000) * 1000)) {
+            for (;;) {
+                if (!read_response_line(strm, *early_res)) {
+                    error_ = Error::Read;
+                    return false;
+                }
+                if (!detail::read_headers(strm, early_res->headers, &header_nodes_)) {
+                    error_ = Error::Read;
+                    return false;
+                }
+                if (early_res->status == 100) {
+                    detail::recycle_headers(early_res->headers, header_nodes_);
+                    early_res->status = -1;
+                    break;
+                }
+                // Final status, the body stays here
+                if (early_res->status < 100 || early_res->status >= 200 || early_res->status == 101) {
+                    early_res->timings.first_byte = detail::timing_now();
+                    return true;
+                }
+                // Other interim responses (102, 103) come before the one that counts
+                detail::recycle_headers(early_res->headers, header_nodes_);
+            }
+        }
+
+        // File
+        if (req.content_file.fd >= 0) {
+            if (!detail::write_file_content(strm, req.content_file, rate_limiters_, req)) {
+                error_ = Error::Write;
+                return false;
+            }
+            return true;
+        }
 
         // ContentProvider
         if (req.content_provider) {
@@ -4004,37 +7366,38 @@ namespace httplib {
 
             bool ok = true;
 
-			DataSink data_sink;
-            
-			data_sink.is_writable = [&](void) { return ok && strm.is_writable(); };
+            // Size line, payload and CRLF of a chunk go out in one write, the buffer is reused for every chunk.
+            // A chunk is held until the next one or the end, so the last one and the end marker share a
+            // write: a separate small write would wait for the server's delayed ACK
+            detail::ArenaString chunk{ detail::ArenaAllocator<char>(&arena_) };
 
-            data_sink.write = [&](const char* d, size_t l) {
+            // Held by reference so DataSink's std::functions don't allocate for them
+            auto is_writable = [&](void) { return ok && strm.is_writable(); };
+
+            auto write = [&](const char* d, size_t l) {
 
                 if (bChunked)
                 {
-					// Emit chunked response header and footer for each chunk
-
-					std::string beforePayloadPart = detail::from_i_to_hex(l) + "\r\n";
-					size_t chunkTotalSize = beforePayloadPart.size(); //size and r-n
-					chunkTotalSize += l; //itself
-					chunkTotalSize += 2; //r-n
-
-					TArray<uint8> ChunkCompiled;
-					ChunkCompiled.AddUninitialized(chunkTotalSize);
-					FMemory::Memcpy(ChunkCompiled.GetData(), beforePayloadPart.c_str(), beforePayloadPart.size());
-					FMemory::Memcpy(ChunkCompiled.GetData() + beforePayloadPart.size(), d, l);
-					ChunkCompiled.GetData()[beforePayloadPart.size() + l] = '\r';
-					ChunkCompiled.GetData()[beforePayloadPart.size() + l + 1] = '\n';
-
-					if (!detail::write_data(strm, (const char*)ChunkCompiled.GetData(), chunkTotalSize)) {
+					if (!ok || l == 0) { return; }
+					if (!chunk.empty() && !detail::write_data_throttled(strm, chunk.data(), chunk.size(), rate_limiters_, req)) {
 						ok = false;
 						return;
 					}
+
+					// Emit chunked response header and footer for each chunk
+					char size_line[24];
+					auto size_line_len = snprintf(size_line, sizeof(size_line), "%zx\r\n", l);
+
+					// Grows the buffer at most once per request, chunks of an upload have the same size
+					chunk.reserve(size_line_len + l + 2 + 5);
+					chunk.assign(size_line, size_line_len);
+					chunk.append(d, l);
+					chunk.append("\r\n", 2);
                 }
                 else
                 {
 					if (ok) {
-						if (detail::write_data(strm, d, l)) {
+						if (detail::write_data_throttled(strm, d, l, rate_limiters_, req)) {
 							offset += l;
 						}
 						else {
@@ -4044,17 +7407,22 @@ namespace httplib {
 				}
             };
 
-            data_sink.done = [&](void) 
+            auto done = [&](void)
             {
-                if (bChunked)
+                if (bChunked && ok)
                 {
-					static const std::string done_marker("0\r\n\r\n");
-					if (!detail::write_data(strm, done_marker.data(), done_marker.size())) {
+					chunk.append("0\r\n\r\n", 5);
+					if (!detail::write_data_throttled(strm, chunk.data(), chunk.size(), rate_limiters_, req)) {
 						ok = false;
 					}
                 }
             };
 
+			DataSink data_sink;
+			data_sink.is_writable = std::ref(is_writable);
+			data_sink.write = std::ref(write);
+			data_sink.done = std::ref(done);
+
             if (end_offset > 0) //if content_length is provided
             {
                 while (offset < end_offset) {
@@ -4083,7 +7451,8 @@ namespace httplib {
 
         // Body
         if (!req.body.empty()) {
-            return detail::write_data(strm, req.body.data(), req.body.size());
+            return detail::write_data_throttled(strm, req.body.data(), req.body.size(),
+                rate_limiters_, req);
         }
 
         return true;
@@ -4096,18 +7465,18 @@ namespace httplib {
         ResponseHandler response_handler,
         ContentReceiver content_receiver,
         Progress progress) {
+        std::lock_guard<std::recursive_mutex> request_mutex_guard(request_mutex_);
 
-        Request req;
-        req.method = method;
-        req.path = path;
-        req.headers = default_headers_;
-        req.headers.insert(headers.begin(), headers.end());
+        auto& req = prepare_request(method, path, headers);
 
         req.response_handler = std::move(response_handler);
         req.content_receiver = std::move(content_receiver);
         req.progress = std::move(progress);
 
-        if (content_type) { req.headers.emplace("Content-Type", content_type); }
+        if (content_type) {
+            detail::emplace_header(req.headers, &header_nodes_, "Content-Type", 12,
+                content_type, strlen(content_type));
+        }
 
 #ifdef CPPHTTPLIB_ZLIB_SUPPORT
         if (compress_) {
@@ -4162,7 +7531,7 @@ namespace httplib {
         {
             if (content_provider) {
                 req.content_length = content_length;
-                req.content_provider = content_provider;
+                req.content_provider = std::move(content_provider);
                 if (!body.empty())
                 {
                     req.body = body;
@@ -4173,22 +7542,147 @@ namespace httplib {
             }
         }
 
-        auto res = std::make_shared<Response>();
+        return send_prepared_request(req);
+    }
+
+    // set_compress() doesn't apply, the file goes out as it is stored
+    inline std::shared_ptr<Response> ClientImpl::send_with_file_content(
+        const char* method, const char* path, const Headers& headers,
+        const FileContent& file, const char* content_type,
+        ResponseHandler response_handler,
+        ContentReceiver content_receiver,
+        Progress progress) {
+        std::lock_guard<std::recursive_mutex> request_mutex_guard(request_mutex_);
+
+        auto& req = prepare_request(method, path, headers);
+
+        req.response_handler = std::move(response_handler);
+        req.content_receiver = std::move(content_receiver);
+        req.progress = std::move(progress);
+        req.content_file = file;
+
+        if (content_type) {
+            detail::emplace_header(req.headers, &header_nodes_, "Content-Type", 12,
+                content_type, strlen(content_type));
+        }
+
+        return send_prepared_request(req);
+    }
+
+    // Like send_with_file_content(), the parts go out as they are
+    inline std::shared_ptr<Response> ClientImpl::send_with_multipart_writer(
+        const char* method, const char* path, const Headers& headers,
+        MultipartFormDataWriter& form,
+        ResponseHandler response_handler,
+        ContentReceiver content_receiver,
+        Progress progress) {
+        std::lock_guard<std::recursive_mutex> request_mutex_guard(request_mutex_);
+
+        auto& req = prepare_request(method, path, headers);
+
+        req.response_handler = std::move(response_handler);
+        req.content_receiver = std::move(content_receiver);
+        req.progress = std::move(progress);
+        req.content_length = form.content_length();
+        req.content_provider = [&form](size_t offset, size_t length, DataSink& sink) {
+            return form.provide(offset, length, sink);
+        };
+
+        auto content_type = form.content_type();
+        detail::emplace_header(req.headers, &header_nodes_, "Content-Type", 12,
+            content_type.data(), content_type.size());
+
+        return send_prepared_request(req);
+    }
+
+    // Fills request_ for a new request, reusing the header nodes and string capacity of the last one.
+    // Callers hold request_mutex_ until send_prepared_request() returns
+    inline Request& ClientImpl::prepare_request(const char* method, const char* path,
+        const Headers& headers) {
+        auto& req = request_;
+        req.method.assign(method);
+        req.path.assign(path);
+
+        detail::recycle_headers(req.headers, header_nodes_);
+        for (const auto& x : default_headers_) {
+            detail::emplace_header(req.headers, &header_nodes_, x.first, x.second);
+        }
+        for (const auto& x : headers) {
+            detail::emplace_header(req.headers, &header_nodes_, x.first, x.second);
+        }
+
+        req.body.clear();
+        req.content_length = 0;
+        req.redirect_count = CPPHTTPLIB_REDIRECT_MAX_COUNT;
+        req.authorization_count_ = 0;
+        return req;
+    }
+
+    inline std::shared_ptr<Response> ClientImpl::send_prepared_request(Request& req) {
+        // The last response is reused once no Result holds on to it any more
+        if (response_ && response_.use_count() == 1) {
+            detail::reset_response(*response_, header_nodes_);
+        }
+        else {
+            response_ = std::make_shared<Response>();
+        }
+        auto res = response_;
+
+        auto ret = send(req, *res);
+
+        // The callbacks may point into the caller's frame, and a large body is not worth keeping
+        req.response_handler = nullptr;
+        req.content_receiver = nullptr;
+        req.content_span_receiver = nullptr;
+        req.content_provider = nullptr;
+        req.content_file = FileContent();
+        req.progress = nullptr;
+        if (req.body.capacity() > CPPHTTPLIB_REQUEST_ARENA_MAX_RETAINED) { std::string().swap(req.body); }
 
-        return send(req, *res) ? res : nullptr;
+        return ret ? res : nullptr;
     }
 
     inline bool ClientImpl::process_request(Stream& strm, const Request& req,
         Response& res, bool close_connection) {
         // Send request
-        if (!write_request(strm, req, close_connection)) { return false; }
+        res.status = -1;
+        if (!write_request(strm, req, close_connection, &res.timings, &res)) { return false; }
+        res.timings.request_sent = detail::timing_now();
+
+        // The server turned the body down before it was sent
+        if (res.status != -1) {
+            auto ret = read_response(strm, req, res, true);
+            // It still counts on the body the headers announced, or closes on its own
+            stop_core();
+            return ret;
+        }
 
-        // Receive response and headers
-        if (!read_response_line(strm, res) ||
-            !detail::read_headers(strm, res.headers)) {
-            error_ = Error::Read;
-            return false;
+        return read_response(strm, req, res);
+    }
+
+    inline bool ClientImpl::read_response_head(Stream& strm, Response& res) {
+        for (auto first = true;; first = false) {
+            if (!read_response_line(strm, res)) {
+                error_ = Error::Read;
+                return false;
+            }
+            if (first) { res.timings.first_byte = detail::timing_now(); }
+
+            if (!detail::read_headers(strm, res.headers, &header_nodes_)) {
+                error_ = Error::Read;
+                return false;
+            }
+
+            // A 100 Continue that came after the Expect timeout, or an early hint
+            if (res.status < 100 || res.status >= 200 || res.status == 101) { return true; }
+            detail::recycle_headers(res.headers, header_nodes_);
         }
+    }
+
+    inline bool ClientImpl::read_response(Stream& strm, const Request& req,
+        Response& res, bool head_received) {
+        // Receive response and headers
+        if (!head_received && !read_response_head(strm, res)) { return false; }
 
         if (req.response_handler) {
             if (!req.response_handler(res)) {
@@ -4199,20 +7693,46 @@ namespace httplib {
 
         // Body
         if (req.method != "HEAD" && req.method != "CONNECT") {
-            auto out = req.content_receiver ?
-                static_cast<ContentReceiver>([&](const char* buf, size_t n) {
-                    auto ret = req.content_receiver(buf, n);
-                    if (!ret) { error_ = Error::Canceled; }
-                    return ret;
-                }) :
-                static_cast<ContentReceiver>([&](const char* buf, size_t n) {
-                    if (res.body.size() + n > res.body.max_size()) { return false; }
-                    res.body.append(buf, n);
-                    return true;
-                });
+            if (req.content_span_receiver &&
+                !(decompress_ && res.has_header("Content-Encoding"))) {
+                if (!read_content_into_spans(strm, req, res)) { return false; }
+            }
+            else {
+                // Decompressed bytes are copied into the spans once
+                detail::SpanWriter spans;
+                if (req.content_span_receiver) {
+                    spans.reset(&req.content_span_receiver, &req.progress, 0);
+                }
+
+                auto out = req.content_span_receiver ?
+                    static_cast<ContentReceiver>([&](const char* buf, size_t n) {
+                        auto ret = spans.write(buf, n);
+                        if (!ret) { error_ = Error::Canceled; }
+                        return ret;
+                    }) :
+                    req.content_receiver ?
+                    static_cast<ContentReceiver>([&](const char* buf, size_t n) {
+                        auto ret = req.content_receiver(buf, n);
+                        if (!ret) { error_ = Error::Canceled; }
+                        return ret;
+                    }) :
+                    static_cast<ContentReceiver>([&](const char* buf, size_t n) {
+                        if (res.body.size() + n > res.body.max_size()) { return false; }
+                        res.body.append(buf, n);
+                        return true;
+                    });
+
+                // read_content_with_length()/read_content_chunked() hand over at most one
+                // pooled buffer per call, so sleeping here paces the socket reads
+                if (detail::is_rate_limited(rate_limiters_, req)) {
+                    out = [&, out](const char* buf, size_t n) {
+                        detail::throttle_download(rate_limiters_, req, n);
+                        return out(buf, n);
+                    };
+                }
 
                 auto progress = [&](uint64_t current, uint64_t total) {
-                    if (!req.progress) { return true; }
+                    if (!req.progress || req.content_span_receiver) { return true; }
                     auto ret = req.progress(current, total);
                     if (!ret) { error_ = Error::Canceled; }
                     return ret;
@@ -4224,8 +7744,11 @@ namespace httplib {
                     if (error_ != Error::Canceled) { error_ = Error::Read; }
                     return false;
                 }
+            }
         }
 
+        res.timings.end = detail::timing_now();
+
         if (res.get_header_value("Connection") == "close" ||
             (res.version == "HTTP/1.0" && res.reason != "Connection established")) {
             stop_core();
@@ -4237,12 +7760,81 @@ namespace httplib {
         return true;
     }
 
+    // recv()/SSL_read() write the body straight into the caller's spans
+    inline bool ClientImpl::read_content_into_spans(Stream& strm, const Request& req,
+        Response& res) {
+        auto chunked = detail::is_chunked_transfer_encoding(res.headers);
+        auto has_length = !chunked && res.has_header("Content-Length");
+        auto len = has_length ?
+            detail::get_header_value<uint64_t>(res.headers, "Content-Length") : 0;
+
+        detail::SpanWriter spans;
+        spans.reset(&req.content_span_receiver, &req.progress, len);
+
+        // SSL_read() and recv() on Windows take an int. With a limiter the reads are
+        // capped to one pooled buffer, so it paces them as it does on the copying path
+        auto throttled = detail::is_rate_limited(rate_limiters_, req);
+        auto max_read = static_cast<uint64_t>(throttled ?
+            detail::BufferPool::get().buffer_size() :
+            static_cast<size_t>((std::numeric_limits<int>::max)()));
+
+        auto read_some = [&](uint64_t n) {
+            auto ret = spans.read(strm, (std::min)(n, max_read));
+            if (ret > 0 && throttled) {
+                detail::throttle_download(rate_limiters_, req, static_cast<size_t>(ret));
+            }
+            return ret;
+        };
+
+        auto read_length = [&](uint64_t n) {
+            uint64_t r = 0;
+            while (r < n) {
+                auto ret = read_some(n - r);
+                if (ret <= 0) { return false; }
+                r += static_cast<uint64_t>(ret);
+            }
+            return true;
+        };
+
+        auto ret = true;
+        if (chunked) {
+            ret = detail::read_chunks(strm, read_length);
+        }
+        else if (has_length) {
+            ret = read_length(len);
+        }
+        else {
+            for (;;) {
+                auto n = read_some((std::numeric_limits<uint64_t>::max)());
+                if (n == 0) { break; }
+                if (n < 0) {
+                    // Running out of room is fine if the body ends right there
+                    char c;
+                    ret = spans.out_of_room() && strm.read(&c, 1) == 0;
+                    break;
+                }
+            }
+        }
+
+        if (!ret) { error_ = spans.canceled() ? Error::Canceled : Error::Read; }
+        return ret;
+    }
+
     inline bool
         ClientImpl::process_socket(Socket& socket,
             std::function<bool(Stream& strm)> callback) {
+#ifdef CPPHTTPLIB_IO_URING_SUPPORT
+        if (io_uring_) {
+            if (auto ring = detail::IoUring::get()) {
+                detail::UringSocketStream strm(*ring, socket.sock, read_timeout_sec_,
+                    read_timeout_usec_, write_timeout_sec_, write_timeout_usec_);
+                return callback(strm);
+            }
+        }
+#endif
         return detail::process_client_socket(socket.sock, read_timeout_sec_,
             read_timeout_usec_, write_timeout_sec_,
-            write_timeout_usec_, callback);
+            write_timeout_usec_, std::move(callback));
     }
 
     inline bool ClientImpl::is_ssl() const { return false; }
@@ -4261,16 +7853,13 @@ namespace httplib {
 
     inline Result ClientImpl::Get(const char* path, const Headers& headers,
         Progress progress) {
-        Request req;
-        req.method = "GET";
-        req.path = path;
-        req.headers = default_headers_;
-        req.headers.insert(headers.begin(), headers.end());
+        std::lock_guard<std::recursive_mutex> request_mutex_guard(request_mutex_);
+
+        auto& req = prepare_request("GET", path, headers);
         req.progress = std::move(progress);
 
-        auto res = std::make_shared<Response>();
-        auto ret = send(req, *res);
-        return Result{ ret ? res : nullptr, get_last_error() };
+        auto res = send_prepared_request(req);
+        return Result{ res, get_last_error() };
     }
 
     inline Result ClientImpl::Get(const char* path,
@@ -4300,14 +7889,14 @@ namespace httplib {
     inline Result ClientImpl::Get(const char* path,
         ResponseHandler response_handler,
         ContentReceiver content_receiver) {
-        return Get(path, Headers(), std::move(response_handler), content_receiver,
+        return Get(path, Headers(), std::move(response_handler), std::move(content_receiver),
             nullptr);
     }
 
     inline Result ClientImpl::Get(const char* path, const Headers& headers,
         ResponseHandler response_handler,
         ContentReceiver content_receiver) {
-        return Get(path, headers, std::move(response_handler), content_receiver,
+        return Get(path, headers, std::move(response_handler), std::move(content_receiver),
             nullptr);
     }
 
@@ -4315,27 +7904,38 @@ namespace httplib {
         ResponseHandler response_handler,
         ContentReceiver content_receiver,
         Progress progress) {
-        return Get(path, Headers(), std::move(response_handler), content_receiver,
-            progress);
+        return Get(path, Headers(), std::move(response_handler), std::move(content_receiver),
+            std::move(progress));
     }
 
     inline Result ClientImpl::Get(const char* path, const Headers& headers,
         ResponseHandler response_handler,
         ContentReceiver content_receiver,
         Progress progress) {
-        Request req;
-        req.method = "GET";
-        req.path = path;
-        req.headers = default_headers_;
-        req.headers.insert(headers.begin(), headers.end());
+        std::lock_guard<std::recursive_mutex> request_mutex_guard(request_mutex_);
 
+        auto& req = prepare_request("GET", path, headers);
         req.response_handler = std::move(response_handler);
         req.content_receiver = std::move(content_receiver);
         req.progress = std::move(progress);
 
-        auto res = std::make_shared<Response>();
-        auto ret = send(req, *res);
-        return Result{ ret ? res : nullptr, get_last_error() };
+        auto res = send_prepared_request(req);
+        return Result{ res, get_last_error() };
+    }
+
+    inline Result ClientImpl::GetInto(const char* path, const Headers& headers,
+        ResponseHandler response_handler,
+        ContentSpanReceiver content_span_receiver,
+        Progress progress) {
+        std::lock_guard<std::recursive_mutex> request_mutex_guard(request_mutex_);
+
+        auto& req = prepare_request("GET", path, headers);
+        req.response_handler = std::move(response_handler);
+        req.content_span_receiver = std::move(content_span_receiver);
+        req.progress = std::move(progress);
+
+        auto res = send_prepared_request(req);
+        return Result{ res, get_last_error() };
     }
 
     inline Result ClientImpl::Head(const char* path) {
@@ -4343,15 +7943,12 @@ namespace httplib {
     }
 
     inline Result ClientImpl::Head(const char* path, const Headers& headers) {
-        Request req;
-        req.method = "HEAD";
-        req.headers = default_headers_;
-        req.headers.insert(headers.begin(), headers.end());
-        req.path = path;
+        std::lock_guard<std::recursive_mutex> request_mutex_guard(request_mutex_);
 
-        auto res = std::make_shared<Response>();
-        auto ret = send(req, *res);
-        return Result{ ret ? res : nullptr, get_last_error() };
+        auto& req = prepare_request("HEAD", path, headers);
+
+        auto res = send_prepared_request(req);
+        return Result{ res, get_last_error() };
     }
 
     inline Result ClientImpl::Post(const char* path) {
@@ -4378,7 +7975,7 @@ namespace httplib {
     inline Result ClientImpl::Post(const char* path, size_t content_length,
         ContentProvider content_provider,
         const char* content_type) {
-        return Post(path, Headers(), content_length, content_provider, content_type);
+        return Post(path, Headers(), content_length, std::move(content_provider), content_type);
     }
 
     inline Result ClientImpl::Post(const char* path, const Headers& headers,
@@ -4386,7 +7983,7 @@ namespace httplib {
         ContentProvider content_provider,
         const char* content_type) {
         auto ret = send_with_content_provider("POST", path, headers, std::string(),
-            content_length, content_provider,
+            content_length, std::move(content_provider),
             content_type, nullptr, nullptr, nullptr);
         return Result{ ret, get_last_error() };
     }
@@ -4398,7 +7995,7 @@ namespace httplib {
         const char* content_type) {
         auto body = detail::params_to_query_str(params);
         auto ret = send_with_content_provider("POST", path, headers, body,
-            content_length, content_provider,
+            content_length, std::move(content_provider),
             content_type, nullptr, nullptr, nullptr);
         return Result{ ret, get_last_error() };
     }
@@ -4411,8 +8008,8 @@ namespace httplib {
         ResponseHandler response_handler) {
         auto body = detail::params_to_query_str(params);
         auto ret = send_with_content_provider("POST", path, headers, body,
-            content_length, content_provider,
-            content_type, response_handler, nullptr, nullptr);
+            content_length, std::move(content_provider),
+            content_type, std::move(response_handler), nullptr, nullptr);
         return Result{ ret, get_last_error() };
     }
 
@@ -4424,8 +8021,8 @@ namespace httplib {
         ContentReceiver content_receiver) {
         auto body = detail::params_to_query_str(params);
         auto ret = send_with_content_provider("POST", path, headers, body,
-            content_length, content_provider,
-            content_type, nullptr, content_receiver, nullptr);
+            content_length, std::move(content_provider),
+            content_type, nullptr, std::move(content_receiver), nullptr);
         return Result{ ret, get_last_error() };
     }
 
@@ -4437,8 +8034,8 @@ namespace httplib {
         Progress progress) {
         auto body = detail::params_to_query_str(params);
         auto ret = send_with_content_provider("POST", path, headers, body,
-            content_length, content_provider,
-            content_type, nullptr, nullptr, progress);
+            content_length, std::move(content_provider),
+            content_type, nullptr, nullptr, std::move(progress));
         return Result{ ret, get_last_error() };
     }
 
@@ -4451,8 +8048,8 @@ namespace httplib {
         Progress progress) {
         auto body = detail::params_to_query_str(params);
         auto ret = send_with_content_provider("POST", path, headers, body,
-            content_length, content_provider,
-            content_type, nullptr, content_receiver, progress);
+            content_length, std::move(content_provider),
+            content_type, nullptr, std::move(content_receiver), std::move(progress));
         return Result{ ret, get_last_error() };
     }
 
@@ -4466,8 +8063,8 @@ namespace httplib {
         Progress progress) {
         auto body = detail::params_to_query_str(params);
         auto ret = send_with_content_provider("POST", path, headers, body,
-            content_length, content_provider,
-            content_type, response_handler, content_receiver, progress);
+            content_length, std::move(content_provider),
+            content_type, std::move(response_handler), std::move(content_receiver), std::move(progress));
         return Result{ ret, get_last_error() };
     }
 
@@ -4528,7 +8125,7 @@ namespace httplib {
     inline Result ClientImpl::Put(const char* path, size_t content_length,
         ContentProvider content_provider,
         const char* content_type) {
-        return Put(path, Headers(), content_length, content_provider, content_type);
+        return Put(path, Headers(), content_length, std::move(content_provider), content_type);
     }
 
     inline Result ClientImpl::Put(const char* path, const Headers& headers,
@@ -4536,7 +8133,7 @@ namespace httplib {
         ContentProvider content_provider,
         const char* content_type) {
         auto ret = send_with_content_provider("PUT", path, headers, std::string(),
-            content_length, content_provider,
+            content_length, std::move(content_provider),
             content_type, nullptr, nullptr, nullptr);
         return Result{ ret, get_last_error() };
     }
@@ -4548,7 +8145,7 @@ namespace httplib {
         const char* content_type) {
         auto body = detail::params_to_query_str(params);
         auto ret = send_with_content_provider("PUT", path, headers, body,
-            content_length, content_provider,
+            content_length, std::move(content_provider),
             content_type, nullptr, nullptr, nullptr);
         return Result{ ret, get_last_error() };
     }
@@ -4561,8 +8158,8 @@ namespace httplib {
         ResponseHandler response_handler) {
         auto body = detail::params_to_query_str(params);
         auto ret = send_with_content_provider("PUT", path, headers, body,
-            content_length, content_provider,
-            content_type, response_handler, nullptr, nullptr);
+            content_length, std::move(content_provider),
+            content_type, std::move(response_handler), nullptr, nullptr);
         return Result{ ret, get_last_error() };
     }
 
@@ -4574,8 +8171,8 @@ namespace httplib {
         ContentReceiver content_receiver) {
         auto body = detail::params_to_query_str(params);
         auto ret = send_with_content_provider("PUT", path, headers, body,
-            content_length, content_provider,
-            content_type, nullptr, content_receiver, nullptr);
+            content_length, std::move(content_provider),
+            content_type, nullptr, std::move(content_receiver), nullptr);
         return Result{ ret, get_last_error() };
     }
 
@@ -4587,8 +8184,8 @@ namespace httplib {
         Progress progress) {
         auto body = detail::params_to_query_str(params);
         auto ret = send_with_content_provider("PUT", path, headers, body,
-            content_length, content_provider,
-            content_type, nullptr, nullptr, progress);
+            content_length, std::move(content_provider),
+            content_type, nullptr, nullptr, std::move(progress));
         return Result{ ret, get_last_error() };
     }
 
@@ -4601,8 +8198,8 @@ namespace httplib {
         Progress progress) {
         auto body = detail::params_to_query_str(params);
         auto ret = send_with_content_provider("PUT", path, headers, body,
-            content_length, content_provider,
-            content_type, nullptr, content_receiver, progress);
+            content_length, std::move(content_provider),
+            content_type, nullptr, std::move(content_receiver), std::move(progress));
         return Result{ ret, get_last_error() };
     }
 
@@ -4616,8 +8213,8 @@ namespace httplib {
         Progress progress) {
         auto body = detail::params_to_query_str(params);
         auto ret = send_with_content_provider("PUT", path, headers, body,
-            content_length, content_provider,
-            content_type, response_handler, content_receiver, progress);
+            content_length, std::move(content_provider),
+            content_type, std::move(response_handler), std::move(content_receiver), std::move(progress));
         return Result{ ret, get_last_error() };
     }
 
@@ -4647,7 +8244,7 @@ namespace httplib {
     inline Result ClientImpl::Patch(const char* path, size_t content_length,
         ContentProvider content_provider,
         const char* content_type) {
-        return Patch(path, Headers(), content_length, content_provider, content_type);
+        return Patch(path, Headers(), content_length, std::move(content_provider), content_type);
     }
 
     inline Result ClientImpl::Patch(const char* path, const Headers& headers,
@@ -4655,7 +8252,7 @@ namespace httplib {
         ContentProvider content_provider,
         const char* content_type) {
         auto ret = send_with_content_provider("PATCH", path, headers, std::string(),
-            content_length, content_provider,
+            content_length, std::move(content_provider),
             content_type, nullptr, nullptr, nullptr);
         return Result{ ret, get_last_error() };
     }
@@ -4667,8 +8264,8 @@ namespace httplib {
         ResponseHandler response_handler) {
         auto body = detail::params_to_query_str(params);
         auto ret = send_with_content_provider("PATCH", path, headers, body,
-            content_length, content_provider,
-            content_type, response_handler, nullptr, nullptr);
+            content_length, std::move(content_provider),
+            content_type, std::move(response_handler), nullptr, nullptr);
         return Result{ ret, get_last_error() };
     }
 
@@ -4679,8 +8276,8 @@ namespace httplib {
         ContentReceiver content_receiver) {
         auto body = detail::params_to_query_str(params);
         auto ret = send_with_content_provider("PATCH", path, headers, body,
-            content_length, content_provider,
-            content_type, nullptr, content_receiver, nullptr);
+            content_length, std::move(content_provider),
+            content_type, nullptr, std::move(content_receiver), nullptr);
         return Result{ ret, get_last_error() };
     }
 
@@ -4691,8 +8288,8 @@ namespace httplib {
         Progress progress) {
         auto body = detail::params_to_query_str(params);
         auto ret = send_with_content_provider("PATCH", path, headers, body,
-            content_length, content_provider,
-            content_type, nullptr, nullptr, progress);
+            content_length, std::move(content_provider),
+            content_type, nullptr, nullptr, std::move(progress));
         return Result{ ret, get_last_error() };
     }
 
@@ -4704,8 +8301,8 @@ namespace httplib {
         Progress progress) {
         auto body = detail::params_to_query_str(params);
         auto ret = send_with_content_provider("PATCH", path, headers, body,
-            content_length, content_provider,
-            content_type, nullptr, content_receiver, progress);
+            content_length, std::move(content_provider),
+            content_type, nullptr, std::move(content_receiver), std::move(progress));
         return Result{ ret, get_last_error() };
     }
 
@@ -4718,8 +8315,68 @@ namespace httplib {
         Progress progress) {
         auto body = detail::params_to_query_str(params);
         auto ret = send_with_content_provider("PATCH", path, headers, body,
-            content_length, content_provider,
-            content_type, response_handler, content_receiver, progress);
+            content_length, std::move(content_provider),
+            content_type, std::move(response_handler), std::move(content_receiver), std::move(progress));
+        return Result{ ret, get_last_error() };
+    }
+
+    inline Result ClientImpl::Post(const char* path, const Headers& headers,
+        const FileContent& file, const char* content_type,
+        ResponseHandler response_handler,
+        ContentReceiver content_receiver,
+        Progress progress) {
+        auto ret = send_with_file_content("POST", path, headers, file, content_type,
+            std::move(response_handler), std::move(content_receiver), std::move(progress));
+        return Result{ ret, get_last_error() };
+    }
+
+    inline Result ClientImpl::Put(const char* path, const Headers& headers,
+        const FileContent& file, const char* content_type,
+        ResponseHandler response_handler,
+        ContentReceiver content_receiver,
+        Progress progress) {
+        auto ret = send_with_file_content("PUT", path, headers, file, content_type,
+            std::move(response_handler), std::move(content_receiver), std::move(progress));
+        return Result{ ret, get_last_error() };
+    }
+
+    inline Result ClientImpl::Patch(const char* path, const Headers& headers,
+        const FileContent& file, const char* content_type,
+        ResponseHandler response_handler,
+        ContentReceiver content_receiver,
+        Progress progress) {
+        auto ret = send_with_file_content("PATCH", path, headers, file, content_type,
+            std::move(response_handler), std::move(content_receiver), std::move(progress));
+        return Result{ ret, get_last_error() };
+    }
+
+    inline Result ClientImpl::Post(const char* path, const Headers& headers,
+        MultipartFormDataWriter& form,
+        ResponseHandler response_handler,
+        ContentReceiver content_receiver,
+        Progress progress) {
+        auto ret = send_with_multipart_writer("POST", path, headers, form,
+            std::move(response_handler), std::move(content_receiver), std::move(progress));
+        return Result{ ret, get_last_error() };
+    }
+
+    inline Result ClientImpl::Put(const char* path, const Headers& headers,
+        MultipartFormDataWriter& form,
+        ResponseHandler response_handler,
+        ContentReceiver content_receiver,
+        Progress progress) {
+        auto ret = send_with_multipart_writer("PUT", path, headers, form,
+            std::move(response_handler), std::move(content_receiver), std::move(progress));
+        return Result{ ret, get_last_error() };
+    }
+
+    inline Result ClientImpl::Patch(const char* path, const Headers& headers,
+        MultipartFormDataWriter& form,
+        ResponseHandler response_handler,
+        ContentReceiver content_receiver,
+        Progress progress) {
+        auto ret = send_with_multipart_writer("PATCH", path, headers, form,
+            std::move(response_handler), std::move(content_receiver), std::move(progress));
         return Result{ ret, get_last_error() };
     }
 
@@ -4745,26 +8402,26 @@ namespace httplib {
     inline Result ClientImpl::Delete(const char* path, const Headers& headers,
         const char* content_type,
         ResponseHandler response_handler) {
-        return Delete(path, headers, std::string(), content_type, response_handler, nullptr, nullptr);
+        return Delete(path, headers, std::string(), content_type, std::move(response_handler), nullptr, nullptr);
     }
 
     inline Result ClientImpl::Delete(const char* path, const Headers& headers,
         const char* content_type,
         ContentReceiver content_receiver) {
-        return Delete(path, headers, std::string(), content_type, nullptr, content_receiver, nullptr);
+        return Delete(path, headers, std::string(), content_type, nullptr, std::move(content_receiver), nullptr);
     }
 
     inline Result ClientImpl::Delete(const char* path, const Headers& headers,
         const char* content_type,
         Progress progress) {
-        return Delete(path, headers, std::string(), content_type, nullptr, nullptr, progress);
+        return Delete(path, headers, std::string(), content_type, nullptr, nullptr, std::move(progress));
     }
 
     inline Result ClientImpl::Delete(const char* path, const Headers& headers,
         const char* content_type,
         ContentReceiver content_receiver,
         Progress progress) {
-        return Delete(path, headers, std::string(), content_type, nullptr, content_receiver, progress);
+        return Delete(path, headers, std::string(), content_type, nullptr, std::move(content_receiver), std::move(progress));
     }
 
     inline Result ClientImpl::Delete(const char* path, const Headers& headers,
@@ -4772,7 +8429,7 @@ namespace httplib {
         ResponseHandler response_handler,
         ContentReceiver content_receiver,
         Progress progress) {
-        return Delete(path, headers, std::string(), content_type, response_handler, content_receiver, progress);
+        return Delete(path, headers, std::string(), content_type, std::move(response_handler), std::move(content_receiver), std::move(progress));
     }
 
     inline Result ClientImpl::Delete(const char* path, const Headers& headers,
@@ -4781,30 +8438,28 @@ namespace httplib {
         ResponseHandler response_handler,
         ContentReceiver content_receiver,
         Progress progress) {
+        std::lock_guard<std::recursive_mutex> request_mutex_guard(request_mutex_);
 
-        Request req;
-        req.method = "DELETE";
-        req.path = path;
-        req.headers = default_headers_;
-        req.headers.insert(headers.begin(), headers.end());
-
+        auto& req = prepare_request("DELETE", path, headers);
         req.response_handler = std::move(response_handler);
         req.content_receiver = std::move(content_receiver);
         req.progress = std::move(progress);
 
-        if (content_type) { req.headers.emplace("Content-Type", content_type); }
+        if (content_type) {
+            detail::emplace_header(req.headers, &header_nodes_, "Content-Type", 12,
+                content_type, strlen(content_type));
+        }
         req.body = body;
 
-        auto res = std::make_shared<Response>();
-        auto ret = send(req, *res);
-        return Result{ ret ? res : nullptr, get_last_error() };
+        auto res = send_prepared_request(req);
+        return Result{ res, get_last_error() };
     }
 
     inline Result ClientImpl::Delete(const char* path, const Headers& headers,
         ResponseHandler response_handler,
         ContentReceiver content_receiver,
         Progress progress) {
-        return Delete(path, headers, std::string(), nullptr, response_handler, content_receiver, progress);
+        return Delete(path, headers, std::string(), nullptr, std::move(response_handler), std::move(content_receiver), std::move(progress));
     }
 
     inline Result ClientImpl::Options(const char* path) {
@@ -4812,15 +8467,12 @@ namespace httplib {
     }
 
     inline Result ClientImpl::Options(const char* path, const Headers& headers) {
-        Request req;
-        req.method = "OPTIONS";
-        req.headers = default_headers_;
-        req.headers.insert(headers.begin(), headers.end());
-        req.path = path;
+        std::lock_guard<std::recursive_mutex> request_mutex_guard(request_mutex_);
 
-        auto res = std::make_shared<Response>();
-        auto ret = send(req, *res);
-        return Result{ ret ? res : nullptr, get_last_error() };
+        auto& req = prepare_request("OPTIONS", path, headers);
+
+        auto res = send_prepared_request(req);
+        return Result{ res, get_last_error() };
     }
 
     inline size_t ClientImpl::is_socket_open() const {
@@ -4828,6 +8480,15 @@ namespace httplib {
         return socket_.is_open();
     }
 
+    inline bool ClientImpl::open_connection() {
+        std::lock_guard<std::recursive_mutex> request_mutex_guard(request_mutex_);
+
+        Response res;
+        res.timings.start = detail::timing_now();
+        bool success = false;
+        return open_socket_if_needed(res, success);
+    }
+
     inline void ClientImpl::stop() {
         stop_core();
         error_ = Error::Canceled;
@@ -4894,6 +8555,26 @@ namespace httplib {
 
     inline void ClientImpl::set_decompress(bool on) { decompress_ = on; }
 
+    inline void ClientImpl::set_http2(bool on) { http2_ = on; }
+
+    inline void ClientImpl::set_http2_prior_knowledge(bool on) {
+        http2_prior_knowledge_ = on;
+    }
+
+    inline void ClientImpl::set_kernel_tls(bool on) { kernel_tls_ = on; }
+
+    inline void ClientImpl::set_io_uring(bool on) { io_uring_ = on; }
+
+    inline void ClientImpl::set_rate_limiters(
+        std::vector<std::shared_ptr<RateLimiter>> limiters) {
+        rate_limiters_ = std::move(limiters);
+    }
+
+    inline void ClientImpl::set_expect_continue(size_t min_body_size, time_t timeout_msec) {
+        expect_continue_min_size_ = min_body_size;
+        expect_continue_timeout_msec_ = timeout_msec;
+    }
+
     inline void ClientImpl::set_interface(const char* intf) { interface_ = intf; }
 
     inline void ClientImpl::set_proxy(const char* host, int port) {
@@ -5061,6 +8742,31 @@ namespace httplib {
             return detail::select_read(sock_, read_timeout_sec_, read_timeout_usec_) > 0;
         }
 
+        // A readable socket may only hold TLS records without application data, TLS 1.3 session
+        // tickets typically. A non-blocking peek takes them in and looks again
+        inline bool SSLSocketStream::wait_readable(time_t sec, time_t usec) const {
+            auto deadline = std::chrono::steady_clock::now() +
+                std::chrono::seconds(sec) + std::chrono::microseconds(usec);
+            for (;;) {
+                if (SSL_pending(ssl_) > 0) { return true; }
+
+                auto left = std::chrono::duration_cast<std::chrono::microseconds>(
+                    deadline - std::chrono::steady_clock::now()).count();
+                if (left <= 0 || select_read(sock_, left / 1000000, left % 1000000) <= 0) {
+                    return false;
+                }
+
+                char c;
+                set_nonblocking(sock_, true);
+                auto n = SSL_peek(ssl_, &c, 1);
+                auto err = n > 0 ? SSL_ERROR_NONE : SSL_get_error(ssl_, n);
+                set_nonblocking(sock_, false);
+
+                // Closed or failed connections are readable too, the read reports them
+                if (err != SSL_ERROR_WANT_READ) { return true; }
+            }
+        }
+
         inline bool SSLSocketStream::is_writable() const {
             return detail::select_write(sock_, write_timeout_sec_, write_timeout_usec_) >
                 0;
@@ -5083,6 +8789,17 @@ namespace httplib {
             detail::get_remote_ip_and_port(sock_, ip, port);
         }
 
+#ifdef CPPHTTPLIB_KTLS_SUPPORT
+        // Only once the kernel seals the records, otherwise the caller falls back to SSL_write()
+        inline ssize_t SSLSocketStream::send_file(int fd, uint64_t offset, size_t size) {
+            if (!BIO_get_ktls_send(SSL_get_wbio(ssl_))) { return -1; }
+            if (!is_writable()) { return -1; }
+
+            SigpipeBlock sigpipe_block;
+            return SSL_sendfile(ssl_, fd, static_cast<off_t>(offset), size, 0);
+        }
+#endif
+
         static SSLInit sslinit_;
 
     } // namespace detail
@@ -5134,13 +8851,19 @@ namespace httplib {
     }
 
     inline SSLClient::~SSLClient() {
+        // ~ClientImpl() only reaches ClientImpl::close_socket(), which would leak the SSL session
+        {
+            std::lock_guard<std::mutex> guard(socket_mutex_);
+            if (socket_.is_open()) { close_socket(socket_, true); }
+        }
         if (ctx_) { SSL_CTX_free(ctx_); }
     }
 
     inline bool SSLClient::is_valid() const { return ctx_ != nullptr; }
 
-    inline bool SSLClient::create_and_connect_socket(Socket& socket) {
-        return is_valid() && ClientImpl::create_and_connect_socket(socket);
+    inline bool SSLClient::create_and_connect_socket(Socket& socket,
+        RequestTimings* timings) {
+        return is_valid() && ClientImpl::create_and_connect_socket(socket, timings);
     }
 
     inline bool SSLClient::connect_with_proxy(Socket& socket, Response& res,
@@ -5241,11 +8964,28 @@ namespace httplib {
                 return true;
             },
             [&](SSL* ssl) {
+                if (http2_) {
+                    static const unsigned char protos[] = "\x02h2\x08http/1.1";
+                    SSL_set_alpn_protos(ssl, protos, sizeof(protos) - 1);
+                }
+#ifdef CPPHTTPLIB_KTLS_SUPPORT
+                if (kernel_tls_) { SSL_set_options(ssl, SSL_OP_ENABLE_KTLS); }
+#endif
                 return true;
             });
 
         if (ssl) {
             socket.ssl = ssl;
+#ifdef CPPHTTPLIB_KTLS_SUPPORT
+            // Without the tls module, or for a cipher the kernel lacks, OpenSSL keeps the records itself
+            socket.is_kernel_tls_send = BIO_get_ktls_send(SSL_get_wbio(ssl)) != 0;
+            socket.is_kernel_tls_recv = BIO_get_ktls_recv(SSL_get_rbio(ssl)) != 0;
+#endif
+
+            const unsigned char* alpn = nullptr;
+            unsigned int alpn_len = 0;
+            SSL_get0_alpn_selected(ssl, &alpn, &alpn_len);
+            socket.is_http2 = alpn_len == 2 && memcmp(alpn, "h2", 2) == 0;
             return true;
         }
 
@@ -5260,6 +9000,10 @@ namespace httplib {
             detail::ssl_delete(ctx_mutex_, socket.ssl, process_socket_ret);
             socket_.ssl = nullptr;
         }
+        socket_.is_kernel_tls_send = false;
+        socket_.is_kernel_tls_recv = false;
+        socket_.is_http2 = false;
+        http2_session_.reset();
     }
 
     inline bool
@@ -5341,11 +9085,11 @@ namespace httplib {
         return cli_->Get(path, headers);
     }
     inline Result Client::Get(const char* path, Progress progress) {
-        return cli_->Get(path, progress);
+        return cli_->Get(path, std::move(progress));
     }
     inline Result Client::Get(const char* path, const Headers & headers,
         Progress progress) {
-        return cli_->Get(path, headers, progress);
+        return cli_->Get(path, headers, std::move(progress));
     }
     inline Result Client::Get(const char* path, ContentReceiver content_receiver) {
         return cli_->Get(path, std::move(content_receiver));
@@ -5382,7 +9126,13 @@ namespace httplib {
     inline Result Client::Get(const char* path, const Headers & headers,
         ResponseHandler response_handler,
         ContentReceiver content_receiver, Progress progress) {
-        return cli_->Get(path, headers, response_handler, content_receiver, progress);
+        return cli_->Get(path, headers, std::move(response_handler), std::move(content_receiver), std::move(progress));
+    }
+
+    inline Result Client::GetInto(const char* path, const Headers & headers,
+        ResponseHandler response_handler,
+        ContentSpanReceiver content_span_receiver, Progress progress) {
+        return cli_->GetInto(path, headers, std::move(response_handler), std::move(content_span_receiver), std::move(progress));
     }
 
     inline Result Client::Head(const char* path) { return cli_->Head(path); }
@@ -5402,13 +9152,13 @@ namespace httplib {
     inline Result Client::Post(const char* path, size_t content_length,
         ContentProvider content_provider,
         const char* content_type) {
-        return cli_->Post(path, content_length, content_provider, content_type);
+        return cli_->Post(path, content_length, std::move(content_provider), content_type);
     }
     inline Result Client::Post(const char* path, const Headers & headers,
         size_t content_length,
         ContentProvider content_provider,
         const char* content_type) {
-        return cli_->Post(path, headers, content_length, content_provider,
+        return cli_->Post(path, headers, content_length, std::move(content_provider),
             content_type);
     }
     /* New functions */
@@ -5417,7 +9167,7 @@ namespace httplib {
         size_t content_length,
         ContentProvider content_provider,
         const char* content_type) {
-        return cli_->Post(path, headers, params, content_length, content_provider,
+        return cli_->Post(path, headers, params, content_length, std::move(content_provider),
             content_type);
     }
     inline Result Client::Post(const char* path, const Headers& headers,
@@ -5426,8 +9176,8 @@ namespace httplib {
         ContentProvider content_provider,
         const char* content_type,
         ResponseHandler response_handler) {
-        return cli_->Post(path, headers, params, content_length, content_provider,
-            content_type, response_handler);
+        return cli_->Post(path, headers, params, content_length, std::move(content_provider),
+            content_type, std::move(response_handler));
     }
     inline Result Client::Post(const char* path, const Headers& headers,
         const Params& params,
@@ -5435,8 +9185,8 @@ namespace httplib {
         ContentProvider content_provider,
         const char* content_type,
         ContentReceiver content_receiver) {
-        return cli_->Post(path, headers, params, content_length, content_provider,
-            content_type, content_receiver);
+        return cli_->Post(path, headers, params, content_length, std::move(content_provider),
+            content_type, std::move(content_receiver));
     }
     inline Result Client::Post(const char* path, const Headers& headers,
         const Params& params,
@@ -5444,8 +9194,8 @@ namespace httplib {
         ContentProvider content_provider,
         const char* content_type,
         Progress progress) {
-        return cli_->Post(path, headers, params, content_length, content_provider,
-            content_type, progress);
+        return cli_->Post(path, headers, params, content_length, std::move(content_provider),
+            content_type, std::move(progress));
     }
     inline Result Client::Post(const char* path, const Headers& headers,
         const Params& params,
@@ -5454,8 +9204,8 @@ namespace httplib {
         const char* content_type,
         ContentReceiver content_receiver,
         Progress progress) {
-        return cli_->Post(path, headers, params, content_length, content_provider,
-            content_type, content_receiver, progress);
+        return cli_->Post(path, headers, params, content_length, std::move(content_provider),
+            content_type, std::move(content_receiver), std::move(progress));
     }
     inline Result Client::Post(const char* path, const Headers& headers,
         const Params& params,
@@ -5465,8 +9215,8 @@ namespace httplib {
         ResponseHandler response_handler,
         ContentReceiver content_receiver,
         Progress progress) {
-        return cli_->Post(path, headers, params, content_length, content_provider,
-            content_type, response_handler, content_receiver, progress);
+        return cli_->Post(path, headers, params, content_length, std::move(content_provider),
+            content_type, std::move(response_handler), std::move(content_receiver), std::move(progress));
     }
     /* New functions end  */
     inline Result Client::Post(const char* path, const Params & params) {
@@ -5497,13 +9247,13 @@ namespace httplib {
     inline Result Client::Put(const char* path, size_t content_length,
         ContentProvider content_provider,
         const char* content_type) {
-        return cli_->Put(path, content_length, content_provider, content_type);
+        return cli_->Put(path, content_length, std::move(content_provider), content_type);
     }
     inline Result Client::Put(const char* path, const Headers & headers,
         size_t content_length,
         ContentProvider content_provider,
         const char* content_type) {
-        return cli_->Put(path, headers, content_length, content_provider,
+        return cli_->Put(path, headers, content_length, std::move(content_provider),
             content_type);
     }
     /* New functions */
@@ -5512,7 +9262,7 @@ namespace httplib {
         size_t content_length,
         ContentProvider content_provider,
         const char* content_type) {
-        return cli_->Put(path, headers, params, content_length, content_provider,
+        return cli_->Put(path, headers, params, content_length, std::move(content_provider),
             content_type);
     }
     inline Result Client::Put(const char* path, const Headers& headers,
@@ -5521,8 +9271,8 @@ namespace httplib {
         ContentProvider content_provider,
         const char* content_type,
         ResponseHandler response_handler) {
-        return cli_->Put(path, headers, params, content_length, content_provider,
-            content_type, response_handler);
+        return cli_->Put(path, headers, params, content_length, std::move(content_provider),
+            content_type, std::move(response_handler));
     }
     inline Result Client::Put(const char* path, const Headers& headers,
         const Params& params,
@@ -5530,8 +9280,8 @@ namespace httplib {
         ContentProvider content_provider,
         const char* content_type,
         ContentReceiver content_receiver) {
-        return cli_->Put(path, headers, params, content_length, content_provider,
-            content_type, content_receiver);
+        return cli_->Put(path, headers, params, content_length, std::move(content_provider),
+            content_type, std::move(content_receiver));
     }
     inline Result Client::Put(const char* path, const Headers& headers,
         const Params& params,
@@ -5539,8 +9289,8 @@ namespace httplib {
         ContentProvider content_provider,
         const char* content_type,
         Progress progress) {
-        return cli_->Put(path, headers, params, content_length, content_provider,
-            content_type, progress);
+        return cli_->Put(path, headers, params, content_length, std::move(content_provider),
+            content_type, std::move(progress));
     }
     inline Result Client::Put(const char* path, const Headers& headers,
         const Params& params,
@@ -5549,8 +9299,8 @@ namespace httplib {
         const char* content_type,
         ContentReceiver content_receiver,
         Progress progress) {
-        return cli_->Put(path, headers, params, content_length, content_provider,
-            content_type, content_receiver, progress);
+        return cli_->Put(path, headers, params, content_length, std::move(content_provider),
+            content_type, std::move(content_receiver), std::move(progress));
     }
     inline Result Client::Put(const char* path, const Headers& headers,
         const Params& params,
@@ -5560,8 +9310,8 @@ namespace httplib {
         ResponseHandler response_handler,
         ContentReceiver content_receiver,
         Progress progress) {
-        return cli_->Put(path, headers, params, content_length, content_provider,
-            content_type, response_handler, content_receiver, progress);
+        return cli_->Put(path, headers, params, content_length, std::move(content_provider),
+            content_type, std::move(response_handler), std::move(content_receiver), std::move(progress));
     }
     /* New functions end  */
     inline Result Client::Put(const char* path, const Params & params) {
@@ -5583,13 +9333,13 @@ namespace httplib {
     inline Result Client::Patch(const char* path, size_t content_length,
         ContentProvider content_provider,
         const char* content_type) {
-        return cli_->Patch(path, content_length, content_provider, content_type);
+        return cli_->Patch(path, content_length, std::move(content_provider), content_type);
     }
     inline Result Client::Patch(const char* path, const Headers & headers,
         size_t content_length,
         ContentProvider content_provider,
         const char* content_type) {
-        return cli_->Patch(path, headers, content_length, content_provider,
+        return cli_->Patch(path, headers, content_length, std::move(content_provider),
             content_type);
     }
     /* New functions */
@@ -5598,24 +9348,24 @@ namespace httplib {
         ContentProvider content_provider,
         const char* content_type,
         ResponseHandler response_handler) {
-        return cli_->Patch(path, headers, params, content_length, content_provider,
-            content_type, response_handler);
+        return cli_->Patch(path, headers, params, content_length, std::move(content_provider),
+            content_type, std::move(response_handler));
     }
     inline Result Client::Patch(const char* path, const Headers& headers,
         const Params& params, size_t content_length,
         ContentProvider content_provider,
         const char* content_type,
         ContentReceiver content_receiver) {
-        return cli_->Patch(path, headers, params, content_length, content_provider,
-            content_type, content_receiver);
+        return cli_->Patch(path, headers, params, content_length, std::move(content_provider),
+            content_type, std::move(content_receiver));
     }
     inline Result Client::Patch(const char* path, const Headers& headers,
         const Params& params, size_t content_length,
         ContentProvider content_provider,
         const char* content_type,
         Progress progress) {
-        return cli_->Patch(path, headers, params, content_length, content_provider,
-            content_type, progress);
+        return cli_->Patch(path, headers, params, content_length, std::move(content_provider),
+            content_type, std::move(progress));
     }
     inline Result Client::Patch(const char* path, const Headers& headers,
         const Params& params, size_t content_length,
@@ -5623,8 +9373,8 @@ namespace httplib {
         const char* content_type,
         ContentReceiver content_receiver,
         Progress progress) {
-        return cli_->Patch(path, headers, params, content_length, content_provider,
-            content_type, content_receiver, progress);
+        return cli_->Patch(path, headers, params, content_length, std::move(content_provider),
+            content_type, std::move(content_receiver), std::move(progress));
     }
     inline Result Client::Patch(const char* path, const Headers& headers,
         const Params& params, size_t content_length,
@@ -5633,8 +9383,56 @@ namespace httplib {
         ResponseHandler response_handler,
         ContentReceiver content_receiver,
         Progress progress) {
-        return cli_->Patch(path, headers, params, content_length, content_provider,
-            content_type, response_handler, content_receiver, progress);
+        return cli_->Patch(path, headers, params, content_length, std::move(content_provider),
+            content_type, std::move(response_handler), std::move(content_receiver), std::move(progress));
+    }
+    inline Result Client::Post(const char* path, const Headers& headers,
+        const FileContent& file, const char* content_type,
+        ResponseHandler response_handler,
+        ContentReceiver content_receiver,
+        Progress progress) {
+        return cli_->Post(path, headers, file, content_type,
+            std::move(response_handler), std::move(content_receiver), std::move(progress));
+    }
+    inline Result Client::Put(const char* path, const Headers& headers,
+        const FileContent& file, const char* content_type,
+        ResponseHandler response_handler,
+        ContentReceiver content_receiver,
+        Progress progress) {
+        return cli_->Put(path, headers, file, content_type,
+            std::move(response_handler), std::move(content_receiver), std::move(progress));
+    }
+    inline Result Client::Patch(const char* path, const Headers& headers,
+        const FileContent& file, const char* content_type,
+        ResponseHandler response_handler,
+        ContentReceiver content_receiver,
+        Progress progress) {
+        return cli_->Patch(path, headers, file, content_type,
+            std::move(response_handler), std::move(content_receiver), std::move(progress));
+    }
+    inline Result Client::Post(const char* path, const Headers& headers,
+        MultipartFormDataWriter& form,
+        ResponseHandler response_handler,
+        ContentReceiver content_receiver,
+        Progress progress) {
+        return cli_->Post(path, headers, form,
+            std::move(response_handler), std::move(content_receiver), std::move(progress));
+    }
+    inline Result Client::Put(const char* path, const Headers& headers,
+        MultipartFormDataWriter& form,
+        ResponseHandler response_handler,
+        ContentReceiver content_receiver,
+        Progress progress) {
+        return cli_->Put(path, headers, form,
+            std::move(response_handler), std::move(content_receiver), std::move(progress));
+    }
+    inline Result Client::Patch(const char* path, const Headers& headers,
+        MultipartFormDataWriter& form,
+        ResponseHandler response_handler,
+        ContentReceiver content_receiver,
+        Progress progress) {
+        return cli_->Patch(path, headers, form,
+            std::move(response_handler), std::move(content_receiver), std::move(progress));
     }
     /* New functions end  */
 
@@ -5655,30 +9453,30 @@ namespace httplib {
     inline Result Client::Delete(const char* path, const Headers& headers,
         const char* content_type,
         ResponseHandler response_handler) {
-        return cli_->Delete(path, headers, content_type, response_handler);
+        return cli_->Delete(path, headers, content_type, std::move(response_handler));
     }
     inline Result Client::Delete(const char* path, const Headers& headers,
         const char* content_type,
         ContentReceiver content_receiver) {
-        return cli_->Delete(path, headers, content_type, content_receiver);
+        return cli_->Delete(path, headers, content_type, std::move(content_receiver));
     }
     inline Result Client::Delete(const char* path, const Headers& headers,
         const char* content_type,
         Progress progress) {
-        return cli_->Delete(path, headers, content_type, progress);
+        return cli_->Delete(path, headers, content_type, std::move(progress));
     }
     inline Result Client::Delete(const char* path, const Headers& headers,
         const char* content_type,
         ContentReceiver content_receiver,
         Progress progress) {
-        return cli_->Delete(path, headers, content_type, content_receiver, progress);
+        return cli_->Delete(path, headers, content_type, std::move(content_receiver), std::move(progress));
     }
     inline Result Client::Delete(const char* path, const Headers& headers,
         const char* content_type,
         ResponseHandler response_handler,
         ContentReceiver content_receiver,
         Progress progress) {
-        return cli_->Delete(path, headers, std::string(), content_type, response_handler, content_receiver, progress);
+        return cli_->Delete(path, headers, std::string(), content_type, std::move(response_handler), std::move(content_receiver), std::move(progress));
     }
     inline Result Client::Delete(const char* path, const Headers& headers,
         const std::string& body,
@@ -5686,13 +9484,13 @@ namespace httplib {
         ResponseHandler response_handler,
         ContentReceiver content_receiver,
         Progress progress) {
-        return cli_->Delete(path, headers, body, content_type, response_handler, content_receiver, progress);
+        return cli_->Delete(path, headers, body, content_type, std::move(response_handler), std::move(content_receiver), std::move(progress));
     }
     inline Result Client::Delete(const char* path, const Headers& headers,
         ResponseHandler response_handler,
         ContentReceiver content_receiver,
         Progress progress) {
-        return cli_->Delete(path, headers, std::string(), nullptr, response_handler, content_receiver, progress);
+        return cli_->Delete(path, headers, std::string(), nullptr, std::move(response_handler), std::move(content_receiver), std::move(progress));
     }
     /* New functions end  */
 
@@ -5705,8 +9503,20 @@ namespace httplib {
         return cli_->send(req, res);
     }
 
+    inline bool Client::send_pipelined(const std::vector<Request> & requests,
+        std::vector<Response> & responses, size_t max_in_flight) {
+        return cli_->send_pipelined(requests, responses, max_in_flight);
+    }
+
+    inline bool Client::send_multiplexed(const std::vector<Request>& requests,
+        std::vector<Response>& responses, size_t max_in_flight) {
+        return cli_->send_multiplexed(requests, responses, max_in_flight);
+    }
+
     inline size_t Client::is_socket_open() const { return cli_->is_socket_open(); }
 
+    inline bool Client::open_connection() { return cli_->open_connection(); }
+
     inline void Client::stop() { cli_->stop(); }
 
     inline void Client::set_default_headers(Headers headers) {
@@ -5750,6 +9560,25 @@ namespace httplib {
 
     inline void Client::set_decompress(bool on) { cli_->set_decompress(on); }
 
+    inline void Client::set_http2(bool on) { cli_->set_http2(on); }
+
+    inline void Client::set_http2_prior_knowledge(bool on) {
+        cli_->set_http2_prior_knowledge(on);
+    }
+
+    inline void Client::set_kernel_tls(bool on) { cli_->set_kernel_tls(on); }
+
+    inline void Client::set_io_uring(bool on) { cli_->set_io_uring(on); }
+
+    inline void Client::set_rate_limiters(
+        std::vector<std::shared_ptr<RateLimiter>> limiters) {
+        cli_->set_rate_limiters(std::move(limiters));
+    }
+
+    inline void Client::set_expect_continue(size_t min_body_size, time_t timeout_msec) {
+        cli_->set_expect_continue(min_body_size, timeout_msec);
+    }
+
     inline void Client::set_interface(const char* intf) {
         cli_->set_interface(intf);
     }
@@ -0,0 +1,103 @@
+/// MIT License, Copyright Burak Kara, burak@burak.io, https://en.wikipedia.org/wiki/MIT_License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BHttpClient.h"
+
+/*
+ * S3 multipart upload for BHttpClient::UploadFileInParts: CreateMultipartUpload, one UploadPart per
+ * part, CompleteMultipartUpload, or AbortMultipartUpload after a failure. Fits AWS and the S3
+ * compatible stores (MinIO, Ceph, R2, ...), path style or virtual host style.
+ *
+ * Requests are not signed, HeadersData goes on every one of them as it is. Stores that take static
+ * credentials in headers work with that; AWS Signature V4 needs a subclass whose PrepareRequest signs
+ * each request, with "x-amz-content-sha256: UNSIGNED-PAYLOAD" so the parts don't have to be hashed.
+ *
+ * */
+class BHTTPCLIENTLIB_API FBHttpS3PartUploadProtocol : public IBHttpPartUploadProtocol
+{
+public:
+    // InObjectUrl is scheme://host[:port]/bucket/key or scheme://bucket.host/key, escaped and without a query
+    FBHttpS3PartUploadProtocol(const FString& InObjectUrl, const TMap<FString, FString>& InHeadersData, const FString& InContentType = TEXT("application/octet-stream"));
+
+    // Empty until the upload started
+    const FString& GetUploadId() const { return UploadId; }
+    // Of the completed object, quotes included
+    const FString& GetObjectETag() const { return ObjectETag; }
+
+    // 8 MB parts unless asked otherwise, at least 5 MB and few enough for 10000 parts
+    virtual int64 GetPartBytes(int64 TotalBytes, int64 RequestedPartBytes) const override;
+
+    virtual bool MakeStartRequest(FBHttpUploadRequest& OutRequest) override;
+    virtual bool OnStartResponse(const FBHttpUploadResponse& Response) override;
+    virtual void MakePartRequest(int32 PartIndex, int64 Offset, int64 Bytes, FBHttpUploadRequest& OutRequest) override;
+    virtual bool OnPartResponse(int32 PartIndex, const FBHttpUploadResponse& Response, FString& OutPartTag) override;
+    virtual void MakeCompleteRequests(const TArray<FString>& PartTags, TArray<FBHttpUploadRequest>& OutRequests) override;
+    // S3 may answer 200 and still fail, with an <Error> body; that is refused and sent again
+    virtual bool OnCompleteResponse(int32 RequestIndex, const FBHttpUploadResponse& Response) override;
+    virtual void MakeAbortRequests(const TArray<FString>& PartTags, TArray<FBHttpUploadRequest>& OutRequests) override;
+
+protected:
+    // Last step of every request before it is sent, e.g. to sign it; called from several threads at once
+    virtual void PrepareRequest(FBHttpUploadRequest& Request) const {}
+
+    FString ObjectUrl;
+    TMap<FString, FString> HeadersData;
+    FString ContentType;
+
+    FString UploadId;
+    FString ObjectETag;
+
+private:
+    void MakeRequest(EBHttpBatchVerb Verb, const FString& Query, FBHttpUploadRequest& OutRequest) const;
+};
+
+/*
+ * Parallel composite upload to Google Cloud Storage, through its XML API, for BHttpClient::UploadFileInParts.
+ * Every part goes up as a temporary object of its own, next to the destination, then the parts are
+ * composed into the destination and deleted. A compose takes at most 32 sources, more parts are
+ * composed in groups of 32 first, which caps an upload at 1024 parts.
+ *
+ * HeadersData goes on every request, typically "Authorization: Bearer <token>". A composite object
+ * has a CRC32C but no MD5, and the temporary part objects count against buckets with a retention
+ * policy or a storage class that charges early deletion: such buckets are better served by S3 style
+ * uploads through GCS's XML API multipart support.
+ *
+ * */
+class BHTTPCLIENTLIB_API FBHttpGcsComposeUploadProtocol : public IBHttpPartUploadProtocol
+{
+public:
+    // InBucketUrl is scheme://host[:port]/bucket, e.g. https://storage.googleapis.com/my-bucket; InObjectName is not escaped
+    FBHttpGcsComposeUploadProtocol(const FString& InBucketUrl, const FString& InObjectName, const TMap<FString, FString>& InHeadersData, const FString& InContentType = TEXT("application/octet-stream"));
+
+    // 16 MB parts unless asked otherwise, few enough for 1024 parts
+    virtual int64 GetPartBytes(int64 TotalBytes, int64 RequestedPartBytes) const override;
+
+    virtual void MakePartRequest(int32 PartIndex, int64 Offset, int64 Bytes, FBHttpUploadRequest& OutRequest) override;
+    virtual bool OnPartResponse(int32 PartIndex, const FBHttpUploadResponse& Response, FString& OutPartTag) override;
+    virtual void MakeCompleteRequests(const TArray<FString>& PartTags, TArray<FBHttpUploadRequest>& OutRequests) override;
+    // Both delete the part objects, and the group objects of more than 32 parts
+    virtual void MakeCleanupRequests(const TArray<FString>& PartTags, TArray<FBHttpUploadRequest>& OutRequests) override;
+    virtual void MakeAbortRequests(const TArray<FString>& PartTags, TArray<FBHttpUploadRequest>& OutRequests) override;
+
+    // Sources of one compose request
+    static constexpr int32 MaxComposeSources = 32;
+
+protected:
+    FString BucketUrl;
+    FString ObjectName;
+    TMap<FString, FString> HeadersData;
+    FString ContentType;
+
+    // Makes the temporary object names of this upload unique, so uploads of the same object don't collide
+    FString UploadTag;
+    int32 GroupCount = 0;
+
+private:
+    // "<ObjectName>.<UploadTag>.part<N>" and "<ObjectName>.<UploadTag>.group<N>"
+    FString GetTemporaryObjectName(const TCHAR* Kind, int32 Index) const;
+    FString GetObjectUrl(const FString& Name) const;
+    void MakeComposeRequest(const FString& Destination, const TArray<FString>& Sources, int32 First, int32 Count, FBHttpUploadRequest& OutRequest) const;
+    void MakeDeleteRequest(const FString& Name, FBHttpUploadRequest& OutRequest) const;
+};